@@ -0,0 +1,340 @@
+/*
+ *  This file is part of the optimized implementation of the Picnic signature scheme.
+ *  See the accompanying documentation for complete details.
+ *
+ *  The code is provided under the MIT license, see LICENSE for
+ *  more details.
+ *  SPDX-License-Identifier: MIT
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "allocator.h"
+#include "compat.h"
+#include "lock.h"
+#include "macros.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined(__STDC_NO_ATOMICS__) && !defined(_MSC_VER)
+#include <stdatomic.h>
+#define HAVE_STDATOMIC
+#endif
+
+/* alignment of picnic_malloc and picnic_calloc, matches what malloc guarantees on 64 bit */
+#define DEFAULT_ALIGNMENT 16
+
+/* an allocator set with picnic_set_allocator; published copies are never modified or released */
+typedef struct allocator_copy_s {
+  picnic_allocator_t allocator;
+  struct allocator_copy_s* next;
+} allocator_copy_t;
+
+/* all published copies, so that setting the same allocator again does not take more memory */
+static allocator_copy_t* allocator_copies;
+static lock_t allocator_lock = LOCK_INITIALIZER;
+
+/* the allocator in use, or NULL for the C library */
+#if defined(HAVE_STDATOMIC)
+static _Atomic(const picnic_allocator_t*) current_allocator;
+#else
+static const picnic_allocator_t* current_allocator;
+#endif
+
+/* number of allocations that could not be served */
+#if defined(HAVE_STDATOMIC)
+static atomic_size_t failures;
+#else
+static size_t failures;
+#endif
+
+/* placed at the start of the buffer of an arena, so that memory can be released on any thread */
+typedef struct {
+  /* number of allocations that have not been freed yet */
+#if defined(HAVE_STDATOMIC)
+  atomic_size_t live;
+#else
+  size_t live;
+#endif
+} arena_control_t;
+
+/* bump arena of the calling thread */
+typedef struct {
+  arena_control_t* control;
+  uint8_t* base;
+  size_t size;
+  size_t offset;
+} arena_t;
+
+static THREAD_LOCAL arena_t arena;
+
+/*
+ * Stored in front of every allocation. It records where the memory came from, so that it is
+ * released correctly regardless of the thread that frees it and of the allocator or arena in use
+ * at that time.
+ */
+typedef struct {
+  /* start of the underlying allocation */
+  void* raw;
+  /* arena the memory was taken from, or NULL */
+  arena_control_t* arena;
+  /* functions to release raw with if the memory was not taken from an arena */
+  void (*free)(void* opaque, void* ptr);
+  void* opaque;
+} allocation_header_t;
+
+static size_t arena_live(const arena_control_t* control) {
+#if defined(HAVE_STDATOMIC)
+  return atomic_load_explicit(&control->live, memory_order_acquire);
+#else
+  return control->live;
+#endif
+}
+
+static void* arena_alloc(size_t alignment, size_t size) {
+  if (!arena.base) {
+    return NULL;
+  }
+  /* reset once all allocations are released; only the owning thread allocates from the arena */
+  if (!arena_live(arena.control)) {
+    arena.offset = 0;
+  }
+
+  const uintptr_t base  = (uintptr_t)arena.base;
+  const uintptr_t start = (base + arena.offset + alignment - 1) & ~((uintptr_t)alignment - 1);
+  const size_t offset   = start - base;
+  if (offset > arena.size || size > arena.size - offset) {
+    return NULL;
+  }
+
+  arena.offset = offset + size;
+#if defined(HAVE_STDATOMIC)
+  atomic_fetch_add_explicit(&arena.control->live, 1, memory_order_relaxed);
+#else
+  ++arena.control->live;
+#endif
+  return (void*)start;
+}
+
+static void arena_free(arena_control_t* control) {
+#if defined(HAVE_STDATOMIC)
+  atomic_fetch_sub_explicit(&control->live, 1, memory_order_release);
+#else
+  --control->live;
+#endif
+}
+
+static void libc_free(void* opaque, void* ptr) {
+  (void)opaque;
+  free(ptr);
+}
+
+static void libc_aligned_free(void* opaque, void* ptr) {
+  (void)opaque;
+  aligned_free(ptr);
+}
+
+/* space in front of an allocation for its header, keeping the allocation aligned */
+static size_t header_size(size_t alignment) {
+  return (sizeof(allocation_header_t) + alignment - 1) & ~(alignment - 1);
+}
+
+static const picnic_allocator_t* get_allocator(void) {
+#if defined(HAVE_STDATOMIC)
+  return atomic_load_explicit(&current_allocator, memory_order_acquire);
+#else
+  return current_allocator;
+#endif
+}
+
+static void publish_allocator(const picnic_allocator_t* new_allocator) {
+#if defined(HAVE_STDATOMIC)
+  atomic_store_explicit(&current_allocator, new_allocator, memory_order_release);
+#else
+  current_allocator = new_allocator;
+#endif
+}
+
+static void* allocation_failed(void) {
+#if defined(HAVE_STDATOMIC)
+  atomic_fetch_add_explicit(&failures, 1, memory_order_relaxed);
+#else
+  ++failures;
+#endif
+  return NULL;
+}
+
+static void* finish_allocation(uint8_t* raw, size_t alignment, arena_control_t* control,
+                               void (*free_fn)(void*, void*), void* opaque) {
+  if (!raw) {
+    return allocation_failed();
+  }
+
+  uint8_t* ptr                = raw + header_size(alignment);
+  allocation_header_t* header = (allocation_header_t*)ptr - 1;
+  header->raw                 = raw;
+  header->arena               = control;
+  header->free                = free_fn;
+  header->opaque              = opaque;
+  return ptr;
+}
+
+/* allocates size bytes and clears them if requested */
+static void* allocate(size_t alignment, size_t size, bool use_arena, bool clear) {
+  if (alignment < DEFAULT_ALIGNMENT) {
+    alignment = DEFAULT_ALIGNMENT;
+  }
+  const size_t offset = header_size(alignment);
+  if (size > SIZE_MAX - offset) {
+    return allocation_failed();
+  }
+
+  uint8_t* raw = use_arena ? arena_alloc(alignment, offset + size) : NULL;
+  if (raw) {
+    if (clear) {
+      memset(raw + offset, 0, size);
+    }
+    return finish_allocation(raw, alignment, arena.control, NULL, NULL);
+  }
+
+  /* alloc, free and opaque are taken from the same copy */
+  const picnic_allocator_t* custom = get_allocator();
+  if (custom) {
+    raw = custom->alloc(custom->opaque, alignment, offset + size);
+    if (raw && clear) {
+      memset(raw + offset, 0, size);
+    }
+    return finish_allocation(raw, alignment, NULL, custom->free, custom->opaque);
+  }
+  if (alignment == DEFAULT_ALIGNMENT) {
+    /* calloc may skip clearing memory that is known to be zero */
+    raw = clear ? calloc(1, offset + size) : malloc(offset + size);
+    return finish_allocation(raw, alignment, NULL, libc_free, NULL);
+  }
+  raw = aligned_alloc(alignment, offset + size);
+  if (raw && clear) {
+    memset(raw + offset, 0, size);
+  }
+  return finish_allocation(raw, alignment, NULL, libc_aligned_free, NULL);
+}
+
+static void deallocate(void* ptr) {
+  if (!ptr) {
+    return;
+  }
+
+  const allocation_header_t* header = (const allocation_header_t*)ptr - 1;
+  if (header->arena) {
+    arena_free(header->arena);
+  } else {
+    header->free(header->opaque, header->raw);
+  }
+}
+
+void* picnic_malloc(size_t size) {
+  return allocate(DEFAULT_ALIGNMENT, size, true, false);
+}
+
+void* picnic_calloc(size_t nmemb, size_t size) {
+  if (size && nmemb > SIZE_MAX / size) {
+    return allocation_failed();
+  }
+  return allocate(DEFAULT_ALIGNMENT, nmemb * size, true, true);
+}
+
+void* picnic_calloc_persistent(size_t nmemb, size_t size) {
+  if (size && nmemb > SIZE_MAX / size) {
+    return allocation_failed();
+  }
+  return allocate(DEFAULT_ALIGNMENT, nmemb * size, false, true);
+}
+
+void* picnic_aligned_alloc(size_t alignment, size_t size) {
+  return allocate(alignment, size, true, false);
+}
+
+void picnic_free(void* ptr) {
+  deallocate(ptr);
+}
+
+void picnic_aligned_free(void* ptr) {
+  deallocate(ptr);
+}
+
+size_t picnic_allocation_failures(void) {
+#if defined(HAVE_STDATOMIC)
+  return atomic_load_explicit(&failures, memory_order_relaxed);
+#else
+  return failures;
+#endif
+}
+
+int PICNIC_CALLING_CONVENTION picnic_set_allocator(const picnic_allocator_t* new_allocator) {
+  if (!new_allocator) {
+    publish_allocator(NULL);
+    return 0;
+  }
+  if (!new_allocator->alloc || !new_allocator->free) {
+    return -1;
+  }
+
+  lock_acquire(&allocator_lock);
+  allocator_copy_t* copy = allocator_copies;
+  while (copy && (copy->allocator.alloc != new_allocator->alloc ||
+                  copy->allocator.free != new_allocator->free ||
+                  copy->allocator.opaque != new_allocator->opaque)) {
+    copy = copy->next;
+  }
+  if (!copy) {
+    /* other threads may still read the current copy, hence a new one is published */
+    copy = malloc(sizeof(*copy));
+    if (!copy) {
+      lock_release(&allocator_lock);
+      return -1;
+    }
+    copy->allocator  = *new_allocator;
+    copy->next       = allocator_copies;
+    allocator_copies = copy;
+  }
+  publish_allocator(&copy->allocator);
+  lock_release(&allocator_lock);
+  return 0;
+}
+
+int PICNIC_CALLING_CONVENTION picnic_set_thread_arena(void* buffer, size_t size) {
+  if (arena.base && arena_live(arena.control)) {
+    /* allocations from the current arena are still in use */
+    return -1;
+  }
+
+  arena.control = NULL;
+  arena.base    = NULL;
+  arena.size    = 0;
+  arena.offset  = 0;
+  if (!buffer || !size) {
+    return 0;
+  }
+
+  /* the control block is placed at the aligned start of the buffer */
+  const uintptr_t start =
+      ((uintptr_t)buffer + DEFAULT_ALIGNMENT - 1) & ~(uintptr_t)(DEFAULT_ALIGNMENT - 1);
+  const size_t reserved = start - (uintptr_t)buffer + sizeof(arena_control_t);
+  if (size <= reserved) {
+    return -1;
+  }
+
+  arena.control = (arena_control_t*)start;
+#if defined(HAVE_STDATOMIC)
+  atomic_init(&arena.control->live, 0);
+#else
+  arena.control->live = 0;
+#endif
+  arena.base = (uint8_t*)buffer + reserved;
+  arena.size = size - reserved;
+  return 0;
+}
@@ -0,0 +1,34 @@
+/*
+ *  This file is part of the optimized implementation of the Picnic signature scheme.
+ *  See the accompanying documentation for complete details.
+ *
+ *  The code is provided under the MIT license, see LICENSE for
+ *  more details.
+ *  SPDX-License-Identifier: MIT
+ */
+
+#ifndef PICNIC_ALLOCATOR_H
+#define PICNIC_ALLOCATOR_H
+
+#include <stddef.h>
+
+#include "picnic.h"
+
+/**
+ * Allocation functions used by the library. They serve the request from the arena of the calling
+ * thread if one is set and has enough space left, and otherwise forward it to the allocator set
+ * via picnic_set_allocator or to the C library.
+ */
+void* picnic_malloc(size_t size);
+void* picnic_calloc(size_t nmemb, size_t size);
+/* for memory that outlives the current operation; never served from the arena */
+void* picnic_calloc_persistent(size_t nmemb, size_t size);
+/* alignment has to be a power of 2 and size a multiple of it */
+void* picnic_aligned_alloc(size_t alignment, size_t size);
+void picnic_free(void* ptr);
+void picnic_aligned_free(void* ptr);
+
+/* number of allocations on any thread that failed so far */
+size_t picnic_allocation_failures(void);
+
+#endif
@@ -12,8 +12,12 @@
 #endif
 
 #include "bitstream.h"
+#include "endian_compat.h"
 #include "macros.h"
 
+#include <stdbool.h>
+#include <string.h>
+
 uint64_t bitstream_get_bits(bitstream_t* bs, unsigned int num_bits) {
   ASSUME(1 <= num_bits && num_bits <= 64);
 
@@ -161,29 +165,164 @@ void bitstream_put_bits_32(bitstream_t* bs, uint32_t value, unsigned int num_bit
   }
 }
 
+static inline void store_be64(uint8_t* dst, uint64_t v) {
+  v = htobe64(v);
+  memcpy(dst, &v, sizeof(v));
+}
+
+/**
+ * Load up to 8 bytes as big endian word. Stores the number of loaded bits in bits.
+ */
+static inline uint64_t load_be64_partial(const uint8_t** src, size_t* remaining_bytes,
+                                         unsigned int* bits) {
+  uint64_t v;
+  if (*remaining_bytes >= sizeof(uint64_t)) {
+    memcpy(&v, *src, sizeof(v));
+    v = be64toh(v);
+    *bits = sizeof(uint64_t) * 8;
+    *src += sizeof(uint64_t);
+    *remaining_bytes -= sizeof(uint64_t);
+    return v;
+  }
+
+  v = 0;
+  for (size_t i = 0; i < *remaining_bytes; ++i) {
+    v |= (uint64_t)(*src)[i] << (56 - 8 * i);
+  }
+  *bits = *remaining_bytes * 8;
+  *src += *remaining_bytes;
+  *remaining_bytes = 0;
+  return v;
+}
+
+/* field i is read from the upper bits of a 64 bit word or, if narrow, a 32 bit word at src[i] */
+static inline uint64_t load_field(const void* src, ptrdiff_t i, bool narrow) {
+  if (narrow) {
+    return (uint64_t)((const uint32_t*)src)[i] << 32;
+  }
+  return ((const uint64_t*)src)[i];
+}
+
+static inline void store_field(void* dst, ptrdiff_t i, uint64_t v, bool narrow) {
+  if (narrow) {
+    ((uint32_t*)dst)[i] = v >> 32;
+  } else {
+    ((uint64_t*)dst)[i] = v;
+  }
+}
+
+static inline void put_fields(bitstream_t* bs, const void* src, ptrdiff_t stride,
+                              size_t num_fields, unsigned int num_bits, bool narrow) {
+  uint8_t* p          = &bs->buffer.w[bs->position / 8];
+  unsigned int fill   = bs->position % 8;
+  const uint64_t mask = UINT64_C(0xffffffffffffffff) << (64 - num_bits);
+
+  bs->position += num_fields * num_bits;
+  // the upper fill bits of the current byte have already been taken
+  uint64_t acc = fill ? (uint64_t)(*p & (0xFF << (8 - fill))) << 56 : 0;
+  for (ptrdiff_t i = 0; num_fields; --num_fields, i += stride) {
+    const uint64_t v = load_field(src, i, narrow) & mask;
+
+    acc |= v >> fill;
+    fill += num_bits;
+    if (fill >= 64) {
+      store_be64(p, acc);
+      p += sizeof(uint64_t);
+      fill -= 64;
+      acc = fill ? v << (num_bits - fill) : 0;
+    }
+  }
+
+  for (; fill >= 8; fill -= 8, acc <<= 8) {
+    *p++ = acc >> 56;
+  }
+  if (fill) {
+    *p = (*p & (0xFF >> fill)) | (acc >> 56); // keep the bits after the end of the stream
+  }
+}
+
+static inline void get_fields(bitstream_t* bs, void* dst, ptrdiff_t stride, size_t num_fields,
+                              unsigned int num_bits, bool narrow) {
+  if (!num_fields) {
+    return;
+  }
+
+  const uint8_t* p             = &bs->buffer.r[bs->position / 8];
+  const unsigned int skip_bits = bs->position % 8;
+  const uint64_t mask          = UINT64_C(0xffffffffffffffff) << (64 - num_bits);
+  // only touch the bytes covered by the fields
+  size_t remaining_bytes = (skip_bits + num_fields * num_bits + 7) / 8;
+
+  bs->position += num_fields * num_bits;
+  unsigned int avail;
+  uint64_t acc = load_be64_partial(&p, &remaining_bytes, &avail) << skip_bits;
+  avail -= skip_bits;
+  for (ptrdiff_t i = 0; num_fields; --num_fields, i += stride) {
+    uint64_t v;
+    if (avail >= num_bits) {
+      v   = acc;
+      acc = num_bits == 64 ? 0 : acc << num_bits;
+      avail -= num_bits;
+    } else {
+      unsigned int loaded;
+      const uint64_t w       = load_be64_partial(&p, &remaining_bytes, &loaded);
+      const unsigned int used = num_bits - avail;
+
+      v     = acc | (w >> avail);
+      acc   = used == 64 ? 0 : w << used;
+      avail = loaded - used;
+    }
+    store_field(dst, i, v & mask, narrow);
+  }
+}
+
+void bitstream_put_fields(bitstream_t* bs, const uint64_t* src, ptrdiff_t stride,
+                          size_t num_fields, unsigned int num_bits) {
+  ASSUME(1 <= num_bits && num_bits <= 64);
+  put_fields(bs, src, stride, num_fields, num_bits, false);
+}
+
+void bitstream_put_fields_32(bitstream_t* bs, const uint32_t* src, ptrdiff_t stride,
+                             size_t num_fields, unsigned int num_bits) {
+  ASSUME(1 <= num_bits && num_bits <= 32);
+  put_fields(bs, src, stride, num_fields, num_bits, true);
+}
+
+void bitstream_get_fields(bitstream_t* bs, uint64_t* dst, ptrdiff_t stride, size_t num_fields,
+                          unsigned int num_bits) {
+  ASSUME(1 <= num_bits && num_bits <= 64);
+  get_fields(bs, dst, stride, num_fields, num_bits, false);
+}
+
+void bitstream_get_fields_32(bitstream_t* bs, uint32_t* dst, ptrdiff_t stride, size_t num_fields,
+                             unsigned int num_bits) {
+  ASSUME(1 <= num_bits && num_bits <= 32);
+  get_fields(bs, dst, stride, num_fields, num_bits, true);
+}
+
 #if defined(WITH_LOWMC_129_129_4) || defined(WITH_LOWMC_192_192_4) || defined(WITH_LOWMC_255_255_4)
 void mzd_to_bitstream(bitstream_t* bs, const mzd_local_t* v, const size_t width,
                       const size_t size) {
-  const uint64_t* d = &CONST_BLOCK(v, 0)->w64[width - 1];
-  size_t bits       = size;
-  for (; bits >= sizeof(uint64_t) * 8; bits -= sizeof(uint64_t) * 8, --d) {
-    bitstream_put_bits(bs, *d, sizeof(uint64_t) * 8);
-  }
+  const uint64_t* d       = &CONST_BLOCK(v, 0)->w64[width - 1];
+  const size_t full_words = size / (sizeof(uint64_t) * 8);
+  const size_t bits       = size % (sizeof(uint64_t) * 8);
+
+  bitstream_put_fields(bs, d, -1, full_words, sizeof(uint64_t) * 8);
   if (bits) {
-    bitstream_put_bits(bs, *d >> (sizeof(uint64_t) * 8 - bits), bits);
+    bitstream_put_fields(bs, d - full_words, -1, 1, bits);
   }
 }
 
 void mzd_from_bitstream(bitstream_t* bs, mzd_local_t* v, const size_t width, const size_t size) {
-  uint64_t* d = &BLOCK(v, 0)->w64[width - 1];
-  uint64_t* f = BLOCK(v, 0)->w64;
+  uint64_t* d             = &BLOCK(v, 0)->w64[width - 1];
+  uint64_t* f             = BLOCK(v, 0)->w64;
+  const size_t full_words = size / (sizeof(uint64_t) * 8);
+  const size_t bits       = size % (sizeof(uint64_t) * 8);
 
-  size_t bits = size;
-  for (; bits >= sizeof(uint64_t) * 8; bits -= sizeof(uint64_t) * 8, --d) {
-    *d = bitstream_get_bits(bs, sizeof(uint64_t) * 8);
-  }
+  bitstream_get_fields(bs, d, -1, full_words, sizeof(uint64_t) * 8);
+  d -= full_words;
   if (bits) {
-    *d = bitstream_get_bits(bs, bits) << (sizeof(uint64_t) * 8 - bits);
+    bitstream_get_fields(bs, d, -1, 1, bits);
     --d;
   }
   for (; d >= f; --d) {
@@ -29,6 +29,24 @@ void bitstream_put_bits(bitstream_t* bs, uint64_t value, unsigned int num_bits);
 void bitstream_put_bits_8(bitstream_t* bs, uint8_t value, unsigned int num_bits);
 void bitstream_put_bits_32(bitstream_t* bs, uint32_t value, unsigned int num_bits);
 
+/**
+ * Write num_fields fields of num_bits bits each. The fields are read from the most significant
+ * bits of src[0], src[stride], src[2 * stride], ...
+ */
+void bitstream_put_fields(bitstream_t* bs, const uint64_t* src, ptrdiff_t stride,
+                          size_t num_fields, unsigned int num_bits);
+/**
+ * Read num_fields fields of num_bits bits each. The fields are stored in the most significant bits
+ * of dst[0], dst[stride], dst[2 * stride], ... with the remaining bits cleared.
+ */
+void bitstream_get_fields(bitstream_t* bs, uint64_t* dst, ptrdiff_t stride, size_t num_fields,
+                          unsigned int num_bits);
+/* variants of the above operating on 32 bit words */
+void bitstream_put_fields_32(bitstream_t* bs, const uint32_t* src, ptrdiff_t stride,
+                             size_t num_fields, unsigned int num_bits);
+void bitstream_get_fields_32(bitstream_t* bs, uint32_t* dst, ptrdiff_t stride, size_t num_fields,
+                             unsigned int num_bits);
+
 #if defined(WITH_LOWMC_129_129_4) || defined(WITH_LOWMC_192_192_4) || defined(WITH_LOWMC_255_255_4)
 void mzd_to_bitstream(bitstream_t* bs, const mzd_local_t* v, const size_t width, const size_t size);
 void mzd_from_bitstream(bitstream_t* bs, mzd_local_t* v, const size_t width, const size_t size);
@@ -8,7 +8,7 @@
 #define ATTRIBUTE_TARGET(x)
 #endif
 
-#if defined(SSE2) || defined(AVX2) || defined(BMI2)
+#if defined(SSE2) || defined(AVX2) || defined(BMI2) || defined(GFNI)
 #include <immintrin.h>
 
 #if defined(SSE2)
@@ -30,6 +30,14 @@ ATTRIBUTE_TARGET("bmi2") void test(void) {
   (void)_pext_u32(0, 0);
 }
 #endif
+
+#if defined(GFNI)
+ATTRIBUTE_TARGET("avx2,gfni") void test(void) {
+  __m256i a = _mm256_setzero_si256();
+  a = _mm256_gf2p8affine_epi64_epi8(a, a, 0);
+  (void)a;
+}
+#endif
 #endif
 
 #if defined(NEON)
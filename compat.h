@@ -39,6 +39,20 @@ void* aligned_alloc(size_t alignment, size_t size);
 void aligned_free(void* ptr);
 #endif
 
+#if defined(HAVE_EXPLICIT_BZERO)
+#include <string.h>
+
+#define picnic_explicit_bzero(ptr, len) explicit_bzero((ptr), (len))
+#else
+#include <stddef.h>
+
+/**
+ * Compatibility implementation of explicit_bzero: clear memory even if it is not accessed
+ * afterwards, e.g., before it is released.
+ */
+void picnic_explicit_bzero(void* ptr, size_t len);
+#endif
+
 #include "endian_compat.h"
 
 #endif
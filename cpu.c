@@ -22,7 +22,8 @@
 
 #include "cpu.h"
 
-#if !defined(BUILTIN_CPU_SUPPORTED) || defined(BUILTIN_CPU_SUPPORTED_BROKEN_BMI2)
+#if !defined(BUILTIN_CPU_SUPPORTED) || defined(BUILTIN_CPU_SUPPORTED_BROKEN_BMI2) ||               \
+    defined(WITH_GFNI)
 #if defined(__arm__) && defined(HAVE_SYS_AUXV_H) && defined(HAVE_ASM_HWCAP_H)
 #include <asm/hwcap.h>
 #include <sys/auxv.h>
@@ -71,6 +72,9 @@ static unsigned init_caps(void) {
     if (regs.ebx & (1 << 8)) {
       caps |= CPU_CAP_BMI2;
     }
+    if (regs.ecx & (1 << 8)) {
+      caps |= CPU_CAP_GFNI;
+    }
   }
 
   return caps;
@@ -91,13 +95,16 @@ static unsigned init_caps(void) {
     }
   }
 
-  if (__get_cpuid(7, &eax, &ebx, &ecx, &edx)) {
+  if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
     if (ebx & (1 << 5)) {
       caps |= CPU_CAP_AVX2;
     }
     if (ebx & (1 << 8)) {
       caps |= CPU_CAP_BMI2;
     }
+    if (ecx & (1 << 8)) {
+      caps |= CPU_CAP_GFNI;
+    }
   }
 
   return caps;
@@ -22,7 +22,8 @@
 #define BUILTIN_CPU_SUPPORTED_BROKEN_BMI2
 #endif
 
-#if !defined(BUILTIN_CPU_SUPPORTED) || defined(BUILTIN_CPU_SUPPORTED_BROKEN_BMI2)
+#if !defined(BUILTIN_CPU_SUPPORTED) || defined(BUILTIN_CPU_SUPPORTED_BROKEN_BMI2) ||               \
+    defined(WITH_GFNI)
 #include <stdbool.h>
 
 /* CPU supports SSE2 */
@@ -35,6 +36,8 @@
 #define CPU_CAP_BMI2 0x00000010
 /* CPU supports NEON */
 #define CPU_CAP_NEON 0x00000008
+/* CPU supports GFNI */
+#define CPU_CAP_GFNI 0x00000020
 
 /**
  * Helper function in case __builtin_cpu_supports is not available.
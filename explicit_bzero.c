@@ -0,0 +1,32 @@
+/*
+ *  This file is part of the optimized implementation of the Picnic signature scheme.
+ *  See the accompanying documentation for complete details.
+ *
+ *  The code is provided under the MIT license, see LICENSE for
+ *  more details.
+ *  SPDX-License-Identifier: MIT
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "compat.h"
+#if !defined(HAVE_EXPLICIT_BZERO)
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <string.h>
+
+/* the compiler cannot assume that this still points to memset when it is called */
+static void* (*const volatile memset_ptr)(void*, int, size_t) = memset;
+#endif
+
+void picnic_explicit_bzero(void* ptr, size_t len) {
+#if defined(_WIN32)
+  SecureZeroMemory(ptr, len);
+#else
+  memset_ptr(ptr, 0, len);
+#endif
+}
+#endif
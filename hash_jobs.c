@@ -0,0 +1,120 @@
+/*
+ *  This file is part of the optimized implementation of the Picnic signature scheme.
+ *  See the accompanying documentation for complete details.
+ *
+ *  The code is provided under the MIT license, see LICENSE for
+ *  more details.
+ *  SPDX-License-Identifier: MIT
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "hash_jobs.h"
+#include "kdf_shake.h"
+
+#include <assert.h>
+
+/* number of queued jobs from which on padding the batch with dummy lanes pays off */
+#if defined(WITH_KECCAK_X4)
+#define HASH_QUEUE_MIN_X4 2
+#else
+/* the 4x instances are emulated with the base implementation */
+#define HASH_QUEUE_MIN_X4 4
+#endif
+
+static void hash_queue_setup(hash_queue_t* queue, size_t digest_size, size_t output_size) {
+  queue->digest_size = digest_size;
+  queue->output_size = output_size;
+  queue->has_prefix  = false;
+  queue->prefix      = 0;
+  queue->num_inputs  = 0;
+  queue->num_jobs    = 0;
+}
+
+void hash_queue_init(hash_queue_t* queue, size_t digest_size, size_t output_size) {
+  hash_queue_setup(queue, digest_size, output_size);
+}
+
+void hash_queue_init_prefix(hash_queue_t* queue, size_t digest_size, uint8_t prefix,
+                            size_t output_size) {
+  hash_queue_setup(queue, digest_size, output_size);
+  queue->has_prefix = true;
+  queue->prefix     = prefix;
+}
+
+void hash_queue_add_input(hash_queue_t* queue, size_t size) {
+  assert(queue->num_inputs < HASH_JOB_MAX_INPUTS && !queue->num_jobs);
+  queue->input_sizes[queue->num_inputs++] = size;
+}
+
+static void run_job(const hash_queue_t* queue, const hash_job_t* job) {
+  hash_context ctx;
+
+  if (queue->has_prefix) {
+    hash_init_prefix(&ctx, queue->digest_size, queue->prefix);
+  } else {
+    hash_init(&ctx, queue->digest_size);
+  }
+  for (unsigned int k = 0; k < queue->num_inputs; ++k) {
+    if (queue->input_sizes[k] == HASH_INPUT_UINT16) {
+      hash_update_uint16_le(&ctx, job->values[k]);
+    } else {
+      hash_update(&ctx, job->data[k], queue->input_sizes[k]);
+    }
+  }
+  hash_final(&ctx);
+  hash_squeeze(&ctx, job->output, queue->output_size);
+}
+
+static void run_jobs_x4(const hash_queue_t* queue) {
+  /* unused lanes repeat the first job and hence write the same output */
+  const hash_job_t* jobs[4];
+  for (unsigned int i = 0; i < 4; ++i) {
+    jobs[i] = &queue->jobs[i < queue->num_jobs ? i : 0];
+  }
+
+  hash_context_x4 ctx;
+
+  if (queue->has_prefix) {
+    hash_init_prefix_x4(&ctx, queue->digest_size, queue->prefix);
+  } else {
+    hash_init_x4(&ctx, queue->digest_size);
+  }
+  for (unsigned int k = 0; k < queue->num_inputs; ++k) {
+    if (queue->input_sizes[k] == HASH_INPUT_UINT16) {
+      const uint16_t values[4] = {jobs[0]->values[k], jobs[1]->values[k], jobs[2]->values[k],
+                                  jobs[3]->values[k]};
+      hash_update_x4_uint16s_le(&ctx, values);
+    } else {
+      const uint8_t* data[4] = {jobs[0]->data[k], jobs[1]->data[k], jobs[2]->data[k],
+                                jobs[3]->data[k]};
+      hash_update_x4(&ctx, data, queue->input_sizes[k]);
+    }
+  }
+  hash_final_x4(&ctx);
+  uint8_t* outputs[4] = {jobs[0]->output, jobs[1]->output, jobs[2]->output, jobs[3]->output};
+  hash_squeeze_x4(&ctx, outputs, queue->output_size);
+}
+
+void hash_queue_flush(hash_queue_t* queue) {
+  if (queue->num_jobs >= HASH_QUEUE_MIN_X4) {
+    run_jobs_x4(queue);
+  } else {
+    for (unsigned int i = 0; i < queue->num_jobs; ++i) {
+      run_job(queue, &queue->jobs[i]);
+    }
+  }
+  queue->num_jobs = 0;
+}
+
+hash_job_t* hash_queue_push(hash_queue_t* queue, uint8_t* output) {
+  if (queue->num_jobs == 4) {
+    hash_queue_flush(queue);
+  }
+
+  hash_job_t* job = &queue->jobs[queue->num_jobs++];
+  job->output     = output;
+  return job;
+}
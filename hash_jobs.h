@@ -0,0 +1,59 @@
+/*
+ *  This file is part of the optimized implementation of the Picnic signature scheme.
+ *  See the accompanying documentation for complete details.
+ *
+ *  The code is provided under the MIT license, see LICENSE for
+ *  more details.
+ *  SPDX-License-Identifier: MIT
+ */
+
+#ifndef HASH_JOBS_H
+#define HASH_JOBS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define HASH_JOB_MAX_INPUTS 5
+/* input size of 16 bit integers, which are hashed in little endian */
+#define HASH_INPUT_UINT16 0
+
+typedef struct {
+  uint8_t* output;
+  /* per input, data of the size given to the queue or the value of an integer input */
+  const uint8_t* data[HASH_JOB_MAX_INPUTS];
+  uint16_t values[HASH_JOB_MAX_INPUTS];
+} hash_job_t;
+
+/**
+ * Queue of independent hash jobs of the same shape, i.e., the same prefix, the same input sizes
+ * and the same output size. The jobs are run four at a time with the 4x Keccak implementation.
+ * Inputs have to stay valid and outputs must not be read until the job was run, which is at the
+ * latest when the queue is flushed. A job may write its output over one of its own inputs.
+ */
+typedef struct {
+  size_t digest_size;
+  size_t output_size;
+  bool has_prefix;
+  uint8_t prefix;
+  unsigned int num_inputs;
+  size_t input_sizes[HASH_JOB_MAX_INPUTS];
+  unsigned int num_jobs;
+  hash_job_t jobs[4];
+} hash_queue_t;
+
+void hash_queue_init(hash_queue_t* queue, size_t digest_size, size_t output_size);
+void hash_queue_init_prefix(hash_queue_t* queue, size_t digest_size, uint8_t prefix,
+                            size_t output_size);
+/* append an input of the given size (or HASH_INPUT_UINT16) to the shape of the jobs */
+void hash_queue_add_input(hash_queue_t* queue, size_t size);
+
+/**
+ * Add a job writing to output and return it, so that the caller can set its inputs. Runs the
+ * queued jobs if the queue is full.
+ */
+hash_job_t* hash_queue_push(hash_queue_t* queue, uint8_t* output);
+/* run all queued jobs */
+void hash_queue_flush(hash_queue_t* queue);
+
+#endif
@@ -0,0 +1,58 @@
+/*
+ *  This file is part of the optimized implementation of the Picnic signature scheme.
+ *  See the accompanying documentation for complete details.
+ *
+ *  The code is provided under the MIT license, see LICENSE for
+ *  more details.
+ *  SPDX-License-Identifier: MIT
+ */
+
+#ifndef PICNIC_LOCK_H
+#define PICNIC_LOCK_H
+
+#if defined(HAVE_CONFIG_H)
+#include <config.h>
+#endif
+
+/* statically initializable mutual exclusion lock */
+#if defined(_WIN32)
+#include <windows.h>
+
+typedef SRWLOCK lock_t;
+#define LOCK_INITIALIZER SRWLOCK_INIT
+
+static inline void lock_acquire(lock_t* lock) {
+  AcquireSRWLockExclusive(lock);
+}
+
+static inline void lock_release(lock_t* lock) {
+  ReleaseSRWLockExclusive(lock);
+}
+#elif defined(HAVE_PTHREAD)
+#include <pthread.h>
+
+typedef pthread_mutex_t lock_t;
+#define LOCK_INITIALIZER PTHREAD_MUTEX_INITIALIZER
+
+static inline void lock_acquire(lock_t* lock) {
+  pthread_mutex_lock(lock);
+}
+
+static inline void lock_release(lock_t* lock) {
+  pthread_mutex_unlock(lock);
+}
+#else
+/* no thread support: callers have to serialize the use of the library themselves */
+typedef int lock_t;
+#define LOCK_INITIALIZER 0
+
+static inline void lock_acquire(lock_t* lock) {
+  (void)lock;
+}
+
+static inline void lock_release(lock_t* lock) {
+  (void)lock;
+}
+#endif
+
+#endif
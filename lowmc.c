@@ -28,6 +28,10 @@
 #endif
 #include <string.h>
 #include <assert.h>
+#if defined(HAVE_MADVISE)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 
 #if defined(WITH_LOWMC_128_128_20)
 #include "lowmc_128_128_20.h"
@@ -47,6 +51,9 @@
 #if defined(WITH_LOWMC_255_255_4)
 #include "lowmc_255_255_4.h"
 #endif
+#if defined(WITH_GFNI)
+#include "lowmc_gfni.h"
+#endif
 
 #if defined(WITH_LOWMC_128_128_20) || defined(WITH_LOWMC_192_192_30) || defined(WITH_LOWMC_256_256_38)
 /* S-box for m = 10 */
@@ -414,6 +421,14 @@ static void sbox_aux_uint64_lowmc_255_255_4(mzd_local_t* statein, mzd_local_t* s
 #endif /* !NO_UINT64_FALLBACK */
 #endif /* WITH_KKW */
 
+/* evaluate four instances using a function for single vectors */
+#define LOWMC_X4(function, result, first, second)                                                  \
+  do {                                                                                             \
+    for (unsigned int rep = 0; rep < 4; ++rep) {                                                   \
+      function((result)[rep], (first)[rep], (second));                                             \
+    }                                                                                              \
+  } while (0)
+
 #if !defined(NO_UINT64_FALLBACK)
 // uint64 based implementation
 #define IMPL uint64
@@ -695,8 +710,96 @@ static void sbox_aux_s256_lowmc_255_255_4(mzd_local_t* statein, mzd_local_t* sta
 
 #include "lowmc_256_256_38_fns_s256.h"
 #include "lowmc.c.i"
+
+#if defined(WITH_GFNI)
+#undef FN_ATTR
+#define FN_ATTR ATTR_TARGET_GFNI
+#undef IMPL
+#define IMPL gfni
+
+/* GFNI only replaces the matrix multiplications, the S-box layers are shared with AVX2 */
+#define sbox_gfni_lowmc_129_129_4_gfni sbox_s256_lowmc_129_129_4
+#define sbox_gfni_lowmc_192_192_4_gfni sbox_s256_lowmc_192_192_4
+#define sbox_gfni_lowmc_255_255_4_gfni sbox_s256_lowmc_255_255_4
+#define sbox_aux_gfni_lowmc_129_129_4_gfni sbox_aux_s256_lowmc_129_129_4
+#define sbox_aux_gfni_lowmc_192_192_4_gfni sbox_aux_s256_lowmc_192_192_4
+#define sbox_aux_gfni_lowmc_255_255_4_gfni sbox_aux_s256_lowmc_255_255_4
+
+#include "lowmc_129_129_4_fns_gfni.h"
+#include "lowmc.c.i"
+
+#include "lowmc_192_192_4_fns_gfni.h"
+#include "lowmc.c.i"
+
+#include "lowmc_255_255_4_fns_gfni.h"
+#include "lowmc.c.i"
+
+#include "lowmc_128_128_20_fns_gfni.h"
+#include "lowmc.c.i"
+
+#include "lowmc_192_192_30_fns_gfni.h"
+#include "lowmc.c.i"
+
+#include "lowmc_256_256_38_fns_gfni.h"
+#include "lowmc.c.i"
+#endif
+#endif
+#endif
+
+static lowmc_backend_t selected_backend = LOWMC_BACKEND_AUTO;
+
+static bool backend_available(lowmc_backend_t backend) {
+  switch (backend) {
+#if defined(WITH_OPT)
+#if defined(WITH_AVX2)
+#if defined(WITH_GFNI)
+  case LOWMC_BACKEND_GFNI:
+    return CPU_SUPPORTS_GFNI;
+#endif
+  case LOWMC_BACKEND_S256:
+    return CPU_SUPPORTS_AVX2;
+#endif
+#if defined(WITH_SSE2) || defined(WITH_NEON)
+  case LOWMC_BACKEND_S128:
+    return CPU_SUPPORTS_SSE2 || CPU_SUPPORTS_NEON;
+#endif
 #endif
+#if !defined(NO_UINT64_FALLBACK)
+  case LOWMC_BACKEND_UINT64:
+    return true;
 #endif
+  case LOWMC_BACKEND_AUTO:
+    return true;
+  default:
+    return false;
+  }
+}
+
+bool lowmc_set_backend(lowmc_backend_t backend) {
+  if (!backend_available(backend)) {
+    return false;
+  }
+
+  selected_backend = backend;
+  return true;
+}
+
+lowmc_backend_t lowmc_get_backend(void) {
+  if (selected_backend != LOWMC_BACKEND_AUTO) {
+    return selected_backend;
+  }
+
+  if (backend_available(LOWMC_BACKEND_GFNI)) {
+    return LOWMC_BACKEND_GFNI;
+  }
+  if (backend_available(LOWMC_BACKEND_S256)) {
+    return LOWMC_BACKEND_S256;
+  }
+  if (backend_available(LOWMC_BACKEND_S128)) {
+    return LOWMC_BACKEND_S128;
+  }
+  return LOWMC_BACKEND_UINT64;
+}
 
 lowmc_implementation_f lowmc_get_implementation(const lowmc_parameters_t* lowmc) {
   assert((lowmc->m == 43 && lowmc->n == 129) || (lowmc->m == 64 && lowmc->n == 192) ||
@@ -705,8 +808,47 @@ lowmc_implementation_f lowmc_get_implementation(const lowmc_parameters_t* lowmc)
 
 #if defined(WITH_OPT)
 #if defined(WITH_AVX2)
+#if defined(WITH_GFNI)
+  /* GFNI enabled instances */
+  if (lowmc_get_backend() == LOWMC_BACKEND_GFNI) {
+#if defined(WITH_ZKBPP)
+    /* Instances with partial Sbox layer */
+    if (lowmc->m == 10) {
+      switch (lowmc->n) {
+#if defined(WITH_LOWMC_128_128_20)
+      case 128:
+        return lowmc_gfni_lowmc_128_128_20_gfni;
+#endif
+#if defined(WITH_LOWMC_192_192_30)
+      case 192:
+        return lowmc_gfni_lowmc_192_192_30_gfni;
+#endif
+#if defined(WITH_LOWMC_256_256_38)
+      case 256:
+        return lowmc_gfni_lowmc_256_256_38_gfni;
+#endif
+      }
+    }
+#endif
+
+    /* Instances with full Sbox layer */
+#if defined(WITH_LOWMC_129_129_4)
+    if (lowmc->n == 129 && lowmc->m == 43)
+      return lowmc_gfni_lowmc_129_129_4_gfni;
+#endif
+#if defined(WITH_LOWMC_192_192_4)
+    if (lowmc->n == 192 && lowmc->m == 64)
+      return lowmc_gfni_lowmc_192_192_4_gfni;
+#endif
+#if defined(WITH_LOWMC_255_255_4)
+    if (lowmc->n == 255 && lowmc->m == 85)
+      return lowmc_gfni_lowmc_255_255_4_gfni;
+#endif
+  }
+#endif
+
   /* AVX2 enabled instances */
-  if (CPU_SUPPORTS_AVX2) {
+  if (lowmc_get_backend() == LOWMC_BACKEND_S256) {
 #if defined(WITH_ZKBPP)
     /* Instances with partial Sbox layer */
     if (lowmc->m == 10) {
@@ -745,7 +887,7 @@ lowmc_implementation_f lowmc_get_implementation(const lowmc_parameters_t* lowmc)
 
 #if defined(WITH_SSE2) || defined(WITH_NEON)
   /* SSE2/NEON enabled instances */
-  if (CPU_SUPPORTS_SSE2 || CPU_SUPPORTS_NEON) {
+  if (lowmc_get_backend() != LOWMC_BACKEND_UINT64) {
 #if defined(WITH_ZKBPP)
     /* Instances with partial Sbox layer */
     if (lowmc->m == 10) {
@@ -823,6 +965,294 @@ lowmc_implementation_f lowmc_get_implementation(const lowmc_parameters_t* lowmc)
   return NULL;
 }
 
+lowmc_sbox_implementation_f lowmc_sbox_get_implementation(const lowmc_parameters_t* lowmc,
+                                                          lowmc_backend_t backend) {
+  switch (backend) {
+#if defined(WITH_OPT)
+#if defined(WITH_AVX2)
+#if defined(WITH_GFNI)
+  case LOWMC_BACKEND_GFNI:
+#if defined(WITH_LOWMC_128_128_20)
+    if (lowmc->n == 128 && lowmc->m == 10)
+      return sbox_layer_gfni_lowmc_128_128_20_gfni;
+#endif
+#if defined(WITH_LOWMC_129_129_4)
+    if (lowmc->n == 129 && lowmc->m == 43)
+      return sbox_layer_gfni_lowmc_129_129_4_gfni;
+#endif
+#if defined(WITH_LOWMC_192_192_30)
+    if (lowmc->n == 192 && lowmc->m == 10)
+      return sbox_layer_gfni_lowmc_192_192_30_gfni;
+#endif
+#if defined(WITH_LOWMC_192_192_4)
+    if (lowmc->n == 192 && lowmc->m == 64)
+      return sbox_layer_gfni_lowmc_192_192_4_gfni;
+#endif
+#if defined(WITH_LOWMC_256_256_38)
+    if (lowmc->n == 256 && lowmc->m == 10)
+      return sbox_layer_gfni_lowmc_256_256_38_gfni;
+#endif
+#if defined(WITH_LOWMC_255_255_4)
+    if (lowmc->n == 255 && lowmc->m == 85)
+      return sbox_layer_gfni_lowmc_255_255_4_gfni;
+#endif
+    break;
+#endif
+  case LOWMC_BACKEND_S256:
+#if defined(WITH_LOWMC_128_128_20)
+    if (lowmc->n == 128 && lowmc->m == 10)
+      return sbox_layer_s256_lowmc_128_128_20;
+#endif
+#if defined(WITH_LOWMC_129_129_4)
+    if (lowmc->n == 129 && lowmc->m == 43)
+      return sbox_layer_s256_lowmc_129_129_4;
+#endif
+#if defined(WITH_LOWMC_192_192_30)
+    if (lowmc->n == 192 && lowmc->m == 10)
+      return sbox_layer_s256_lowmc_192_192_30;
+#endif
+#if defined(WITH_LOWMC_192_192_4)
+    if (lowmc->n == 192 && lowmc->m == 64)
+      return sbox_layer_s256_lowmc_192_192_4;
+#endif
+#if defined(WITH_LOWMC_256_256_38)
+    if (lowmc->n == 256 && lowmc->m == 10)
+      return sbox_layer_s256_lowmc_256_256_38;
+#endif
+#if defined(WITH_LOWMC_255_255_4)
+    if (lowmc->n == 255 && lowmc->m == 85)
+      return sbox_layer_s256_lowmc_255_255_4;
+#endif
+    break;
+#endif
+#if defined(WITH_SSE2) || defined(WITH_NEON)
+  case LOWMC_BACKEND_S128:
+#if defined(WITH_LOWMC_128_128_20)
+    if (lowmc->n == 128 && lowmc->m == 10)
+      return sbox_layer_s128_lowmc_128_128_20;
+#endif
+#if defined(WITH_LOWMC_129_129_4)
+    if (lowmc->n == 129 && lowmc->m == 43)
+      return sbox_layer_s128_lowmc_129_129_4;
+#endif
+#if defined(WITH_LOWMC_192_192_30)
+    if (lowmc->n == 192 && lowmc->m == 10)
+      return sbox_layer_s128_lowmc_192_192_30;
+#endif
+#if defined(WITH_LOWMC_192_192_4)
+    if (lowmc->n == 192 && lowmc->m == 64)
+      return sbox_layer_s128_lowmc_192_192_4;
+#endif
+#if defined(WITH_LOWMC_256_256_38)
+    if (lowmc->n == 256 && lowmc->m == 10)
+      return sbox_layer_s128_lowmc_256_256_38;
+#endif
+#if defined(WITH_LOWMC_255_255_4)
+    if (lowmc->n == 255 && lowmc->m == 85)
+      return sbox_layer_s128_lowmc_255_255_4;
+#endif
+    break;
+#endif
+#endif
+#if !defined(NO_UINT64_FALLBACK)
+  case LOWMC_BACKEND_UINT64:
+#if defined(WITH_LOWMC_128_128_20)
+    if (lowmc->n == 128 && lowmc->m == 10)
+      return sbox_layer_uint64_lowmc_128_128_20;
+#endif
+#if defined(WITH_LOWMC_129_129_4)
+    if (lowmc->n == 129 && lowmc->m == 43)
+      return sbox_layer_uint64_lowmc_129_129_4;
+#endif
+#if defined(WITH_LOWMC_192_192_30)
+    if (lowmc->n == 192 && lowmc->m == 10)
+      return sbox_layer_uint64_lowmc_192_192_30;
+#endif
+#if defined(WITH_LOWMC_192_192_4)
+    if (lowmc->n == 192 && lowmc->m == 64)
+      return sbox_layer_uint64_lowmc_192_192_4;
+#endif
+#if defined(WITH_LOWMC_256_256_38)
+    if (lowmc->n == 256 && lowmc->m == 10)
+      return sbox_layer_uint64_lowmc_256_256_38;
+#endif
+#if defined(WITH_LOWMC_255_255_4)
+    if (lowmc->n == 255 && lowmc->m == 85)
+      return sbox_layer_uint64_lowmc_255_255_4;
+#endif
+    break;
+#endif
+  default:
+    break;
+  }
+
+  return NULL;
+}
+
+lowmc_batch_implementation_f lowmc_batch_get_implementation(const lowmc_parameters_t* lowmc) {
+  assert((lowmc->m == 43 && lowmc->n == 129) || (lowmc->m == 64 && lowmc->n == 192) ||
+         (lowmc->m == 85 && lowmc->n == 255) ||
+         (lowmc->m == 10 && (lowmc->n == 128 || lowmc->n == 192 || lowmc->n == 256)));
+
+#if defined(WITH_OPT)
+#if defined(WITH_AVX2)
+#if defined(WITH_GFNI)
+  /* GFNI enabled instances */
+  if (lowmc_get_backend() == LOWMC_BACKEND_GFNI) {
+#if defined(WITH_ZKBPP)
+    /* Instances with partial Sbox layer */
+    if (lowmc->m == 10) {
+      switch (lowmc->n) {
+#if defined(WITH_LOWMC_128_128_20)
+      case 128:
+        return lowmc_x4_gfni_lowmc_128_128_20_gfni;
+#endif
+#if defined(WITH_LOWMC_192_192_30)
+      case 192:
+        return lowmc_x4_gfni_lowmc_192_192_30_gfni;
+#endif
+#if defined(WITH_LOWMC_256_256_38)
+      case 256:
+        return lowmc_x4_gfni_lowmc_256_256_38_gfni;
+#endif
+      }
+    }
+#endif
+
+    /* Instances with full Sbox layer */
+#if defined(WITH_LOWMC_129_129_4)
+    if (lowmc->n == 129 && lowmc->m == 43)
+      return lowmc_x4_gfni_lowmc_129_129_4_gfni;
+#endif
+#if defined(WITH_LOWMC_192_192_4)
+    if (lowmc->n == 192 && lowmc->m == 64)
+      return lowmc_x4_gfni_lowmc_192_192_4_gfni;
+#endif
+#if defined(WITH_LOWMC_255_255_4)
+    if (lowmc->n == 255 && lowmc->m == 85)
+      return lowmc_x4_gfni_lowmc_255_255_4_gfni;
+#endif
+  }
+#endif
+
+  /* AVX2 enabled instances */
+  if (lowmc_get_backend() == LOWMC_BACKEND_S256) {
+#if defined(WITH_ZKBPP)
+    /* Instances with partial Sbox layer */
+    if (lowmc->m == 10) {
+      switch (lowmc->n) {
+#if defined(WITH_LOWMC_128_128_20)
+      case 128:
+        return lowmc_x4_s256_lowmc_128_128_20;
+#endif
+#if defined(WITH_LOWMC_192_192_30)
+      case 192:
+        return lowmc_x4_s256_lowmc_192_192_30;
+#endif
+#if defined(WITH_LOWMC_256_256_38)
+      case 256:
+        return lowmc_x4_s256_lowmc_256_256_38;
+#endif
+      }
+    }
+#endif
+
+    /* Instances with full Sbox layer */
+#if defined(WITH_LOWMC_129_129_4)
+    if (lowmc->n == 129 && lowmc->m == 43)
+      return lowmc_x4_s256_lowmc_129_129_4;
+#endif
+#if defined(WITH_LOWMC_192_192_4)
+    if (lowmc->n == 192 && lowmc->m == 64)
+      return lowmc_x4_s256_lowmc_192_192_4;
+#endif
+#if defined(WITH_LOWMC_255_255_4)
+    if (lowmc->n == 255 && lowmc->m == 85)
+      return lowmc_x4_s256_lowmc_255_255_4;
+#endif
+  }
+#endif
+
+#if defined(WITH_SSE2) || defined(WITH_NEON)
+  /* SSE2/NEON enabled instances */
+  if (lowmc_get_backend() != LOWMC_BACKEND_UINT64) {
+#if defined(WITH_ZKBPP)
+    /* Instances with partial Sbox layer */
+    if (lowmc->m == 10) {
+      switch (lowmc->n) {
+#if defined(WITH_LOWMC_128_128_20)
+      case 128:
+        return lowmc_x4_s128_lowmc_128_128_20;
+#endif
+#if defined(WITH_LOWMC_192_192_30)
+      case 192:
+        return lowmc_x4_s128_lowmc_192_192_30;
+#endif
+#if defined(WITH_LOWMC_256_256_38)
+      case 256:
+        return lowmc_x4_s128_lowmc_256_256_38;
+#endif
+      }
+    }
+#endif
+
+    /* Instances with full Sbox layer */
+#if defined(WITH_LOWMC_129_129_4)
+    if (lowmc->n == 129 && lowmc->m == 43)
+      return lowmc_x4_s128_lowmc_129_129_4;
+#endif
+#if defined(WITH_LOWMC_192_192_4)
+    if (lowmc->n == 192 && lowmc->m == 64)
+      return lowmc_x4_s128_lowmc_192_192_4;
+#endif
+#if defined(WITH_LOWMC_255_255_4)
+    if (lowmc->n == 255 && lowmc->m == 85)
+      return lowmc_x4_s128_lowmc_255_255_4;
+#endif
+  }
+#endif
+#endif
+
+#if !defined(NO_UINT64_FALLBACK)
+  /* uint64_t implementations */
+#if defined(WITH_ZKBPP)
+  /* Instances with partial Sbox layer */
+  if (lowmc->m == 10) {
+    switch (lowmc->n) {
+#if defined(WITH_LOWMC_128_128_20)
+    case 128:
+      return lowmc_x4_uint64_lowmc_128_128_20;
+#endif
+#if defined(WITH_LOWMC_192_192_30)
+    case 192:
+      return lowmc_x4_uint64_lowmc_192_192_30;
+#endif
+#if defined(WITH_LOWMC_256_256_38)
+    case 256:
+      return lowmc_x4_uint64_lowmc_256_256_38;
+#endif
+    }
+  }
+#endif
+
+  /* Instances with full Sbox layer */
+#if defined(WITH_LOWMC_129_129_4)
+  if (lowmc->n == 129 && lowmc->m == 43)
+    return lowmc_x4_uint64_lowmc_129_129_4;
+#endif
+#if defined(WITH_LOWMC_192_192_4)
+  if (lowmc->n == 192 && lowmc->m == 64)
+    return lowmc_x4_uint64_lowmc_192_192_4;
+#endif
+#if defined(WITH_LOWMC_255_255_4)
+  if (lowmc->n == 255 && lowmc->m == 85)
+    return lowmc_x4_uint64_lowmc_255_255_4;
+#endif
+#endif
+
+  return NULL;
+}
+
 #if defined(WITH_ZKBPP)
 lowmc_store_implementation_f lowmc_store_get_implementation(const lowmc_parameters_t* lowmc) {
   assert((lowmc->m == 43 && lowmc->n == 129) || (lowmc->m == 64 && lowmc->n == 192) ||
@@ -831,8 +1261,45 @@ lowmc_store_implementation_f lowmc_store_get_implementation(const lowmc_paramete
 
 #if defined(WITH_OPT)
 #if defined(WITH_AVX2)
+#if defined(WITH_GFNI)
+  /* GFNI enabled instances */
+  if (lowmc_get_backend() == LOWMC_BACKEND_GFNI) {
+    /* Instances with partial Sbox layer */
+    if (lowmc->m == 10) {
+      switch (lowmc->n) {
+#if defined(WITH_LOWMC_128_128_20)
+      case 128:
+        return lowmc_store_gfni_lowmc_128_128_20_gfni;
+#endif
+#if defined(WITH_LOWMC_192_192_30)
+      case 192:
+        return lowmc_store_gfni_lowmc_192_192_30_gfni;
+#endif
+#if defined(WITH_LOWMC_256_256_38)
+      case 256:
+        return lowmc_store_gfni_lowmc_256_256_38_gfni;
+#endif
+      }
+    }
+
+    /* Instances with full Sbox layer */
+#if defined(WITH_LOWMC_129_129_4)
+    if (lowmc->n == 129 && lowmc->m == 43)
+      return lowmc_store_gfni_lowmc_129_129_4_gfni;
+#endif
+#if defined(WITH_LOWMC_192_192_4)
+    if (lowmc->n == 192 && lowmc->m == 64)
+      return lowmc_store_gfni_lowmc_192_192_4_gfni;
+#endif
+#if defined(WITH_LOWMC_255_255_4)
+    if (lowmc->n == 255 && lowmc->m == 85)
+      return lowmc_store_gfni_lowmc_255_255_4_gfni;
+#endif
+  }
+#endif
+
   /* AVX2 enabled instances */
-  if (CPU_SUPPORTS_AVX2) {
+  if (lowmc_get_backend() == LOWMC_BACKEND_S256) {
     /* Instances with partial Sbox layer */
     if (lowmc->m == 10) {
       switch (lowmc->n) {
@@ -869,7 +1336,7 @@ lowmc_store_implementation_f lowmc_store_get_implementation(const lowmc_paramete
 
 #if defined(WITH_SSE2) || defined(WITH_NEON)
   /* SSE2/NEON enabled instances */
-  if (CPU_SUPPORTS_SSE2 || CPU_SUPPORTS_NEON) {
+  if (lowmc_get_backend() != LOWMC_BACKEND_UINT64) {
     /* Instances with partial Sbox layer */
     if (lowmc->m == 10) {
       switch (lowmc->n) {
@@ -952,7 +1419,24 @@ lowmc_compute_aux_get_implementation(const lowmc_parameters_t* lowmc) {
 
 #if defined(WITH_OPT)
 #if defined(WITH_AVX2)
-  if (CPU_SUPPORTS_AVX2) {
+#if defined(WITH_GFNI)
+  if (lowmc_get_backend() == LOWMC_BACKEND_GFNI) {
+#if defined(WITH_LOWMC_129_129_4)
+    if (lowmc->n == 129 && lowmc->m == 43)
+      return lowmc_compute_aux_gfni_lowmc_129_129_4_gfni;
+#endif
+#if defined(WITH_LOWMC_192_192_4)
+    if (lowmc->n == 192 && lowmc->m == 64)
+      return lowmc_compute_aux_gfni_lowmc_192_192_4_gfni;
+#endif
+#if defined(WITH_LOWMC_255_255_4)
+    if (lowmc->n == 255 && lowmc->m == 85)
+      return lowmc_compute_aux_gfni_lowmc_255_255_4_gfni;
+#endif
+  }
+#endif
+
+  if (lowmc_get_backend() == LOWMC_BACKEND_S256) {
 #if defined(WITH_LOWMC_129_129_4)
     if (lowmc->n == 129 && lowmc->m == 43)
       return lowmc_compute_aux_s256_lowmc_129_129_4;
@@ -968,7 +1452,7 @@ lowmc_compute_aux_get_implementation(const lowmc_parameters_t* lowmc) {
   }
 #endif
 #if defined(WITH_SSE2) || defined(WITH_NEON)
-  if (CPU_SUPPORTS_SSE2 || CPU_SUPPORTS_NEON) {
+  if (lowmc_get_backend() != LOWMC_BACKEND_UINT64) {
 #if defined(WITH_LOWMC_129_129_4)
     if (lowmc->n == 129 && lowmc->m == 43)
       return lowmc_compute_aux_s128_lowmc_129_129_4;
@@ -1003,3 +1487,142 @@ lowmc_compute_aux_get_implementation(const lowmc_parameters_t* lowmc) {
   return NULL;
 }
 #endif
+
+/* granularity used to touch the tables; reading more often than once per page is harmless */
+#define PREFAULT_STRIDE 4096
+
+static size_t prefault_table(const mzd_local_t* table, size_t blocks, bool touch) {
+  if (!table || !blocks) {
+    return 0;
+  }
+
+  const size_t size = blocks * sizeof(mzd_local_t);
+#if defined(HAVE_MADVISE)
+  const long page_size = sysconf(_SC_PAGESIZE);
+  if (page_size > 0) {
+    const uintptr_t begin = (uintptr_t)table & ~((uintptr_t)page_size - 1);
+    const uintptr_t end   = (uintptr_t)table + size;
+    /* only a hint, failure is not an error */
+    madvise((void*)begin, end - begin, MADV_WILLNEED);
+  }
+#endif
+
+  if (touch) {
+    const volatile uint8_t* ptr = (const volatile uint8_t*)table;
+    for (size_t i = 0; i < size; i += PREFAULT_STRIDE) {
+      (void)ptr[i];
+    }
+    (void)ptr[size - 1];
+  }
+  return size;
+}
+
+#if defined(WITH_LOWMC_128_128_20) || defined(WITH_LOWMC_192_192_30) ||                          \
+    defined(WITH_LOWMC_256_256_38)
+/* number of blocks of a matrix with rows rows; rows of 128 bit instances are packed in pairs */
+static size_t partial_matrix_blocks(unsigned int rows, unsigned int n) {
+  return n == 128 ? (rows + 1) / 2 : rows;
+}
+
+static size_t prefault_partial(const lowmc_partial_t* lowmc, const lowmc_parameters_t* params,
+                               bool tiled, bool touch) {
+  const unsigned int n = params->n;
+  /* the tiled matrices take one block per input byte and four output bytes */
+  const size_t linear_blocks = tiled ? n * n / 256 : partial_matrix_blocks(n, n);
+  const size_t round_blocks  = tiled ? n / 8 : partial_matrix_blocks(3 * params->m, n);
+
+  /* the 32 bit words of the non-linear part of all rounds */
+  const size_t non_linear_blocks = (params->r * 32 + 255) / 256;
+
+  size_t size = prefault_table(lowmc->k0_matrix, linear_blocks, touch);
+  size += prefault_table(lowmc->zr_matrix, linear_blocks, touch);
+  size += prefault_table(lowmc->precomputed_non_linear_part_matrix, n * non_linear_blocks, touch);
+  size += prefault_table(lowmc->precomputed_constant_linear, 1, touch);
+  size += prefault_table(lowmc->precomputed_constant_non_linear, non_linear_blocks, touch);
+  for (unsigned int i = 0; i < params->r - 1; ++i) {
+    size += prefault_table(lowmc->rounds[i].z_matrix, round_blocks, touch);
+    size += prefault_table(lowmc->rounds[i].r_matrix, round_blocks, touch);
+  }
+  return size;
+}
+#endif
+
+#if defined(WITH_LOWMC_129_129_4) || defined(WITH_LOWMC_192_192_4) ||                            \
+    defined(WITH_LOWMC_255_255_4)
+static size_t prefault_full(const lowmc_t* lowmc, const lowmc_parameters_t* params, bool tiled,
+                            bool touch) {
+  /* rows are padded to a multiple of 64; the tiled matrices take one block per input byte and four
+   * output bytes, where the first 63 bits of the 129 bit instance are skipped */
+  const size_t padded = (params->n + 63) / 64 * 64;
+  const size_t blocks =
+      tiled ? (params->n == 129 ? 17 * 24 / 4 : padded * padded / 256) : padded;
+
+  size_t size = prefault_table(lowmc->k0_matrix, blocks, touch);
+  size += prefault_table(lowmc->ki0_matrix, blocks, touch);
+  for (unsigned int i = 0; i < params->r; ++i) {
+    size += prefault_table(lowmc->rounds[i].k_matrix, blocks, touch);
+    size += prefault_table(lowmc->rounds[i].l_matrix, blocks, touch);
+    size += prefault_table(lowmc->rounds[i].li_matrix, blocks, touch);
+    size += prefault_table(lowmc->rounds[i].constant, 1, touch);
+  }
+  return size;
+}
+#endif
+
+size_t lowmc_prefault(const lowmc_parameters_t* lowmc, bool touch) {
+#if defined(WITH_GFNI)
+  if (lowmc_get_backend() == LOWMC_BACKEND_GFNI) {
+#if defined(WITH_LOWMC_128_128_20)
+    if (lowmc->n == 128 && lowmc->m == 10)
+      return prefault_partial(&lowmc_128_128_20_gfni, lowmc, true, touch);
+#endif
+#if defined(WITH_LOWMC_192_192_30)
+    if (lowmc->n == 192 && lowmc->m == 10)
+      return prefault_partial(&lowmc_192_192_30_gfni, lowmc, true, touch);
+#endif
+#if defined(WITH_LOWMC_256_256_38)
+    if (lowmc->n == 256 && lowmc->m == 10)
+      return prefault_partial(&lowmc_256_256_38_gfni, lowmc, true, touch);
+#endif
+#if defined(WITH_LOWMC_129_129_4)
+    if (lowmc->n == 129 && lowmc->m == 43)
+      return prefault_full(&lowmc_129_129_4_gfni, lowmc, true, touch);
+#endif
+#if defined(WITH_LOWMC_192_192_4)
+    if (lowmc->n == 192 && lowmc->m == 64)
+      return prefault_full(&lowmc_192_192_4_gfni, lowmc, true, touch);
+#endif
+#if defined(WITH_LOWMC_255_255_4)
+    if (lowmc->n == 255 && lowmc->m == 85)
+      return prefault_full(&lowmc_255_255_4_gfni, lowmc, true, touch);
+#endif
+    return 0;
+  }
+#endif
+
+#if defined(WITH_LOWMC_128_128_20)
+  if (lowmc->n == 128 && lowmc->m == 10)
+    return prefault_partial(&lowmc_128_128_20, lowmc, false, touch);
+#endif
+#if defined(WITH_LOWMC_192_192_30)
+  if (lowmc->n == 192 && lowmc->m == 10)
+    return prefault_partial(&lowmc_192_192_30, lowmc, false, touch);
+#endif
+#if defined(WITH_LOWMC_256_256_38)
+  if (lowmc->n == 256 && lowmc->m == 10)
+    return prefault_partial(&lowmc_256_256_38, lowmc, false, touch);
+#endif
+#if defined(WITH_LOWMC_129_129_4)
+  if (lowmc->n == 129 && lowmc->m == 43)
+    return prefault_full(&lowmc_129_129_4, lowmc, false, touch);
+#endif
+#if defined(WITH_LOWMC_192_192_4)
+  if (lowmc->n == 192 && lowmc->m == 64)
+    return prefault_full(&lowmc_192_192_4, lowmc, false, touch);
+#endif
+#if defined(WITH_LOWMC_255_255_4)
+  if (lowmc->n == 255 && lowmc->m == 85)
+    return prefault_full(&lowmc_255_255_4, lowmc, false, touch);
+#endif
+  return 0;
+}
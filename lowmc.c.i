@@ -10,13 +10,40 @@
 #if defined(LOWMC_INSTANCE)
 #define N_LOWMC CONCAT(lowmc, CONCAT(IMPL, LOWMC_INSTANCE))
 #define SBOX_FUNC CONCAT(sbox, CONCAT(IMPL, LOWMC_INSTANCE))
+#define N_LOWMC_X4 CONCAT(lowmc_x4, CONCAT(IMPL, LOWMC_INSTANCE))
+#if !defined(MUL_X4)
+#define MUL_X4(c, v, A) LOWMC_X4(MUL, c, v, A)
+#define MUL_X4_FALLBACK
+#endif
+#if !defined(ADDMUL_X4)
+#define ADDMUL_X4(c, v, A) LOWMC_X4(ADDMUL, c, v, A)
+#define ADDMUL_X4_FALLBACK
+#endif
 #if defined(LOWMC_PARTIAL)
 #define SBOX(x) sbox_layer_10_uint64(&BLOCK(x, 0)->w64[(LOWMC_N / (sizeof(word) * 8)) - 1])
 #include "lowmc_impl_partial.c.i"
+#include "lowmc_impl_partial_x4.c.i"
 #else
 #define SBOX(x) SBOX_FUNC(BLOCK(x, 0))
 #include "lowmc_impl.c.i"
+#include "lowmc_impl_x4.c.i"
+#endif
+
+#if defined(FN_ATTR)
+FN_ATTR
+#endif
+static void CONCAT(sbox_layer, CONCAT(IMPL, LOWMC_INSTANCE))(mzd_local_t* x) {
+  SBOX(x);
+}
+#if defined(MUL_X4_FALLBACK)
+#undef MUL_X4
+#undef MUL_X4_FALLBACK
+#endif
+#if defined(ADDMUL_X4_FALLBACK)
+#undef ADDMUL_X4
+#undef ADDMUL_X4_FALLBACK
 #endif
+#undef N_LOWMC_X4
 #if defined(WITH_ZKBPP)
 #undef N_LOWMC
 #define N_LOWMC CONCAT(lowmc_store, CONCAT(IMPL, LOWMC_INSTANCE))
@@ -19,13 +19,55 @@ typedef struct {
 // forward decleration to picnic3_types.h since we get some cyclic dependencies otherwise
 typedef struct randomTape_t randomTape_t;
 
+/* number of LowMC instances evaluated by a batch implementation */
+#define LOWMC_BATCH_SIZE 4
+
 typedef void (*lowmc_implementation_f)(lowmc_key_t const*, mzd_local_t const*, mzd_local_t*);
+/* evaluates LOWMC_BATCH_SIZE instances at once */
+typedef void (*lowmc_batch_implementation_f)(lowmc_key_t const* const*, mzd_local_t const* const*,
+                                             mzd_local_t* const*);
 typedef void (*lowmc_store_implementation_f)(lowmc_key_t const*, mzd_local_t const*,
                                              recorded_state_t* state);
 typedef void (*lowmc_compute_aux_implementation_f)(lowmc_key_t*, randomTape_t* tapes);
 
+/* backends of the S-box and matrix multiplication kernels */
+typedef enum {
+  LOWMC_BACKEND_UINT64,
+  LOWMC_BACKEND_S128,
+  LOWMC_BACKEND_S256,
+  /* AVX2 with the matrix multiplications using GFNI */
+  LOWMC_BACKEND_GFNI,
+  /* the fastest backend supported by the CPU */
+  LOWMC_BACKEND_AUTO,
+} lowmc_backend_t;
+
+typedef void (*lowmc_sbox_implementation_f)(mzd_local_t*);
+
+/**
+ * Select the backend returned by the *_get_implementation functions. Returns false if the backend
+ * is not compiled in or not supported by the CPU.
+ */
+bool lowmc_set_backend(lowmc_backend_t backend);
+/**
+ * The backend returned by the *_get_implementation functions; never LOWMC_BACKEND_AUTO.
+ */
+lowmc_backend_t lowmc_get_backend(void);
+
 lowmc_implementation_f lowmc_get_implementation(const lowmc_parameters_t* lowmc);
+lowmc_batch_implementation_f lowmc_batch_get_implementation(const lowmc_parameters_t* lowmc);
 lowmc_store_implementation_f lowmc_store_get_implementation(const lowmc_parameters_t* lowmc);
 lowmc_compute_aux_implementation_f lowmc_compute_aux_get_implementation(const lowmc_parameters_t* lowmc);
+/**
+ * Returns the S-box layer of the given backend, or NULL if it is not compiled in. Does not check
+ * whether the CPU supports the backend; only intended for benchmarking individual kernels.
+ */
+lowmc_sbox_implementation_f lowmc_sbox_get_implementation(const lowmc_parameters_t* lowmc,
+                                                          lowmc_backend_t backend);
+/**
+ * Advise the kernel that the constant tables of the instance will be needed soon. If touch is set,
+ * additionally read every page of the tables so that they are resident when the call returns.
+ * Returns the size of the tables in bytes.
+ */
+size_t lowmc_prefault(const lowmc_parameters_t* lowmc, bool touch);
 
 #endif
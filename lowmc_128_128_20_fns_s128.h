@@ -17,7 +17,7 @@
 
 #define MUL_MC mzd_mul_v_s128_128_640
 #define ADDMUL_R mzd_addmul_v_s128_30_128
-#define MUL_Z mzd_mul_v_parity_uint64_128_30
+#define MUL_Z mzd_mul_v_parity_s128_128_30
 #define XOR_MC mzd_xor_s128_640
 
 #if defined(WITH_LOWMC_128_128_20)
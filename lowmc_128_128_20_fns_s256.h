@@ -11,13 +11,15 @@
 
 #define ADDMUL mzd_addmul_v_s256_128
 #define MUL mzd_mul_v_s256_128
+#define ADDMUL_X4 mzd_addmul_v_s256_128_x4
+#define MUL_X4 mzd_mul_v_s256_128_x4
 #define SHUFFLE mzd_shuffle_pext_128_30
 #define XOR mzd_xor_s256_128
 #define COPY mzd_copy_s256_128
 
 #define MUL_MC mzd_mul_v_s256_128_768
 #define ADDMUL_R mzd_addmul_v_s256_30_128
-#define MUL_Z mzd_mul_v_parity_uint64_128_30
+#define MUL_Z mzd_mul_v_parity_s256_128_30
 #define XOR_MC mzd_xor_s256_768
 
 #if defined(WITH_LOWMC_128_128_20)
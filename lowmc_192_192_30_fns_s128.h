@@ -17,7 +17,7 @@
 
 #define MUL_MC mzd_mul_v_s128_192_1024
 #define ADDMUL_R mzd_addmul_v_s128_30_192
-#define MUL_Z mzd_mul_v_parity_uint64_192_30
+#define MUL_Z mzd_mul_v_parity_s128_192_30
 #define XOR_MC mzd_xor_s128_1024
 
 #if defined(WITH_LOWMC_192_192_30)
@@ -11,13 +11,15 @@
 
 #define ADDMUL mzd_addmul_v_s256_192
 #define MUL mzd_mul_v_s256_192
+#define ADDMUL_X4 mzd_addmul_v_s256_192_x4
+#define MUL_X4 mzd_mul_v_s256_192_x4
 #define SHUFFLE mzd_shuffle_pext_192_30
 #define XOR mzd_xor_s256_256
 #define COPY mzd_copy_s256_256
 
 #define MUL_MC mzd_mul_v_s256_192_1024
 #define ADDMUL_R mzd_addmul_v_s256_30_192
-#define MUL_Z mzd_mul_v_parity_uint64_192_30
+#define MUL_Z mzd_mul_v_parity_s256_192_30
 #define XOR_MC mzd_xor_s256_1024
 
 #if defined(WITH_LOWMC_192_192_30)
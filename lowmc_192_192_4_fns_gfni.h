@@ -0,0 +1,26 @@
+/*
+ *  This file is part of the optimized implementation of the Picnic signature scheme.
+ *  See the accompanying documentation for complete details.
+ *
+ *  The code is provided under the MIT license, see LICENSE for
+ *  more details.
+ *  SPDX-License-Identifier: MIT
+ */
+
+#include "lowmc_fns_undef.h"
+
+#define ADDMUL mzd_addmul_v_gfni_192
+#define MUL mzd_mul_v_gfni_192
+#define MUL_XOR mzd_mul_v_xor_gfni_192
+#define MUL_RK mzd_mul_v_rk_gfni_192
+#define ADDMUL_X4 mzd_addmul_v_gfni_192_x4
+#define MUL_X4 mzd_mul_v_gfni_192_x4
+#define XOR mzd_xor_s256_256
+#define COPY mzd_copy_s256_256
+
+#if defined(WITH_LOWMC_192_192_4)
+#define LOWMC_INSTANCE lowmc_192_192_4_gfni
+#define LOWMC_N LOWMC_192_192_4_N
+#define LOWMC_R LOWMC_192_192_4_R
+#define LOWMC_M LOWMC_192_192_4_M
+#endif
@@ -11,6 +11,8 @@
 
 #define ADDMUL mzd_addmul_v_s128_192
 #define MUL mzd_mul_v_s128_192
+#define MUL_XOR mzd_mul_v_xor_s128_192
+#define MUL_RK mzd_mul_v_rk_s128_192
 #define XOR mzd_xor_s128_256
 #define COPY mzd_copy_s128_256
 #define MPC_MUL mpc_matrix_mul_s128_192
@@ -3660,8 +3660,11 @@ static const lowmc_round_t rounds[4] = {
   },
 };
 
+static const mzd_local_t* const k_matrices[5] = {K_0, K_1, K_2, K_3, K_4};
+
 const lowmc_t lowmc_255_255_4 = {
   K_0,
   Ki_0,
   rounds,
+  k_matrices,
 };
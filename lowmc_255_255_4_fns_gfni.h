@@ -0,0 +1,26 @@
+/*
+ *  This file is part of the optimized implementation of the Picnic signature scheme.
+ *  See the accompanying documentation for complete details.
+ *
+ *  The code is provided under the MIT license, see LICENSE for
+ *  more details.
+ *  SPDX-License-Identifier: MIT
+ */
+
+#include "lowmc_fns_undef.h"
+
+#define ADDMUL mzd_addmul_v_gfni_256
+#define MUL mzd_mul_v_gfni_256
+#define MUL_XOR mzd_mul_v_xor_gfni_256
+#define MUL_RK mzd_mul_v_rk_gfni_256
+#define ADDMUL_X4 mzd_addmul_v_gfni_256_x4
+#define MUL_X4 mzd_mul_v_gfni_256_x4
+#define XOR mzd_xor_s256_256
+#define COPY mzd_copy_s256_256
+
+#if defined(WITH_LOWMC_255_255_4)
+#define LOWMC_INSTANCE lowmc_255_255_4_gfni
+#define LOWMC_N LOWMC_255_255_4_N
+#define LOWMC_R LOWMC_255_255_4_R
+#define LOWMC_M LOWMC_255_255_4_M
+#endif
@@ -11,6 +11,10 @@
 
 #define ADDMUL mzd_addmul_v_s256_256
 #define MUL mzd_mul_v_s256_256
+#define MUL_XOR mzd_mul_v_xor_s256_256
+#define MUL_RK mzd_mul_v_rk_s256_256
+#define ADDMUL_X4 mzd_addmul_v_s256_256_x4
+#define MUL_X4 mzd_mul_v_s256_256_x4
 #define XOR mzd_xor_s256_256
 #define COPY mzd_copy_s256_256
 #define MPC_MUL mpc_matrix_mul_s256_256
@@ -11,6 +11,8 @@
 
 #define ADDMUL mzd_addmul_v_uint64_256
 #define MUL mzd_mul_v_uint64_256
+#define MUL_XOR mzd_mul_v_xor_uint64_256
+#define MUL_RK mzd_mul_v_rk_uint64_256
 #define XOR mzd_xor_uint64_256
 #define COPY mzd_copy_uint64_256
 #define MPC_MUL mpc_matrix_mul_uint64_256
@@ -8,6 +8,7 @@
  */
 
 #undef ADDMUL
+#undef ADDMUL_X4
 #undef COPY
 #undef LOWMC_INSTANCE
 #undef LOWMC_N
@@ -15,6 +16,9 @@
 #undef LOWMC_M
 #undef LOWMC_PARTIAL
 #undef MUL
+#undef MUL_X4
+#undef MUL_XOR
+#undef MUL_RK
 #undef MUL_MC
 #undef ADDMUL_R
 #undef MUL_Z
@@ -0,0 +1,46 @@
+/*
+ *  This file is part of the optimized implementation of the Picnic signature scheme.
+ *  See the accompanying documentation for complete details.
+ *
+ *  The code is provided under the MIT license, see LICENSE for
+ *  more details.
+ *  SPDX-License-Identifier: MIT
+ */
+
+#ifndef LOWMC_GFNI_H
+#define LOWMC_GFNI_H
+
+#include "lowmc_pars.h"
+
+/**
+ * LowMC instances with the matrices stored as 8x8 tiles for the GFNI backend. The definitions are
+ * generated from the instances in lowmc_*.c by tools/generate_gfni_tables.c.
+ *
+ * A matrix maps a range of input bytes to a range of output bytes. The output is split into
+ * chunks of up to 32 bytes, each computed with k accumulators, where lane l of accumulator j
+ * collects output byte k * l + j of the chunk. For every chunk and input byte, the tiles of the k
+ * accumulators follow each other, one block per accumulator. The tile of lane l is the 8x8 bit
+ * matrix as expected by vgf2p8affineqb: bit i of byte 7 - t is set if input bit i of the byte
+ * contributes to output bit t.
+ */
+
+#if defined(WITH_LOWMC_128_128_20)
+extern const lowmc_partial_t lowmc_128_128_20_gfni;
+#endif
+#if defined(WITH_LOWMC_129_129_4)
+extern const lowmc_t lowmc_129_129_4_gfni;
+#endif
+#if defined(WITH_LOWMC_192_192_30)
+extern const lowmc_partial_t lowmc_192_192_30_gfni;
+#endif
+#if defined(WITH_LOWMC_192_192_4)
+extern const lowmc_t lowmc_192_192_4_gfni;
+#endif
+#if defined(WITH_LOWMC_255_255_4)
+extern const lowmc_t lowmc_255_255_4_gfni;
+#endif
+#if defined(WITH_LOWMC_256_256_38)
+extern const lowmc_partial_t lowmc_256_256_38_gfni;
+#endif
+
+#endif
@@ -16,11 +16,18 @@ static void N_LOWMC(lowmc_key_t const* lowmc_key, mzd_local_t const* p, recorded
 #else
 static void N_LOWMC(lowmc_key_t const* lowmc_key, mzd_local_t const* p, mzd_local_t* c) {
 #endif
-  mzd_local_t x[((LOWMC_N) + 255) / 256];
-  mzd_local_t y[((LOWMC_N) + 255) / 256];
+  mzd_local_t buffers[2][((LOWMC_N) + 255) / 256];
+  mzd_local_t* x = buffers[0];
+  mzd_local_t* y = buffers[1];
+  mzd_local_t round_keys[(LOWMC_R) + 1][((LOWMC_N) + 255) / 256];
 
-  COPY(x, p);
-  ADDMUL(x, lowmc_key, LOWMC_INSTANCE.k0_matrix);
+  // all round keys with the round constants folded in
+  MUL_RK(round_keys[0], lowmc_key, LOWMC_INSTANCE.k_matrices);
+  for (unsigned i = 0; i < LOWMC_R; ++i) {
+    XOR(round_keys[i + 1], round_keys[i + 1], LOWMC_INSTANCE.rounds[i].constant);
+  }
+
+  XOR(x, p, round_keys[0]);
 
   lowmc_round_t const* round = LOWMC_INSTANCE.rounds;
   for (unsigned i = 0; i < LOWMC_R; ++i, ++round) {
@@ -29,9 +36,11 @@ static void N_LOWMC(lowmc_key_t const* lowmc_key, mzd_local_t const* p, mzd_loca
 #endif
     SBOX(x);
 
-    MUL(y, x, round->l_matrix);
-    XOR(x, y, round->constant);
-    ADDMUL(x, lowmc_key, round->k_matrix);
+    MUL_XOR(y, x, round->l_matrix, round_keys[i + 1]);
+    // the output of this round is the input of the next one
+    mzd_local_t* t = x;
+    x              = y;
+    y              = t;
   }
 
 #if defined(RECORD_STATE)
@@ -0,0 +1,66 @@
+/*
+ *  This file is part of the optimized implementation of the Picnic signature scheme.
+ *  See the accompanying documentation for complete details.
+ *
+ *  The code is provided under the MIT license, see LICENSE for
+ *  more details.
+ *  SPDX-License-Identifier: MIT
+ */
+
+#if defined(FN_ATTR)
+FN_ATTR
+#endif
+static void N_LOWMC_X4(lowmc_key_t const* const* lowmc_key, mzd_local_t const* const* p,
+                       mzd_local_t* const* c) {
+  mzd_local_t x[4][((LOWMC_N) + 255) / 256];
+  mzd_local_t y[4][((LOWMC_N) + 255) / 256];
+  mzd_local_t nl_part[4][(LOWMC_R * 32 + 255) / 256];
+  mzd_local_t* xs[4]        = {x[0], x[1], x[2], x[3]};
+  mzd_local_t const* cxs[4] = {x[0], x[1], x[2], x[3]};
+  mzd_local_t* ys[4]        = {y[0], y[1], y[2], y[3]};
+
+  for (unsigned int rep = 0; rep < 4; ++rep) {
+    XOR(x[rep], p[rep], LOWMC_INSTANCE.precomputed_constant_linear);
+  }
+  ADDMUL_X4(xs, lowmc_key, LOWMC_INSTANCE.k0_matrix);
+  for (unsigned int rep = 0; rep < 4; ++rep) {
+    MUL_MC(nl_part[rep], lowmc_key[rep], LOWMC_INSTANCE.precomputed_non_linear_part_matrix);
+    XOR_MC(nl_part[rep], nl_part[rep], LOWMC_INSTANCE.precomputed_constant_non_linear);
+  }
+
+  // multiply non-linear part of state with Z0 matrix
+  lowmc_partial_round_t const* round = LOWMC_INSTANCE.rounds;
+  for (unsigned i = 0; i < LOWMC_R - 1; ++i, ++round) {
+    for (unsigned int rep = 0; rep < 4; ++rep) {
+      SBOX(x[rep]);
+
+      const word nl = CONST_BLOCK(nl_part[rep], i >> 3)->w64[(i & 0x7) >> 1];
+      BLOCK(x[rep], 0)->w64[(LOWMC_N) / (sizeof(word) * 8) - 1] ^=
+          (nl << (1 - (i & 1)) * 32) & WORD_C(0xFFFFFFFF00000000);
+
+      MUL_Z(y[rep], x[rep], round->z_matrix);
+      SHUFFLE(x[rep], round->r_mask);
+      ADDMUL_R(y[rep], x[rep], round->r_matrix);
+
+      BLOCK(x[rep], 0)->w64[(LOWMC_N) / (sizeof(word) * 8) - 1] &=
+          WORD_C(0x00000003FFFFFFFF); // clear nl part
+      XOR(x[rep], y[rep], x[rep]);
+    }
+  }
+
+  unsigned int i = (LOWMC_R - 1);
+  for (unsigned int rep = 0; rep < 4; ++rep) {
+    SBOX(x[rep]);
+
+    const word nl = CONST_BLOCK(nl_part[rep], i >> 3)->w64[(i & 0x7) >> 1];
+    BLOCK(x[rep], 0)->w64[(LOWMC_N) / (sizeof(word) * 8) - 1] ^=
+        (nl << (1 - (i & 1)) * 32) & WORD_C(0xFFFFFFFF00000000);
+  }
+  MUL_X4(ys, cxs, LOWMC_INSTANCE.zr_matrix);
+
+  for (unsigned int rep = 0; rep < 4; ++rep) {
+    COPY(c[rep], y[rep]);
+  }
+}
+
+// vim: ft=c
@@ -0,0 +1,44 @@
+/*
+ *  This file is part of the optimized implementation of the Picnic signature scheme.
+ *  See the accompanying documentation for complete details.
+ *
+ *  The code is provided under the MIT license, see LICENSE for
+ *  more details.
+ *  SPDX-License-Identifier: MIT
+ */
+
+#if defined(FN_ATTR)
+FN_ATTR
+#endif
+static void N_LOWMC_X4(lowmc_key_t const* const* lowmc_key, mzd_local_t const* const* p,
+                       mzd_local_t* const* c) {
+  mzd_local_t x[4][((LOWMC_N) + 255) / 256];
+  mzd_local_t y[4][((LOWMC_N) + 255) / 256];
+  mzd_local_t* xs[4]        = {x[0], x[1], x[2], x[3]};
+  mzd_local_t const* cxs[4] = {x[0], x[1], x[2], x[3]};
+  mzd_local_t* ys[4]        = {y[0], y[1], y[2], y[3]};
+
+  for (unsigned int rep = 0; rep < 4; ++rep) {
+    COPY(x[rep], p[rep]);
+  }
+  ADDMUL_X4(xs, lowmc_key, LOWMC_INSTANCE.k0_matrix);
+
+  lowmc_round_t const* round = LOWMC_INSTANCE.rounds;
+  for (unsigned i = 0; i < LOWMC_R; ++i, ++round) {
+    for (unsigned int rep = 0; rep < 4; ++rep) {
+      SBOX(x[rep]);
+    }
+
+    MUL_X4(ys, cxs, round->l_matrix);
+    for (unsigned int rep = 0; rep < 4; ++rep) {
+      XOR(x[rep], y[rep], round->constant);
+    }
+    ADDMUL_X4(xs, lowmc_key, round->k_matrix);
+  }
+
+  for (unsigned int rep = 0; rep < 4; ++rep) {
+    COPY(c[rep], x[rep]);
+  }
+}
+
+// vim: ft=c
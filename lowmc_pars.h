@@ -57,6 +57,7 @@ typedef struct {
   const mzd_local_t* k0_matrix; // K_0
   const mzd_local_t* ki0_matrix; // inverse of K_0
   const lowmc_round_t* rounds;
+  const mzd_local_t* const* k_matrices; // K_0 followed by the round key matrices
 } lowmc_t;
 
 /**
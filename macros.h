@@ -132,6 +132,13 @@
 #define ATTR_CONST
 #endif
 
+/* thread local storage */
+#if defined(_MSC_VER)
+#define THREAD_LOCAL __declspec(thread)
+#else
+#define THREAD_LOCAL _Thread_local
+#endif
+
 /* target attribute */
 #if defined(__GNUC__) || __has_attribute(target)
 #define ATTR_TARGET(x) __attribute__((target((x))))
@@ -147,6 +154,7 @@
 #endif
 
 #define ATTR_TARGET_AVX2 ATTR_TARGET("avx2,bmi2")
+#define ATTR_TARGET_GFNI ATTR_TARGET("avx2,bmi2,gfni")
 #define ATTR_TARGET_SSE2 ATTR_TARGET("sse2")
 
 #define FN_ATTRIBUTES_AVX2 ATTR_ARTIFICIAL ATTR_ALWAYS_INLINE ATTR_TARGET_AVX2
@@ -44,6 +44,9 @@
 #if defined(WITH_LOWMC_255_255_4)
 #include "lowmc_255_255_4.h"
 #endif
+#if defined(WITH_GFNI)
+#include "lowmc_gfni.h"
+#endif
 
 #define MPC_LOOP_CONST(function, result, first, second, sc)                                        \
   do {                                                                                             \
@@ -66,6 +69,13 @@
     }                                                                                              \
   } while (0)
 
+#define MPC_LOOP_ROUND_KEY(function, result, first, second, round_keys, i, sc)                     \
+  do {                                                                                             \
+    for (unsigned int e = 0; e < (sc); ++e) {                                                      \
+      function((result)[e], (first)[e], (second), (round_keys)[e][i]);                             \
+    }                                                                                              \
+  } while (0)
+
 #define MPC_LOOP_CONST_C_0(function, result, first, second, sc)                                    \
   function((result)[0], (first)[0], (second))
 
@@ -78,10 +88,41 @@
     }                                                                                              \
   } while (0)
 
+/* helpers for the implementations evaluating four repetitions at once */
+#define MPC_X4(function, result, first, second)                                                    \
+  do {                                                                                             \
+    for (unsigned int rep = 0; rep < 4; ++rep) {                                                   \
+      function((result)[rep], (first)[rep], (second));                                             \
+    }                                                                                              \
+  } while (0)
+
+#define MPC_LOOP_CONST_X4(function, result, first, second, sc)                                     \
+  do {                                                                                             \
+    for (unsigned int e = 0; e < (sc); ++e) {                                                      \
+      mzd_local_t* r[4]       = {(result)[0][e], (result)[1][e], (result)[2][e], (result)[3][e]};  \
+      mzd_local_t const* f[4] = {(first)[0][e], (first)[1][e], (first)[2][e], (first)[3][e]};      \
+      function(r, f, (second));                                                                    \
+    }                                                                                              \
+  } while (0)
+
+#define MPC_X4_INPUT(result, in_out_shares, sc)                                                    \
+  do {                                                                                             \
+    for (unsigned int rep = 0; rep < 4; ++rep) {                                                   \
+      for (unsigned int e = 0; e < (sc); ++e) {                                                    \
+        (result)[rep][e] = (in_out_shares)[2 * rep].s[e];                                          \
+      }                                                                                            \
+    }                                                                                              \
+  } while (0)
+
+#define MUL_MC_X4(result, first, second) MPC_X4(MUL_MC, result, first, second)
+#define MUL_Z_X4(result, first, second) MPC_X4(MUL_Z, result, first, second)
+#define ADDMUL_R_X4(result, first, second) MPC_X4(ADDMUL_R, result, first, second)
+
 #if defined(WITH_LOWMC_128_128_20) || defined(WITH_LOWMC_192_192_30) || defined(WITH_LOWMC_256_256_38)
+#if !defined(NO_UINT64_FALLBACK)
 /* MPC Sbox implementation for partical Sbox */
 static void mpc_and_uint64(uint64_t* res, uint64_t const* first, uint64_t const* second,
-                           uint64_t const* r, view_t* view, unsigned viewshift) {
+                           uint64_t const* r, view_partial_t* view, unsigned viewshift) {
   for (unsigned m = 0; m < SC_PROOF; ++m) {
     const unsigned j = (m + 1) % SC_PROOF;
     uint64_t tmp1    = second[m] ^ second[j];
@@ -92,16 +133,16 @@ static void mpc_and_uint64(uint64_t* res, uint64_t const* first, uint64_t const*
     res[m] = tmp1 = tmp1 ^ tmp2;
     if (viewshift) {
       tmp1       = tmp1 >> viewshift;
-      view->t[m] = view->t[m] ^ tmp1;
+      view->t[m] = view->t[m] ^ (uint32_t)(tmp1 >> 32);
     } else {
       // on first call (viewshift == 0), view->t[0..2] == 0
-      view->t[m] = tmp1;
+      view->t[m] = tmp1 >> 32;
     }
   }
 }
 
 static void mpc_and_verify_uint64(uint64_t* res, uint64_t const* first, uint64_t const* second,
-                                  uint64_t const* r, view_t* view, uint64_t const mask,
+                                  uint64_t const* r, view_partial_t* view, uint64_t const mask,
                                   unsigned viewshift) {
   for (unsigned m = 0; m < (SC_VERIFY - 1); ++m) {
     const unsigned j = (m + 1);
@@ -113,14 +154,14 @@ static void mpc_and_verify_uint64(uint64_t* res, uint64_t const* first, uint64_t
     res[m] = tmp1 = tmp1 ^ tmp2;
     if (viewshift || m) {
       tmp1       = tmp1 >> viewshift;
-      view->t[m] = view->t[m] ^ tmp1;
+      view->t[m] = view->t[m] ^ (uint32_t)(tmp1 >> 32);
     } else {
       // on first call (viewshift == 0), view->t[0] == 0
-      view->t[m] = tmp1;
+      view->t[m] = tmp1 >> 32;
     }
   }
 
-  const uint64_t rsc = view->t[SC_VERIFY - 1] << viewshift;
+  const uint64_t rsc = (uint64_t)view->t[SC_VERIFY - 1] << (32 + viewshift);
   res[SC_VERIFY - 1] = rsc & mask;
 }
 
@@ -136,7 +177,7 @@ static void mpc_and_verify_uint64(uint64_t* res, uint64_t const* first, uint64_t
   do {                                                                                             \
     for (unsigned int m = 0; m < (sc); ++m) {                                                      \
       const uint64_t inm   = in[m];                                                                \
-      const uint64_t rvecm = rvec[m];                                                              \
+      const uint64_t rvecm = (uint64_t)rvec->t[m] << 32;                                           \
                                                                                                    \
       x0s[m] = (inm & MASK_X0I) << 2;                                                              \
       x1s[m] = (inm & MASK_X1I) << 1;                                                              \
@@ -163,7 +204,8 @@ static void mpc_and_verify_uint64(uint64_t* res, uint64_t const* first, uint64_t
     }                                                                                              \
   } while (0)
 
-static void mpc_sbox_prove_uint64_10(uint64_t* in, view_t* view, uint64_t const* rvec) {
+static void mpc_sbox_prove_uint64_10(uint64_t* in, view_partial_t* view,
+                                     const rvec_partial_t* rvec) {
   bitsliced_step_1_uint64_10(SC_PROOF);
 
   mpc_and_uint64(r0m, x0s, x1s, r2m, view, 0);
@@ -173,7 +215,8 @@ static void mpc_sbox_prove_uint64_10(uint64_t* in, view_t* view, uint64_t const*
   bitsliced_step_2_uint64_10(SC_PROOF - 1);
 }
 
-static void mpc_sbox_verify_uint64_10(uint64_t* in, view_t* view, uint64_t const* rvec) {
+static void mpc_sbox_verify_uint64_10(uint64_t* in, view_partial_t* view,
+                                      const rvec_partial_t* rvec) {
   bitsliced_step_1_uint64_10(SC_VERIFY);
 
   mpc_and_verify_uint64(r0m, x0s, x1s, r2m, view, MASK_X2I, 0);
@@ -184,6 +227,245 @@ static void mpc_sbox_verify_uint64_10(uint64_t* in, view_t* view, uint64_t const
 }
 #endif
 
+#if defined(WITH_OPT)
+#if defined(WITH_SSE2) || defined(WITH_NEON)
+/* The partial S-box layer only operates on the upper 32 bits of the last word of the state. The
+ * s128 implementation packs them for all shares into the 32 bit lanes of one vector, lane m holding
+ * share m. */
+typedef union {
+  uint32_t w32[4];
+  word128 w128;
+} packed_shares_s128_t;
+
+static const packed_shares_s128_t lane_0_s128    = {{UINT32_MAX, 0, 0, 0}};
+static const packed_shares_s128_t lane_1_x2_s128 = {{0, MASK_X2I >> 32, 0, 0}};
+
+/* lane m of the result holds lane (m + 1) % 3 of x */
+ATTR_TARGET_S128 ATTR_CONST static inline word128 mm128_rotate_shares(word128 x) {
+#if defined(WITH_SSE2)
+  return _mm_shuffle_epi32(x, _MM_SHUFFLE(3, 0, 2, 1));
+#else
+  const uint32x4_t x32 = vreinterpretq_u32_u64(x);
+  return vreinterpretq_u64_u32(vcopyq_laneq_u32(vextq_u32(x32, x32, 1), 2, x32, 0));
+#endif
+}
+
+/* upper halves of the three words in the lanes 0 to 2 */
+ATTR_TARGET_S128 ATTR_CONST static inline word128 mm128_pack_shares(word w0, word w1, word w2) {
+#if defined(WITH_SSE2)
+  const __m128 w01 = _mm_castsi128_ps(_mm_set_epi64x(w1, w0));
+  const __m128 w2z = _mm_castsi128_ps(_mm_cvtsi64_si128(w2));
+  return _mm_castps_si128(_mm_shuffle_ps(w01, w2z, _MM_SHUFFLE(2, 1, 3, 1)));
+#else
+  const uint32x4_t w01 = vreinterpretq_u32_u64(vcombine_u64(vcreate_u64(w0), vcreate_u64(w1)));
+  const uint32x4_t w2z = vreinterpretq_u32_u64(vcombine_u64(vcreate_u64(w2), vcreate_u64(0)));
+  return vreinterpretq_u64_u32(vuzp2q_u32(w01, w2z));
+#endif
+}
+
+/* words of a view or random tape in the lanes 0 to 2 */
+ATTR_TARGET_S128 static inline word128 mm128_load_view(const view_partial_t* view) {
+#if defined(WITH_SSE2)
+  return _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i*)view->t),
+                            _mm_cvtsi32_si128(view->t[2]));
+#else
+  return vreinterpretq_u64_u32(
+      vld1q_lane_u32(&view->t[2], vcombine_u32(vld1_u32(view->t), vdup_n_u32(0)), 2));
+#endif
+}
+
+/* store lane m in the m-th word of the view */
+ATTR_TARGET_S128 static inline void mm128_store_view(view_partial_t* view, word128 t) {
+#if defined(WITH_SSE2)
+  _mm_storel_epi64((__m128i*)view->t, t);
+  view->t[2] = _mm_cvtsi128_si32(_mm_unpackhi_epi64(t, t));
+#else
+  const uint32x4_t t32 = vreinterpretq_u32_u64(t);
+  vst1_u32(view->t, vget_low_u32(t32));
+  vst1q_lane_u32(&view->t[2], t32, 2);
+#endif
+}
+
+ATTR_TARGET_S128 ATTR_CONST static inline uint32_t mm128_lane_0(word128 t) {
+#if defined(WITH_SSE2)
+  return _mm_cvtsi128_si32(t);
+#else
+  return vgetq_lane_u32(vreinterpretq_u32_u64(t), 0);
+#endif
+}
+
+ATTR_TARGET_S128 ATTR_CONST static inline word128 mpc_and_s128(word128 first, word128 second,
+                                                               word128 r) {
+  const word128 first_j  = mm128_rotate_shares(first);
+  const word128 second_j = mm128_rotate_shares(second);
+
+  word128 res = mm128_and(mm128_xor(second, second_j), first);
+  res         = mm128_xor(res, mm128_and(first_j, second));
+  return mm128_xor(res, mm128_xor(r, mm128_rotate_shares(r)));
+}
+
+/* lane 1 is the share of the view, shifted by the position of the AND gate */
+ATTR_TARGET_S128 ATTR_CONST static inline word128
+mpc_and_verify_s128(word128 first, word128 second, word128 r, word128 shifted_view) {
+  const word128 res = mpc_and_s128(first, second, r);
+  return mm128_xor(mm128_and(res, lane_0_s128.w128),
+                   mm128_and(shifted_view, lane_1_x2_s128.w128));
+}
+
+#define bitsliced_step_1_s128_10                                                                   \
+  const word128 mask_x0 = mm128_broadcast_u32(MASK_X0I >> 32);                                     \
+  const word128 mask_x1 = mm128_broadcast_u32(MASK_X1I >> 32);                                     \
+  const word128 mask_x2 = mm128_broadcast_u32(MASK_X2I >> 32);                                     \
+  const word128 rvecm   = mm128_load_view(rvec);                                                   \
+                                                                                                   \
+  const word128 x0s = mm128_sl_u32(mm128_and(in, mask_x0), 2);                                     \
+  const word128 x1s = mm128_sl_u32(mm128_and(in, mask_x1), 1);                                     \
+  const word128 x2m = mm128_and(in, mask_x2);                                                      \
+                                                                                                   \
+  const word128 r0s = mm128_sl_u32(mm128_and(rvecm, mask_x0), 2);                                  \
+  const word128 r1s = mm128_sl_u32(mm128_and(rvecm, mask_x1), 1);                                  \
+  const word128 r2m = mm128_and(rvecm, mask_x2)
+
+#define bitsliced_step_2_s128_10(t0, t1, t2)                                                       \
+  do {                                                                                             \
+    const word128 tmp1 = mm128_xor(t1, x0s);                                                       \
+    const word128 tmp2 = mm128_xor(x0s, x1s);                                                      \
+    const word128 tmp3 = mm128_xor(tmp2, t2);                                                      \
+    const word128 tmp4 = mm128_xor(mm128_xor(tmp2, t0), x2m);                                      \
+                                                                                                   \
+    in = mm128_xor(mm128_and(in, mm128_broadcast_u32(MASK_MASK >> 32)), tmp4);                     \
+    in = mm128_xor(in, mm128_xor(mm128_sr_u32(tmp1, 2), mm128_sr_u32(tmp3, 1)));                   \
+  } while (0)
+
+ATTR_TARGET_S128 static inline word128 mpc_sbox_prove_s128_10(word128 in, view_partial_t* view,
+                                                              const rvec_partial_t* rvec) {
+  bitsliced_step_1_s128_10;
+
+  const word128 t0 = mpc_and_s128(x0s, x1s, r2m);
+  const word128 t1 = mpc_and_s128(x1s, x2m, r1s);
+  const word128 t2 = mpc_and_s128(x0s, x2m, r0s);
+  mm128_store_view(view, mm128_xor(t0, mm128_xor(mm128_sr_u32(t1, 1), mm128_sr_u32(t2, 2))));
+
+  bitsliced_step_2_s128_10(t0, t1, t2);
+  return in;
+}
+
+ATTR_TARGET_S128 static inline word128 mpc_sbox_verify_s128_10(word128 in, view_partial_t* view,
+                                                               const rvec_partial_t* rvec) {
+  bitsliced_step_1_s128_10;
+
+  const word128 vt = mm128_load_view(view);
+  const word128 t0 = mpc_and_verify_s128(x0s, x1s, r2m, vt);
+  const word128 t1 = mpc_and_verify_s128(x1s, x2m, r1s, mm128_sl_u32(vt, 1));
+  const word128 t2 = mpc_and_verify_s128(x0s, x2m, r0s, mm128_sl_u32(vt, 2));
+  view->t[0] = mm128_lane_0(mm128_xor(t0, mm128_xor(mm128_sr_u32(t1, 1), mm128_sr_u32(t2, 2))));
+
+  bitsliced_step_2_s128_10(t0, t1, t2);
+  return in;
+}
+
+#undef bitsliced_step_1_s128_10
+#undef bitsliced_step_2_s128_10
+#endif
+
+#if defined(WITH_AVX2)
+/* The s256 implementation packs the last word of all shares into one vector, lane m holding share
+ * m. */
+
+/* lane m of the result holds lane (m + 1) % 3 of x */
+ATTR_TARGET_AVX2 ATTR_CONST static inline word256 mm256_rotate_shares(word256 x) {
+  return _mm256_permute4x64_epi64(x, _MM_SHUFFLE(3, 0, 2, 1));
+}
+
+ATTR_TARGET_AVX2 ATTR_CONST static inline word256 mpc_and_s256(word256 first, word256 second,
+                                                               word256 r) {
+  const word256 first_j  = mm256_rotate_shares(first);
+  const word256 second_j = mm256_rotate_shares(second);
+
+  word256 res = mm256_and(mm256_xor(second, second_j), first);
+  res         = mm256_xor(res, mm256_and(first_j, second));
+  return mm256_xor(res, mm256_xor(r, mm256_rotate_shares(r)));
+}
+
+/* view or random tape with word m in the upper half of lane m */
+ATTR_TARGET_AVX2 static inline word256 mm256_load_view(const view_partial_t* view) {
+  const word128 t = _mm_maskload_epi32((const int*)view->t, _mm_setr_epi32(-1, -1, -1, 0));
+  return _mm256_slli_epi64(_mm256_cvtepu32_epi64(t), 32);
+}
+
+/* lane 1 is the share of the view, shifted by the position of the AND gate */
+ATTR_TARGET_AVX2 ATTR_CONST static inline word256
+mpc_and_verify_s256(word256 first, word256 second, word256 r, word256 shifted_view) {
+  const word256 res = mpc_and_s256(first, second, r);
+  return _mm256_blend_epi32(
+      res, mm256_and(shifted_view, _mm256_set1_epi64x(MASK_X2I)), _MM_SHUFFLE(0, 0, 3, 0));
+}
+
+#define bitsliced_step_1_s256_10                                                                   \
+  const word256 mask_x0 = _mm256_set1_epi64x(MASK_X0I);                                            \
+  const word256 mask_x1 = _mm256_set1_epi64x(MASK_X1I);                                            \
+  const word256 mask_x2 = _mm256_set1_epi64x(MASK_X2I);                                            \
+  const word256 rvecm   = mm256_load_view(rvec);                                                   \
+                                                                                                   \
+  const word256 x0s = _mm256_slli_epi64(mm256_and(in, mask_x0), 2);                                \
+  const word256 x1s = _mm256_slli_epi64(mm256_and(in, mask_x1), 1);                                \
+  const word256 x2m = mm256_and(in, mask_x2);                                                      \
+                                                                                                   \
+  const word256 r0s = _mm256_slli_epi64(mm256_and(rvecm, mask_x0), 2);                             \
+  const word256 r1s = _mm256_slli_epi64(mm256_and(rvecm, mask_x1), 1);                             \
+  const word256 r2m = mm256_and(rvecm, mask_x2)
+
+#define bitsliced_step_2_s256_10(t0, t1, t2)                                                       \
+  do {                                                                                             \
+    const word256 tmp1 = mm256_xor(t1, x0s);                                                       \
+    const word256 tmp2 = mm256_xor(x0s, x1s);                                                      \
+    const word256 tmp3 = mm256_xor(tmp2, t2);                                                      \
+    const word256 tmp4 = mm256_xor(mm256_xor(tmp2, t0), x2m);                                      \
+                                                                                                   \
+    in = mm256_xor(mm256_and(in, _mm256_set1_epi64x(MASK_MASK)), tmp4);                            \
+    in = mm256_xor(in, mm256_xor(_mm256_srli_epi64(tmp1, 2), _mm256_srli_epi64(tmp3, 1)));         \
+  } while (0)
+
+ATTR_TARGET_AVX2 static inline word256 mpc_sbox_prove_s256_10(word256 in, view_partial_t* view,
+                                                              const rvec_partial_t* rvec) {
+  bitsliced_step_1_s256_10;
+
+  const word256 t0 = mpc_and_s256(x0s, x1s, r2m);
+  const word256 t1 = mpc_and_s256(x1s, x2m, r1s);
+  const word256 t2 = mpc_and_s256(x0s, x2m, r0s);
+  const word256 t =
+      mm256_xor(t0, mm256_xor(_mm256_srli_epi64(t1, 1), _mm256_srli_epi64(t2, 2)));
+  /* gather the upper halves of the lanes 0 to 2 */
+  const word256 upper = _mm256_permutevar8x32_epi32(t, _mm256_setr_epi32(1, 3, 5, 7, 0, 2, 4, 6));
+  _mm_maskstore_epi32((int*)view->t, _mm_setr_epi32(-1, -1, -1, 0), _mm256_castsi256_si128(upper));
+
+  bitsliced_step_2_s256_10(t0, t1, t2);
+  return in;
+}
+
+ATTR_TARGET_AVX2 static inline word256 mpc_sbox_verify_s256_10(word256 in, view_partial_t* view,
+                                                               const rvec_partial_t* rvec) {
+  bitsliced_step_1_s256_10;
+
+  const word256 vt = mm256_load_view(view);
+  const word256 t0 = mpc_and_verify_s256(x0s, x1s, r2m, vt);
+  const word256 t1 = mpc_and_verify_s256(x1s, x2m, r1s, _mm256_slli_epi64(vt, 1));
+  const word256 t2 = mpc_and_verify_s256(x0s, x2m, r0s, _mm256_slli_epi64(vt, 2));
+  const word256 t =
+      mm256_xor(t0, mm256_xor(_mm256_srli_epi64(t1, 1), _mm256_srli_epi64(t2, 2)));
+  /* only the first share of the view is computed */
+  view->t[0] = _mm256_extract_epi32(t, 1);
+
+  bitsliced_step_2_s256_10(t0, t1, t2);
+  return in;
+}
+
+#undef bitsliced_step_1_s256_10
+#undef bitsliced_step_2_s256_10
+#endif
+#endif
+#endif
+
 /* MPC Sbox implementation for full instances */
 #if !defined(NO_UINT64_FALLBACK)
 #if defined(WITH_LOWMC_129_129_4) || defined(WITH_LOWMC_192_192_4)
@@ -859,7 +1141,7 @@ static void mpc_sbox_verify_s256_lowmc_255_255_4(mzd_local_t* out, const mzd_loc
     for (unsigned int count = 0; count < shares; ++count) {                                        \
       in[count] = CONST_BLOCK(x[count], 0)->w64[(n) / (sizeof(word) * 8) - 1];                     \
     }                                                                                              \
-    sbox(in, views, rvec->t);                                                                      \
+    sbox(in, views, rvec);                                                                         \
     for (unsigned int count = 0; count < shares2; ++count) {                                       \
       memcpy(BLOCK(y[count], 0)->w64, CONST_BLOCK(x[count], 0)->w64,                               \
              ((n) / (sizeof(word) * 8) - 1) * sizeof(word));                                       \
@@ -867,6 +1149,92 @@ static void mpc_sbox_verify_s256_lowmc_255_255_4(mzd_local_t* out, const mzd_loc
     }                                                                                              \
   } while (0)
 
+/* S-box layer of the partial instances followed by the injection of the non-linear part of round
+ * i */
+#define SBOX_NL_uint64(sbox, y, x, views, rvec, nl, i, n, shares, shares2)                         \
+  do {                                                                                             \
+    SBOX_uint64(sbox, y, x, views, rvec, n, shares, shares2);                                      \
+    for (unsigned int k = 0; k < (shares2); ++k) {                                                 \
+      const word nlk = CONST_BLOCK((nl)[k], (i) >> 3)->w64[((i)&0x7) >> 1];                        \
+      BLOCK(y[k], 0)->w64[(n) / (sizeof(word) * 8) - 1] ^=                                         \
+          ((i)&1) ? (nlk & WORD_C(0xFFFFFFFF00000000)) : (nlk << 32);                              \
+    }                                                                                              \
+  } while (0)
+
+#if defined(WITH_OPT)
+/* last word of the state of share k; the partial S-box layer handles at most three shares */
+#define LAST_WORD(x, k, n, shares)                                                                 \
+  ((k) < (shares) ? CONST_BLOCK(x[k], 0)->w64[(n) / (sizeof(word) * 8) - 1] : 0)
+#define NL_WORD(nl, k, i, shares)                                                                  \
+  ((k) < (shares) ? CONST_BLOCK((nl)[k], (i) >> 3)->w64[((i)&0x7) >> 1] : 0)
+
+#if defined(WITH_SSE2) || defined(WITH_NEON)
+/* the shares are packed in registers to avoid store forwarding stalls; nl is XORed to the packed
+ * output of the S-box layer */
+#define SBOX_PACKED_s128(sbox, y, x, views, rvec, n, shares, shares2, nl)                          \
+  do {                                                                                             \
+    const word128 packed =                                                                         \
+        mm128_pack_shares(LAST_WORD(x, 0, n, shares), LAST_WORD(x, 1, n, shares),                  \
+                          LAST_WORD(x, 2, n, shares));                                             \
+    packed_shares_s128_t out;                                                                      \
+    out.w128 = mm128_xor(sbox(packed, views, rvec), (nl));                                         \
+    for (unsigned int count = 0; count < (shares2); ++count) {                                     \
+      const word last = CONST_BLOCK(x[count], 0)->w64[(n) / (sizeof(word) * 8) - 1];               \
+      memcpy(BLOCK(y[count], 0)->w64, CONST_BLOCK(x[count], 0)->w64,                               \
+             ((n) / (sizeof(word) * 8) - 1) * sizeof(word));                                       \
+      BLOCK(y[count], 0)->w64[(n) / (sizeof(word) * 8) - 1] =                                      \
+          (last & WORD_C(0xFFFFFFFF)) | ((word)out.w32[count] << 32);                              \
+    }                                                                                              \
+  } while (0)
+
+#define SBOX_s128(sbox, y, x, views, rvec, n, shares, shares2)                                     \
+  SBOX_PACKED_s128(sbox, y, x, views, rvec, n, shares, shares2, mm128_zero)
+
+#define SBOX_NL_s128(sbox, y, x, views, rvec, nl, i, n, shares, shares2)                           \
+  do {                                                                                             \
+    const word128 nl_lanes =                                                                       \
+        ((i)&1) ? mm128_pack_shares(NL_WORD(nl, 0, i, shares2), NL_WORD(nl, 1, i, shares2),        \
+                                    NL_WORD(nl, 2, i, shares2))                                    \
+                : mm128_pack_shares(NL_WORD(nl, 0, i, shares2) << 32,                              \
+                                    NL_WORD(nl, 1, i, shares2) << 32,                              \
+                                    NL_WORD(nl, 2, i, shares2) << 32);                             \
+    SBOX_PACKED_s128(sbox, y, x, views, rvec, n, shares, shares2, nl_lanes);                       \
+  } while (0)
+#endif
+
+#if defined(WITH_AVX2)
+/* the shares are packed in registers to avoid store forwarding stalls; nl is XORed to the packed
+ * output of the S-box layer */
+#define SBOX_PACKED_s256(sbox, y, x, views, rvec, n, shares, shares2, nl)                          \
+  do {                                                                                             \
+    const word256 packed = _mm256_set_epi64x(0, LAST_WORD(x, 2, n, shares),                        \
+                                             LAST_WORD(x, 1, n, shares),                           \
+                                             LAST_WORD(x, 0, n, shares));                          \
+    block_t out;                                                                                   \
+    out.w256 = mm256_xor(sbox(packed, views, rvec), (nl));                                         \
+    for (unsigned int count = 0; count < (shares2); ++count) {                                     \
+      memcpy(BLOCK(y[count], 0)->w64, CONST_BLOCK(x[count], 0)->w64,                               \
+             ((n) / (sizeof(word) * 8) - 1) * sizeof(word));                                       \
+      BLOCK(y[count], 0)->w64[(n) / (sizeof(word) * 8) - 1] = out.w64[count];                      \
+    }                                                                                              \
+  } while (0)
+
+#define SBOX_s256(sbox, y, x, views, rvec, n, shares, shares2)                                     \
+  SBOX_PACKED_s256(sbox, y, x, views, rvec, n, shares, shares2, mm256_zero)
+
+#define SBOX_NL_s256(sbox, y, x, views, rvec, nl, i, n, shares, shares2)                           \
+  do {                                                                                             \
+    const word256 nl_words =                                                                       \
+        _mm256_set_epi64x(0, NL_WORD(nl, 2, i, shares2), NL_WORD(nl, 1, i, shares2),               \
+                          NL_WORD(nl, 0, i, shares2));                                             \
+    const word256 nl_lanes =                                                                       \
+        ((i)&1) ? mm256_and(nl_words, _mm256_set1_epi64x(WORD_C(0xFFFFFFFF00000000)))             \
+                : _mm256_slli_epi64(nl_words, 32);                                                 \
+    SBOX_PACKED_s256(sbox, y, x, views, rvec, n, shares, shares2, nl_lanes);                       \
+  } while (0)
+#endif
+#endif
+
 #if !defined(NO_UINT64_FALLBACK)
 #define IMPL uint64
 
@@ -947,6 +1315,47 @@ static void mpc_sbox_verify_s256_lowmc_255_255_4(mzd_local_t* out, const mzd_loc
 #include "mpc_lowmc.c.i"
 
 #undef FN_ATTR
+
+#if defined(WITH_GFNI)
+#define FN_ATTR ATTR_TARGET_GFNI
+#undef IMPL
+#define IMPL gfni
+
+/* GFNI only replaces the matrix multiplications, the S-box layers are shared with AVX2 */
+#define SBOX_gfni SBOX_s256
+#define SBOX_NL_gfni SBOX_NL_s256
+#define mpc_sbox_prove_gfni_10 mpc_sbox_prove_s256_10
+#define mpc_sbox_verify_gfni_10 mpc_sbox_verify_s256_10
+#define mpc_sbox_prove_gfni_lowmc_129_129_4_gfni mpc_sbox_prove_s256_lowmc_129_129_4
+#define mpc_sbox_verify_gfni_lowmc_129_129_4_gfni mpc_sbox_verify_s256_lowmc_129_129_4
+#define mpc_sbox_prove_gfni_lowmc_192_192_4_gfni mpc_sbox_prove_s256_lowmc_192_192_4
+#define mpc_sbox_verify_gfni_lowmc_192_192_4_gfni mpc_sbox_verify_s256_lowmc_192_192_4
+#define mpc_sbox_prove_gfni_lowmc_255_255_4_gfni mpc_sbox_prove_s256_lowmc_255_255_4
+#define mpc_sbox_verify_gfni_lowmc_255_255_4_gfni mpc_sbox_verify_s256_lowmc_255_255_4
+
+// L1 using GFNI
+#include "lowmc_128_128_20_fns_gfni.h"
+#include "mpc_lowmc.c.i"
+
+#include "lowmc_129_129_4_fns_gfni.h"
+#include "mpc_lowmc.c.i"
+
+// L3 using GFNI
+#include "lowmc_192_192_30_fns_gfni.h"
+#include "mpc_lowmc.c.i"
+
+#include "lowmc_192_192_4_fns_gfni.h"
+#include "mpc_lowmc.c.i"
+
+// L5 using GFNI
+#include "lowmc_256_256_38_fns_gfni.h"
+#include "mpc_lowmc.c.i"
+
+#include "lowmc_255_255_4_fns_gfni.h"
+#include "mpc_lowmc.c.i"
+
+#undef FN_ATTR
+#endif
 #endif
 #endif
 
@@ -957,7 +1366,44 @@ zkbpp_lowmc_implementation_f get_zkbpp_lowmc_implementation(const lowmc_paramete
 
 #if defined(WITH_OPT)
 #if defined(WITH_AVX2)
-  if (CPU_SUPPORTS_AVX2) {
+#if defined(WITH_GFNI)
+  if (lowmc_get_backend() == LOWMC_BACKEND_GFNI) {
+    if (lowmc->m == 10) {
+      switch (lowmc->n) {
+#if defined(WITH_LOWMC_128_128_20)
+      case 128:
+        return mpc_lowmc_prove_gfni_lowmc_128_128_20_gfni;
+#endif
+#if defined(WITH_LOWMC_192_192_30)
+      case 192:
+        return mpc_lowmc_prove_gfni_lowmc_192_192_30_gfni;
+#endif
+#if defined(WITH_LOWMC_256_256_38)
+      case 256:
+        return mpc_lowmc_prove_gfni_lowmc_256_256_38_gfni;
+#endif
+      }
+    }
+
+#if defined(WITH_LOWMC_129_129_4)
+    if (lowmc->n == 129 && lowmc->m == 43) {
+      return mpc_lowmc_prove_gfni_lowmc_129_129_4_gfni;
+    }
+#endif
+#if defined(WITH_LOWMC_192_192_4)
+    if (lowmc->n == 192 && lowmc->m == 64) {
+      return mpc_lowmc_prove_gfni_lowmc_192_192_4_gfni;
+    }
+#endif
+#if defined(WITH_LOWMC_255_255_4)
+    if (lowmc->n == 255 && lowmc->m == 85) {
+      return mpc_lowmc_prove_gfni_lowmc_255_255_4_gfni;
+    }
+#endif
+  }
+#endif
+
+  if (lowmc_get_backend() == LOWMC_BACKEND_S256) {
     if (lowmc->m == 10) {
       switch (lowmc->n) {
 #if defined(WITH_LOWMC_128_128_20)
@@ -994,7 +1440,7 @@ zkbpp_lowmc_implementation_f get_zkbpp_lowmc_implementation(const lowmc_paramete
 #endif
 
 #if defined(WITH_SSE2) || defined(WITH_NEON)
-  if (CPU_SUPPORTS_SSE2 || CPU_SUPPORTS_NEON) {
+  if (lowmc_get_backend() != LOWMC_BACKEND_UINT64) {
     if (lowmc->m == 10) {
       switch (lowmc->n) {
 #if defined(WITH_LOWMC_128_128_20)
@@ -1077,7 +1523,44 @@ get_zkbpp_lowmc_verify_implementation(const lowmc_parameters_t* lowmc) {
 
 #if defined(WITH_OPT)
 #if defined(WITH_AVX2)
-  if (CPU_SUPPORTS_AVX2) {
+#if defined(WITH_GFNI)
+  if (lowmc_get_backend() == LOWMC_BACKEND_GFNI) {
+    if (lowmc->m == 10) {
+      switch (lowmc->n) {
+#if defined(WITH_LOWMC_128_128_20)
+      case 128:
+        return mpc_lowmc_verify_gfni_lowmc_128_128_20_gfni;
+#endif
+#if defined(WITH_LOWMC_192_192_30)
+      case 192:
+        return mpc_lowmc_verify_gfni_lowmc_192_192_30_gfni;
+#endif
+#if defined(WITH_LOWMC_256_256_38)
+      case 256:
+        return mpc_lowmc_verify_gfni_lowmc_256_256_38_gfni;
+#endif
+      }
+    }
+
+#if defined(WITH_LOWMC_129_129_4)
+    if (lowmc->n == 129 && lowmc->m == 43) {
+      return mpc_lowmc_verify_gfni_lowmc_129_129_4_gfni;
+    }
+#endif
+#if defined(WITH_LOWMC_192_192_4)
+    if (lowmc->n == 192 && lowmc->m == 64) {
+      return mpc_lowmc_verify_gfni_lowmc_192_192_4_gfni;
+    }
+#endif
+#if defined(WITH_LOWMC_255_255_4)
+    if (lowmc->n == 255 && lowmc->m == 85) {
+      return mpc_lowmc_verify_gfni_lowmc_255_255_4_gfni;
+    }
+#endif
+  }
+#endif
+
+  if (lowmc_get_backend() == LOWMC_BACKEND_S256) {
     if (lowmc->m == 10) {
       switch (lowmc->n) {
 #if defined(WITH_LOWMC_128_128_20)
@@ -1114,7 +1597,7 @@ get_zkbpp_lowmc_verify_implementation(const lowmc_parameters_t* lowmc) {
 #endif
 
 #if defined(WITH_SSE2) || defined(WITH_NEON)
-  if (CPU_SUPPORTS_SSE2 || CPU_SUPPORTS_NEON) {
+  if (lowmc_get_backend() != LOWMC_BACKEND_UINT64) {
     if (lowmc->m == 10) {
       switch (lowmc->n) {
 #if defined(WITH_LOWMC_128_128_20)
@@ -1189,6 +1672,319 @@ get_zkbpp_lowmc_verify_implementation(const lowmc_parameters_t* lowmc) {
   return NULL;
 }
 
+zkbpp_lowmc_implementation_f get_zkbpp_lowmc_x4_implementation(const lowmc_parameters_t* lowmc) {
+  assert((lowmc->m == 43 && lowmc->n == 129) || (lowmc->m == 64 && lowmc->n == 192) ||
+         (lowmc->m == 85 && lowmc->n == 255) ||
+         (lowmc->m == 10 && (lowmc->n == 128 || lowmc->n == 192 || lowmc->n == 256)));
+
+#if defined(WITH_OPT)
+#if defined(WITH_AVX2)
+#if defined(WITH_GFNI)
+  if (lowmc_get_backend() == LOWMC_BACKEND_GFNI) {
+    if (lowmc->m == 10) {
+      switch (lowmc->n) {
+#if defined(WITH_LOWMC_128_128_20)
+      case 128:
+        return mpc_lowmc_prove_x4_gfni_lowmc_128_128_20_gfni;
+#endif
+#if defined(WITH_LOWMC_192_192_30)
+      case 192:
+        return mpc_lowmc_prove_x4_gfni_lowmc_192_192_30_gfni;
+#endif
+#if defined(WITH_LOWMC_256_256_38)
+      case 256:
+        return mpc_lowmc_prove_x4_gfni_lowmc_256_256_38_gfni;
+#endif
+      }
+    }
+
+#if defined(WITH_LOWMC_129_129_4)
+    if (lowmc->n == 129 && lowmc->m == 43) {
+      return mpc_lowmc_prove_x4_gfni_lowmc_129_129_4_gfni;
+    }
+#endif
+#if defined(WITH_LOWMC_192_192_4)
+    if (lowmc->n == 192 && lowmc->m == 64) {
+      return mpc_lowmc_prove_x4_gfni_lowmc_192_192_4_gfni;
+    }
+#endif
+#if defined(WITH_LOWMC_255_255_4)
+    if (lowmc->n == 255 && lowmc->m == 85) {
+      return mpc_lowmc_prove_x4_gfni_lowmc_255_255_4_gfni;
+    }
+#endif
+  }
+#endif
+
+  if (lowmc_get_backend() == LOWMC_BACKEND_S256) {
+    if (lowmc->m == 10) {
+      switch (lowmc->n) {
+#if defined(WITH_LOWMC_128_128_20)
+      case 128:
+        return mpc_lowmc_prove_x4_s256_lowmc_128_128_20;
+#endif
+#if defined(WITH_LOWMC_192_192_30)
+      case 192:
+        return mpc_lowmc_prove_x4_s256_lowmc_192_192_30;
+#endif
+#if defined(WITH_LOWMC_256_256_38)
+      case 256:
+        return mpc_lowmc_prove_x4_s256_lowmc_256_256_38;
+#endif
+      }
+    }
+
+#if defined(WITH_LOWMC_129_129_4)
+    if (lowmc->n == 129 && lowmc->m == 43) {
+      return mpc_lowmc_prove_x4_s256_lowmc_129_129_4;
+    }
+#endif
+#if defined(WITH_LOWMC_192_192_4)
+    if (lowmc->n == 192 && lowmc->m == 64) {
+      return mpc_lowmc_prove_x4_s256_lowmc_192_192_4;
+    }
+#endif
+#if defined(WITH_LOWMC_255_255_4)
+    if (lowmc->n == 255 && lowmc->m == 85) {
+      return mpc_lowmc_prove_x4_s256_lowmc_255_255_4;
+    }
+#endif
+  }
+#endif
+
+#if defined(WITH_SSE2) || defined(WITH_NEON)
+  if (lowmc_get_backend() != LOWMC_BACKEND_UINT64) {
+    if (lowmc->m == 10) {
+      switch (lowmc->n) {
+#if defined(WITH_LOWMC_128_128_20)
+      case 128:
+        return mpc_lowmc_prove_x4_s128_lowmc_128_128_20;
+#endif
+#if defined(WITH_LOWMC_192_192_30)
+      case 192:
+        return mpc_lowmc_prove_x4_s128_lowmc_192_192_30;
+#endif
+#if defined(WITH_LOWMC_256_256_38)
+      case 256:
+        return mpc_lowmc_prove_x4_s128_lowmc_256_256_38;
+#endif
+      }
+    }
+
+#if defined(WITH_LOWMC_129_129_4)
+    if (lowmc->n == 129 && lowmc->m == 43) {
+      return mpc_lowmc_prove_x4_s128_lowmc_129_129_4;
+    }
+#endif
+#if defined(WITH_LOWMC_192_192_4)
+    if (lowmc->n == 192 && lowmc->m == 64) {
+      return mpc_lowmc_prove_x4_s128_lowmc_192_192_4;
+    }
+#endif
+#if defined(WITH_LOWMC_255_255_4)
+    if (lowmc->n == 255 && lowmc->m == 85) {
+      return mpc_lowmc_prove_x4_s128_lowmc_255_255_4;
+    }
+#endif
+  }
+#endif
+#endif
+
+#if !defined(NO_UINT64_FALLBACK)
+  if (lowmc->m == 10) {
+    switch (lowmc->n) {
+#if defined(WITH_LOWMC_128_128_20)
+    case 128:
+      return mpc_lowmc_prove_x4_uint64_lowmc_128_128_20;
+#endif
+#if defined(WITH_LOWMC_192_192_30)
+    case 192:
+      return mpc_lowmc_prove_x4_uint64_lowmc_192_192_30;
+#endif
+#if defined(WITH_LOWMC_256_256_38)
+    case 256:
+      return mpc_lowmc_prove_x4_uint64_lowmc_256_256_38;
+#endif
+    }
+  }
+
+#if defined(WITH_LOWMC_129_129_4)
+  if (lowmc->n == 129 && lowmc->m == 43) {
+    return mpc_lowmc_prove_x4_uint64_lowmc_129_129_4;
+  }
+#endif
+#if defined(WITH_LOWMC_192_192_4)
+  if (lowmc->n == 192 && lowmc->m == 64) {
+    return mpc_lowmc_prove_x4_uint64_lowmc_192_192_4;
+  }
+#endif
+#if defined(WITH_LOWMC_255_255_4)
+  if (lowmc->n == 255 && lowmc->m == 85) {
+    return mpc_lowmc_prove_x4_uint64_lowmc_255_255_4;
+  }
+#endif
+#endif
+
+  return NULL;
+}
+
+zkbpp_lowmc_verify_implementation_f
+get_zkbpp_lowmc_verify_x4_implementation(const lowmc_parameters_t* lowmc) {
+  assert((lowmc->m == 43 && lowmc->n == 129) || (lowmc->m == 64 && lowmc->n == 192) ||
+         (lowmc->m == 85 && lowmc->n == 255) ||
+         (lowmc->m == 10 && (lowmc->n == 128 || lowmc->n == 192 || lowmc->n == 256)));
+
+#if defined(WITH_OPT)
+#if defined(WITH_AVX2)
+#if defined(WITH_GFNI)
+  if (lowmc_get_backend() == LOWMC_BACKEND_GFNI) {
+    if (lowmc->m == 10) {
+      switch (lowmc->n) {
+#if defined(WITH_LOWMC_128_128_20)
+      case 128:
+        return mpc_lowmc_verify_x4_gfni_lowmc_128_128_20_gfni;
+#endif
+#if defined(WITH_LOWMC_192_192_30)
+      case 192:
+        return mpc_lowmc_verify_x4_gfni_lowmc_192_192_30_gfni;
+#endif
+#if defined(WITH_LOWMC_256_256_38)
+      case 256:
+        return mpc_lowmc_verify_x4_gfni_lowmc_256_256_38_gfni;
+#endif
+      }
+    }
+
+#if defined(WITH_LOWMC_129_129_4)
+    if (lowmc->n == 129 && lowmc->m == 43) {
+      return mpc_lowmc_verify_x4_gfni_lowmc_129_129_4_gfni;
+    }
+#endif
+#if defined(WITH_LOWMC_192_192_4)
+    if (lowmc->n == 192 && lowmc->m == 64) {
+      return mpc_lowmc_verify_x4_gfni_lowmc_192_192_4_gfni;
+    }
+#endif
+#if defined(WITH_LOWMC_255_255_4)
+    if (lowmc->n == 255 && lowmc->m == 85) {
+      return mpc_lowmc_verify_x4_gfni_lowmc_255_255_4_gfni;
+    }
+#endif
+  }
+#endif
+
+  if (lowmc_get_backend() == LOWMC_BACKEND_S256) {
+    if (lowmc->m == 10) {
+      switch (lowmc->n) {
+#if defined(WITH_LOWMC_128_128_20)
+      case 128:
+        return mpc_lowmc_verify_x4_s256_lowmc_128_128_20;
+#endif
+#if defined(WITH_LOWMC_192_192_30)
+      case 192:
+        return mpc_lowmc_verify_x4_s256_lowmc_192_192_30;
+#endif
+#if defined(WITH_LOWMC_256_256_38)
+      case 256:
+        return mpc_lowmc_verify_x4_s256_lowmc_256_256_38;
+#endif
+      }
+    }
+
+#if defined(WITH_LOWMC_129_129_4)
+    if (lowmc->n == 129 && lowmc->m == 43) {
+      return mpc_lowmc_verify_x4_s256_lowmc_129_129_4;
+    }
+#endif
+#if defined(WITH_LOWMC_192_192_4)
+    if (lowmc->n == 192 && lowmc->m == 64) {
+      return mpc_lowmc_verify_x4_s256_lowmc_192_192_4;
+    }
+#endif
+#if defined(WITH_LOWMC_255_255_4)
+    if (lowmc->n == 255 && lowmc->m == 85) {
+      return mpc_lowmc_verify_x4_s256_lowmc_255_255_4;
+    }
+#endif
+  }
+#endif
+
+#if defined(WITH_SSE2) || defined(WITH_NEON)
+  if (lowmc_get_backend() != LOWMC_BACKEND_UINT64) {
+    if (lowmc->m == 10) {
+      switch (lowmc->n) {
+#if defined(WITH_LOWMC_128_128_20)
+      case 128:
+        return mpc_lowmc_verify_x4_s128_lowmc_128_128_20;
+#endif
+#if defined(WITH_LOWMC_192_192_30)
+      case 192:
+        return mpc_lowmc_verify_x4_s128_lowmc_192_192_30;
+#endif
+#if defined(WITH_LOWMC_256_256_38)
+      case 256:
+        return mpc_lowmc_verify_x4_s128_lowmc_256_256_38;
+#endif
+      }
+    }
+
+#if defined(WITH_LOWMC_129_129_4)
+    if (lowmc->n == 129 && lowmc->m == 43) {
+      return mpc_lowmc_verify_x4_s128_lowmc_129_129_4;
+    }
+#endif
+#if defined(WITH_LOWMC_192_192_4)
+    if (lowmc->n == 192 && lowmc->m == 64) {
+      return mpc_lowmc_verify_x4_s128_lowmc_192_192_4;
+    }
+#endif
+#if defined(WITH_LOWMC_255_255_4)
+    if (lowmc->n == 255 && lowmc->m == 85) {
+      return mpc_lowmc_verify_x4_s128_lowmc_255_255_4;
+    }
+#endif
+  }
+#endif
+#endif
+
+#if !defined(NO_UINT64_FALLBACK)
+  if (lowmc->m == 10) {
+    switch (lowmc->n) {
+#if defined(WITH_LOWMC_128_128_20)
+    case 128:
+      return mpc_lowmc_verify_x4_uint64_lowmc_128_128_20;
+#endif
+#if defined(WITH_LOWMC_192_192_30)
+    case 192:
+      return mpc_lowmc_verify_x4_uint64_lowmc_192_192_30;
+#endif
+#if defined(WITH_LOWMC_256_256_38)
+    case 256:
+      return mpc_lowmc_verify_x4_uint64_lowmc_256_256_38;
+#endif
+    }
+  }
+
+#if defined(WITH_LOWMC_129_129_4)
+  if (lowmc->n == 129 && lowmc->m == 43) {
+    return mpc_lowmc_verify_x4_uint64_lowmc_129_129_4;
+  }
+#endif
+#if defined(WITH_LOWMC_192_192_4)
+  if (lowmc->n == 192 && lowmc->m == 64) {
+    return mpc_lowmc_verify_x4_uint64_lowmc_192_192_4;
+  }
+#endif
+#if defined(WITH_LOWMC_255_255_4)
+  if (lowmc->n == 255 && lowmc->m == 85) {
+    return mpc_lowmc_verify_x4_uint64_lowmc_255_255_4;
+  }
+#endif
+#endif
+
+  return NULL;
+}
+
 #if !defined(NO_UINT64_FALLBACK)
 static void mzd_share_uint64_128(mzd_local_t* r, const mzd_local_t* v1, const mzd_local_t* v2,
                                  const mzd_local_t* v3) {
@@ -1243,10 +2039,158 @@ static void mzd_share_s256_256(mzd_local_t* r, const mzd_local_t* v1, const mzd_
 #endif
 #endif
 
+zkbpp_sbox_implementation_f get_zkbpp_sbox_implementation(const lowmc_parameters_t* lowmc,
+                                                          lowmc_backend_t backend, bool verify) {
+  switch (backend) {
+#if defined(WITH_OPT)
+#if defined(WITH_AVX2)
+#if defined(WITH_GFNI)
+  case LOWMC_BACKEND_GFNI:
+#if defined(WITH_LOWMC_128_128_20)
+    if (lowmc->n == 128 && lowmc->m == 10)
+      return verify ? mpc_sbox_layer_verify_gfni_lowmc_128_128_20_gfni
+                    : mpc_sbox_layer_prove_gfni_lowmc_128_128_20_gfni;
+#endif
+#if defined(WITH_LOWMC_129_129_4)
+    if (lowmc->n == 129 && lowmc->m == 43)
+      return verify ? mpc_sbox_layer_verify_gfni_lowmc_129_129_4_gfni
+                    : mpc_sbox_layer_prove_gfni_lowmc_129_129_4_gfni;
+#endif
+#if defined(WITH_LOWMC_192_192_30)
+    if (lowmc->n == 192 && lowmc->m == 10)
+      return verify ? mpc_sbox_layer_verify_gfni_lowmc_192_192_30_gfni
+                    : mpc_sbox_layer_prove_gfni_lowmc_192_192_30_gfni;
+#endif
+#if defined(WITH_LOWMC_192_192_4)
+    if (lowmc->n == 192 && lowmc->m == 64)
+      return verify ? mpc_sbox_layer_verify_gfni_lowmc_192_192_4_gfni
+                    : mpc_sbox_layer_prove_gfni_lowmc_192_192_4_gfni;
+#endif
+#if defined(WITH_LOWMC_256_256_38)
+    if (lowmc->n == 256 && lowmc->m == 10)
+      return verify ? mpc_sbox_layer_verify_gfni_lowmc_256_256_38_gfni
+                    : mpc_sbox_layer_prove_gfni_lowmc_256_256_38_gfni;
+#endif
+#if defined(WITH_LOWMC_255_255_4)
+    if (lowmc->n == 255 && lowmc->m == 85)
+      return verify ? mpc_sbox_layer_verify_gfni_lowmc_255_255_4_gfni
+                    : mpc_sbox_layer_prove_gfni_lowmc_255_255_4_gfni;
+#endif
+    break;
+#endif
+  case LOWMC_BACKEND_S256:
+#if defined(WITH_LOWMC_128_128_20)
+    if (lowmc->n == 128 && lowmc->m == 10)
+      return verify ? mpc_sbox_layer_verify_s256_lowmc_128_128_20
+                    : mpc_sbox_layer_prove_s256_lowmc_128_128_20;
+#endif
+#if defined(WITH_LOWMC_129_129_4)
+    if (lowmc->n == 129 && lowmc->m == 43)
+      return verify ? mpc_sbox_layer_verify_s256_lowmc_129_129_4
+                    : mpc_sbox_layer_prove_s256_lowmc_129_129_4;
+#endif
+#if defined(WITH_LOWMC_192_192_30)
+    if (lowmc->n == 192 && lowmc->m == 10)
+      return verify ? mpc_sbox_layer_verify_s256_lowmc_192_192_30
+                    : mpc_sbox_layer_prove_s256_lowmc_192_192_30;
+#endif
+#if defined(WITH_LOWMC_192_192_4)
+    if (lowmc->n == 192 && lowmc->m == 64)
+      return verify ? mpc_sbox_layer_verify_s256_lowmc_192_192_4
+                    : mpc_sbox_layer_prove_s256_lowmc_192_192_4;
+#endif
+#if defined(WITH_LOWMC_256_256_38)
+    if (lowmc->n == 256 && lowmc->m == 10)
+      return verify ? mpc_sbox_layer_verify_s256_lowmc_256_256_38
+                    : mpc_sbox_layer_prove_s256_lowmc_256_256_38;
+#endif
+#if defined(WITH_LOWMC_255_255_4)
+    if (lowmc->n == 255 && lowmc->m == 85)
+      return verify ? mpc_sbox_layer_verify_s256_lowmc_255_255_4
+                    : mpc_sbox_layer_prove_s256_lowmc_255_255_4;
+#endif
+    break;
+#endif
+#if defined(WITH_SSE2) || defined(WITH_NEON)
+  case LOWMC_BACKEND_S128:
+#if defined(WITH_LOWMC_128_128_20)
+    if (lowmc->n == 128 && lowmc->m == 10)
+      return verify ? mpc_sbox_layer_verify_s128_lowmc_128_128_20
+                    : mpc_sbox_layer_prove_s128_lowmc_128_128_20;
+#endif
+#if defined(WITH_LOWMC_129_129_4)
+    if (lowmc->n == 129 && lowmc->m == 43)
+      return verify ? mpc_sbox_layer_verify_s128_lowmc_129_129_4
+                    : mpc_sbox_layer_prove_s128_lowmc_129_129_4;
+#endif
+#if defined(WITH_LOWMC_192_192_30)
+    if (lowmc->n == 192 && lowmc->m == 10)
+      return verify ? mpc_sbox_layer_verify_s128_lowmc_192_192_30
+                    : mpc_sbox_layer_prove_s128_lowmc_192_192_30;
+#endif
+#if defined(WITH_LOWMC_192_192_4)
+    if (lowmc->n == 192 && lowmc->m == 64)
+      return verify ? mpc_sbox_layer_verify_s128_lowmc_192_192_4
+                    : mpc_sbox_layer_prove_s128_lowmc_192_192_4;
+#endif
+#if defined(WITH_LOWMC_256_256_38)
+    if (lowmc->n == 256 && lowmc->m == 10)
+      return verify ? mpc_sbox_layer_verify_s128_lowmc_256_256_38
+                    : mpc_sbox_layer_prove_s128_lowmc_256_256_38;
+#endif
+#if defined(WITH_LOWMC_255_255_4)
+    if (lowmc->n == 255 && lowmc->m == 85)
+      return verify ? mpc_sbox_layer_verify_s128_lowmc_255_255_4
+                    : mpc_sbox_layer_prove_s128_lowmc_255_255_4;
+#endif
+    break;
+#endif
+#endif
+#if !defined(NO_UINT64_FALLBACK)
+  case LOWMC_BACKEND_UINT64:
+#if defined(WITH_LOWMC_128_128_20)
+    if (lowmc->n == 128 && lowmc->m == 10)
+      return verify ? mpc_sbox_layer_verify_uint64_lowmc_128_128_20
+                    : mpc_sbox_layer_prove_uint64_lowmc_128_128_20;
+#endif
+#if defined(WITH_LOWMC_129_129_4)
+    if (lowmc->n == 129 && lowmc->m == 43)
+      return verify ? mpc_sbox_layer_verify_uint64_lowmc_129_129_4
+                    : mpc_sbox_layer_prove_uint64_lowmc_129_129_4;
+#endif
+#if defined(WITH_LOWMC_192_192_30)
+    if (lowmc->n == 192 && lowmc->m == 10)
+      return verify ? mpc_sbox_layer_verify_uint64_lowmc_192_192_30
+                    : mpc_sbox_layer_prove_uint64_lowmc_192_192_30;
+#endif
+#if defined(WITH_LOWMC_192_192_4)
+    if (lowmc->n == 192 && lowmc->m == 64)
+      return verify ? mpc_sbox_layer_verify_uint64_lowmc_192_192_4
+                    : mpc_sbox_layer_prove_uint64_lowmc_192_192_4;
+#endif
+#if defined(WITH_LOWMC_256_256_38)
+    if (lowmc->n == 256 && lowmc->m == 10)
+      return verify ? mpc_sbox_layer_verify_uint64_lowmc_256_256_38
+                    : mpc_sbox_layer_prove_uint64_lowmc_256_256_38;
+#endif
+#if defined(WITH_LOWMC_255_255_4)
+    if (lowmc->n == 255 && lowmc->m == 85)
+      return verify ? mpc_sbox_layer_verify_uint64_lowmc_255_255_4
+                    : mpc_sbox_layer_prove_uint64_lowmc_255_255_4;
+#endif
+    break;
+#endif
+  default:
+    break;
+  }
+
+  return NULL;
+}
+
 zkbpp_share_implementation_f get_zkbpp_share_implentation(const lowmc_parameters_t* lowmc) {
 #if defined(WITH_OPT)
 #if defined(WITH_AVX2)
-  if (CPU_SUPPORTS_AVX2) {
+  if (lowmc_get_backend() == LOWMC_BACKEND_S256 || lowmc_get_backend() == LOWMC_BACKEND_GFNI) {
     if (lowmc->n <= 128) {
       return mzd_share_s256_128;
     } else {
@@ -1255,7 +2199,7 @@ zkbpp_share_implementation_f get_zkbpp_share_implentation(const lowmc_parameters
   }
 #endif
 #if defined(WITH_SSE2) || defined(WITH_NEON)
-  if (CPU_SUPPORTS_SSE2 || CPU_SUPPORTS_NEON) {
+  if (lowmc_get_backend() != LOWMC_BACKEND_UINT64) {
     if (lowmc->n <= 128) {
       return mzd_share_s128_128;
     } else {
@@ -1273,5 +2217,7 @@ zkbpp_share_implementation_f get_zkbpp_share_implentation(const lowmc_parameters
   } else {
     return mzd_share_uint64_256;
   }
+#else
+  return NULL;
 #endif
 }
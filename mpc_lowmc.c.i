@@ -8,9 +8,62 @@
  */
 
 #if defined(LOWMC_INSTANCE)
+#if defined(LOWMC_PARTIAL)
+#define VIEW_T view_partial_t
+#define RVEC_T rvec_partial_t
+#else
+#define VIEW_T view_t
+#define RVEC_T rvec_t
+#endif
+
 #define N_SIGN CONCAT(mpc_lowmc_prove, CONCAT(IMPL, LOWMC_INSTANCE))
 #define N_VERIFY CONCAT(mpc_lowmc_verify, CONCAT(IMPL, LOWMC_INSTANCE))
 #include "mpc_lowmc_impl.c.i"
+#define N_SIGN_X4 CONCAT(mpc_lowmc_prove_x4, CONCAT(IMPL, LOWMC_INSTANCE))
+#define N_VERIFY_X4 CONCAT(mpc_lowmc_verify_x4, CONCAT(IMPL, LOWMC_INSTANCE))
+#include "mpc_lowmc_impl_x4.c.i"
+
+#if defined(LOWMC_PARTIAL)
+#define SBOX_LAYER(sbox, y, x, views, rvec, shares, reduced_shares)                                \
+  CONCAT(SBOX, IMPL)(CONCAT(sbox, CONCAT(IMPL, 10)), y, x, views, rvec, LOWMC_N, shares,          \
+                     reduced_shares)
+#else
+#define SBOX_LAYER(sbox, y, x, views, rvec, shares, reduced_shares)                                \
+  SBOX(CONCAT(sbox, CONCAT(IMPL, LOWMC_INSTANCE)), y, x, views, rvec, LOWMC_N, shares,            \
+       reduced_shares)
+#endif
+
+#if defined(FN_ATTR)
+FN_ATTR
+#endif
+static void CONCAT(mpc_sbox_layer_prove, CONCAT(IMPL, LOWMC_INSTANCE))(mzd_local_t* dst,
+                                                                       const mzd_local_t* src,
+                                                                       void* view_buffer,
+                                                                       void* rvec_buffer) {
+  const mzd_local_t(*x)[((LOWMC_N) + 255) / 256] = (const void*)src;
+  mzd_local_t(*y)[((LOWMC_N) + 255) / 256]       = (void*)dst;
+  VIEW_T* views                                  = view_buffer;
+  RVEC_T* rvec                                   = rvec_buffer;
+  SBOX_LAYER(mpc_sbox_prove, y, x, views, rvec, SC_PROOF, SC_PROOF - 1);
+}
+
+#if defined(FN_ATTR)
+FN_ATTR
+#endif
+static void CONCAT(mpc_sbox_layer_verify, CONCAT(IMPL, LOWMC_INSTANCE))(mzd_local_t* dst,
+                                                                       const mzd_local_t* src,
+                                                                       void* view_buffer,
+                                                                       void* rvec_buffer) {
+  const mzd_local_t(*x)[((LOWMC_N) + 255) / 256] = (const void*)src;
+  mzd_local_t(*y)[((LOWMC_N) + 255) / 256]       = (void*)dst;
+  VIEW_T* views                                  = view_buffer;
+  RVEC_T* rvec                                   = rvec_buffer;
+  SBOX_LAYER(mpc_sbox_verify, y, x, views, rvec, SC_VERIFY, SC_VERIFY);
+}
+
+#undef SBOX_LAYER
+#undef VIEW_T
+#undef RVEC_T
 #endif
 
 #undef N_SIGN
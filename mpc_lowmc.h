@@ -26,19 +26,50 @@ typedef union {
 
 typedef view_t rvec_t;
 
+/**
+ * View (or random tape) of one round of the instances with partial S-box layer. Only 30 bits are
+ * communicated per player and round; they are stored in the most significant bits of t[m] for
+ * player m.
+ */
+typedef struct {
+  uint32_t t[SC_PROOF];
+} view_partial_t;
+
+typedef view_partial_t rvec_partial_t;
+
 typedef struct {
   mzd_local_t s[SC_PROOF][(MAX_LOWMC_BLOCK_SIZE + 255) / 256];
 } in_out_shares_t ATTR_ALIGNED(32);
 
-typedef void (*zkbpp_lowmc_implementation_f)(mzd_local_t const*, view_t*, in_out_shares_t*, rvec_t*,
-                                             recorded_state_t*);
-typedef void (*zkbpp_lowmc_verify_implementation_f)(mzd_local_t const*, view_t*, in_out_shares_t*,
-                                                    rvec_t*, unsigned int);
+/*
+ * The views and random tapes passed to the implementations are arrays of view_t and rvec_t with one
+ * entry per round, or of view_partial_t and rvec_partial_t for the instances with partial S-box
+ * layer.
+ */
+typedef void (*zkbpp_lowmc_implementation_f)(mzd_local_t const*, void*, in_out_shares_t*, void*,
+                                             recorded_state_t const*);
+typedef void (*zkbpp_lowmc_verify_implementation_f)(mzd_local_t const*, void*, in_out_shares_t*,
+                                                    void*, unsigned int);
+/* S-box layer on SC_PROOF (SC_VERIFY for verification) consecutive shares */
+typedef void (*zkbpp_sbox_implementation_f)(mzd_local_t*, const mzd_local_t*, void*, void*);
 typedef void (*zkbpp_share_implementation_f)(mzd_local_t*, const mzd_local_t*, const mzd_local_t*,
                                              const mzd_local_t*);
 
 zkbpp_lowmc_implementation_f get_zkbpp_lowmc_implementation(const lowmc_parameters_t* lowmc);
 zkbpp_lowmc_verify_implementation_f get_zkbpp_lowmc_verify_implementation(const lowmc_parameters_t* lowmc);
+/**
+ * Implementations evaluating four repetitions at once. views and rvec consist of four consecutive
+ * blocks of r entries, in_out_shares of four consecutive input/output pairs.
+ */
+zkbpp_lowmc_implementation_f get_zkbpp_lowmc_x4_implementation(const lowmc_parameters_t* lowmc);
+zkbpp_lowmc_verify_implementation_f
+get_zkbpp_lowmc_verify_x4_implementation(const lowmc_parameters_t* lowmc);
 zkbpp_share_implementation_f get_zkbpp_share_implentation(const lowmc_parameters_t* lowmc);
+/**
+ * Returns the MPC S-box layer of the given backend, or NULL if it is not compiled in. Does not check
+ * whether the CPU supports the backend; only intended for benchmarking individual kernels.
+ */
+zkbpp_sbox_implementation_f get_zkbpp_sbox_implementation(const lowmc_parameters_t* lowmc,
+                                                          lowmc_backend_t backend, bool verify);
 
 #endif
@@ -10,8 +10,10 @@
 #if defined(FN_ATTR)
 FN_ATTR
 #endif
-static void N_SIGN(mzd_local_t const* p, view_t* views, in_out_shares_t* in_out_shares,
-                   rvec_t* rvec, recorded_state_t* recorded_state) {
+static void N_SIGN(mzd_local_t const* p, void* view_buffer, in_out_shares_t* in_out_shares,
+                   void* rvec_buffer, recorded_state_t const* recorded_state) {
+  VIEW_T* views = view_buffer;
+  RVEC_T* rvec  = rvec_buffer;
 #define reduced_shares (SC_PROOF - 1)
 #define MPC_LOOP_CONST_C(function, result, first, second, sc, c)                                   \
   MPC_LOOP_CONST_C_0(function, result, first, second, sc)
@@ -21,7 +23,7 @@ static void N_SIGN(mzd_local_t const* p, view_t* views, in_out_shares_t* in_out_
 #define ch 0
 #define shares SC_PROOF
 #if defined(LOWMC_PARTIAL)
-#define sbox mpc_sbox_prove_uint64_10
+#define sbox CONCAT(mpc_sbox_prove, CONCAT(IMPL, 10))
 #else
 #define sbox CONCAT(mpc_sbox_prove, CONCAT(IMPL, LOWMC_INSTANCE))
 #endif
@@ -29,7 +31,15 @@ static void N_SIGN(mzd_local_t const* p, view_t* views, in_out_shares_t* in_out_
   mzd_local_t x[SC_PROOF][((LOWMC_N) + 255) / 256];
   mzd_local_t y[SC_PROOF][((LOWMC_N) + 255) / 256];
 
+#if defined(LOWMC_PARTIAL)
   MPC_LOOP_CONST(MUL, x, in_out_shares[0].s, LOWMC_INSTANCE.k0_matrix, reduced_shares);
+#else
+  mzd_local_t round_keys[SC_PROOF][(LOWMC_R) + 1][((LOWMC_N) + 255) / 256];
+  for (unsigned int e = 0; e < (reduced_shares); ++e) {
+    MUL_RK(round_keys[e][0], in_out_shares[0].s[e], LOWMC_INSTANCE.k_matrices);
+    COPY(x[e], round_keys[e][0]);
+  }
+#endif
   MPC_LOOP_CONST_C(XOR, x, x, p, reduced_shares, ch);
 
 #if defined(LOWMC_PARTIAL)
@@ -51,15 +61,17 @@ static void N_SIGN(mzd_local_t const* p, view_t* views, in_out_shares_t* in_out_
 #if defined(FN_ATTR)
 FN_ATTR
 #endif
-static void N_VERIFY(mzd_local_t const* p, view_t* views, in_out_shares_t* in_out_shares,
-                     rvec_t* rvec, unsigned int ch) {
+static void N_VERIFY(mzd_local_t const* p, void* view_buffer, in_out_shares_t* in_out_shares,
+                     void* rvec_buffer, unsigned int ch) {
+  VIEW_T* views = view_buffer;
+  RVEC_T* rvec  = rvec_buffer;
 #define MPC_LOOP_CONST_C(function, result, first, second, sc, c)                                   \
   MPC_LOOP_CONST_C_ch(function, result, first, second, sc, c)
 
 #define shares SC_VERIFY
 #define reduced_shares shares
 #if defined(LOWMC_PARTIAL)
-#define sbox mpc_sbox_verify_uint64_10
+#define sbox CONCAT(mpc_sbox_verify, CONCAT(IMPL, 10))
 #else
 #define sbox CONCAT(mpc_sbox_verify, CONCAT(IMPL, LOWMC_INSTANCE))
 #endif
@@ -67,7 +79,15 @@ static void N_VERIFY(mzd_local_t const* p, view_t* views, in_out_shares_t* in_ou
   mzd_local_t x[SC_VERIFY][((LOWMC_N) + 255) / 256];
   mzd_local_t y[SC_VERIFY][((LOWMC_N) + 255) / 256];
 
+#if defined(LOWMC_PARTIAL)
   MPC_LOOP_CONST(MUL, x, in_out_shares[0].s, LOWMC_INSTANCE.k0_matrix, SC_VERIFY);
+#else
+  mzd_local_t round_keys[SC_VERIFY][(LOWMC_R) + 1][((LOWMC_N) + 255) / 256];
+  for (unsigned int e = 0; e < (SC_VERIFY); ++e) {
+    MUL_RK(round_keys[e][0], in_out_shares[0].s[e], LOWMC_INSTANCE.k_matrices);
+    COPY(x[e], round_keys[e][0]);
+  }
+#endif
   MPC_LOOP_CONST_C(XOR, x, x, p, SC_VERIFY, ch);
 
 #if defined(LOWMC_PARTIAL)
@@ -0,0 +1,129 @@
+/*
+ *  This file is part of the optimized implementation of the Picnic signature scheme.
+ *  See the accompanying documentation for complete details.
+ *
+ *  The code is provided under the MIT license, see LICENSE for
+ *  more details.
+ *  SPDX-License-Identifier: MIT
+ */
+
+/*
+ * Evaluate four ZKB++ repetitions in lockstep. views and rvec hold LOWMC_R entries per
+ * repetition, in_out_shares holds the input and output shares of repetition i at 2 * i and
+ * 2 * i + 1.
+ */
+
+#if !defined(MUL_X4)
+#define MUL_X4(c, v, A) MPC_X4(MUL, c, v, A)
+#define MUL_X4_FALLBACK
+#endif
+#if !defined(ADDMUL_X4)
+#define ADDMUL_X4(c, v, A) MPC_X4(ADDMUL, c, v, A)
+#define ADDMUL_X4_FALLBACK
+#endif
+
+#if defined(FN_ATTR)
+FN_ATTR
+#endif
+static void N_SIGN_X4(mzd_local_t const* p, void* view_buffer, in_out_shares_t* in_out_shares,
+                      void* rvec_buffer, recorded_state_t const* recorded_state) {
+  VIEW_T* views = view_buffer;
+  RVEC_T* rvec  = rvec_buffer;
+#define reduced_shares (SC_PROOF - 1)
+#define MPC_LOOP_CONST_C(function, result, first, second, sc, c)                                   \
+  MPC_LOOP_CONST_C_0(function, result, first, second, sc)
+#define RECOVER_FROM_STATE(x, i)                                                                   \
+  XOR((x)[SC_PROOF - 1], (x)[0], (x)[1]);                                                          \
+  XOR((x)[SC_PROOF - 1], (x)[SC_PROOF - 1], recorded_state[i].state)
+#define ch 0
+#define shares SC_PROOF
+#if defined(LOWMC_PARTIAL)
+#define sbox CONCAT(mpc_sbox_prove, CONCAT(IMPL, 10))
+#else
+#define sbox CONCAT(mpc_sbox_prove, CONCAT(IMPL, LOWMC_INSTANCE))
+#endif
+
+  mzd_local_t x[4][SC_PROOF][((LOWMC_N) + 255) / 256];
+  mzd_local_t y[4][SC_PROOF][((LOWMC_N) + 255) / 256];
+  mzd_local_t const* inputs[4][SC_PROOF];
+  MPC_X4_INPUT(inputs, in_out_shares, SC_PROOF);
+
+  MPC_LOOP_CONST_X4(MUL_X4, x, inputs, LOWMC_INSTANCE.k0_matrix, reduced_shares);
+  for (unsigned int rep = 0; rep < 4; ++rep) {
+    MPC_LOOP_CONST_C(XOR, x[rep], x[rep], p, reduced_shares, ch);
+  }
+
+#if defined(LOWMC_PARTIAL)
+  #include "mpc_lowmc_loop_partial_x4.c.i"
+#else
+  #include "mpc_lowmc_loop_x4.c.i"
+#endif
+
+  for (unsigned int rep = 0; rep < 4; ++rep) {
+    MPC_LOOP_SHARED_1(COPY, in_out_shares[2 * rep + 1].s, x[rep], SC_PROOF);
+  }
+
+#undef reduced_shares
+#undef RECOVER_FROM_STATE
+#undef ch
+#undef shares
+#undef sbox
+#undef MPC_LOOP_CONST_C
+}
+
+#if defined(FN_ATTR)
+FN_ATTR
+#endif
+static void N_VERIFY_X4(mzd_local_t const* p, void* view_buffer, in_out_shares_t* in_out_shares,
+                        void* rvec_buffer, unsigned int ch) {
+  VIEW_T* views = view_buffer;
+  RVEC_T* rvec  = rvec_buffer;
+#define MPC_LOOP_CONST_C(function, result, first, second, sc, c)                                   \
+  MPC_LOOP_CONST_C_ch(function, result, first, second, sc, c)
+
+#define shares SC_VERIFY
+#define reduced_shares shares
+#if defined(LOWMC_PARTIAL)
+#define sbox CONCAT(mpc_sbox_verify, CONCAT(IMPL, 10))
+#else
+#define sbox CONCAT(mpc_sbox_verify, CONCAT(IMPL, LOWMC_INSTANCE))
+#endif
+
+  mzd_local_t x[4][SC_VERIFY][((LOWMC_N) + 255) / 256];
+  mzd_local_t y[4][SC_VERIFY][((LOWMC_N) + 255) / 256];
+  mzd_local_t const* inputs[4][SC_VERIFY];
+  MPC_X4_INPUT(inputs, in_out_shares, SC_VERIFY);
+
+  MPC_LOOP_CONST_X4(MUL_X4, x, inputs, LOWMC_INSTANCE.k0_matrix, SC_VERIFY);
+  for (unsigned int rep = 0; rep < 4; ++rep) {
+    MPC_LOOP_CONST_C(XOR, x[rep], x[rep], p, SC_VERIFY, ch);
+  }
+
+#if defined(LOWMC_PARTIAL)
+  #include "mpc_lowmc_loop_partial_x4.c.i"
+#else
+  #include "mpc_lowmc_loop_x4.c.i"
+#endif
+
+  for (unsigned int rep = 0; rep < 4; ++rep) {
+    MPC_LOOP_SHARED_1(COPY, in_out_shares[2 * rep + 1].s, x[rep], SC_VERIFY);
+  }
+
+#undef sbox
+#undef reduced_shares
+#undef shares
+#undef MPC_LOOP_CONST_C
+}
+
+#if defined(MUL_X4_FALLBACK)
+#undef MUL_X4
+#undef MUL_X4_FALLBACK
+#endif
+#if defined(ADDMUL_X4_FALLBACK)
+#undef ADDMUL_X4
+#undef ADDMUL_X4_FALLBACK
+#endif
+#undef N_SIGN_X4
+#undef N_VERIFY_X4
+
+// vim: ft=c
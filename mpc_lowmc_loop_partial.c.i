@@ -17,12 +17,7 @@ lowmc_partial_round_t const* round = LOWMC_INSTANCE.rounds;
 #if defined(RECOVER_FROM_STATE)
     RECOVER_FROM_STATE(x, i);
 #endif
-    SBOX_uint64(sbox, y, x, views, rvec, LOWMC_N, shares, reduced_shares);
-    for (unsigned int k = 0; k < reduced_shares; ++k) {
-      const word nl = CONST_BLOCK(nl_part[k], i >> 3)->w64[(i & 0x7) >> 1];
-      BLOCK(y[k], 0)->w64[(LOWMC_N) / (sizeof(word) * 8) - 1] ^=
-        (i & 1) ? (nl & WORD_C(0xFFFFFFFF00000000)) : (nl << 32);
-    }
+    CONCAT(SBOX_NL, IMPL)(sbox, y, x, views, rvec, nl_part, i, LOWMC_N, shares, reduced_shares);
     MPC_LOOP_CONST(MUL_Z, x, y, round->z_matrix, reduced_shares);
 
     for(unsigned int k = 0; k < reduced_shares; ++k) {
@@ -39,13 +34,7 @@ lowmc_partial_round_t const* round = LOWMC_INSTANCE.rounds;
 #if defined(RECOVER_FROM_STATE)
   RECOVER_FROM_STATE(x, i);
 #endif
-  SBOX_uint64(sbox, y, x, views, rvec, LOWMC_N, shares, reduced_shares);
-
-  for (unsigned int k = 0; k < reduced_shares; ++k) {
-    const word nl = CONST_BLOCK(nl_part[k], i >> 3)->w64[(i & 0x7) >> 1];
-    BLOCK(y[k], 0)->w64[(LOWMC_N) / (sizeof(word) * 8) - 1] ^=
-      (i & 1) ? (nl & WORD_C(0xFFFFFFFF00000000)) : (nl << 32);
-  }
+  CONCAT(SBOX_NL, IMPL)(sbox, y, x, views, rvec, nl_part, i, LOWMC_N, shares, reduced_shares);
   MPC_LOOP_CONST(MUL, x, y, LOWMC_INSTANCE.zr_matrix, reduced_shares);
 #if defined(RECOVER_FROM_STATE)
 RECOVER_FROM_STATE(x, LOWMC_R);
@@ -0,0 +1,65 @@
+/*
+ *  This file is part of the optimized implementation of the Picnic signature scheme.
+ *  See the accompanying documentation for complete details.
+ *
+ *  The code is provided under the MIT license, see LICENSE for
+ *  more details.
+ *  SPDX-License-Identifier: MIT
+ */
+
+lowmc_partial_round_t const* round = LOWMC_INSTANCE.rounds;
+  mzd_local_t nl_part[4][reduced_shares][(LOWMC_R * 32 + 255) / 256];
+  for (unsigned int rep = 0; rep < 4; ++rep) {
+    MPC_LOOP_CONST_C(XOR, x[rep], x[rep], LOWMC_INSTANCE.precomputed_constant_linear,
+                     reduced_shares, ch);
+  }
+  MPC_LOOP_CONST_X4(MUL_MC_X4, nl_part, inputs, LOWMC_INSTANCE.precomputed_non_linear_part_matrix,
+                    reduced_shares);
+  for (unsigned int rep = 0; rep < 4; ++rep) {
+    MPC_LOOP_CONST_C(XOR_MC, nl_part[rep], nl_part[rep],
+                     LOWMC_INSTANCE.precomputed_constant_non_linear, reduced_shares, ch);
+  }
+  for (unsigned i = 0; i < (LOWMC_R-1); ++i, ++round) {
+    for (unsigned int rep = 0; rep < 4; ++rep) {
+      view_partial_t* view = &views[rep * (LOWMC_R) + i];
+      rvec_partial_t* rv   = &rvec[rep * (LOWMC_R) + i];
+#if defined(RECOVER_FROM_STATE)
+      RECOVER_FROM_STATE(x[rep], i);
+#endif
+      CONCAT(SBOX_NL, IMPL)(sbox, y[rep], x[rep], view, rv, nl_part[rep], i, LOWMC_N, shares,
+                            reduced_shares);
+    }
+    MPC_LOOP_CONST_X4(MUL_Z_X4, x, y, round->z_matrix, reduced_shares);
+
+    for (unsigned int rep = 0; rep < 4; ++rep) {
+      for (unsigned int k = 0; k < reduced_shares; ++k) {
+        SHUFFLE(y[rep][k], round->r_mask);
+      }
+    }
+
+    MPC_LOOP_CONST_X4(ADDMUL_R_X4, x, y, round->r_matrix, reduced_shares);
+    for (unsigned int rep = 0; rep < 4; ++rep) {
+      for (unsigned int k = 0; k < reduced_shares; ++k) {
+        BLOCK(y[rep][k], 0)->w64[(LOWMC_N) / (sizeof(word) * 8) - 1] &= WORD_C(0x00000003FFFFFFFF); //clear nl part
+      }
+      MPC_LOOP_SHARED(XOR, x[rep], x[rep], y[rep], reduced_shares);
+    }
+  }
+  unsigned i = (LOWMC_R-1);
+  for (unsigned int rep = 0; rep < 4; ++rep) {
+    view_partial_t* view = &views[rep * (LOWMC_R) + i];
+    rvec_partial_t* rv   = &rvec[rep * (LOWMC_R) + i];
+#if defined(RECOVER_FROM_STATE)
+    RECOVER_FROM_STATE(x[rep], i);
+#endif
+    CONCAT(SBOX_NL, IMPL)(sbox, y[rep], x[rep], view, rv, nl_part[rep], i, LOWMC_N, shares,
+                          reduced_shares);
+  }
+  MPC_LOOP_CONST_X4(MUL_X4, x, y, LOWMC_INSTANCE.zr_matrix, reduced_shares);
+#if defined(RECOVER_FROM_STATE)
+for (unsigned int rep = 0; rep < 4; ++rep) {
+  RECOVER_FROM_STATE(x[rep], LOWMC_R);
+}
+#endif
+
+// vim: ft=c
@@ -0,0 +1,32 @@
+/*
+ *  This file is part of the optimized implementation of the Picnic signature scheme.
+ *  See the accompanying documentation for complete details.
+ *
+ *  The code is provided under the MIT license, see LICENSE for
+ *  more details.
+ *  SPDX-License-Identifier: MIT
+ */
+
+lowmc_round_t const* round = LOWMC_INSTANCE.rounds;
+for (unsigned i = 0; i < (LOWMC_R); ++i, ++round) {
+  for (unsigned int rep = 0; rep < 4; ++rep) {
+    view_t* view = &views[rep * (LOWMC_R) + i];
+    rvec_t* rv   = &rvec[rep * (LOWMC_R) + i];
+#if defined(RECOVER_FROM_STATE)
+    RECOVER_FROM_STATE(x[rep], i);
+#endif
+    SBOX(sbox, y[rep], x[rep], view, rv, LOWMC_N, shares, reduced_shares);
+  }
+  MPC_LOOP_CONST_X4(MUL_X4, x, y, round->l_matrix, reduced_shares);
+  for (unsigned int rep = 0; rep < 4; ++rep) {
+    MPC_LOOP_CONST_C(XOR, x[rep], x[rep], round->constant, reduced_shares, ch);
+  }
+  MPC_LOOP_CONST_X4(ADDMUL_X4, x, inputs, round->k_matrix, reduced_shares);
+}
+#if defined(RECOVER_FROM_STATE)
+for (unsigned int rep = 0; rep < 4; ++rep) {
+  RECOVER_FROM_STATE(x[rep], LOWMC_R);
+}
+#endif
+
+// vim: ft=c
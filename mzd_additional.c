@@ -11,6 +11,7 @@
 #include <config.h>
 #endif
 
+#include "allocator.h"
 #include "compat.h"
 #include "mzd_additional.h"
 
@@ -63,7 +64,7 @@ mzd_local_t* mzd_local_init_ex(unsigned int r, unsigned int c, bool clear) {
   /* We always align mzd_local_ts to 32 bytes. Thus the first row is always
    * aligned to 32 bytes as well. For 128 bit and SSE all other rows are then
    * aligned to 16 bytes. */
-  unsigned char* buffer = aligned_alloc(32, alloc_size);
+  unsigned char* buffer = picnic_aligned_alloc(32, alloc_size);
   if (clear) {
     memset(buffer, 0, alloc_size);
   }
@@ -72,7 +73,7 @@ mzd_local_t* mzd_local_init_ex(unsigned int r, unsigned int c, bool clear) {
 }
 
 void mzd_local_free(mzd_local_t* v) {
-  aligned_free(v);
+  picnic_aligned_free(v);
 }
 
 void mzd_local_init_multiple_ex(mzd_local_t** dst, size_t n, unsigned int r, unsigned int c, bool clear) {
@@ -81,7 +82,7 @@ void mzd_local_init_multiple_ex(mzd_local_t** dst, size_t n, unsigned int r, uns
   const size_t buffer_size   = r * rowstride * sizeof(word);
   const size_t size_per_elem = (buffer_size + 31) & ~31;
 
-  unsigned char* full_buffer = aligned_alloc(32, size_per_elem * n);
+  unsigned char* full_buffer = picnic_aligned_alloc(32, size_per_elem * n);
   if (clear) {
     memset(full_buffer, 0, size_per_elem * n);
   }
@@ -93,7 +94,7 @@ void mzd_local_init_multiple_ex(mzd_local_t** dst, size_t n, unsigned int r, uns
 
 void mzd_local_free_multiple(mzd_local_t** vs) {
   if (vs) {
-    aligned_free(vs[0]);
+    picnic_aligned_free(vs[0]);
   }
 }
 
@@ -627,13 +628,16 @@ void mzd_mul_v_s128_129(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const*
   cblock->w128[1] = mm128_xor(cval[1], cval[3]);
 }
 
+/* computes c = v * A + b; c may alias b */
 ATTR_TARGET_S128
-void mzd_addmul_v_s128_129(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A) {
+static inline void mzd_addmul_v_s128_129_impl(mzd_local_t* c, mzd_local_t const* v,
+                                              mzd_local_t const* A, mzd_local_t const* b) {
   block_t* cblock       = BLOCK(c, 0);
   const word* vptr      = CONST_BLOCK(v, 0)->w64;
   const block_t* Ablock = CONST_BLOCK(A, 0);
+  const block_t* bblock = CONST_BLOCK(b, 0);
 
-  word128 cval[4] ATTR_ALIGNED(alignof(word128)) = {cblock->w128[0], cblock->w128[1], mm128_zero,
+  word128 cval[4] ATTR_ALIGNED(alignof(word128)) = {bblock->w128[0], bblock->w128[1], mm128_zero,
                                                     mm128_zero};
   {
     Ablock += 63;
@@ -653,6 +657,11 @@ void mzd_addmul_v_s128_129(mzd_local_t* c, mzd_local_t const* v, mzd_local_t con
   cblock->w128[1] = mm128_xor(cval[1], cval[3]);
 }
 
+ATTR_TARGET_S128
+void mzd_addmul_v_s128_129(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A) {
+  mzd_addmul_v_s128_129_impl(c, v, A, c);
+}
+
 ATTR_TARGET_S128
 void mzd_mul_v_s128_192(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A) {
   block_t* cblock       = BLOCK(c, 0);
@@ -672,12 +681,14 @@ void mzd_mul_v_s128_192(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const*
 }
 
 ATTR_TARGET_S128
-void mzd_addmul_v_s128_192(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A) {
+static inline void mzd_addmul_v_s128_192_impl(mzd_local_t* c, mzd_local_t const* v,
+                                              mzd_local_t const* A, mzd_local_t const* b) {
   block_t* cblock       = BLOCK(c, 0);
   const word* vptr      = CONST_BLOCK(v, 0)->w64;
   const block_t* Ablock = CONST_BLOCK(A, 0);
+  const block_t* bblock = CONST_BLOCK(b, 0);
 
-  word128 cval[4] ATTR_ALIGNED(alignof(word128)) = {cblock->w128[0], cblock->w128[1], mm128_zero,
+  word128 cval[4] ATTR_ALIGNED(alignof(word128)) = {bblock->w128[0], bblock->w128[1], mm128_zero,
                                                     mm128_zero};
   for (unsigned int w = 3; w; --w, ++vptr) {
     word idx = *vptr;
@@ -690,6 +701,11 @@ void mzd_addmul_v_s128_192(mzd_local_t* c, mzd_local_t const* v, mzd_local_t con
   cblock->w128[1] = mm128_xor(cval[1], cval[3]);
 }
 
+ATTR_TARGET_S128
+void mzd_addmul_v_s128_192(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A) {
+  mzd_addmul_v_s128_192_impl(c, v, A, c);
+}
+
 ATTR_TARGET_S128
 void mzd_mul_v_s128_256(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A) {
   block_t* cblock       = BLOCK(c, 0);
@@ -709,12 +725,14 @@ void mzd_mul_v_s128_256(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const*
 }
 
 ATTR_TARGET_S128
-void mzd_addmul_v_s128_256(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A) {
+static inline void mzd_addmul_v_s128_256_impl(mzd_local_t* c, mzd_local_t const* v,
+                                              mzd_local_t const* A, mzd_local_t const* b) {
   block_t* cblock       = BLOCK(c, 0);
   const word* vptr      = CONST_BLOCK(v, 0)->w64;
   const block_t* Ablock = CONST_BLOCK(A, 0);
+  const block_t* bblock = CONST_BLOCK(b, 0);
 
-  word128 cval[4] ATTR_ALIGNED(alignof(word128)) = {cblock->w128[0], cblock->w128[1], mm128_zero,
+  word128 cval[4] ATTR_ALIGNED(alignof(word128)) = {bblock->w128[0], bblock->w128[1], mm128_zero,
                                                     mm128_zero};
   for (unsigned int w = 4; w; --w, ++vptr) {
     word idx = *vptr;
@@ -727,6 +745,74 @@ void mzd_addmul_v_s128_256(mzd_local_t* c, mzd_local_t const* v, mzd_local_t con
   cblock->w128[1] = mm128_xor(cval[1], cval[3]);
 }
 
+ATTR_TARGET_S128
+void mzd_addmul_v_s128_256(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A) {
+  mzd_addmul_v_s128_256_impl(c, v, A, c);
+}
+
+ATTR_TARGET_S128
+void mzd_mul_v_xor_s128_129(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A,
+                            mzd_local_t const* b) {
+  mzd_addmul_v_s128_129_impl(c, v, A, b);
+}
+
+ATTR_TARGET_S128
+void mzd_mul_v_xor_s128_192(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A,
+                            mzd_local_t const* b) {
+  mzd_addmul_v_s128_192_impl(c, v, A, b);
+}
+
+ATTR_TARGET_S128
+void mzd_mul_v_xor_s128_256(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A,
+                            mzd_local_t const* b) {
+  mzd_addmul_v_s128_256_impl(c, v, A, b);
+}
+
+/* one block per row; the first skip rows of the matrices are unused */
+ATTR_TARGET_S128
+static inline void mzd_mul_v_rk_s128_impl(mzd_local_t* c, mzd_local_t const* v,
+                                          mzd_local_t const* const* A, const unsigned int width,
+                                          unsigned int skip) {
+  const word* vptr = CONST_BLOCK(v, 0)->w64;
+  const block_t* Ablock[5];
+  for (unsigned int k = 0; k < 5; ++k) {
+    Ablock[k] = CONST_BLOCK(A[k], 0) + skip;
+  }
+
+  word128 cval[5][2] ATTR_ALIGNED(alignof(word128));
+  for (unsigned int k = 0; k < 5; ++k) {
+    cval[k][0] = cval[k][1] = mm128_zero;
+  }
+  for (unsigned int w = width, row = 0; w; --w, ++vptr, skip = 0) {
+    word idx = (*vptr) >> skip;
+    for (unsigned int i = sizeof(word) * 8 - skip; i; --i, idx >>= 1, ++row) {
+      const word128 mask = mm128_compute_mask(idx, 0);
+      for (unsigned int k = 0; k < 5; ++k) {
+        mm128_xor_mask_region(cval[k], Ablock[k][row].w128, mask, 2);
+      }
+    }
+  }
+  for (unsigned int k = 0; k < 5; ++k) {
+    BLOCK(c, k)->w128[0] = cval[k][0];
+    BLOCK(c, k)->w128[1] = cval[k][1];
+  }
+}
+
+ATTR_TARGET_S128
+void mzd_mul_v_rk_s128_129(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* const* A) {
+  mzd_mul_v_rk_s128_impl(c, v, A, 3, 63);
+}
+
+ATTR_TARGET_S128
+void mzd_mul_v_rk_s128_192(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* const* A) {
+  mzd_mul_v_rk_s128_impl(c, v, A, 3, 0);
+}
+
+ATTR_TARGET_S128
+void mzd_mul_v_rk_s128_256(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* const* A) {
+  mzd_mul_v_rk_s128_impl(c, v, A, 4, 0);
+}
+
 #if defined(WITH_LOWMC_128_128_20)
 ATTR_TARGET_S128
 void mzd_mul_v_s128_128_640(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A) {
@@ -886,13 +972,16 @@ void mzd_mul_v_s256_128(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const*
       mm256_xor(cval[0], _mm256_permute4x64_epi64(cval[0], _MM_SHUFFLE(3, 2, 3, 2))), 0);
 }
 
+/* computes c = v * A + b; c may alias b */
 ATTR_TARGET_AVX2
-void mzd_addmul_v_s256_129(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A) {
+static inline void mzd_addmul_v_s256_129_impl(mzd_local_t* c, mzd_local_t const* v,
+                                              mzd_local_t const* A, mzd_local_t const* b) {
   block_t* cblock       = BLOCK(c, 0);
   const word* vptr      = CONST_BLOCK(v, 0)->w64;
   const block_t* Ablock = CONST_BLOCK(A, 0);
+  const block_t* bblock = CONST_BLOCK(b, 0);
 
-  word256 cval[2] ATTR_ALIGNED(alignof(word256)) = {cblock->w256, mm256_zero};
+  word256 cval[2] ATTR_ALIGNED(alignof(word256)) = {bblock->w256, mm256_zero};
   {
     Ablock += 63;
     word idx = (*vptr) >> 63;
@@ -912,6 +1001,11 @@ void mzd_addmul_v_s256_129(mzd_local_t* c, mzd_local_t const* v, mzd_local_t con
   cblock->w256 = mm256_xor(cval[0], cval[1]);
 }
 
+ATTR_TARGET_AVX2
+void mzd_addmul_v_s256_129(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A) {
+  mzd_addmul_v_s256_129_impl(c, v, A, c);
+}
+
 ATTR_TARGET_AVX2
 void mzd_mul_v_s256_129(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A) {
   block_t* cblock       = BLOCK(c, 0);
@@ -939,12 +1033,14 @@ void mzd_mul_v_s256_129(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const*
 }
 
 ATTR_TARGET_AVX2
-void mzd_addmul_v_s256_192(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A) {
+static inline void mzd_addmul_v_s256_192_impl(mzd_local_t* c, mzd_local_t const* v,
+                                              mzd_local_t const* A, mzd_local_t const* b) {
   block_t* cblock       = BLOCK(c, 0);
   const word* vptr      = CONST_BLOCK(v, 0)->w64;
   const block_t* Ablock = CONST_BLOCK(A, 0);
+  const block_t* bblock = CONST_BLOCK(b, 0);
 
-  word256 cval[2] ATTR_ALIGNED(alignof(word256)) = {cblock->w256, mm256_zero};
+  word256 cval[2] ATTR_ALIGNED(alignof(word256)) = {bblock->w256, mm256_zero};
   for (unsigned int w = 3; w; --w, ++vptr) {
     word idx = *vptr;
     for (unsigned int i = sizeof(word) * 8; i; i -= 4, idx >>= 4, Ablock += 4) {
@@ -957,6 +1053,11 @@ void mzd_addmul_v_s256_192(mzd_local_t* c, mzd_local_t const* v, mzd_local_t con
   cblock->w256 = mm256_xor(cval[0], cval[1]);
 }
 
+ATTR_TARGET_AVX2
+void mzd_addmul_v_s256_192(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A) {
+  mzd_addmul_v_s256_192_impl(c, v, A, c);
+}
+
 ATTR_TARGET_AVX2
 void mzd_mul_v_s256_192(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A) {
   block_t* cblock       = BLOCK(c, 0);
@@ -977,12 +1078,14 @@ void mzd_mul_v_s256_192(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const*
 }
 
 ATTR_TARGET_AVX2
-void mzd_addmul_v_s256_256(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A) {
+static inline void mzd_addmul_v_s256_256_impl(mzd_local_t* c, mzd_local_t const* v,
+                                              mzd_local_t const* A, mzd_local_t const* b) {
   block_t* cblock       = BLOCK(c, 0);
   const word* vptr      = CONST_BLOCK(v, 0)->w64;
   const block_t* Ablock = CONST_BLOCK(A, 0);
+  const block_t* bblock = CONST_BLOCK(b, 0);
 
-  word256 cval[2] ATTR_ALIGNED(alignof(word256)) = {cblock->w256, mm256_zero};
+  word256 cval[2] ATTR_ALIGNED(alignof(word256)) = {bblock->w256, mm256_zero};
   for (unsigned int w = 4; w; --w, ++vptr) {
     word idx = *vptr;
     for (unsigned int i = sizeof(word) * 8; i; i -= 4, idx >>= 4, Ablock += 4) {
@@ -995,6 +1098,11 @@ void mzd_addmul_v_s256_256(mzd_local_t* c, mzd_local_t const* v, mzd_local_t con
   cblock->w256 = mm256_xor(cval[0], cval[1]);
 }
 
+ATTR_TARGET_AVX2
+void mzd_addmul_v_s256_256(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A) {
+  mzd_addmul_v_s256_256_impl(c, v, A, c);
+}
+
 ATTR_TARGET_AVX2
 void mzd_mul_v_s256_256(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A) {
   block_t* cblock       = BLOCK(c, 0);
@@ -1083,6 +1191,199 @@ void mzd_mul_v_s256_256_1280(mzd_local_t* c, mzd_local_t const* v, mzd_local_t c
   }
 }
 #endif
+
+/* Multiplication of four vectors with the same matrix. Every row of A is loaded once. */
+
+ATTR_TARGET_AVX2 ATTR_ARTIFICIAL ATTR_CONST static inline word256
+mm256_compute_mask_pair(const word idx_lo, const word idx_hi, const size_t bit) {
+  const uint64_t m1 = -((idx_lo >> bit) & 1);
+  const uint64_t m2 = -((idx_hi >> bit) & 1);
+  return _mm256_set_epi64x(m2, m2, m1, m1);
+}
+
+/* 128 bit vectors: two rows share one block and two vectors share one register */
+ATTR_TARGET_AVX2
+static inline void mzd_addmul_v_s256_128_x4_impl(word256 cval[2], mzd_local_t const* const* v,
+                                                 const block_t* Ablock) {
+  for (unsigned int w = 0; w < 2; ++w) {
+    word idx[4] = {CONST_BLOCK(v[0], 0)->w64[w], CONST_BLOCK(v[1], 0)->w64[w],
+                   CONST_BLOCK(v[2], 0)->w64[w], CONST_BLOCK(v[3], 0)->w64[w]};
+    for (unsigned int i = sizeof(word) * 8; i; i -= 2, ++Ablock) {
+      const word256 row0 = _mm256_permute2x128_si256(Ablock->w256, Ablock->w256, 0x00);
+      const word256 row1 = _mm256_permute2x128_si256(Ablock->w256, Ablock->w256, 0x11);
+
+      cval[0] = mm256_xor_mask(cval[0], row0, mm256_compute_mask_pair(idx[0], idx[1], 0));
+      cval[1] = mm256_xor_mask(cval[1], row0, mm256_compute_mask_pair(idx[2], idx[3], 0));
+      cval[0] = mm256_xor_mask(cval[0], row1, mm256_compute_mask_pair(idx[0], idx[1], 1));
+      cval[1] = mm256_xor_mask(cval[1], row1, mm256_compute_mask_pair(idx[2], idx[3], 1));
+      for (unsigned int k = 0; k < 4; ++k) {
+        idx[k] >>= 2;
+      }
+    }
+  }
+}
+
+ATTR_TARGET_AVX2
+void mzd_mul_v_s256_128_x4(mzd_local_t* const* c, mzd_local_t const* const* v,
+                           mzd_local_t const* A) {
+  word256 cval[2] ATTR_ALIGNED(alignof(word256)) = {mm256_zero, mm256_zero};
+  mzd_addmul_v_s256_128_x4_impl(cval, v, CONST_BLOCK(A, 0));
+
+  BLOCK(c[0], 0)->w128[0] = _mm256_extracti128_si256(cval[0], 0);
+  BLOCK(c[1], 0)->w128[0] = _mm256_extracti128_si256(cval[0], 1);
+  BLOCK(c[2], 0)->w128[0] = _mm256_extracti128_si256(cval[1], 0);
+  BLOCK(c[3], 0)->w128[0] = _mm256_extracti128_si256(cval[1], 1);
+}
+
+ATTR_TARGET_AVX2
+void mzd_addmul_v_s256_128_x4(mzd_local_t* const* c, mzd_local_t const* const* v,
+                              mzd_local_t const* A) {
+  word256 cval[2] ATTR_ALIGNED(alignof(word256)) = {
+      _mm256_setr_m128i(BLOCK(c[0], 0)->w128[0], BLOCK(c[1], 0)->w128[0]),
+      _mm256_setr_m128i(BLOCK(c[2], 0)->w128[0], BLOCK(c[3], 0)->w128[0])};
+  mzd_addmul_v_s256_128_x4_impl(cval, v, CONST_BLOCK(A, 0));
+
+  BLOCK(c[0], 0)->w128[0] = _mm256_extracti128_si256(cval[0], 0);
+  BLOCK(c[1], 0)->w128[0] = _mm256_extracti128_si256(cval[0], 1);
+  BLOCK(c[2], 0)->w128[0] = _mm256_extracti128_si256(cval[1], 0);
+  BLOCK(c[3], 0)->w128[0] = _mm256_extracti128_si256(cval[1], 1);
+}
+
+/* one block per row; the first skip rows of the matrix are unused */
+ATTR_TARGET_AVX2
+static inline void mzd_addmul_v_s256_x4_impl(word256 cval[4], mzd_local_t const* const* v,
+                                             const block_t* Ablock, const unsigned int width,
+                                             unsigned int skip) {
+  Ablock += skip;
+  for (unsigned int w = 0; w < width; ++w, skip = 0) {
+    word idx[4] = {
+        CONST_BLOCK(v[0], 0)->w64[w] >> skip, CONST_BLOCK(v[1], 0)->w64[w] >> skip,
+        CONST_BLOCK(v[2], 0)->w64[w] >> skip, CONST_BLOCK(v[3], 0)->w64[w] >> skip};
+    for (unsigned int i = sizeof(word) * 8 - skip; i; --i, ++Ablock) {
+      const word256 row = Ablock->w256;
+      for (unsigned int k = 0; k < 4; ++k) {
+        cval[k] = mm256_xor_mask(cval[k], row, mm256_compute_mask(idx[k], 0));
+        idx[k] >>= 1;
+      }
+    }
+  }
+}
+
+#define MZD_MUL_V_S256_X4(width, skip)                                                             \
+  word256 cval[4] ATTR_ALIGNED(alignof(word256)) = {mm256_zero, mm256_zero, mm256_zero,            \
+                                                    mm256_zero};                                   \
+  mzd_addmul_v_s256_x4_impl(cval, v, CONST_BLOCK(A, 0), width, skip);                              \
+  for (unsigned int k = 0; k < 4; ++k) {                                                           \
+    BLOCK(c[k], 0)->w256 = cval[k];                                                                \
+  }
+
+#define MZD_ADDMUL_V_S256_X4(width, skip)                                                          \
+  word256 cval[4] ATTR_ALIGNED(alignof(word256)) = {BLOCK(c[0], 0)->w256, BLOCK(c[1], 0)->w256,    \
+                                                    BLOCK(c[2], 0)->w256, BLOCK(c[3], 0)->w256};   \
+  mzd_addmul_v_s256_x4_impl(cval, v, CONST_BLOCK(A, 0), width, skip);                              \
+  for (unsigned int k = 0; k < 4; ++k) {                                                           \
+    BLOCK(c[k], 0)->w256 = cval[k];                                                                \
+  }
+
+ATTR_TARGET_AVX2
+void mzd_mul_v_s256_129_x4(mzd_local_t* const* c, mzd_local_t const* const* v,
+                           mzd_local_t const* A) {
+  MZD_MUL_V_S256_X4(3, 63);
+}
+
+ATTR_TARGET_AVX2
+void mzd_addmul_v_s256_129_x4(mzd_local_t* const* c, mzd_local_t const* const* v,
+                              mzd_local_t const* A) {
+  MZD_ADDMUL_V_S256_X4(3, 63);
+}
+
+ATTR_TARGET_AVX2
+void mzd_mul_v_s256_192_x4(mzd_local_t* const* c, mzd_local_t const* const* v,
+                           mzd_local_t const* A) {
+  MZD_MUL_V_S256_X4(3, 0);
+}
+
+ATTR_TARGET_AVX2
+void mzd_addmul_v_s256_192_x4(mzd_local_t* const* c, mzd_local_t const* const* v,
+                              mzd_local_t const* A) {
+  MZD_ADDMUL_V_S256_X4(3, 0);
+}
+
+ATTR_TARGET_AVX2
+void mzd_mul_v_s256_256_x4(mzd_local_t* const* c, mzd_local_t const* const* v,
+                           mzd_local_t const* A) {
+  MZD_MUL_V_S256_X4(4, 0);
+}
+
+ATTR_TARGET_AVX2
+void mzd_addmul_v_s256_256_x4(mzd_local_t* const* c, mzd_local_t const* const* v,
+                              mzd_local_t const* A) {
+  MZD_ADDMUL_V_S256_X4(4, 0);
+}
+
+#undef MZD_MUL_V_S256_X4
+#undef MZD_ADDMUL_V_S256_X4
+
+ATTR_TARGET_AVX2
+void mzd_mul_v_xor_s256_129(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A,
+                            mzd_local_t const* b) {
+  mzd_addmul_v_s256_129_impl(c, v, A, b);
+}
+
+ATTR_TARGET_AVX2
+void mzd_mul_v_xor_s256_192(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A,
+                            mzd_local_t const* b) {
+  mzd_addmul_v_s256_192_impl(c, v, A, b);
+}
+
+ATTR_TARGET_AVX2
+void mzd_mul_v_xor_s256_256(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A,
+                            mzd_local_t const* b) {
+  mzd_addmul_v_s256_256_impl(c, v, A, b);
+}
+
+/* one block per row; the first skip rows of the matrices are unused */
+ATTR_TARGET_AVX2
+static inline void mzd_mul_v_rk_s256_impl(mzd_local_t* c, mzd_local_t const* v,
+                                          mzd_local_t const* const* A, const unsigned int width,
+                                          unsigned int skip) {
+  const word* vptr = CONST_BLOCK(v, 0)->w64;
+  const block_t* Ablock[5];
+  for (unsigned int k = 0; k < 5; ++k) {
+    Ablock[k] = CONST_BLOCK(A[k], 0) + skip;
+  }
+
+  word256 cval[5] ATTR_ALIGNED(alignof(word256)) = {mm256_zero, mm256_zero, mm256_zero,
+                                                    mm256_zero, mm256_zero};
+  for (unsigned int w = width, row = 0; w; --w, ++vptr, skip = 0) {
+    word idx = (*vptr) >> skip;
+    for (unsigned int i = sizeof(word) * 8 - skip; i; --i, idx >>= 1, ++row) {
+      const word256 mask = mm256_compute_mask(idx, 0);
+      for (unsigned int k = 0; k < 5; ++k) {
+        cval[k] = mm256_xor_mask(cval[k], Ablock[k][row].w256, mask);
+      }
+    }
+  }
+  for (unsigned int k = 0; k < 5; ++k) {
+    BLOCK(c, k)->w256 = cval[k];
+  }
+}
+
+ATTR_TARGET_AVX2
+void mzd_mul_v_rk_s256_129(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* const* A) {
+  mzd_mul_v_rk_s256_impl(c, v, A, 3, 63);
+}
+
+ATTR_TARGET_AVX2
+void mzd_mul_v_rk_s256_192(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* const* A) {
+  mzd_mul_v_rk_s256_impl(c, v, A, 3, 0);
+}
+
+ATTR_TARGET_AVX2
+void mzd_mul_v_rk_s256_256(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* const* A) {
+  mzd_mul_v_rk_s256_impl(c, v, A, 4, 0);
+}
+
 #endif
 #endif
 
@@ -1128,8 +1429,10 @@ void mzd_mul_v_uint64_128(mzd_local_t* c, mzd_local_t const* v, mzd_local_t cons
   mzd_addmul_v_uint64_128(c, v, A);
 }
 
-void mzd_addmul_v_uint64_129(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A) {
-  block_t* cblock       = BLOCK(c, 0);
+/* computes c = v * A + b; c may alias b */
+static inline void mzd_addmul_v_uint64_129_impl(mzd_local_t* c, mzd_local_t const* v,
+                                                mzd_local_t const* A, mzd_local_t const* b) {
+  block_t cval          = *CONST_BLOCK(b, 0);
   const word* vptr      = CONST_BLOCK(v, 0)->w64;
   const block_t* Ablock = CONST_BLOCK(A, 0);
 
@@ -1137,7 +1440,7 @@ void mzd_addmul_v_uint64_129(mzd_local_t* c, mzd_local_t const* v, mzd_local_t c
   {
     word idx            = (*vptr) >> 63;
     const uint64_t mask = -(idx & 1);
-    mzd_xor_mask_uint64_block(cblock, Ablock, mask, 3);
+    mzd_xor_mask_uint64_block(&cval, Ablock, mask, 3);
     Ablock++;
     vptr++;
   }
@@ -1146,9 +1449,14 @@ void mzd_addmul_v_uint64_129(mzd_local_t* c, mzd_local_t const* v, mzd_local_t c
     word idx = *vptr;
     for (unsigned int i = sizeof(word) * 8; i; --i, idx >>= 1, ++Ablock) {
       const uint64_t mask = -(idx & 1);
-      mzd_xor_mask_uint64_block(cblock, Ablock, mask, 3);
+      mzd_xor_mask_uint64_block(&cval, Ablock, mask, 3);
     }
   }
+  *BLOCK(c, 0) = cval;
+}
+
+void mzd_addmul_v_uint64_129(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A) {
+  mzd_addmul_v_uint64_129_impl(c, v, A, c);
 }
 
 void mzd_mul_v_uint64_129(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A) {
@@ -1156,8 +1464,9 @@ void mzd_mul_v_uint64_129(mzd_local_t* c, mzd_local_t const* v, mzd_local_t cons
   mzd_addmul_v_uint64_129(c, v, A);
 }
 
-void mzd_addmul_v_uint64_192(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A) {
-  block_t* cblock       = BLOCK(c, 0);
+static inline void mzd_addmul_v_uint64_192_impl(mzd_local_t* c, mzd_local_t const* v,
+                                                mzd_local_t const* A, mzd_local_t const* b) {
+  block_t cval          = *CONST_BLOCK(b, 0);
   const word* vptr      = CONST_BLOCK(v, 0)->w64;
   const block_t* Ablock = CONST_BLOCK(A, 0);
 
@@ -1165,9 +1474,14 @@ void mzd_addmul_v_uint64_192(mzd_local_t* c, mzd_local_t const* v, mzd_local_t c
     word idx = *vptr;
     for (unsigned int i = sizeof(word) * 8; i; --i, idx >>= 1, ++Ablock) {
       const uint64_t mask = -(idx & 1);
-      mzd_xor_mask_uint64_block(cblock, Ablock, mask, 3);
+      mzd_xor_mask_uint64_block(&cval, Ablock, mask, 3);
     }
   }
+  *BLOCK(c, 0) = cval;
+}
+
+void mzd_addmul_v_uint64_192(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A) {
+  mzd_addmul_v_uint64_192_impl(c, v, A, c);
 }
 
 void mzd_mul_v_uint64_192(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A) {
@@ -1175,8 +1489,9 @@ void mzd_mul_v_uint64_192(mzd_local_t* c, mzd_local_t const* v, mzd_local_t cons
   mzd_addmul_v_uint64_192(c, v, A);
 }
 
-void mzd_addmul_v_uint64_256(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A) {
-  block_t* cblock       = BLOCK(c, 0);
+static inline void mzd_addmul_v_uint64_256_impl(mzd_local_t* c, mzd_local_t const* v,
+                                                mzd_local_t const* A, mzd_local_t const* b) {
+  block_t cval          = *CONST_BLOCK(b, 0);
   const word* vptr      = CONST_BLOCK(v, 0)->w64;
   const block_t* Ablock = CONST_BLOCK(A, 0);
 
@@ -1185,9 +1500,14 @@ void mzd_addmul_v_uint64_256(mzd_local_t* c, mzd_local_t const* v, mzd_local_t c
 
     for (unsigned int i = sizeof(word) * 8; i; --i, idx >>= 1, ++Ablock) {
       const uint64_t mask = -(idx & 1);
-      mzd_xor_mask_uint64_block(cblock, Ablock, mask, 4);
+      mzd_xor_mask_uint64_block(&cval, Ablock, mask, 4);
     }
   }
+  *BLOCK(c, 0) = cval;
+}
+
+void mzd_addmul_v_uint64_256(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A) {
+  mzd_addmul_v_uint64_256_impl(c, v, A, c);
 }
 
 void mzd_mul_v_uint64_256(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A) {
@@ -1195,6 +1515,55 @@ void mzd_mul_v_uint64_256(mzd_local_t* c, mzd_local_t const* v, mzd_local_t cons
   mzd_addmul_v_uint64_256(c, v, A);
 }
 
+void mzd_mul_v_xor_uint64_129(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A,
+                              mzd_local_t const* b) {
+  mzd_addmul_v_uint64_129_impl(c, v, A, b);
+}
+
+void mzd_mul_v_xor_uint64_192(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A,
+                              mzd_local_t const* b) {
+  mzd_addmul_v_uint64_192_impl(c, v, A, b);
+}
+
+void mzd_mul_v_xor_uint64_256(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A,
+                              mzd_local_t const* b) {
+  mzd_addmul_v_uint64_256_impl(c, v, A, b);
+}
+
+/* one block per row; the first skip rows of the matrices are unused */
+static void mzd_mul_v_rk_uint64_impl(mzd_local_t* c, mzd_local_t const* v,
+                                     mzd_local_t const* const* A, const unsigned int width,
+                                     unsigned int skip, const unsigned int idx_words) {
+  const word* vptr = CONST_BLOCK(v, 0)->w64;
+  const block_t* Ablock[5];
+  for (unsigned int k = 0; k < 5; ++k) {
+    Ablock[k] = CONST_BLOCK(A[k], 0) + skip;
+    clear_uint64_block(BLOCK(c, k), idx_words);
+  }
+
+  for (unsigned int w = width, row = 0; w; --w, ++vptr, skip = 0) {
+    word idx = (*vptr) >> skip;
+    for (unsigned int i = sizeof(word) * 8 - skip; i; --i, idx >>= 1, ++row) {
+      const uint64_t mask = -(idx & 1);
+      for (unsigned int k = 0; k < 5; ++k) {
+        mzd_xor_mask_uint64_block(BLOCK(c, k), &Ablock[k][row], mask, idx_words);
+      }
+    }
+  }
+}
+
+void mzd_mul_v_rk_uint64_129(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* const* A) {
+  mzd_mul_v_rk_uint64_impl(c, v, A, 3, 63, 3);
+}
+
+void mzd_mul_v_rk_uint64_192(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* const* A) {
+  mzd_mul_v_rk_uint64_impl(c, v, A, 3, 0, 3);
+}
+
+void mzd_mul_v_rk_uint64_256(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* const* A) {
+  mzd_mul_v_rk_uint64_impl(c, v, A, 4, 0, 4);
+}
+
 #if defined(WITH_LOWMC_128_128_20)
 void mzd_mul_v_uint64_128_640(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A) {
   const word* vptr      = CONST_BLOCK(v, 0)->w64;
@@ -1391,6 +1760,131 @@ void mzd_addmul_v_s128_30_256(mzd_local_t* c, mzd_local_t const* v, mzd_local_t
   mzd_addmul_v_s128_30_256_idx(c, A, CONST_BLOCK(v, 0)->w64[3] >> 34);
 }
 #endif
+
+#if defined(WITH_LOWMC_128_128_20) || defined(WITH_LOWMC_192_192_30) || defined(WITH_LOWMC_256_256_38)
+/* reduce two rows to one 64 bit word each */
+ATTR_TARGET_S128 ATTR_CONST static inline word128 mm128_reduce_2_rows(word128 row0, word128 row1) {
+  return mm128_xor(mm128_unpacklo_u64(row0, row1), mm128_unpackhi_u64(row0, row1));
+}
+
+/*
+ * Parities of 16 rows as 16 bit integer. Lane k of rows[g] holds row 8k + g reduced to 64 bits. The
+ * rows are folded to half of their size and interleaved with the next group of rows until each row
+ * is represented by one byte.
+ */
+ATTR_TARGET_S128 static inline word mm128_parity_16_rows(word128 rows[8]) {
+  const word128 mask_32 = mm128_broadcast_u64(UINT32_MAX);
+  const word128 mask_16 = mm128_broadcast_u32(UINT16_MAX);
+  const word128 mask_8  = mm128_broadcast_u16(UINT8_MAX);
+
+  /* 32 bit lane 2k + h holds row 8k + 4h + g */
+  for (unsigned int g = 0; g < 4; ++g) {
+    const word128 lo = mm128_xor(rows[g], mm128_sr_u64(rows[g], 32));
+    const word128 hi = mm128_xor(rows[g + 4], mm128_sr_u64(rows[g + 4], 32));
+    rows[g]          = mm128_xor(mm128_and(lo, mask_32), mm128_sl_u64(hi, 32));
+  }
+  /* 16 bit lane 4k + 2h + j holds row 8k + 4h + 2j + g */
+  for (unsigned int g = 0; g < 2; ++g) {
+    const word128 lo = mm128_xor(rows[g], mm128_sr_u32(rows[g], 16));
+    const word128 hi = mm128_xor(rows[g + 2], mm128_sr_u32(rows[g + 2], 16));
+    rows[g]          = mm128_xor(mm128_and(lo, mask_16), mm128_sl_u32(hi, 16));
+  }
+  /* byte i holds row i */
+  const word128 lo = mm128_xor(rows[0], mm128_sr_u16(rows[0], 8));
+  const word128 hi = mm128_xor(rows[1], mm128_sr_u16(rows[1], 8));
+  word128 x        = mm128_xor(mm128_and(lo, mask_8), mm128_sl_u16(hi, 8));
+  /* only the lowest bit of each byte is of interest, so bits crossing bytes do not matter */
+  x = mm128_xor(x, mm128_sr_u16(x, 4));
+  x = mm128_xor(x, mm128_sr_u16(x, 2));
+  x = mm128_xor(x, mm128_sr_u16(x, 1));
+#if defined(WITH_SSE2)
+  return _mm_movemask_epi8(mm128_sl_u16(x, 7));
+#else
+  static const int8_t shifts[16] = {0, 1, 2, 3, 4, 5, 6, 7, 0, 1, 2, 3, 4, 5, 6, 7};
+  const uint8x16_t bits =
+      vshlq_u8(vandq_u8(vreinterpretq_u8_u64(x), vdupq_n_u8(1)), vld1q_s8(shifts));
+  return vaddv_u8(vget_low_u8(bits)) | ((word)vaddv_u8(vget_high_u8(bits)) << 8);
+#endif
+}
+#endif
+
+#if defined(WITH_LOWMC_128_128_20)
+ATTR_TARGET_S128
+void mzd_mul_v_parity_s128_128_30(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* At) {
+  block_t* cblock       = BLOCK(c, 0);
+  const word128 vval    = CONST_BLOCK(v, 0)->w128[0];
+  const block_t* Ablock = CONST_BLOCK(At, 0);
+
+  /* each block holds two rows; the rows 30 and 31 of the last iteration are zero */
+  word res = 0;
+  for (unsigned int i = 0; i < 30; i += 16) {
+    word128 rows[8];
+    for (unsigned int g = 0; g < 8; ++g) {
+      const unsigned int r0 = i + g;
+      const unsigned int r1 = i + g + 8;
+      rows[g]               = mm128_reduce_2_rows(
+          mm128_and(vval, Ablock[r0 / 2].w128[r0 % 2]),
+          r1 < 30 ? mm128_and(vval, Ablock[r1 / 2].w128[r1 % 2]) : mm128_zero);
+    }
+    res |= mm128_parity_16_rows(rows) << (34 + i);
+  }
+  cblock->w64[0] = 0;
+  cblock->w64[1] = res;
+}
+#endif
+
+#if defined(WITH_LOWMC_192_192_30) || defined(WITH_LOWMC_256_256_38)
+ATTR_TARGET_S128 ATTR_PURE static inline word128 mm128_mul_row(const word128 vval[2],
+                                                               const block_t* Ablock) {
+  return mm128_xor(mm128_and(vval[0], Ablock->w128[0]), mm128_and(vval[1], Ablock->w128[1]));
+}
+
+ATTR_TARGET_S128
+static inline word mzd_mul_v_parity_s128_256_30_idx(const word128 vval[2], mzd_local_t const* At) {
+  const block_t* Ablock = CONST_BLOCK(At, 0);
+
+  /* the rows 30 and 31 of the last iteration are zero */
+  word res = 0;
+  for (unsigned int i = 0; i < 30; i += 16) {
+    word128 rows[8];
+    for (unsigned int g = 0; g < 8; ++g) {
+      const unsigned int r0 = i + g;
+      const unsigned int r1 = i + g + 8;
+      rows[g]               = mm128_reduce_2_rows(mm128_mul_row(vval, &Ablock[r0]),
+                                    r1 < 30 ? mm128_mul_row(vval, &Ablock[r1]) : mm128_zero);
+    }
+    res |= mm128_parity_16_rows(rows) << (34 + i);
+  }
+  return res;
+}
+#endif
+
+#if defined(WITH_LOWMC_192_192_30)
+ATTR_TARGET_S128
+void mzd_mul_v_parity_s128_192_30(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* At) {
+  block_t* cblock       = BLOCK(c, 0);
+  const block_t* vblock = CONST_BLOCK(v, 0);
+
+  /* only the lower word of the second half is part of the vector */
+  const word128 vval[2] = {vblock->w128[0], mm128_unpacklo_u64(vblock->w128[1], mm128_zero)};
+  const word res        = mzd_mul_v_parity_s128_256_30_idx(vval, At);
+  cblock->w128[0]       = mm128_zero;
+  cblock->w64[2]        = res;
+}
+#endif
+
+#if defined(WITH_LOWMC_256_256_38)
+ATTR_TARGET_S128
+void mzd_mul_v_parity_s128_256_30(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* At) {
+  block_t* cblock       = BLOCK(c, 0);
+  const block_t* vblock = CONST_BLOCK(v, 0);
+
+  const word res  = mzd_mul_v_parity_s128_256_30_idx(vblock->w128, At);
+  cblock->w128[0] = mm128_zero;
+  cblock->w64[2]  = 0;
+  cblock->w64[3]  = res;
+}
+#endif
 #endif
 
 #if defined(WITH_AVX2)
@@ -1459,6 +1953,122 @@ void mzd_addmul_v_s256_30_256(mzd_local_t* c, mzd_local_t const* v, mzd_local_t
 }
 #endif
 
+#if defined(WITH_LOWMC_128_128_20) || defined(WITH_LOWMC_192_192_30) || defined(WITH_LOWMC_256_256_38)
+/*
+ * Parities of 16 rows as 16 bit integer. Lane k of rows[g] holds row 4k + g reduced to 64 bits. The
+ * rows are folded to half of their size and interleaved with another group of rows until each row
+ * is represented by 16 bits.
+ */
+ATTR_TARGET_AVX2 ATTR_PURE static inline word mm256_parity_16_rows(const word256 rows[4]) {
+  word256 x[4];
+  for (unsigned int g = 0; g < 4; ++g) {
+    x[g] = mm256_xor(rows[g], _mm256_srli_epi64(rows[g], 32));
+  }
+  /* 32 bit lane 2k + h holds row 4k + 2h + g */
+  for (unsigned int g = 0; g < 2; ++g) {
+    x[g] = _mm256_blend_epi32(x[g], _mm256_slli_epi64(x[g + 2], 32), 0xaa);
+    x[g] = mm256_xor(x[g], _mm256_srli_epi32(x[g], 16));
+  }
+  /* 16 bit lane i holds row i */
+  word256 y = _mm256_blend_epi16(x[0], _mm256_slli_epi32(x[1], 16), 0xaa);
+  y         = mm256_xor(y, _mm256_srli_epi16(y, 8));
+  y         = mm256_xor(y, _mm256_srli_epi16(y, 4));
+  y         = mm256_xor(y, _mm256_srli_epi16(y, 2));
+  y         = mm256_xor(y, _mm256_srli_epi16(y, 1));
+  /* saturate the parity bits to bytes; packs works on 128 bit halves */
+  const uint32_t mask =
+      _mm256_movemask_epi8(_mm256_packs_epi16(_mm256_slli_epi16(y, 15), mm256_zero));
+  return (mask & 0xff) | ((mask >> 8) & 0xff00);
+}
+#endif
+
+#if defined(WITH_LOWMC_128_128_20)
+ATTR_TARGET_AVX2
+void mzd_mul_v_parity_s256_128_30(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* At) {
+  block_t* cblock       = BLOCK(c, 0);
+  const word256 vval    = _mm256_broadcastsi128_si256(CONST_BLOCK(v, 0)->w128[0]);
+  const block_t* Ablock = CONST_BLOCK(At, 0);
+
+  /* each block holds two rows; the rows 30 and 31 of the last iteration are zero */
+  word res = 0;
+  for (unsigned int i = 0; i < 30; i += 16, Ablock += 8) {
+    /* rows 2b and 2b + 1 reduced to 64 bits, each stored twice */
+    word256 blocks[8];
+    for (unsigned int b = 0; b < 8; ++b) {
+      const word256 t = i + 2 * b < 30 ? mm256_and(vval, Ablock[b].w256) : mm256_zero;
+      blocks[b]       = mm256_xor(t, _mm256_shuffle_epi32(t, _MM_SHUFFLE(1, 0, 3, 2)));
+    }
+    /* row 4k + g is stored in block 2k + g / 2 */
+    word256 rows[4];
+    for (unsigned int g = 0; g < 4; ++g) {
+      const word256 rows01 = _mm256_blend_epi32(blocks[g / 2], blocks[g / 2 + 2], 0xcc);
+      const word256 rows23 = _mm256_blend_epi32(blocks[g / 2 + 4], blocks[g / 2 + 6], 0xcc);
+      rows[g]              = g % 2 ? _mm256_permute2x128_si256(rows01, rows23, 0x31)
+                                   : _mm256_permute2x128_si256(rows01, rows23, 0x20);
+    }
+    res |= mm256_parity_16_rows(rows) << (34 + i);
+  }
+  cblock->w64[0] = 0;
+  cblock->w64[1] = res;
+}
+#endif
+
+#if defined(WITH_LOWMC_192_192_30) || defined(WITH_LOWMC_256_256_38)
+/* reduce four rows to one 64 bit word each */
+ATTR_TARGET_AVX2 ATTR_CONST static inline word256 mm256_reduce_4_rows(word256 row0, word256 row1,
+                                                                       word256 row2, word256 row3) {
+  const word256 rows01 =
+      mm256_xor(_mm256_unpacklo_epi64(row0, row1), _mm256_unpackhi_epi64(row0, row1));
+  const word256 rows23 =
+      mm256_xor(_mm256_unpacklo_epi64(row2, row3), _mm256_unpackhi_epi64(row2, row3));
+  return mm256_xor(_mm256_permute2x128_si256(rows01, rows23, 0x20),
+                   _mm256_permute2x128_si256(rows01, rows23, 0x31));
+}
+
+ATTR_TARGET_AVX2
+static inline word mzd_mul_v_parity_s256_256_30_idx(const word256 vval, mzd_local_t const* At) {
+  const block_t* Ablock = CONST_BLOCK(At, 0);
+
+  /* the rows 30 and 31 of the last iteration are zero */
+  word res = 0;
+  for (unsigned int i = 0; i < 30; i += 16, Ablock += 16) {
+    word256 rows[4];
+    for (unsigned int g = 0; g < 4; ++g) {
+      rows[g] = mm256_reduce_4_rows(
+          mm256_and(vval, Ablock[g].w256), mm256_and(vval, Ablock[g + 4].w256),
+          mm256_and(vval, Ablock[g + 8].w256),
+          i + g + 12 < 30 ? mm256_and(vval, Ablock[g + 12].w256) : mm256_zero);
+    }
+    res |= mm256_parity_16_rows(rows) << (34 + i);
+  }
+  return res;
+}
+#endif
+
+#if defined(WITH_LOWMC_192_192_30)
+ATTR_TARGET_AVX2
+void mzd_mul_v_parity_s256_192_30(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* At) {
+  block_t* cblock = BLOCK(c, 0);
+  /* the last word is not part of the vector */
+  const word256 vval = _mm256_blend_epi32(CONST_BLOCK(v, 0)->w256, mm256_zero, 0xc0);
+
+  const word res = mzd_mul_v_parity_s256_256_30_idx(vval, At);
+  cblock->w256   = mm256_zero;
+  cblock->w64[2] = res;
+}
+#endif
+
+#if defined(WITH_LOWMC_256_256_38)
+ATTR_TARGET_AVX2
+void mzd_mul_v_parity_s256_256_30(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* At) {
+  block_t* cblock = BLOCK(c, 0);
+
+  const word res = mzd_mul_v_parity_s256_256_30_idx(CONST_BLOCK(v, 0)->w256, At);
+  cblock->w256   = mm256_zero;
+  cblock->w64[3] = res;
+}
+#endif
+
 #if defined(WITH_LOWMC_128_128_20) || defined(WITH_LOWMC_192_192_30) || defined(WITH_LOWMC_256_256_38)
 #if !defined(__x86_64__) && !defined(_M_X64)
 ATTR_TARGET_AVX2 ATTR_CONST static uint8_t popcount_32(uint32_t value) {
@@ -1506,4 +2116,373 @@ void mzd_shuffle_pext_256_30(mzd_local_t* x, const word mask) {
   mzd_shuffle_pext_30_idx(x, mask, 3);
 }
 #endif
+
+#if defined(WITH_GFNI)
+/*
+ * Multiplications with matrices stored as 8x8 tiles (see lowmc_gfni.h). Each input byte is
+ * broadcast and transformed with the tiles of all accumulators. Hence, all bytes of a 64 bit lane of
+ * an accumulator hold the same output byte.
+ */
+
+ATTR_TARGET_GFNI ATTR_ARTIFICIAL static inline void
+mm256_gfni_accumulate(word256* acc, const unsigned int k, const uint8_t* v,
+                      const unsigned int in_bytes, const block_t* Ablock) {
+  for (unsigned int b = 0; b < in_bytes; ++b, Ablock += k) {
+    const word256 x = _mm256_set1_epi8(v[b]);
+    for (unsigned int j = 0; j < k; ++j) {
+      acc[j] = mm256_xor(acc[j], _mm256_gf2p8affine_epi64_epi8(x, Ablock[j].w256, 0));
+    }
+  }
+}
+
+/* the four vectors are interleaved; byte i of every 32 bit lane belongs to vector i */
+ATTR_TARGET_GFNI ATTR_ARTIFICIAL static inline void
+mm256_gfni_accumulate_x4(word256* acc, const unsigned int k, mzd_local_t const* const* v,
+                         const unsigned int in_offset, const unsigned int in_bytes,
+                         const block_t* Ablock) {
+  const uint8_t* v0 = (const uint8_t*)CONST_BLOCK(v[0], 0)->w64 + in_offset;
+  const uint8_t* v1 = (const uint8_t*)CONST_BLOCK(v[1], 0)->w64 + in_offset;
+  const uint8_t* v2 = (const uint8_t*)CONST_BLOCK(v[2], 0)->w64 + in_offset;
+  const uint8_t* v3 = (const uint8_t*)CONST_BLOCK(v[3], 0)->w64 + in_offset;
+  for (unsigned int b = 0; b < in_bytes; ++b, Ablock += k) {
+    const word256 x = _mm256_set1_epi32(v0[b] | (v1[b] << 8) | (v2[b] << 16) | ((uint32_t)v3[b] << 24));
+    for (unsigned int j = 0; j < k; ++j) {
+      acc[j] = mm256_xor(acc[j], _mm256_gf2p8affine_epi64_epi8(x, Ablock[j].w256, 0));
+    }
+  }
+}
+
+/* spread byte i of every 32 bit lane (and hence the output of vector i) over the 64 bit lane */
+ATTR_TARGET_GFNI ATTR_ARTIFICIAL static inline void
+mm256_gfni_select(word256* dst, const word256* acc, const unsigned int k, const unsigned int i) {
+  const uint64_t lo   = UINT64_C(0x0101010101010101) * i;
+  const word256 index = _mm256_set_epi64x(lo + UINT64_C(0x0808080808080808), lo,
+                                          lo + UINT64_C(0x0808080808080808), lo);
+  for (unsigned int j = 0; j < k; ++j) {
+    dst[j] = _mm256_shuffle_epi8(acc[j], index);
+  }
+}
+
+/* interleave the bytes of k accumulators; k is 4, 6 or 8 */
+ATTR_TARGET_GFNI ATTR_ARTIFICIAL static inline word256 mm256_gfni_combine(const word256* acc,
+                                                                         const unsigned int k) {
+  const word256 odd   = _mm256_set1_epi16((short)0xff00);
+  const word256 p01   = _mm256_blendv_epi8(acc[0], acc[1], odd);
+  const word256 p23   = _mm256_blendv_epi8(acc[2], acc[3], odd);
+  const word256 p0123 = _mm256_blend_epi16(p01, p23, 0xaa);
+  if (k == 4) {
+    /* the first 32 bit of every 64 bit lane hold the output */
+    return _mm256_permutevar8x32_epi32(p0123, _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7));
+  }
+
+  const word256 p45 = _mm256_blendv_epi8(acc[4], acc[5], odd);
+  if (k == 6) {
+    /* the first 48 bit of every 64 bit lane hold the output; the last 64 bit are cleared */
+    const word256 t = _mm256_shuffle_epi8(
+        _mm256_blend_epi32(p0123, p45, 0xaa),
+        _mm256_setr_epi8(0, 1, 2, 3, 4, 5, 8, 9, 10, 11, 12, 13, -1, -1, -1, -1, 0, 1, 2, 3, 4, 5,
+                         8, 9, 10, 11, 12, 13, -1, -1, -1, -1));
+    return _mm256_permutevar8x32_epi32(t, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+  }
+
+  const word256 p67 = _mm256_blendv_epi8(acc[6], acc[7], odd);
+  return _mm256_blend_epi32(p0123, _mm256_blend_epi16(p45, p67, 0xaa), 0xaa);
+}
+
+/* v * A for matrices with k (4, 6 or 8) accumulators */
+ATTR_TARGET_GFNI ATTR_ARTIFICIAL static inline word256
+mm256_gfni_mul(const unsigned int k, const uint8_t* v, const unsigned int in_bytes,
+               const block_t* Ablock) {
+  word256 acc[8] ATTR_ALIGNED(alignof(word256)) = {mm256_zero, mm256_zero, mm256_zero, mm256_zero,
+                                                   mm256_zero, mm256_zero, mm256_zero, mm256_zero};
+  mm256_gfni_accumulate(acc, k, v, in_bytes, Ablock);
+  return mm256_gfni_combine(acc, k);
+}
+
+ATTR_TARGET_GFNI ATTR_ARTIFICIAL static inline void
+mm256_gfni_mul_x4(word256 cval[4], const unsigned int k, mzd_local_t const* const* v,
+                  const unsigned int in_offset, const unsigned int in_bytes,
+                  const block_t* Ablock) {
+  word256 acc[8] ATTR_ALIGNED(alignof(word256)) = {mm256_zero, mm256_zero, mm256_zero, mm256_zero,
+                                                   mm256_zero, mm256_zero, mm256_zero, mm256_zero};
+  mm256_gfni_accumulate_x4(acc, k, v, in_offset, in_bytes, Ablock);
+  for (unsigned int i = 0; i < 4; ++i) {
+    word256 tmp[8] ATTR_ALIGNED(alignof(word256));
+    mm256_gfni_select(tmp, acc, k, i);
+    cval[i] = mm256_gfni_combine(tmp, k);
+  }
+}
+
+#define GFNI_BYTES(v, offset) ((const uint8_t*)CONST_BLOCK(v, 0)->w64 + (offset))
+
+ATTR_TARGET_GFNI
+void mzd_mul_v_gfni_128(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A) {
+  BLOCK(c, 0)->w128[0] =
+      _mm256_castsi256_si128(mm256_gfni_mul(4, GFNI_BYTES(v, 0), 16, CONST_BLOCK(A, 0)));
+}
+
+ATTR_TARGET_GFNI
+void mzd_addmul_v_gfni_128(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A) {
+  block_t* cblock = BLOCK(c, 0);
+  cblock->w128[0] =
+      mm128_xor(cblock->w128[0], _mm256_castsi256_si128(
+                                     mm256_gfni_mul(4, GFNI_BYTES(v, 0), 16, CONST_BLOCK(A, 0))));
+}
+
+/* only the 129 bits starting at bit 63 are used */
+ATTR_TARGET_GFNI
+void mzd_mul_v_gfni_129(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A) {
+  BLOCK(c, 0)->w256 = mm256_gfni_mul(6, GFNI_BYTES(v, 7), 17, CONST_BLOCK(A, 0));
+}
+
+ATTR_TARGET_GFNI
+void mzd_addmul_v_gfni_129(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A) {
+  block_t* cblock = BLOCK(c, 0);
+  cblock->w256 = mm256_xor(cblock->w256, mm256_gfni_mul(6, GFNI_BYTES(v, 7), 17, CONST_BLOCK(A, 0)));
+}
+
+ATTR_TARGET_GFNI
+void mzd_mul_v_gfni_192(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A) {
+  BLOCK(c, 0)->w256 = mm256_gfni_mul(6, GFNI_BYTES(v, 0), 24, CONST_BLOCK(A, 0));
+}
+
+ATTR_TARGET_GFNI
+void mzd_addmul_v_gfni_192(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A) {
+  block_t* cblock = BLOCK(c, 0);
+  cblock->w256 = mm256_xor(cblock->w256, mm256_gfni_mul(6, GFNI_BYTES(v, 0), 24, CONST_BLOCK(A, 0)));
+}
+
+ATTR_TARGET_GFNI
+void mzd_mul_v_gfni_256(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A) {
+  BLOCK(c, 0)->w256 = mm256_gfni_mul(8, GFNI_BYTES(v, 0), 32, CONST_BLOCK(A, 0));
+}
+
+ATTR_TARGET_GFNI
+void mzd_addmul_v_gfni_256(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A) {
+  block_t* cblock = BLOCK(c, 0);
+  cblock->w256 = mm256_xor(cblock->w256, mm256_gfni_mul(8, GFNI_BYTES(v, 0), 32, CONST_BLOCK(A, 0)));
+}
+
+ATTR_TARGET_GFNI
+void mzd_mul_v_xor_gfni_129(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A,
+                            mzd_local_t const* b) {
+  BLOCK(c, 0)->w256 = mm256_xor(CONST_BLOCK(b, 0)->w256,
+                                mm256_gfni_mul(6, GFNI_BYTES(v, 7), 17, CONST_BLOCK(A, 0)));
+}
+
+ATTR_TARGET_GFNI
+void mzd_mul_v_xor_gfni_192(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A,
+                            mzd_local_t const* b) {
+  BLOCK(c, 0)->w256 = mm256_xor(CONST_BLOCK(b, 0)->w256,
+                                mm256_gfni_mul(6, GFNI_BYTES(v, 0), 24, CONST_BLOCK(A, 0)));
+}
+
+ATTR_TARGET_GFNI
+void mzd_mul_v_xor_gfni_256(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A,
+                            mzd_local_t const* b) {
+  BLOCK(c, 0)->w256 = mm256_xor(CONST_BLOCK(b, 0)->w256,
+                                mm256_gfni_mul(8, GFNI_BYTES(v, 0), 32, CONST_BLOCK(A, 0)));
+}
+
+ATTR_TARGET_GFNI ATTR_ARTIFICIAL static inline void
+mzd_mul_v_rk_gfni_impl(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* const* A,
+                       const unsigned int k, const unsigned int in_offset,
+                       const unsigned int in_bytes) {
+  word256 cval[5] ATTR_ALIGNED(alignof(word256));
+  for (unsigned int i = 0; i < 5; ++i) {
+    cval[i] = mm256_gfni_mul(k, GFNI_BYTES(v, in_offset), in_bytes, CONST_BLOCK(A[i], 0));
+  }
+  for (unsigned int i = 0; i < 5; ++i) {
+    BLOCK(c, i)->w256 = cval[i];
+  }
+}
+
+ATTR_TARGET_GFNI
+void mzd_mul_v_rk_gfni_129(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* const* A) {
+  mzd_mul_v_rk_gfni_impl(c, v, A, 6, 7, 17);
+}
+
+ATTR_TARGET_GFNI
+void mzd_mul_v_rk_gfni_192(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* const* A) {
+  mzd_mul_v_rk_gfni_impl(c, v, A, 6, 0, 24);
+}
+
+ATTR_TARGET_GFNI
+void mzd_mul_v_rk_gfni_256(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* const* A) {
+  mzd_mul_v_rk_gfni_impl(c, v, A, 8, 0, 32);
+}
+
+ATTR_TARGET_GFNI
+void mzd_mul_v_gfni_128_x4(mzd_local_t* const* c, mzd_local_t const* const* v,
+                           mzd_local_t const* A) {
+  word256 cval[4] ATTR_ALIGNED(alignof(word256));
+  mm256_gfni_mul_x4(cval, 4, v, 0, 16, CONST_BLOCK(A, 0));
+  for (unsigned int i = 0; i < 4; ++i) {
+    BLOCK(c[i], 0)->w128[0] = _mm256_castsi256_si128(cval[i]);
+  }
+}
+
+ATTR_TARGET_GFNI
+void mzd_addmul_v_gfni_128_x4(mzd_local_t* const* c, mzd_local_t const* const* v,
+                              mzd_local_t const* A) {
+  word256 cval[4] ATTR_ALIGNED(alignof(word256));
+  mm256_gfni_mul_x4(cval, 4, v, 0, 16, CONST_BLOCK(A, 0));
+  for (unsigned int i = 0; i < 4; ++i) {
+    block_t* cblock = BLOCK(c[i], 0);
+    cblock->w128[0] = mm128_xor(cblock->w128[0], _mm256_castsi256_si128(cval[i]));
+  }
+}
+
+#define MZD_MUL_V_GFNI_X4(k, in_offset, in_bytes)                                                  \
+  word256 cval[4] ATTR_ALIGNED(alignof(word256));                                                  \
+  mm256_gfni_mul_x4(cval, k, v, in_offset, in_bytes, CONST_BLOCK(A, 0));                           \
+  for (unsigned int i = 0; i < 4; ++i) {                                                           \
+    BLOCK(c[i], 0)->w256 = cval[i];                                                                \
+  }
+
+#define MZD_ADDMUL_V_GFNI_X4(k, in_offset, in_bytes)                                               \
+  word256 cval[4] ATTR_ALIGNED(alignof(word256));                                                  \
+  mm256_gfni_mul_x4(cval, k, v, in_offset, in_bytes, CONST_BLOCK(A, 0));                           \
+  for (unsigned int i = 0; i < 4; ++i) {                                                           \
+    BLOCK(c[i], 0)->w256 = mm256_xor(BLOCK(c[i], 0)->w256, cval[i]);                               \
+  }
+
+ATTR_TARGET_GFNI
+void mzd_mul_v_gfni_129_x4(mzd_local_t* const* c, mzd_local_t const* const* v,
+                           mzd_local_t const* A) {
+  MZD_MUL_V_GFNI_X4(6, 7, 17);
+}
+
+ATTR_TARGET_GFNI
+void mzd_addmul_v_gfni_129_x4(mzd_local_t* const* c, mzd_local_t const* const* v,
+                              mzd_local_t const* A) {
+  MZD_ADDMUL_V_GFNI_X4(6, 7, 17);
+}
+
+ATTR_TARGET_GFNI
+void mzd_mul_v_gfni_192_x4(mzd_local_t* const* c, mzd_local_t const* const* v,
+                           mzd_local_t const* A) {
+  MZD_MUL_V_GFNI_X4(6, 0, 24);
+}
+
+ATTR_TARGET_GFNI
+void mzd_addmul_v_gfni_192_x4(mzd_local_t* const* c, mzd_local_t const* const* v,
+                              mzd_local_t const* A) {
+  MZD_ADDMUL_V_GFNI_X4(6, 0, 24);
+}
+
+ATTR_TARGET_GFNI
+void mzd_mul_v_gfni_256_x4(mzd_local_t* const* c, mzd_local_t const* const* v,
+                           mzd_local_t const* A) {
+  MZD_MUL_V_GFNI_X4(8, 0, 32);
+}
+
+ATTR_TARGET_GFNI
+void mzd_addmul_v_gfni_256_x4(mzd_local_t* const* c, mzd_local_t const* const* v,
+                              mzd_local_t const* A) {
+  MZD_ADDMUL_V_GFNI_X4(8, 0, 32);
+}
+
+#undef MZD_MUL_V_GFNI_X4
+#undef MZD_ADDMUL_V_GFNI_X4
+
+#if defined(WITH_LOWMC_128_128_20) || defined(WITH_LOWMC_192_192_30) || defined(WITH_LOWMC_256_256_38)
+/* the precomputed non-linear part consists of blocks of 32 byte chunks */
+ATTR_TARGET_GFNI ATTR_ARTIFICIAL static inline void
+mzd_mul_v_gfni_mc_impl(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A,
+                       const unsigned int in_bytes, const unsigned int blocks) {
+  const block_t* Ablock = CONST_BLOCK(A, 0);
+
+  word256 cval[5] ATTR_ALIGNED(alignof(word256));
+  for (unsigned int j = 0; j < blocks; ++j, Ablock += 8 * in_bytes) {
+    cval[j] = mm256_gfni_mul(8, GFNI_BYTES(v, 0), in_bytes, Ablock);
+  }
+  for (unsigned int j = 0; j < blocks; ++j) {
+    BLOCK(c, j)->w256 = cval[j];
+  }
+}
+
+/* the 30 bits of v are stored in the upper part of its last word */
+ATTR_TARGET_GFNI ATTR_ARTIFICIAL static inline word
+mzd_mul_v_parity_gfni_impl(mzd_local_t const* v, mzd_local_t const* At,
+                           const unsigned int in_bytes) {
+  word256 acc = mm256_zero;
+  mm256_gfni_accumulate(&acc, 1, GFNI_BYTES(v, 0), in_bytes, CONST_BLOCK(At, 0));
+  /* gather the first bytes of the 64 bit lanes */
+  acc = _mm256_shuffle_epi8(acc, _mm256_setr_epi8(0, 8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                                  -1, -1, -1, -1, -1, 0, 8, -1, -1, -1, -1, -1, -1,
+                                                  -1, -1, -1, -1, -1, -1));
+  const word128 res =
+      mm128_xor(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+  return ((word)(uint32_t)_mm_cvtsi128_si32(res)) << 32;
+}
+#endif
+
+#if defined(WITH_LOWMC_128_128_20)
+ATTR_TARGET_GFNI
+void mzd_mul_v_gfni_128_768(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A) {
+  mzd_mul_v_gfni_mc_impl(c, v, A, 16, 3);
+}
+
+ATTR_TARGET_GFNI
+void mzd_addmul_v_gfni_30_128(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A) {
+  block_t* cblock = BLOCK(c, 0);
+  cblock->w128[0] =
+      mm128_xor(cblock->w128[0], _mm256_castsi256_si128(
+                                     mm256_gfni_mul(4, GFNI_BYTES(v, 12), 4, CONST_BLOCK(A, 0))));
+}
+
+ATTR_TARGET_GFNI
+void mzd_mul_v_parity_gfni_128_30(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* At) {
+  block_t* cblock = BLOCK(c, 0);
+  const word res  = mzd_mul_v_parity_gfni_impl(v, At, 16);
+  cblock->w64[0]  = 0;
+  cblock->w64[1]  = res;
+}
+#endif
+
+#if defined(WITH_LOWMC_192_192_30)
+ATTR_TARGET_GFNI
+void mzd_mul_v_gfni_192_1024(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A) {
+  mzd_mul_v_gfni_mc_impl(c, v, A, 24, 4);
+}
+
+ATTR_TARGET_GFNI
+void mzd_addmul_v_gfni_30_192(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A) {
+  block_t* cblock = BLOCK(c, 0);
+  cblock->w256 = mm256_xor(cblock->w256, mm256_gfni_mul(6, GFNI_BYTES(v, 20), 4, CONST_BLOCK(A, 0)));
+}
+
+ATTR_TARGET_GFNI
+void mzd_mul_v_parity_gfni_192_30(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* At) {
+  block_t* cblock = BLOCK(c, 0);
+  const word res  = mzd_mul_v_parity_gfni_impl(v, At, 24);
+  cblock->w256    = mm256_zero;
+  cblock->w64[2]  = res;
+}
+#endif
+
+#if defined(WITH_LOWMC_256_256_38)
+ATTR_TARGET_GFNI
+void mzd_mul_v_gfni_256_1280(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A) {
+  mzd_mul_v_gfni_mc_impl(c, v, A, 32, 5);
+}
+
+ATTR_TARGET_GFNI
+void mzd_addmul_v_gfni_30_256(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A) {
+  block_t* cblock = BLOCK(c, 0);
+  cblock->w256 = mm256_xor(cblock->w256, mm256_gfni_mul(8, GFNI_BYTES(v, 28), 4, CONST_BLOCK(A, 0)));
+}
+
+ATTR_TARGET_GFNI
+void mzd_mul_v_parity_gfni_256_30(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* At) {
+  block_t* cblock = BLOCK(c, 0);
+  const word res  = mzd_mul_v_parity_gfni_impl(v, At, 32);
+  cblock->w256    = mm256_zero;
+  cblock->w64[3]  = res;
+}
+#endif
+
+#undef GFNI_BYTES
+#endif
 #endif
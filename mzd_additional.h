@@ -218,6 +218,18 @@ void mzd_mul_v_parity_uint64_192_30(mzd_local_t* c, mzd_local_t const* v,
                                     mzd_local_t const* A) ATTR_NONNULL;
 void mzd_mul_v_parity_uint64_256_30(mzd_local_t* c, mzd_local_t const* v,
                                     mzd_local_t const* A) ATTR_NONNULL;
+void mzd_mul_v_parity_s128_128_30(mzd_local_t* c, mzd_local_t const* v,
+                                  mzd_local_t const* A) ATTR_NONNULL;
+void mzd_mul_v_parity_s128_192_30(mzd_local_t* c, mzd_local_t const* v,
+                                  mzd_local_t const* A) ATTR_NONNULL;
+void mzd_mul_v_parity_s128_256_30(mzd_local_t* c, mzd_local_t const* v,
+                                  mzd_local_t const* A) ATTR_NONNULL;
+void mzd_mul_v_parity_s256_128_30(mzd_local_t* c, mzd_local_t const* v,
+                                  mzd_local_t const* A) ATTR_NONNULL;
+void mzd_mul_v_parity_s256_192_30(mzd_local_t* c, mzd_local_t const* v,
+                                  mzd_local_t const* A) ATTR_NONNULL;
+void mzd_mul_v_parity_s256_256_30(mzd_local_t* c, mzd_local_t const* v,
+                                  mzd_local_t const* A) ATTR_NONNULL;
 
 /**
  * Compute c + v * A optimized for c and v being vectors.
@@ -239,6 +251,131 @@ void mzd_addmul_v_s256_129(mzd_local_t* c, mzd_local_t const* v, mzd_local_t con
 void mzd_addmul_v_s256_192(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A) ATTR_NONNULL;
 void mzd_addmul_v_s256_256(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A) ATTR_NONNULL;
 
+/**
+ * Compute v * A + b optimized for v and b being vectors.
+ */
+void mzd_mul_v_xor_uint64_129(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A,
+                              mzd_local_t const* b) ATTR_NONNULL;
+void mzd_mul_v_xor_uint64_192(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A,
+                              mzd_local_t const* b) ATTR_NONNULL;
+void mzd_mul_v_xor_uint64_256(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A,
+                              mzd_local_t const* b) ATTR_NONNULL;
+void mzd_mul_v_xor_s128_129(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A,
+                            mzd_local_t const* b) ATTR_NONNULL;
+void mzd_mul_v_xor_s128_192(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A,
+                            mzd_local_t const* b) ATTR_NONNULL;
+void mzd_mul_v_xor_s128_256(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A,
+                            mzd_local_t const* b) ATTR_NONNULL;
+void mzd_mul_v_xor_s256_129(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A,
+                            mzd_local_t const* b) ATTR_NONNULL;
+void mzd_mul_v_xor_s256_192(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A,
+                            mzd_local_t const* b) ATTR_NONNULL;
+void mzd_mul_v_xor_s256_256(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A,
+                            mzd_local_t const* b) ATTR_NONNULL;
+
+/**
+ * Compute v * A[i] for the five key matrices of the 4 round instances in a single pass over v.
+ * The i-th product is stored in the i-th block of c.
+ */
+void mzd_mul_v_rk_uint64_129(mzd_local_t* c, mzd_local_t const* v,
+                             mzd_local_t const* const* A) ATTR_NONNULL;
+void mzd_mul_v_rk_uint64_192(mzd_local_t* c, mzd_local_t const* v,
+                             mzd_local_t const* const* A) ATTR_NONNULL;
+void mzd_mul_v_rk_uint64_256(mzd_local_t* c, mzd_local_t const* v,
+                             mzd_local_t const* const* A) ATTR_NONNULL;
+void mzd_mul_v_rk_s128_129(mzd_local_t* c, mzd_local_t const* v,
+                           mzd_local_t const* const* A) ATTR_NONNULL;
+void mzd_mul_v_rk_s128_192(mzd_local_t* c, mzd_local_t const* v,
+                           mzd_local_t const* const* A) ATTR_NONNULL;
+void mzd_mul_v_rk_s128_256(mzd_local_t* c, mzd_local_t const* v,
+                           mzd_local_t const* const* A) ATTR_NONNULL;
+void mzd_mul_v_rk_s256_129(mzd_local_t* c, mzd_local_t const* v,
+                           mzd_local_t const* const* A) ATTR_NONNULL;
+void mzd_mul_v_rk_s256_192(mzd_local_t* c, mzd_local_t const* v,
+                           mzd_local_t const* const* A) ATTR_NONNULL;
+void mzd_mul_v_rk_s256_256(mzd_local_t* c, mzd_local_t const* v,
+                           mzd_local_t const* const* A) ATTR_NONNULL;
+
+/**
+ * Compute c[i] = v[i] * A and c[i] + v[i] * A for four vectors at once, loading each row of A
+ * only once. Use AVX2.
+ */
+void mzd_mul_v_s256_128_x4(mzd_local_t* const* c, mzd_local_t const* const* v,
+                           mzd_local_t const* A) ATTR_NONNULL;
+void mzd_mul_v_s256_129_x4(mzd_local_t* const* c, mzd_local_t const* const* v,
+                           mzd_local_t const* A) ATTR_NONNULL;
+void mzd_mul_v_s256_192_x4(mzd_local_t* const* c, mzd_local_t const* const* v,
+                           mzd_local_t const* A) ATTR_NONNULL;
+void mzd_mul_v_s256_256_x4(mzd_local_t* const* c, mzd_local_t const* const* v,
+                           mzd_local_t const* A) ATTR_NONNULL;
+void mzd_addmul_v_s256_128_x4(mzd_local_t* const* c, mzd_local_t const* const* v,
+                              mzd_local_t const* A) ATTR_NONNULL;
+void mzd_addmul_v_s256_129_x4(mzd_local_t* const* c, mzd_local_t const* const* v,
+                              mzd_local_t const* A) ATTR_NONNULL;
+void mzd_addmul_v_s256_192_x4(mzd_local_t* const* c, mzd_local_t const* const* v,
+                              mzd_local_t const* A) ATTR_NONNULL;
+void mzd_addmul_v_s256_256_x4(mzd_local_t* const* c, mzd_local_t const* const* v,
+                              mzd_local_t const* A) ATTR_NONNULL;
+
+/**
+ * Variants of the above using GFNI. The matrices have to be stored as 8x8 tiles as generated by
+ * tools/generate_gfni_tables.c (see lowmc_gfni.h).
+ */
+void mzd_mul_v_gfni_128(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A) ATTR_NONNULL;
+void mzd_mul_v_gfni_129(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A) ATTR_NONNULL;
+void mzd_mul_v_gfni_192(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A) ATTR_NONNULL;
+void mzd_mul_v_gfni_256(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A) ATTR_NONNULL;
+void mzd_addmul_v_gfni_128(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A) ATTR_NONNULL;
+void mzd_addmul_v_gfni_129(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A) ATTR_NONNULL;
+void mzd_addmul_v_gfni_192(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A) ATTR_NONNULL;
+void mzd_addmul_v_gfni_256(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A) ATTR_NONNULL;
+void mzd_mul_v_xor_gfni_129(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A,
+                            mzd_local_t const* b) ATTR_NONNULL;
+void mzd_mul_v_xor_gfni_192(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A,
+                            mzd_local_t const* b) ATTR_NONNULL;
+void mzd_mul_v_xor_gfni_256(mzd_local_t* c, mzd_local_t const* v, mzd_local_t const* A,
+                            mzd_local_t const* b) ATTR_NONNULL;
+void mzd_mul_v_rk_gfni_129(mzd_local_t* c, mzd_local_t const* v,
+                           mzd_local_t const* const* A) ATTR_NONNULL;
+void mzd_mul_v_rk_gfni_192(mzd_local_t* c, mzd_local_t const* v,
+                           mzd_local_t const* const* A) ATTR_NONNULL;
+void mzd_mul_v_rk_gfni_256(mzd_local_t* c, mzd_local_t const* v,
+                           mzd_local_t const* const* A) ATTR_NONNULL;
+void mzd_mul_v_gfni_128_x4(mzd_local_t* const* c, mzd_local_t const* const* v,
+                           mzd_local_t const* A) ATTR_NONNULL;
+void mzd_mul_v_gfni_129_x4(mzd_local_t* const* c, mzd_local_t const* const* v,
+                           mzd_local_t const* A) ATTR_NONNULL;
+void mzd_mul_v_gfni_192_x4(mzd_local_t* const* c, mzd_local_t const* const* v,
+                           mzd_local_t const* A) ATTR_NONNULL;
+void mzd_mul_v_gfni_256_x4(mzd_local_t* const* c, mzd_local_t const* const* v,
+                           mzd_local_t const* A) ATTR_NONNULL;
+void mzd_addmul_v_gfni_128_x4(mzd_local_t* const* c, mzd_local_t const* const* v,
+                              mzd_local_t const* A) ATTR_NONNULL;
+void mzd_addmul_v_gfni_129_x4(mzd_local_t* const* c, mzd_local_t const* const* v,
+                              mzd_local_t const* A) ATTR_NONNULL;
+void mzd_addmul_v_gfni_192_x4(mzd_local_t* const* c, mzd_local_t const* const* v,
+                              mzd_local_t const* A) ATTR_NONNULL;
+void mzd_addmul_v_gfni_256_x4(mzd_local_t* const* c, mzd_local_t const* const* v,
+                              mzd_local_t const* A) ATTR_NONNULL;
+void mzd_mul_v_gfni_128_768(mzd_local_t* c, mzd_local_t const* v,
+                            mzd_local_t const* A) ATTR_NONNULL;
+void mzd_mul_v_gfni_192_1024(mzd_local_t* c, mzd_local_t const* v,
+                             mzd_local_t const* A) ATTR_NONNULL;
+void mzd_mul_v_gfni_256_1280(mzd_local_t* c, mzd_local_t const* v,
+                             mzd_local_t const* A) ATTR_NONNULL;
+void mzd_addmul_v_gfni_30_128(mzd_local_t* c, mzd_local_t const* v,
+                              mzd_local_t const* A) ATTR_NONNULL;
+void mzd_addmul_v_gfni_30_192(mzd_local_t* c, mzd_local_t const* v,
+                              mzd_local_t const* A) ATTR_NONNULL;
+void mzd_addmul_v_gfni_30_256(mzd_local_t* c, mzd_local_t const* v,
+                              mzd_local_t const* A) ATTR_NONNULL;
+void mzd_mul_v_parity_gfni_128_30(mzd_local_t* c, mzd_local_t const* v,
+                                  mzd_local_t const* A) ATTR_NONNULL;
+void mzd_mul_v_parity_gfni_192_30(mzd_local_t* c, mzd_local_t const* v,
+                                  mzd_local_t const* A) ATTR_NONNULL;
+void mzd_mul_v_parity_gfni_256_30(mzd_local_t* c, mzd_local_t const* v,
+                                  mzd_local_t const* A) ATTR_NONNULL;
+
 /**
  * Shuffle vector x according to info in mask. Needed for OLLE optimiztaions.
  */
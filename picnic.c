@@ -17,9 +17,11 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "allocator.h"
 #include "io.h"
 #include "lowmc.h"
 #include "picnic_instances.h"
+#include "picnic_presign.h"
 #if defined(WITH_ZKBPP)
 #include "picnic_impl.h"
 #endif
@@ -114,6 +116,83 @@ int PICNIC_CALLING_CONVENTION picnic_keygen(picnic_params_t param, picnic_public
   return 0;
 }
 
+/* encrypt the plaintexts of LOWMC_BATCH_SIZE private keys of the same instance */
+static void lowmc_encrypt_batch(const picnic_instance_t* instance, const picnic_privatekey_t* sk,
+                                uint8_t ciphertexts[LOWMC_BATCH_SIZE][MAX_LOWMC_BLOCK_SIZE]) {
+  const size_t input_size  = instance->input_size;
+  const size_t output_size = instance->output_size;
+
+  mzd_local_t plaintext[LOWMC_BATCH_SIZE][(MAX_LOWMC_BLOCK_SIZE_BITS + 255) / 256];
+  mzd_local_t privkey[LOWMC_BATCH_SIZE][(MAX_LOWMC_BLOCK_SIZE_BITS + 255) / 256];
+  mzd_local_t ciphertext[LOWMC_BATCH_SIZE][(MAX_LOWMC_BLOCK_SIZE_BITS + 255) / 256];
+  mzd_local_t const* plaintexts[LOWMC_BATCH_SIZE];
+  mzd_local_t const* privkeys[LOWMC_BATCH_SIZE];
+  mzd_local_t* ciphertext_ptrs[LOWMC_BATCH_SIZE];
+
+  for (unsigned int i = 0; i < LOWMC_BATCH_SIZE; ++i) {
+    mzd_from_char_array(plaintext[i], SK_PT(&sk[i]), output_size);
+    mzd_from_char_array(privkey[i], SK_SK(&sk[i]), input_size);
+    plaintexts[i]      = plaintext[i];
+    privkeys[i]        = privkey[i];
+    ciphertext_ptrs[i] = ciphertext[i];
+  }
+
+  instance->impls.lowmc_batch(privkeys, plaintexts, ciphertext_ptrs);
+
+  for (unsigned int i = 0; i < LOWMC_BATCH_SIZE; ++i) {
+    mzd_to_char_array(ciphertexts[i], ciphertext[i], output_size);
+  }
+}
+
+int PICNIC_CALLING_CONVENTION picnic_keygen_batch(picnic_params_t param, picnic_publickey_t* pk,
+                                                  picnic_privatekey_t* sk, size_t count) {
+  if ((!pk || !sk) && count) {
+    return -1;
+  }
+
+  const picnic_instance_t* instance = picnic_instance_get(param);
+  if (!instance) {
+    return -1;
+  }
+
+  const size_t input_size  = instance->input_size;
+  const size_t output_size = instance->output_size;
+
+  size_t idx = 0;
+  if (instance->impls.lowmc_batch) {
+    for (; idx + LOWMC_BATCH_SIZE <= count; idx += LOWMC_BATCH_SIZE) {
+      for (unsigned int i = 0; i < LOWMC_BATCH_SIZE; ++i) {
+        picnic_privatekey_t* key = &sk[idx + i];
+
+        // generate private key
+        key->data[0] = param;
+        // random secret key and plain text
+        if (rand_bits(SK_SK(key), instance->lowmc.k) || rand_bits(SK_PT(key), instance->lowmc.n)) {
+          return -1;
+        }
+      }
+
+      // encrypt plaintexts under secret keys
+      uint8_t ciphertexts[LOWMC_BATCH_SIZE][MAX_LOWMC_BLOCK_SIZE];
+      lowmc_encrypt_batch(instance, &sk[idx], ciphertexts);
+
+      for (unsigned int i = 0; i < LOWMC_BATCH_SIZE; ++i) {
+        pk[idx + i].data[0] = param;
+        memcpy(PK_PT(&pk[idx + i]), SK_PT(&sk[idx + i]), output_size);
+        memcpy(PK_C(&pk[idx + i]), ciphertexts[i], output_size);
+        memcpy(SK_C(&sk[idx + i]), ciphertexts[i], output_size);
+      }
+    }
+  }
+
+  for (; idx < count; ++idx) {
+    if (picnic_keygen(param, &pk[idx], &sk[idx])) {
+      return -1;
+    }
+  }
+  return 0;
+}
+
 int PICNIC_CALLING_CONVENTION picnic_sk_to_pk(const picnic_privatekey_t* sk,
                                               picnic_publickey_t* pk) {
   if (!sk || !pk) {
@@ -193,6 +272,65 @@ int PICNIC_CALLING_CONVENTION picnic_validate_keypair(const picnic_privatekey_t*
   return memcmp(buffer, pk_c, output_size);
 }
 
+int PICNIC_CALLING_CONVENTION picnic_validate_keypairs(const picnic_privatekey_t* sk,
+                                                       const picnic_publickey_t* pk, size_t count) {
+  if ((!sk || !pk) && count) {
+    return -1;
+  }
+
+  size_t idx = 0;
+  while (idx + LOWMC_BATCH_SIZE <= count) {
+    const picnic_params_t param       = sk[idx].data[0];
+    const picnic_instance_t* instance = picnic_instance_get(param);
+    if (!instance) {
+      return -1;
+    }
+
+    const size_t input_size  = instance->input_size;
+    const size_t output_size = instance->output_size;
+
+    // batches are only formed from keys of a single parameter set
+    unsigned int batchable = instance->impls.lowmc_batch != NULL;
+    for (unsigned int i = 0; batchable && i < LOWMC_BATCH_SIZE; ++i) {
+      batchable = sk[idx + i].data[0] == param;
+    }
+    if (!batchable) {
+      if (picnic_validate_keypair(&sk[idx], &pk[idx])) {
+        return -1;
+      }
+      ++idx;
+      continue;
+    }
+
+    // check param and plaintext
+    for (unsigned int i = 0; i < LOWMC_BATCH_SIZE; ++i) {
+      const picnic_privatekey_t* key = &sk[idx + i];
+      if (param != pk[idx + i].data[0] ||
+          memcmp(SK_PT(key), PK_PT(&pk[idx + i]), output_size) != 0 ||
+          memcmp(SK_C(key), PK_C(&pk[idx + i]), output_size) != 0) {
+        return -1;
+      }
+    }
+
+    uint8_t ciphertexts[LOWMC_BATCH_SIZE][MAX_LOWMC_BLOCK_SIZE];
+    lowmc_encrypt_batch(instance, &sk[idx], ciphertexts);
+
+    for (unsigned int i = 0; i < LOWMC_BATCH_SIZE; ++i) {
+      if (memcmp(ciphertexts[i], PK_C(&pk[idx + i]), output_size) != 0) {
+        return -1;
+      }
+    }
+    idx += LOWMC_BATCH_SIZE;
+  }
+
+  for (; idx < count; ++idx) {
+    if (picnic_validate_keypair(&sk[idx], &pk[idx])) {
+      return -1;
+    }
+  }
+  return 0;
+}
+
 int PICNIC_CALLING_CONVENTION picnic_sign(const picnic_privatekey_t* sk, const uint8_t* message,
                                           size_t message_len, uint8_t* signature,
                                           size_t* signature_len) {
@@ -209,6 +347,11 @@ int PICNIC_CALLING_CONVENTION picnic_sign(const picnic_privatekey_t* sk, const u
   const size_t output_size = instance->output_size;
   const size_t input_size  = instance->input_size;
 
+  const int presigned = presign_sign(sk, message, message_len, signature, signature_len);
+  if (presigned <= 0) {
+    return presigned;
+  }
+
   const uint8_t* sk_sk = SK_SK(sk);
   const uint8_t* sk_c  = SK_C(sk);
   const uint8_t* sk_pt = SK_PT(sk);
@@ -405,6 +548,114 @@ int PICNIC_CALLING_CONVENTION picnic_read_private_key(picnic_privatekey_t* key,
   return 0;
 }
 
+int PICNIC_CALLING_CONVENTION picnic_set_backend(picnic_backend_t backend) {
+  lowmc_backend_t lowmc_backend;
+  switch (backend) {
+  case PICNIC_BACKEND_AUTO:
+    lowmc_backend = LOWMC_BACKEND_AUTO;
+    break;
+  case PICNIC_BACKEND_UINT64:
+    lowmc_backend = LOWMC_BACKEND_UINT64;
+    break;
+  case PICNIC_BACKEND_S128:
+    lowmc_backend = LOWMC_BACKEND_S128;
+    break;
+  case PICNIC_BACKEND_S256:
+    lowmc_backend = LOWMC_BACKEND_S256;
+    break;
+  case PICNIC_BACKEND_GFNI:
+    lowmc_backend = LOWMC_BACKEND_GFNI;
+    break;
+  default:
+    return -1;
+  }
+
+  return picnic_instances_set_backend(lowmc_backend) ? 0 : -1;
+}
+
+picnic_backend_t PICNIC_CALLING_CONVENTION picnic_get_backend(void) {
+  switch (picnic_instances_get_backend()) {
+  case LOWMC_BACKEND_GFNI:
+    return PICNIC_BACKEND_GFNI;
+  case LOWMC_BACKEND_S256:
+    return PICNIC_BACKEND_S256;
+  case LOWMC_BACKEND_S128:
+    return PICNIC_BACKEND_S128;
+  default:
+    return PICNIC_BACKEND_UINT64;
+  }
+}
+
+const char* PICNIC_CALLING_CONVENTION picnic_get_backend_name(picnic_backend_t backend) {
+  switch (backend) {
+  case PICNIC_BACKEND_AUTO:
+    return "auto";
+  case PICNIC_BACKEND_UINT64:
+    return "uint64";
+  case PICNIC_BACKEND_S128:
+    return "s128";
+  case PICNIC_BACKEND_S256:
+    return "s256";
+  case PICNIC_BACKEND_GFNI:
+    return "gfni";
+  default:
+    return "unknown";
+  }
+}
+
+/* sign and verify once to page in the code and to prime the allocator */
+static int warmup(picnic_params_t param) {
+  static const uint8_t m[] = "warmup";
+
+  picnic_publickey_t pk;
+  picnic_privatekey_t sk;
+  if (picnic_keygen(param, &pk, &sk)) {
+    return -1;
+  }
+
+  size_t signature_len = picnic_signature_size(param);
+  uint8_t* signature   = picnic_malloc(signature_len);
+  if (!signature) {
+    return -1;
+  }
+
+  int ret = picnic_sign(&sk, m, sizeof(m), signature, &signature_len);
+  if (!ret) {
+    ret = picnic_verify(&pk, m, sizeof(m), signature, signature_len);
+  }
+
+  picnic_free(signature);
+  return ret;
+}
+
+int PICNIC_CALLING_CONVENTION picnic_init(uint32_t params_mask, unsigned int flags) {
+  if (flags & ~(PICNIC_INIT_ADVISE | PICNIC_INIT_PREFAULT | PICNIC_INIT_WARMUP)) {
+    return -1;
+  }
+
+  int ret = 0;
+  for (unsigned int param = PARAMETER_SET_INVALID + 1; param < PARAMETER_SET_MAX_INDEX; ++param) {
+    if (!(params_mask & PICNIC_PARAMS_MASK(param))) {
+      continue;
+    }
+
+    const picnic_instance_t* instance = picnic_instance_get(param);
+    if (!instance) {
+      /* not supported by this build */
+      continue;
+    }
+
+    if (flags & (PICNIC_INIT_ADVISE | PICNIC_INIT_PREFAULT)) {
+      lowmc_prefault(&instance->lowmc, flags & PICNIC_INIT_PREFAULT);
+    }
+    if ((flags & PICNIC_INIT_WARMUP) && warmup(param)) {
+      ret = -1;
+    }
+  }
+
+  return ret;
+}
+
 #if defined(PICNIC_STATIC) && defined(WITH_ZKBPP)
 void picnic_visualize_keys(FILE* out, const picnic_privatekey_t* sk, const picnic_publickey_t* pk) {
   if (!sk || !pk) {
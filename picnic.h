@@ -134,6 +134,25 @@ PICNIC_EXPORT int PICNIC_CALLING_CONVENTION picnic_keygen(picnic_params_t parame
                                                           picnic_publickey_t* pk,
                                                           picnic_privatekey_t* sk);
 
+/**
+ * Batch key generation function.
+ * Generates count public and private key pairs for the specified parameter set. The LowMC
+ * encryptions of up to four key pairs are evaluated at once.
+ *
+ * @param[in]  parameters The parameter set to use when generating the keys.
+ * @param[out] pk         Array of count public keys.
+ * @param[out] sk         Array of count private keys.
+ * @param[in]  count      The number of key pairs to generate.
+ *
+ * @return Returns 0 for success, or a nonzero value indicating an error.
+ *
+ * @see picnic_keygen()
+ */
+PICNIC_EXPORT int PICNIC_CALLING_CONVENTION picnic_keygen_batch(picnic_params_t parameters,
+                                                                picnic_publickey_t* pk,
+                                                                picnic_privatekey_t* sk,
+                                                                size_t count);
+
 /**
  * Signature function.
  * Signs a message with the given keypair.
@@ -250,6 +269,20 @@ PICNIC_EXPORT int PICNIC_CALLING_CONVENTION picnic_read_private_key(picnic_priva
                                                                     const uint8_t* buf,
                                                                     size_t buflen);
 
+/**
+ * Compute the public key of a private key, i.e., encrypt the plaintext of the private key under
+ * its secret key.
+ *
+ * @param[in]  privatekey The private key
+ * @param[out] publickey The public key to be populated
+ *
+ * @return Returns 0 on success, or a nonzero value indicating an error
+ *
+ * @see picnic_keygen()
+ */
+PICNIC_EXPORT int PICNIC_CALLING_CONVENTION picnic_sk_to_pk(const picnic_privatekey_t* privatekey,
+                                                            picnic_publickey_t* publickey);
+
 /**
  * Check that a key pair is valid.
  *
@@ -261,6 +294,554 @@ PICNIC_EXPORT int PICNIC_CALLING_CONVENTION picnic_read_private_key(picnic_priva
 PICNIC_EXPORT int PICNIC_CALLING_CONVENTION
 picnic_validate_keypair(const picnic_privatekey_t* privatekey, const picnic_publickey_t* publickey);
 
+/**
+ * Check that multiple key pairs are valid.
+ *
+ * @param[in] privatekeys Array of count private keys to check
+ * @param[in] publickeys Array of count public keys to check
+ * @param[in] count The number of key pairs
+ *
+ * @return Returns 0 if all key pairs are valid, or a nonzero value indicating an error
+ *
+ * @see picnic_validate_keypair()
+ */
+PICNIC_EXPORT int PICNIC_CALLING_CONVENTION
+picnic_validate_keypairs(const picnic_privatekey_t* privatekeys,
+                         const picnic_publickey_t* publickeys, size_t count);
+
+/* Backend selection */
+
+/** Implementations of the LowMC and MPC kernels */
+typedef enum {
+  /* the fastest implementation supported by the CPU */
+  PICNIC_BACKEND_AUTO,
+  /* portable implementation using 64 bit words */
+  PICNIC_BACKEND_UINT64,
+  /* SSE2 or NEON */
+  PICNIC_BACKEND_S128,
+  /* AVX2 and BMI2 */
+  PICNIC_BACKEND_S256,
+  /* AVX2 and GFNI for the matrix multiplications */
+  PICNIC_BACKEND_GFNI,
+} picnic_backend_t;
+
+/**
+ * Select the implementation used by all parameter sets for the whole process.
+ *
+ * If this function is not called before the first use of the library, the backend is taken from the
+ * PICNIC_BACKEND environment variable (one of uint64, s128, s256 or gfni), and the fastest backend
+ * supported by the CPU is used if the variable is unset or empty. An unknown or unavailable backend
+ * in the variable is reported on stderr in debug builds and also falls back to the fastest backend;
+ * picnic_get_backend() returns the backend actually in use. This function must not be called
+ * concurrently with any other function of the library.
+ *
+ * @param[in] backend The backend
+ *
+ * @return Returns 0 on success, or a nonzero value if the backend is not compiled in or not
+ * supported by the CPU. In the latter case the previous backend remains selected.
+ */
+PICNIC_EXPORT int PICNIC_CALLING_CONVENTION picnic_set_backend(picnic_backend_t backend);
+
+/**
+ * Get the backend currently in use.
+ *
+ * @return The backend, never PICNIC_BACKEND_AUTO.
+ */
+PICNIC_EXPORT picnic_backend_t PICNIC_CALLING_CONVENTION picnic_get_backend(void);
+
+/**
+ * Get a string representation of a backend.
+ *
+ * @param backend A backend
+ *
+ * @return A null-terminated string describing the backend.
+ */
+PICNIC_EXPORT const char* PICNIC_CALLING_CONVENTION
+picnic_get_backend_name(picnic_backend_t backend);
+
+/* Initialization API */
+
+/** Bit of a parameter set in the params_mask argument of picnic_init() */
+#define PICNIC_PARAMS_MASK(p) (UINT32_C(1) << (p))
+/** Mask selecting all parameter sets */
+#define PICNIC_PARAMS_ALL UINT32_C(0xfffffffe)
+
+/** Advise the operating system that the constant tables will be needed soon */
+#define PICNIC_INIT_ADVISE 0x1
+/** Read every page of the constant tables so that they are resident afterwards */
+#define PICNIC_INIT_PREFAULT 0x2
+/** Generate a key and sign and verify a message once to warm up the code paths */
+#define PICNIC_INIT_WARMUP 0x4
+
+/**
+ * Initialize the library ahead of the first call.
+ *
+ * Parameter sets are otherwise set up lazily on first use, and their LowMC constant tables are
+ * paged in when they are first touched. Calling this function at startup moves that cost out of
+ * the first signing or verification operation. It is safe to call this function concurrently with
+ * other functions of the library (except picnic_set_backend), and to call it multiple times.
+ *
+ * @param[in] params_mask The parameter sets to initialize, a combination of
+ * PICNIC_PARAMS_MASK() values or PICNIC_PARAMS_ALL. Parameter sets that are not supported by this
+ * build are skipped.
+ * @param[in] flags       A combination of the PICNIC_INIT_* flags, or 0 to only set up the
+ * parameter sets.
+ *
+ * @return Returns 0 on success, or a nonzero value if the flags are invalid or the warm-up failed.
+ */
+PICNIC_EXPORT int PICNIC_CALLING_CONVENTION picnic_init(uint32_t params_mask, unsigned int flags);
+
+/* Memory API */
+
+/** Allocation functions used for all memory allocated by the library */
+typedef struct {
+  /**
+   * Allocate size bytes aligned to alignment, a power of 2. Returns NULL on failure.
+   */
+  void* (*alloc)(void* opaque, size_t alignment, size_t size);
+  /** Release memory returned by alloc; ptr is never NULL */
+  void (*free)(void* opaque, void* ptr);
+  /** Passed to alloc and free */
+  void* opaque;
+} picnic_allocator_t;
+
+/**
+ * Route all allocations of the library through the given functions instead of malloc and
+ * aligned_alloc. Memory is always released with the functions that allocated it, so this function
+ * may be called at any time and from any thread, as long as the previously set functions remain
+ * usable until all memory obtained from them has been released. Allocations running concurrently
+ * use either the previous or the new functions. The library keeps a copy of every distinct
+ * allocator that was set until the process exits.
+ *
+ * @param[in] allocator The allocation functions, or NULL to restore the C library's functions.
+ *
+ * @return Returns 0 on success, or a nonzero value if one of the functions is missing or the copy
+ * could not be allocated.
+ */
+PICNIC_EXPORT int PICNIC_CALLING_CONVENTION
+picnic_set_allocator(const picnic_allocator_t* allocator);
+
+/**
+ * Serve the allocations of the calling thread from a bump arena in the given buffer. The arena is
+ * reset whenever all memory allocated from it has been released, i.e., after each key generation,
+ * signing or verification operation. Requests that do not fit into the remaining space are
+ * forwarded to the allocator. Serving all allocations of an operation from the arena requires about
+ * the total_bytes reported by bench_memory plus up to 64 bytes per allocation. Memory from the
+ * arena may be released on any thread. The contents of the buffer are not cleared.
+ *
+ * @param[in] buffer The buffer, which must remain valid until all memory allocated from it has been
+ * released, or NULL to stop using an arena.
+ * @param[in] size   The size of the buffer in bytes.
+ *
+ * @return Returns 0 on success, or a nonzero value if called while memory from the current arena
+ * is still in use or if the buffer is too small.
+ */
+PICNIC_EXPORT int PICNIC_CALLING_CONVENTION picnic_set_thread_arena(void* buffer, size_t size);
+
+/* Verification cache API */
+
+/** Eviction policies of the verification cache */
+typedef enum {
+  /* evict the least recently inserted or used entry */
+  PICNIC_CACHE_LRU,
+  /* evict the least recently inserted entry; lookups do not reorder the entries */
+  PICNIC_CACHE_FIFO,
+} picnic_cache_policy_t;
+
+/** Counters of the verification cache */
+typedef struct {
+  uint64_t hits;
+  uint64_t misses;
+  uint64_t evictions;
+  size_t entries;
+  size_t capacity;
+} picnic_verify_cache_stats_t;
+
+/**
+ * Enable the verification cache used by picnic_verify_cached(), or replace the existing cache by an
+ * empty one. The counters are reset as well. The memory of the cache is obtained from the allocator
+ * set with picnic_set_allocator().
+ *
+ * @param[in] capacity The maximal number of cached results, at most 2^31.
+ * @param[in] policy   The entry to evict once the cache is full.
+ *
+ * @return Returns 0 on success, or a nonzero value if the arguments are invalid or the memory could
+ * not be allocated.
+ */
+PICNIC_EXPORT int PICNIC_CALLING_CONVENTION
+picnic_verify_cache_enable(size_t capacity, picnic_cache_policy_t policy);
+
+/**
+ * Disable the verification cache and release its memory.
+ */
+PICNIC_EXPORT void PICNIC_CALLING_CONVENTION picnic_verify_cache_disable(void);
+
+/**
+ * Verification function with a cache of previous results.
+ * Behaves like picnic_verify(), but looks up the result for the same public key, message and
+ * signature in the verification cache first and stores the result of new verifications there. The
+ * cache is keyed by a SHAKE256 digest of its inputs. Failed verifications during which memory could
+ * not be allocated are not cached. Without an enabled cache, this function is equivalent to
+ * picnic_verify(). It is safe to call from multiple threads.
+ *
+ * @param[in] pk The signer's public key.
+ * @param[in] message The message the signature purportedly signs.
+ * @param[in] message_len The length of the message, in bytes.
+ * @param[in] signature The signature to verify.
+ * @param[in] signature_len The length of the signature.
+ *
+ * @return Returns 0 for success, indicating that both the signature and public key are valid. Any
+ * nonzero value indicates failure.
+ *
+ * @see picnic_verify(), picnic_verify_cache_enable()
+ */
+PICNIC_EXPORT int PICNIC_CALLING_CONVENTION picnic_verify_cached(const picnic_publickey_t* pk,
+                                                                 const uint8_t* message,
+                                                                 size_t message_len,
+                                                                 const uint8_t* signature,
+                                                                 size_t signature_len);
+
+/**
+ * Get the counters of the verification cache.
+ *
+ * @param[out] stats The counters to be populated
+ */
+PICNIC_EXPORT void PICNIC_CALLING_CONVENTION
+picnic_verify_cache_get_stats(picnic_verify_cache_stats_t* stats);
+
+/* Presigning API */
+
+/** Counters of the presigning pool of a private key */
+typedef struct {
+  /* signatures created from a precomputed transcript */
+  uint64_t hits;
+  /* signatures created without, since the pool was empty */
+  uint64_t misses;
+  /* failed precomputations, e.g., since memory or randomness was unavailable; the pool retries
+   * with increasing delays */
+  uint64_t failures;
+  size_t available;
+  size_t capacity;
+} picnic_presign_stats_t;
+
+/**
+ * Enable offline/online signing for a private key, or replace its existing pool by an empty one.
+ *
+ * A background thread keeps up to capacity transcripts for sk precomputed, i.e., everything of a
+ * signature that does not depend on the message: the random tapes, the MPC simulation, the views
+ * and all commitments. picnic_sign() then only computes the challenge and serializes the signature
+ * if a transcript is available, and otherwise signs as usual.
+ *
+ * Security note: picnic_sign() derives the seeds of a signature from the private key and the
+ * message. Seeds of precomputed transcripts are drawn from the system's random number generator
+ * instead, so signatures of the same message are no longer deterministic, and the security of the
+ * private key relies on the quality of that generator. Opening one transcript for two different
+ * challenges reveals the private key. The library never uses a transcript twice and discards the
+ * pool in a child process after fork(), but transcripts must not be duplicated by other means,
+ * such as snapshots of a running process. The pool holds copies of the private key and of secret
+ * seeds in memory.
+ *
+ * The memory of the pool is obtained from the allocator set with picnic_set_allocator(). Requires
+ * pthreads.
+ *
+ * @param[in] sk       The private key.
+ * @param[in] capacity The maximal number of precomputed transcripts.
+ *
+ * @return Returns 0 on success, or a nonzero value if the arguments are invalid or the pool could
+ * not be set up.
+ */
+PICNIC_EXPORT int PICNIC_CALLING_CONVENTION picnic_presign_enable(const picnic_privatekey_t* sk,
+                                                                  size_t capacity);
+
+/**
+ * Stop the background thread of the pool of a private key and release its transcripts.
+ *
+ * @param[in] sk The private key.
+ */
+PICNIC_EXPORT void PICNIC_CALLING_CONVENTION picnic_presign_disable(const picnic_privatekey_t* sk);
+
+/**
+ * Get the counters of the pool of a private key.
+ *
+ * @param[in] sk     The private key.
+ * @param[out] stats The counters to be populated
+ *
+ * @return Returns 0 on success, or a nonzero value if no pool is enabled for the key.
+ */
+PICNIC_EXPORT int PICNIC_CALLING_CONVENTION
+picnic_presign_get_stats(const picnic_privatekey_t* sk, picnic_presign_stats_t* stats);
+
+/* Stepwise signing and verification API */
+
+/** State of a signature computed in steps */
+typedef struct picnic_sign_ctx_s picnic_sign_ctx_t;
+/** State of a verification computed in steps */
+typedef struct picnic_verify_ctx_s picnic_verify_ctx_t;
+
+/**
+ * Start signing a message in bounded steps, e.g., to interleave signing with other work on an event
+ * loop or to abandon it once a deadline passed. Each call of picnic_sign_step() performs a bounded
+ * amount of work, i.e., a few parallel repetitions of the proof. The signature is identical to the
+ * one produced by picnic_sign() without presigning pool.
+ *
+ * The private key and the message are not copied and must remain valid until the context is
+ * released by picnic_sign_finish() or picnic_sign_cancel(). A context must not be used by multiple
+ * threads at the same time.
+ *
+ * @param[in] sk          The signer's private key.
+ * @param[in] message     The message to be signed.
+ * @param[in] message_len The length of the message, in bytes.
+ *
+ * @return Returns the context, or NULL if the key is invalid or the memory could not be allocated.
+ */
+PICNIC_EXPORT picnic_sign_ctx_t* PICNIC_CALLING_CONVENTION
+picnic_sign_begin(const picnic_privatekey_t* sk, const uint8_t* message, size_t message_len);
+
+/**
+ * Perform the next step of a signature.
+ *
+ * @param[in] ctx The context returned by picnic_sign_begin().
+ *
+ * @return Returns a positive value if more steps follow, 0 once all steps are done, and a negative
+ * value on failure. Calling it again after it returned 0 or a negative value has no effect.
+ */
+PICNIC_EXPORT int PICNIC_CALLING_CONVENTION picnic_sign_step(picnic_sign_ctx_t* ctx);
+
+/**
+ * Perform the remaining steps of a signature, serialize the signature and release the context.
+ *
+ * @param[in] ctx               The context returned by picnic_sign_begin().
+ * @param[out] signature        A buffer to hold the signature.
+ * @param[in,out] signature_len As in picnic_sign().
+ *
+ * @return Returns 0 on success, or a nonzero value on error. The context is released in any case.
+ */
+PICNIC_EXPORT int PICNIC_CALLING_CONVENTION picnic_sign_finish(picnic_sign_ctx_t* ctx,
+                                                                uint8_t* signature,
+                                                                size_t* signature_len);
+
+/**
+ * Abandon a signature and release the context.
+ *
+ * @param[in] ctx The context returned by picnic_sign_begin(), or NULL.
+ */
+PICNIC_EXPORT void PICNIC_CALLING_CONVENTION picnic_sign_cancel(picnic_sign_ctx_t* ctx);
+
+/**
+ * Start verifying a signature in bounded steps. The requirements of picnic_sign_begin() on the
+ * lifetime of the arguments and the use of the context apply accordingly; in particular the
+ * signature must remain valid until the context is released.
+ *
+ * @param[in] pk            The signer's public key.
+ * @param[in] message       The message the signature purportedly signs.
+ * @param[in] message_len   The length of the message, in bytes.
+ * @param[in] signature     The signature to verify.
+ * @param[in] signature_len The length of the signature.
+ *
+ * @return Returns the context, or NULL if the key or the signature is malformed or the memory could
+ * not be allocated.
+ */
+PICNIC_EXPORT picnic_verify_ctx_t* PICNIC_CALLING_CONVENTION
+picnic_verify_begin(const picnic_publickey_t* pk, const uint8_t* message, size_t message_len,
+                    const uint8_t* signature, size_t signature_len);
+
+/**
+ * Perform the next step of a verification.
+ *
+ * @param[in] ctx The context returned by picnic_verify_begin().
+ *
+ * @return Returns a positive value if more steps follow, 0 once all steps are done, and a negative
+ * value if the signature was already found to be invalid. An invalid signature of Picnic3 may be
+ * detected by any step, whereas one of the other parameter sets is only detected by
+ * picnic_verify_finish().
+ */
+PICNIC_EXPORT int PICNIC_CALLING_CONVENTION picnic_verify_step(picnic_verify_ctx_t* ctx);
+
+/**
+ * Perform the remaining steps of a verification and release the context.
+ *
+ * @param[in] ctx The context returned by picnic_verify_begin().
+ *
+ * @return Returns 0 if the signature is valid. Any nonzero value indicates failure.
+ */
+PICNIC_EXPORT int PICNIC_CALLING_CONVENTION picnic_verify_finish(picnic_verify_ctx_t* ctx);
+
+/**
+ * Abandon a verification and release the context.
+ *
+ * @param[in] ctx The context returned by picnic_verify_begin(), or NULL.
+ */
+PICNIC_EXPORT void PICNIC_CALLING_CONVENTION picnic_verify_cancel(picnic_verify_ctx_t* ctx);
+
+/* Executor API */
+
+/** Executor running signing and verification jobs on a pool of threads */
+typedef struct picnic_executor_s picnic_executor_t;
+
+/**
+ * A signing or verification job. The memory of the job, the key, the message and the signature are
+ * owned by the caller and must remain valid until the callback of the job was invoked.
+ */
+typedef struct picnic_job_s {
+  /** The private key of a signing job */
+  const picnic_privatekey_t* sk;
+  /** The public key of a verification job */
+  const picnic_publickey_t* pk;
+  const uint8_t* message;
+  size_t message_len;
+  /** The buffer for the signature of a signing job, or the signature to verify */
+  uint8_t* signature;
+  /** As for picnic_sign() for a signing job, or the length of the signature to verify */
+  size_t signature_len;
+  /** The result of picnic_sign() or picnic_verify(), set before the callback is invoked */
+  int result;
+  /** Available to the caller, e.g., to pass context to the callback */
+  void* opaque;
+
+  /* used by the executor */
+  void (*callback)(struct picnic_job_s* job);
+  struct picnic_job_s* next;
+  int verify;
+} picnic_job_t;
+
+/** Callback invoked by picnic_executor_dispatch() for each completed job */
+typedef void (*picnic_job_callback_t)(picnic_job_t* job);
+
+/**
+ * Create an executor with the given number of worker threads. Jobs are distributed over the queues
+ * of the workers, and idle workers take jobs from the queues of the others. Verification jobs of
+ * the same parameter set queued together are run back to back by one worker. The memory of the
+ * executor is obtained from the allocator set with picnic_set_allocator(). Requires pthreads.
+ *
+ * @param[in] threads The number of worker threads, or 0 for one per online CPU.
+ *
+ * @return Returns the executor, or NULL if it could not be set up.
+ */
+PICNIC_EXPORT picnic_executor_t* PICNIC_CALLING_CONVENTION
+picnic_executor_create(unsigned int threads);
+
+/**
+ * Complete all submitted jobs, invoke their callbacks on the calling thread and release the
+ * executor. Jobs can no longer be submitted once this function was called, including from the
+ * callbacks it invokes.
+ *
+ * @param[in] executor The executor, or NULL.
+ */
+PICNIC_EXPORT void PICNIC_CALLING_CONVENTION picnic_executor_destroy(picnic_executor_t* executor);
+
+/**
+ * Submit a job signing job->message with job->sk into job->signature. Behaves like picnic_sign(),
+ * including the use of presigning pools.
+ *
+ * @param[in] executor The executor.
+ * @param[in] job      The job; its fields up to opaque have to be set.
+ * @param[in] callback The function invoked once the job is completed.
+ *
+ * @return Returns 0 on success, or a nonzero value if the arguments are invalid or the executor is
+ * being destroyed.
+ */
+PICNIC_EXPORT int PICNIC_CALLING_CONVENTION picnic_submit_sign(picnic_executor_t* executor,
+                                                                picnic_job_t* job,
+                                                                picnic_job_callback_t callback);
+
+/**
+ * Submit a job verifying job->signature on job->message with job->pk. Behaves like picnic_verify().
+ *
+ * @param[in] executor The executor.
+ * @param[in] job      The job; its fields up to opaque have to be set.
+ * @param[in] callback The function invoked once the job is completed.
+ *
+ * @return Returns 0 on success, or a nonzero value if the arguments are invalid or the executor is
+ * being destroyed.
+ */
+PICNIC_EXPORT int PICNIC_CALLING_CONVENTION picnic_submit_verify(picnic_executor_t* executor,
+                                                                  picnic_job_t* job,
+                                                                  picnic_job_callback_t callback);
+
+/**
+ * Get a file descriptor that becomes readable once jobs are completed, e.g., to wait for it with
+ * poll() or epoll. The descriptor is an eventfd where available, and a pipe otherwise. It is owned
+ * by the executor and must only be read by picnic_executor_dispatch().
+ *
+ * @param[in] executor The executor.
+ *
+ * @return Returns the file descriptor, or -1 if executor is NULL.
+ */
+PICNIC_EXPORT int PICNIC_CALLING_CONVENTION picnic_executor_fd(const picnic_executor_t* executor);
+
+/**
+ * Invoke the callbacks of all completed jobs on the calling thread, in the order of their
+ * completion. The callbacks may submit new jobs. Must not be called by multiple threads at the
+ * same time.
+ *
+ * @param[in] executor The executor.
+ *
+ * @return Returns the number of invoked callbacks.
+ */
+PICNIC_EXPORT size_t PICNIC_CALLING_CONVENTION
+picnic_executor_dispatch(picnic_executor_t* executor);
+
+/* Statistics API */
+
+/** Phases of signing and verification tracked by the statistics API */
+typedef enum {
+  /* derivation of seeds and seed trees */
+  PICNIC_STATS_SEEDS,
+  /* KDF initialization, input share and random tape generation */
+  PICNIC_STATS_TAPES,
+  /* LowMC evaluation and MPC simulation */
+  PICNIC_STATS_MPC,
+  /* compression and decompression of views and output shares */
+  PICNIC_STATS_VIEWS,
+  /* commitments, Unruh's G and Merkle trees */
+  PICNIC_STATS_COMMITMENTS,
+  /* challenge computation (H3) */
+  PICNIC_STATS_CHALLENGE,
+  /* (de)serialization of signatures */
+  PICNIC_STATS_SERIALIZATION,
+  PICNIC_STATS_MAX
+} picnic_stats_phase_t;
+
+/** Accumulated time and number of measurements of one phase */
+typedef struct {
+  uint64_t ticks;
+  uint64_t calls;
+} picnic_stats_entry_t;
+
+/** Statistics of all phases */
+typedef struct {
+  picnic_stats_entry_t phases[PICNIC_STATS_MAX];
+} picnic_stats_t;
+
+/**
+ * Get the per-phase statistics accumulated by the calling thread.
+ *
+ * Statistics are only collected if the library was built with WITH_STATS. Time is measured in
+ * ticks of the CPU's timestamp counter if available, otherwise in nanoseconds.
+ *
+ * @param[out] stats The statistics to be populated
+ *
+ * @return Returns 0 on success, or a nonzero value if statistics are not available.
+ *
+ * @see picnic_stats_reset()
+ */
+PICNIC_EXPORT int PICNIC_CALLING_CONVENTION picnic_stats_get(picnic_stats_t* stats);
+
+/**
+ * Reset the per-phase statistics of the calling thread.
+ */
+PICNIC_EXPORT void PICNIC_CALLING_CONVENTION picnic_stats_reset(void);
+
+/**
+ * Get a string representation of a phase.
+ *
+ * @param phase A phase
+ *
+ * @return A null-terminated string describing the phase.
+ */
+PICNIC_EXPORT const char* PICNIC_CALLING_CONVENTION
+picnic_stats_get_phase_name(picnic_stats_phase_t phase);
+
 #ifdef __cplusplus
 }
 #endif
@@ -21,6 +21,8 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "allocator.h"
+#include "hash_jobs.h"
 #include "io.h"
 #include "kdf_shake.h"
 #include "macros.h"
@@ -28,6 +30,8 @@
 #include "picnic3_impl.h"
 #include "picnic3_tree.h"
 #include "picnic3_types.h"
+#include "picnic_stats.h"
+#include "randomness.h"
 
 /* Helper functions */
 
@@ -98,21 +102,30 @@ static void computeAuxTape(randomTape_t* tapes, uint8_t* input_masks,
   tapes->pos = 0;
 }
 
-static void commit(uint8_t* digest, const uint8_t* seed, const uint8_t* aux, const uint8_t* salt,
-                   size_t t, size_t j, const picnic_instance_t* params) {
-  /* Compute C[t][j];  as digest = H(seed||[aux]) aux is optional */
-  hash_context ctx;
+/* Compute C[t][j] as digest = H(seed||[aux]||salt||t||j) in a queue, aux is optional */
+static void commit_queue_init(hash_queue_t* queue, bool with_aux, const picnic_instance_t* params) {
+  hash_queue_init(queue, params->digest_size, params->digest_size);
+  hash_queue_add_input(queue, params->seed_size);
+  if (with_aux) {
+    hash_queue_add_input(queue, params->view_size);
+  }
+  hash_queue_add_input(queue, SALT_SIZE);
+  hash_queue_add_input(queue, HASH_INPUT_UINT16);
+  hash_queue_add_input(queue, HASH_INPUT_UINT16);
+}
 
-  hash_init(&ctx, params->digest_size);
-  hash_update(&ctx, seed, params->seed_size);
+/* aux has to be given iff the queue was initialized with aux */
+static void commit_enqueue(hash_queue_t* queue, uint8_t* digest, const uint8_t* seed,
+                           const uint8_t* aux, const uint8_t* salt, size_t t, size_t j) {
+  hash_job_t* job = hash_queue_push(queue, digest);
+  unsigned int k  = 0;
+  job->data[k++]  = seed;
   if (aux != NULL) {
-    hash_update(&ctx, aux, params->view_size);
+    job->data[k++] = aux;
   }
-  hash_update(&ctx, salt, SALT_SIZE);
-  hash_update_uint16_le(&ctx, t);
-  hash_update_uint16_le(&ctx, j);
-  hash_final(&ctx);
-  hash_squeeze(&ctx, digest, params->digest_size);
+  job->data[k++]   = salt;
+  job->values[k++] = t;
+  job->values[k]   = j;
 }
 
 static void commit_x4(uint8_t** digest, const uint8_t** seed, const uint8_t* salt, size_t t,
@@ -274,7 +287,7 @@ static void expandChallenge(uint16_t* challengeC, uint16_t* challengeP, const ui
   uint32_t bitsPerChunkC = ceil_log2(params->num_rounds);
   uint32_t bitsPerChunkP = ceil_log2(params->num_MPC_parties);
   uint16_t* chunks =
-      calloc(params->digest_size * 8 / MIN(bitsPerChunkP, bitsPerChunkC), sizeof(uint16_t));
+      picnic_calloc(params->digest_size * 8 / MIN(bitsPerChunkP, bitsPerChunkC), sizeof(uint16_t));
 
   size_t countC = 0;
   while (countC < params->num_opened_rounds) {
@@ -314,7 +327,7 @@ static void expandChallenge(uint16_t* challengeC, uint16_t* challengeP, const ui
     hash_final(&ctx);
     hash_squeeze(&ctx, h, params->digest_size);
   }
-  free(chunks);
+  picnic_free(chunks);
 }
 
 static void HCP(uint8_t* sigH, uint16_t* challengeC, uint16_t* challengeP, commitments_t* Ch,
@@ -342,7 +355,7 @@ static void HCP(uint8_t* sigH, uint16_t* challengeC, uint16_t* challengeP, commi
 
 static uint16_t* getMissingLeavesList(uint16_t* challengeC, const picnic_instance_t* params) {
   size_t missingLeavesSize = params->num_rounds - params->num_opened_rounds;
-  uint16_t* missingLeaves  = calloc(missingLeavesSize, sizeof(uint16_t));
+  uint16_t* missingLeaves  = picnic_calloc(missingLeavesSize, sizeof(uint16_t));
   size_t pos               = 0;
 
   for (size_t i = 0; i < params->num_rounds; i++) {
@@ -355,161 +368,241 @@ static uint16_t* getMissingLeavesList(uint16_t* challengeC, const picnic_instanc
   return missingLeaves;
 }
 
-static int verify_picnic3(signature2_t* sig, const uint8_t* pubKey, const uint8_t* plaintext,
-                          const uint8_t* message, size_t messageByteLength,
-                          const picnic_instance_t* params) {
+/* state of a verification, see verifyBegin */
+typedef struct {
+  signature2_t* sig;
   commitments_t C[4];
-  allocateCommitments2(&C[0], params, params->num_MPC_parties);
-  allocateCommitments2(&C[1], params, params->num_MPC_parties);
-  allocateCommitments2(&C[2], params, params->num_MPC_parties);
-  allocateCommitments2(&C[3], params, params->num_MPC_parties);
-  msgs_t* msgs              = allocateMsgsVerify(params);
-  tree_t* treeCv            = createTree(params->num_rounds, params->digest_size);
-  size_t challengeSizeBytes = params->num_opened_rounds * sizeof(uint16_t);
-  uint16_t* challengeC      = malloc(challengeSizeBytes);
-  uint16_t* challengeP      = malloc(challengeSizeBytes);
-  uint8_t challenge[MAX_DIGEST_SIZE];
-  randomTape_t* tapes = malloc(params->num_rounds * sizeof(randomTape_t));
-  tree_t* iSeedsTree  = createTree(params->num_rounds, params->seed_size);
-  int ret = reconstructSeeds(iSeedsTree, sig->challengeC, params->num_opened_rounds, sig->iSeedInfo,
-                             sig->iSeedInfoLen, sig->salt, 0, params);
-  const size_t last                      = params->num_MPC_parties - 1;
-  lowmc_simulate_online_f simulateOnline = params->impls.lowmc_simulate_online;
-
+  msgs_t* msgs;
+  randomTape_t* tapes;
+  /* number of rounds with random tapes */
+  size_t num_tapes;
+  tree_t* iSeedsTree;
+  /* the seeds are kept until the queued commitments of the last party are computed */
+  tree_t* seeds[4];
+  /* commitments of the last party, which are not covered by commit_x4, batched over 4 rounds */
+  hash_queue_t last_commits;
   commitments_t Ch;
-  allocateCommitments2(&Ch, params, params->num_rounds);
   commitments_t Cv;
-  allocateCommitments2(&Cv, params, params->num_rounds);
-  mzd_local_t m_plaintext[1];
-  mzd_local_t m_maskedKey[1];
-  mzd_from_char_array(m_plaintext, plaintext, params->output_size);
+} verify_state_t;
+
+static void verifyFree(verify_state_t* state) {
+  for (size_t t = 0; t < state->num_tapes; t++) {
+    freeRandomTape(&state->tapes[t]);
+  }
 
+  for (size_t i = 0; i < 4; i++) {
+    freeTree(state->seeds[i]);
+  }
+  freeCommitments2(&state->Cv);
+  freeCommitments2(&state->Ch);
+  freeTree(state->iSeedsTree);
+  picnic_free(state->tapes);
+  freeMsgs(state->msgs);
+  freeCommitments2(&state->C[3]);
+  freeCommitments2(&state->C[2]);
+  freeCommitments2(&state->C[1]);
+  freeCommitments2(&state->C[0]);
+  picnic_free(state);
+}
+
+/* Set up the verification of sig. Returns NULL if the initial seeds cannot be reconstructed. */
+static verify_state_t* verifyBegin(signature2_t* sig, const picnic_instance_t* params) {
+  verify_state_t* state = picnic_calloc(1, sizeof(verify_state_t));
+  if (!state) {
+    return NULL;
+  }
+
+  state->sig = sig;
+  allocateCommitments2(&state->C[0], params, params->num_MPC_parties);
+  allocateCommitments2(&state->C[1], params, params->num_MPC_parties);
+  allocateCommitments2(&state->C[2], params, params->num_MPC_parties);
+  allocateCommitments2(&state->C[3], params, params->num_MPC_parties);
+  state->msgs       = allocateMsgsVerify(params);
+  state->tapes      = picnic_malloc(params->num_rounds * sizeof(randomTape_t));
+  state->iSeedsTree = createTree(params->num_rounds, params->seed_size);
+  commit_queue_init(&state->last_commits, true, params);
+  allocateCommitments2(&state->Ch, params, params->num_rounds);
+  allocateCommitments2(&state->Cv, params, params->num_rounds);
+
+  STATS_TIMER(stats_timer);
+  const int ret = reconstructSeeds(state->iSeedsTree, sig->challengeC, params->num_opened_rounds,
+                                   sig->iSeedInfo, sig->iSeedInfoLen, sig->salt, 0, params);
+  STATS_RECORD(stats_timer, SEEDS);
   if (ret != 0) {
-    ret = -1;
-    goto Exit;
+    verifyFree(state);
+    return NULL;
   }
+  return state;
+}
 
-  /* Populate seeds with values from the signature */
-  for (size_t t = 0; t < params->num_rounds; t++) {
-    tree_t* seed = NULL;
-    if (!contains(sig->challengeC, params->num_opened_rounds, t)) {
-      /* Expand iSeed[t] to seeds for each parties, using a seed tree */
-      seed = generateSeeds(params->num_MPC_parties, getLeaf(iSeedsTree, t), sig->salt, t, params);
-    } else {
-      /* We don't have the initial seed for the round, but instead a seed
-       * for each unopened party */
-      seed           = createTree(params->num_MPC_parties, params->seed_size);
-      size_t P_index = indexOf(sig->challengeC, params->num_opened_rounds, t);
-      uint16_t hideList[1];
-      hideList[0] = sig->challengeP[P_index];
-      ret = reconstructSeeds(seed, hideList, 1, sig->proofs[t].seedInfo, sig->proofs[t].seedInfoLen,
-                             sig->salt, t, params);
-      if (ret != 0) {
+/* Recompute the commitments of round t */
+static int verifyRound(verify_state_t* state, size_t t, const picnic_instance_t* params) {
+  signature2_t* sig   = state->sig;
+  commitments_t* C    = state->C;
+  randomTape_t* tapes = state->tapes;
+  const size_t last   = params->num_MPC_parties - 1;
+
+  STATS_TIMER(stats_timer);
+  tree_t* seed = NULL;
+  if (!contains(sig->challengeC, params->num_opened_rounds, t)) {
+    /* Expand iSeed[t] to seeds for each parties, using a seed tree */
+    seed = generateSeeds(params->num_MPC_parties, getLeaf(state->iSeedsTree, t), sig->salt, t,
+                         params);
+  } else {
+    /* We don't have the initial seed for the round, but instead a seed
+     * for each unopened party */
+    seed           = createTree(params->num_MPC_parties, params->seed_size);
+    size_t P_index = indexOf(sig->challengeC, params->num_opened_rounds, t);
+    uint16_t hideList[1];
+    hideList[0] = sig->challengeP[P_index];
+    int ret = reconstructSeeds(seed, hideList, 1, sig->proofs[t].seedInfo, sig->proofs[t].seedInfoLen,
+                               sig->salt, t, params);
+    if (ret != 0) {
 #if !defined(NDEBUG)
-        printf("Failed to reconstruct seeds for round " SIZET_FMT "\n", t);
+      printf("Failed to reconstruct seeds for round " SIZET_FMT "\n", t);
 #endif
-        freeTree(seed);
-        ret = -1;
-        goto Exit;
-      }
+      freeTree(seed);
+      return -1;
     }
-    /* Commit */
-
-    /* Compute random tapes for all parties.  One party for each repitition
-     * challengeC will have a bogus seed; but we won't use that party's
-     * random tape. */
-    createRandomTapes(&tapes[t], getLeaves(seed), sig->salt, t, params);
-
-    if (!contains(sig->challengeC, params->num_opened_rounds, t)) {
-      /* We're given iSeed, have expanded the seeds, compute aux from scratch so we can comnpte
-       * Com[t] */
-      computeAuxTape(&tapes[t], NULL, params);
-      for (size_t j = 0; j < params->num_MPC_parties; j += 4) {
-        const uint8_t* seed_ptr[4] = {getLeaf(seed, j + 0), getLeaf(seed, j + 1),
-                                      getLeaf(seed, j + 2), getLeaf(seed, j + 3)};
-        commit_x4(C[t % 4].hashes + j, seed_ptr, sig->salt, t, j, params);
-      }
-      commit(C[t % 4].hashes[last], getLeaf(seed, last), tapes[t].aux_bits, sig->salt, t, last,
-             params);
-      /* after we have checked the tape, we do not need it anymore for this opened iteration */
-    } else {
-      /* We're given all seeds and aux bits, execpt for the unopened
-       * party, we get their commitment */
-      size_t unopened = sig->challengeP[indexOf(sig->challengeC, params->num_opened_rounds, t)];
-      for (size_t j = 0; j < params->num_MPC_parties; j += 4) {
-        const uint8_t* seed_ptr[4] = {getLeaf(seed, j + 0), getLeaf(seed, j + 1),
-                                      getLeaf(seed, j + 2), getLeaf(seed, j + 3)};
-        commit_x4(C[t % 4].hashes + j, seed_ptr, sig->salt, t, j, params);
-      }
-      if (last != unopened) {
-        commit(C[t % 4].hashes[last], getLeaf(seed, last), sig->proofs[t].aux, sig->salt, t, last,
-               params);
-      }
-
-      memcpy(C[t % 4].hashes[unopened], sig->proofs[t].C, params->digest_size);
+  }
+  state->seeds[t % 4] = seed;
+  STATS_RECORD(stats_timer, SEEDS);
+  /* Commit */
+
+  /* Compute random tapes for all parties.  One party for each repitition
+   * challengeC will have a bogus seed; but we won't use that party's
+   * random tape. */
+  createRandomTapes(&tapes[t], getLeaves(seed), sig->salt, t, params);
+  state->num_tapes = t + 1;
+  STATS_RECORD(stats_timer, TAPES);
+
+  if (!contains(sig->challengeC, params->num_opened_rounds, t)) {
+    /* We're given iSeed, have expanded the seeds, compute aux from scratch so we can comnpte
+     * Com[t] */
+    computeAuxTape(&tapes[t], NULL, params);
+    STATS_RECORD(stats_timer, MPC);
+    for (size_t j = 0; j < params->num_MPC_parties; j += 4) {
+      const uint8_t* seed_ptr[4] = {getLeaf(seed, j + 0), getLeaf(seed, j + 1),
+                                    getLeaf(seed, j + 2), getLeaf(seed, j + 3)};
+      commit_x4(C[t % 4].hashes + j, seed_ptr, sig->salt, t, j, params);
     }
-    /* hash commitments every four iterations if possible, for the last few do single commitments
-     */
-    if (t >= params->num_rounds / 4 * 4) {
-      commit_h(Ch.hashes[t], &C[t % 4], params);
-    } else if ((t + 1) % 4 == 0) {
-      size_t t4 = t / 4 * 4;
-      commit_h_x4(&Ch.hashes[t4], &C[0], params);
+    commit_enqueue(&state->last_commits, C[t % 4].hashes[last], getLeaf(seed, last),
+                   tapes[t].aux_bits, sig->salt, t, last);
+    /* after we have checked the tape, we do not need it anymore for this opened iteration */
+  } else {
+    /* We're given all seeds and aux bits, execpt for the unopened
+     * party, we get their commitment */
+    size_t unopened = sig->challengeP[indexOf(sig->challengeC, params->num_opened_rounds, t)];
+    for (size_t j = 0; j < params->num_MPC_parties; j += 4) {
+      const uint8_t* seed_ptr[4] = {getLeaf(seed, j + 0), getLeaf(seed, j + 1),
+                                    getLeaf(seed, j + 2), getLeaf(seed, j + 3)};
+      commit_x4(C[t % 4].hashes + j, seed_ptr, sig->salt, t, j, params);
+    }
+    if (last != unopened) {
+      commit_enqueue(&state->last_commits, C[t % 4].hashes[last], getLeaf(seed, last),
+                     sig->proofs[t].aux, sig->salt, t, last);
     }
-    freeTree(seed);
-  }
 
-  /* Commit to the views */
-  for (size_t t = 0; t < params->num_rounds; t++) {
-    if (!contains(sig->challengeC, params->num_opened_rounds, t)) {
-      Cv.hashes[t] = NULL;
+    memcpy(C[t % 4].hashes[unopened], sig->proofs[t].C, params->digest_size);
+  }
+  /* hash commitments every four iterations if possible, for the last few do single commitments
+   */
+  if (t >= params->num_rounds / 4 * 4) {
+    hash_queue_flush(&state->last_commits);
+    commit_h(state->Ch.hashes[t], &C[t % 4], params);
+    freeTree(seed);
+    state->seeds[t % 4] = NULL;
+  } else if ((t + 1) % 4 == 0) {
+    hash_queue_flush(&state->last_commits);
+    size_t t4 = t / 4 * 4;
+    commit_h_x4(&state->Ch.hashes[t4], &C[0], params);
+    for (size_t i = 0; i < 4; i++) {
+      freeTree(state->seeds[i]);
+      state->seeds[i] = NULL;
     }
   }
+  STATS_RECORD(stats_timer, COMMITMENTS);
+  return 0;
+}
 
-  for (size_t i = 0; i < params->num_opened_rounds; i++) {
-    /* 2. When t is in C, we have everything we need to re-compute the view, as an honest signer
-     * would.
-     * We simulate the MPC with one fewer party; the unopned party's values are all set to zero.
-     */
-    size_t t       = sig->challengeC[i];
-    int unopened   = sig->challengeP[i];
-    uint8_t* input = sig->proofs[t].input;
-    setAuxBits(&tapes[t], sig->proofs[t].aux, params);
-    memset(tapes[t].tape[unopened], 0, 2 * params->view_size);
-    memcpy(msgs->msgs[unopened], sig->proofs[t].msgs, params->view_size);
-    mzd_from_char_array(m_maskedKey, input, params->input_size);
-    msgs->unopened = unopened;
-    msgs->pos      = 0;
-    ret            = simulateOnline(m_maskedKey, &tapes[t], msgs, m_plaintext, pubKey, params);
+/* Simulate the online phase of the i-th opened round and commit to its views */
+static int verifyOnline(verify_state_t* state, size_t i, const uint8_t* pubKey,
+                        const uint8_t* plaintext, const picnic_instance_t* params) {
+  signature2_t* sig = state->sig;
+  msgs_t* msgs      = state->msgs;
+  mzd_local_t m_plaintext[1];
+  mzd_local_t m_maskedKey[1];
+  mzd_from_char_array(m_plaintext, plaintext, params->output_size);
 
-    if (ret != 0) {
+  /* 2. When t is in C, we have everything we need to re-compute the view, as an honest signer
+   * would.
+   * We simulate the MPC with one fewer party; the unopned party's values are all set to zero.
+   */
+  STATS_TIMER(stats_timer);
+  size_t t       = sig->challengeC[i];
+  int unopened   = sig->challengeP[i];
+  uint8_t* input = sig->proofs[t].input;
+  setAuxBits(&state->tapes[t], sig->proofs[t].aux, params);
+  memset(state->tapes[t].tape[unopened], 0, 2 * params->view_size);
+  memcpy(msgs->msgs[unopened], sig->proofs[t].msgs, params->view_size);
+  mzd_from_char_array(m_maskedKey, input, params->input_size);
+  msgs->unopened = unopened;
+  msgs->pos      = 0;
+  int ret = params->impls.lowmc_simulate_online(m_maskedKey, &state->tapes[t], msgs, m_plaintext,
+                                                pubKey, params);
+  STATS_RECORD(stats_timer, MPC);
+
+  if (ret != 0) {
 #if !defined(NDEBUG)
-      printf("MPC simulation failed for round " SIZET_FMT ", signature invalid\n", i);
+    printf("MPC simulation failed for round " SIZET_FMT ", signature invalid\n", i);
 #endif
-      ret = -1;
-      goto Exit;
+    return -1;
+  }
+  commit_v(state->Cv.hashes[t], sig->proofs[t].input, msgs, params);
+  STATS_RECORD(stats_timer, COMMITMENTS);
+  return 0;
+}
+
+/* Check the commitments to the views and recompute the challenge once all rounds are done */
+static int verifyChallenge(verify_state_t* state, const uint8_t* pubKey, const uint8_t* plaintext,
+                           const uint8_t* message, size_t messageByteLength,
+                           const picnic_instance_t* params) {
+  signature2_t* sig         = state->sig;
+  tree_t* treeCv            = createTree(params->num_rounds, params->digest_size);
+  size_t challengeSizeBytes = params->num_opened_rounds * sizeof(uint16_t);
+  uint16_t* challengeC      = picnic_malloc(challengeSizeBytes);
+  uint16_t* challengeP      = picnic_malloc(challengeSizeBytes);
+  uint8_t challenge[MAX_DIGEST_SIZE];
+  int ret;
+
+  /* Commit to the views */
+  for (size_t t = 0; t < params->num_rounds; t++) {
+    if (!contains(sig->challengeC, params->num_opened_rounds, t)) {
+      state->Cv.hashes[t] = NULL;
     }
-    commit_v(Cv.hashes[t], sig->proofs[t].input, msgs, params);
   }
 
+  STATS_TIMER(stats_timer);
   size_t missingLeavesSize = params->num_rounds - params->num_opened_rounds;
   uint16_t* missingLeaves  = getMissingLeavesList(sig->challengeC, params);
   ret = addMerkleNodes(treeCv, missingLeaves, missingLeavesSize, sig->cvInfo, sig->cvInfoLen);
-  free(missingLeaves);
+  picnic_free(missingLeaves);
   if (ret != 0) {
     ret = -1;
     goto Exit;
   }
 
-  ret = verifyMerkleTree(treeCv, Cv.hashes, sig->salt, params);
+  ret = verifyMerkleTree(treeCv, state->Cv.hashes, sig->salt, params);
   if (ret != 0) {
     ret = -1;
     goto Exit;
   }
+  STATS_RECORD(stats_timer, COMMITMENTS);
 
   /* Compute the challenge; two lists of integers */
-  HCP(challenge, challengeC, challengeP, &Ch, treeCv->nodes[0], sig->salt, pubKey, plaintext,
-      message, messageByteLength, params);
+  HCP(challenge, challengeC, challengeP, &state->Ch, treeCv->nodes[0], sig->salt, pubKey,
+      plaintext, message, messageByteLength, params);
+  STATS_RECORD(stats_timer, CHALLENGE);
 
   /* Compare to challenge from signature */
   if (memcmp(sig->challenge, challenge, params->digest_size) != 0) {
@@ -523,23 +616,33 @@ static int verify_picnic3(signature2_t* sig, const uint8_t* pubKey, const uint8_
   ret = EXIT_SUCCESS;
 
 Exit:
-  for (size_t t = 0; t < params->num_rounds; t++) {
-    freeRandomTape(&tapes[t]);
+  picnic_free(challengeP);
+  picnic_free(challengeC);
+  freeTree(treeCv);
+  return ret;
+}
+
+static int verify_picnic3(signature2_t* sig, const uint8_t* pubKey, const uint8_t* plaintext,
+                          const uint8_t* message, size_t messageByteLength,
+                          const picnic_instance_t* params) {
+  verify_state_t* state = verifyBegin(sig, params);
+  if (!state) {
+    return -1;
   }
 
-  freeCommitments2(&Cv);
-  freeCommitments2(&Ch);
-  freeTree(iSeedsTree);
-  free(tapes);
-  free(challengeP);
-  free(challengeC);
-  freeTree(treeCv);
-  freeMsgs(msgs);
-  freeCommitments2(&C[3]);
-  freeCommitments2(&C[2]);
-  freeCommitments2(&C[1]);
-  freeCommitments2(&C[0]);
+  int ret = 0;
+  /* Populate seeds with values from the signature */
+  for (size_t t = 0; !ret && t < params->num_rounds; t++) {
+    ret = verifyRound(state, t, params);
+  }
+  for (size_t i = 0; !ret && i < params->num_opened_rounds; i++) {
+    ret = verifyOnline(state, i, pubKey, plaintext, params);
+  }
+  if (!ret) {
+    ret = verifyChallenge(state, pubKey, plaintext, message, messageByteLength, params);
+  }
 
+  verifyFree(state);
   return ret;
 }
 
@@ -559,115 +662,237 @@ static void computeSaltAndRootSeed(uint8_t* saltAndRoot, size_t saltAndRootLengt
   hash_squeeze(&ctx, saltAndRoot, saltAndRootLength);
 }
 
-static int sign_picnic3(const uint8_t* privateKey, const uint8_t* pubKey, const uint8_t* plaintext,
-                        const uint8_t* message, size_t messageByteLength, signature2_t* sig,
-                        const picnic_instance_t* params) {
-  int ret              = 0;
-  uint8_t* saltAndRoot = malloc(params->seed_size + SALT_SIZE);
+/* message independent part of a signature */
+typedef struct {
+  uint8_t salt[SALT_SIZE];
+  tree_t* iSeedsTree;
+  tree_t** seeds;
+  randomTape_t* tapes;
+  inputs_t inputs;
+  msgs_t* msgs;
+  commitments_t* C;
+  /* commitments of the last party, which are not covered by commit_x4, batched over all rounds */
+  hash_queue_t last_commits;
+  /* commitments to the commitments */
+  commitments_t Ch;
+  /* commitments to the views, only until the Merkle tree is built */
+  commitments_t Cv;
+  /* Merkle tree of the commitments to the views */
+  tree_t* treeCv;
+} transcript_t;
 
-  computeSaltAndRootSeed(saltAndRoot, params->seed_size + SALT_SIZE, privateKey, pubKey, plaintext,
-                         message, messageByteLength, params);
-  memcpy(sig->salt, saltAndRoot, SALT_SIZE);
-  tree_t* iSeedsTree =
-      generateSeeds(params->num_rounds, saltAndRoot + SALT_SIZE, sig->salt, 0, params);
-  uint8_t** iSeeds = getLeaves(iSeedsTree);
-  free(saltAndRoot);
+static void freeTranscript(transcript_t* transcript, const picnic_instance_t* params) {
+  freeTree(transcript->treeCv);
+  for (size_t t = 0; t < params->num_rounds; t++) {
+    freeRandomTape(&transcript->tapes[t]);
+    freeTree(transcript->seeds[t]);
+  }
+  freeCommitments2(&transcript->Cv);
+  freeCommitments2(&transcript->Ch);
+  freeMsgs(transcript->msgs);
+  freeInputs(transcript->inputs);
+  freeCommitments(transcript->C);
+  picnic_free(transcript->seeds);
+  picnic_free(transcript->tapes);
+  freeTree(transcript->iSeedsTree);
+  picnic_free(transcript);
+}
 
-  randomTape_t* tapes = malloc(params->num_rounds * sizeof(randomTape_t));
-  tree_t** seeds      = malloc(params->num_rounds * sizeof(tree_t*));
-  commitments_t* C    = allocateCommitments(params, 0);
+/* Allocate a transcript; saltAndRoot holds the salt followed by the root seed. The tapes and seeds
+ * are cleared so that a transcript can be released before all rounds are preprocessed. */
+static transcript_t* newTranscript(uint8_t* saltAndRoot, const picnic_instance_t* params) {
+  transcript_t* transcript = picnic_calloc(1, sizeof(transcript_t));
+  if (!transcript) {
+    return NULL;
+  }
+
+  STATS_TIMER(stats_timer);
+  memcpy(transcript->salt, saltAndRoot, SALT_SIZE);
+  transcript->iSeedsTree =
+      generateSeeds(params->num_rounds, saltAndRoot + SALT_SIZE, transcript->salt, 0, params);
+  STATS_RECORD(stats_timer, SEEDS);
 
-  lowmc_simulate_online_f simulateOnline = params->impls.lowmc_simulate_online;
-  inputs_t inputs                        = allocateInputs(params);
-  msgs_t* msgs                           = allocateMsgs(params);
+  transcript->tapes  = picnic_calloc(params->num_rounds, sizeof(randomTape_t));
+  transcript->seeds  = picnic_calloc(params->num_rounds, sizeof(tree_t*));
+  transcript->C      = allocateCommitments(params, 0);
+  transcript->inputs = allocateInputs(params);
+  transcript->msgs   = allocateMsgs(params);
+  commit_queue_init(&transcript->last_commits, true, params);
 
   /* Commitments to the commitments and views */
-  commitments_t Ch;
-  allocateCommitments2(&Ch, params, params->num_rounds);
-  commitments_t Cv;
-  allocateCommitments2(&Cv, params, params->num_rounds);
+  allocateCommitments2(&transcript->Ch, params, params->num_rounds);
+  allocateCommitments2(&transcript->Cv, params, params->num_rounds);
+  return transcript;
+}
+
+/* Preprocessing of round t; the commitments of the last party are computed after the last round */
+static void preprocessRound(transcript_t* transcript, size_t t, const picnic_instance_t* params) {
+  tree_t** seeds      = transcript->seeds;
+  randomTape_t* tapes = transcript->tapes;
+  commitments_t* C    = transcript->C;
+  uint8_t* salt       = transcript->salt;
+
+  STATS_TIMER(stats_timer);
+  seeds[t] = generateSeeds(params->num_MPC_parties, getLeaf(transcript->iSeedsTree, t), salt, t,
+                           params);
+  STATS_RECORD(stats_timer, SEEDS);
+  createRandomTapes(&tapes[t], getLeaves(seeds[t]), salt, t, params);
+  STATS_RECORD(stats_timer, TAPES);
+  /* Preprocessing; compute aux tape for the N-th player, for each parallel rep */
+  computeAuxTape(&tapes[t], transcript->inputs[t], params);
+  STATS_RECORD(stats_timer, MPC);
+  /* Commit to seeds and aux bits */
+  assert(params->num_MPC_parties % 4 == 0);
+  for (size_t j = 0; j < params->num_MPC_parties; j += 4) {
+    const uint8_t* seed_ptr[4] = {getLeaf(seeds[t], j + 0), getLeaf(seeds[t], j + 1),
+                                  getLeaf(seeds[t], j + 2), getLeaf(seeds[t], j + 3)};
+    commit_x4(C[t].hashes + j, seed_ptr, salt, t, j, params);
+  }
+  const size_t last = params->num_MPC_parties - 1;
+  commit_enqueue(&transcript->last_commits, C[t].hashes[last], getLeaf(seeds[t], last),
+                 tapes[t].aux_bits, salt, t, last);
+  if (t == params->num_rounds - 1) {
+    hash_queue_flush(&transcript->last_commits);
+  }
+  STATS_RECORD(stats_timer, COMMITMENTS);
+}
 
+/* Simulate the online phase of the MPC in round t */
+static int simulateRound(transcript_t* transcript, size_t t, const uint8_t* privateKey,
+                         const uint8_t* pubKey, const uint8_t* plaintext,
+                         const picnic_instance_t* params) {
+  randomTape_t* tapes = transcript->tapes;
   mzd_local_t m_plaintext[1];
   mzd_local_t m_maskedKey[1];
 
+  STATS_TIMER(stats_timer);
   mzd_from_char_array(m_plaintext, plaintext, params->output_size);
+  uint8_t* maskedKey = transcript->inputs[t];
 
-  for (size_t t = 0; t < params->num_rounds; t++) {
-    seeds[t] = generateSeeds(params->num_MPC_parties, iSeeds[t], sig->salt, t, params);
-    createRandomTapes(&tapes[t], getLeaves(seeds[t]), sig->salt, t, params);
-    /* Preprocessing; compute aux tape for the N-th player, for each parallel rep */
-    computeAuxTape(&tapes[t], inputs[t], params);
-    /* Commit to seeds and aux bits */
-    assert(params->num_MPC_parties % 4 == 0);
-    for (size_t j = 0; j < params->num_MPC_parties; j += 4) {
-      const uint8_t* seed_ptr[4] = {getLeaf(seeds[t], j + 0), getLeaf(seeds[t], j + 1),
-                                    getLeaf(seeds[t], j + 2), getLeaf(seeds[t], j + 3)};
-      commit_x4(C[t].hashes + j, seed_ptr, sig->salt, t, j, params);
-    }
-    const size_t last = params->num_MPC_parties - 1;
-    commit(C[t].hashes[last], getLeaf(seeds[t], last), tapes[t].aux_bits, sig->salt, t, last,
-           params);
+  xor_byte_array(maskedKey, maskedKey, privateKey,
+                 params->input_size); // maskedKey += privateKey
+  for (size_t i = params->lowmc.n; i < params->input_size * 8; i++) {
+    setBit(maskedKey, i, 0);
+  }
+  mzd_from_char_array(m_maskedKey, maskedKey, params->input_size);
+
+  int rv = params->impls.lowmc_simulate_online(m_maskedKey, &tapes[t], &transcript->msgs[t],
+                                               m_plaintext, pubKey, params);
+  /* Only the aux bits of the random tapes are needed to open the transcript */
+  picnic_free(tapes[t].tape[0]);
+  picnic_free(tapes[t].parity_tapes);
+  tapes[t].tape[0]      = NULL;
+  tapes[t].parity_tapes = NULL;
+  STATS_RECORD(stats_timer, MPC);
+  if (rv != 0) {
+#if !defined(NDEBUG)
+    printf("MPC simulation failed in round " SIZET_FMT ", aborting signature\n", t);
+#endif
+    return -1;
   }
+  return 0;
+}
 
-  for (size_t t = 0; t < params->num_rounds; t++) {
-    /* Simulate the online phase of the MPC */
-    uint8_t* maskedKey = inputs[t];
+/* Commit to the commitments and views of the rounds t to t + 3, or only of round t for the last few
+ * rounds */
+static void commitRounds(transcript_t* transcript, size_t t, const picnic_instance_t* params) {
+  STATS_TIMER(stats_timer);
+  if (t + 4 <= params->num_rounds) {
+    commit_h_x4(&transcript->Ch.hashes[t], &transcript->C[t], params);
+    commit_v_x4(&transcript->Cv.hashes[t], (const uint8_t**)&transcript->inputs[t],
+                &transcript->msgs[t], params);
+  } else {
+    commit_h(transcript->Ch.hashes[t], &transcript->C[t], params);
+    commit_v(transcript->Cv.hashes[t], transcript->inputs[t], &transcript->msgs[t], params);
+  }
+  STATS_RECORD(stats_timer, COMMITMENTS);
+}
 
-    xor_byte_array(maskedKey, maskedKey, privateKey,
-                   params->input_size); // maskedKey += privateKey
-    for (size_t i = params->lowmc.n; i < params->input_size * 8; i++) {
-      setBit(maskedKey, i, 0);
-    }
-    mzd_from_char_array(m_maskedKey, maskedKey, params->input_size);
+/* Create a Merkle tree with Cv as the leaves */
+static void buildCvTree(transcript_t* transcript, const picnic_instance_t* params) {
+  STATS_TIMER(stats_timer);
+  transcript->treeCv = createTree(params->num_rounds, params->digest_size);
+  buildMerkleTree(transcript->treeCv, transcript->Cv.hashes, transcript->salt, params);
+  freeCommitments2(&transcript->Cv);
+  transcript->Cv.hashes = NULL;
+  STATS_RECORD(stats_timer, COMMITMENTS);
+}
 
-    int rv = simulateOnline(m_maskedKey, &tapes[t], &msgs[t], m_plaintext, pubKey, params);
-    if (rv != 0) {
-#if !defined(NDEBUG)
-      printf("MPC simulation failed in round " SIZET_FMT ", aborting signature\n", t);
-#endif
+/* Run everything before the challenge: preprocessing, the online simulation and the commitments.
+ * saltAndRoot holds the salt followed by the root seed. */
+static transcript_t* commitTranscript(const uint8_t* privateKey, const uint8_t* pubKey,
+                                      const uint8_t* plaintext, uint8_t* saltAndRoot,
+                                      const picnic_instance_t* params) {
+  transcript_t* transcript = newTranscript(saltAndRoot, params);
+  if (!transcript) {
+    return NULL;
+  }
+  int ret = 0;
+
+  for (size_t t = 0; t < params->num_rounds; t++) {
+    preprocessRound(transcript, t, params);
+  }
+  for (size_t t = 0; t < params->num_rounds; t++) {
+    if (simulateRound(transcript, t, privateKey, pubKey, plaintext, params)) {
       ret = -1;
     }
   }
-  /* Commit to the commitments and views */
-  {
-    size_t t = 0;
-    for (; t < params->num_rounds / 4 * 4; t += 4) {
-      commit_h_x4(&Ch.hashes[t], &C[t], params);
-      commit_v_x4(&Cv.hashes[t], (const uint8_t**)&inputs[t], &msgs[t], params);
-    }
-    for (; t < params->num_rounds; t++) {
-      commit_h(Ch.hashes[t], &C[t], params);
-      commit_v(Cv.hashes[t], inputs[t], &msgs[t], params);
-    }
+  for (size_t t = 0; t < params->num_rounds; t += (t + 4 <= params->num_rounds) ? 4 : 1) {
+    commitRounds(transcript, t, params);
   }
-  /* Create a Merkle tree with Cv as the leaves */
-  tree_t* treeCv = createTree(params->num_rounds, params->digest_size);
-  buildMerkleTree(treeCv, Cv.hashes, sig->salt, params);
+  buildCvTree(transcript, params);
+
+  if (ret) {
+    freeTranscript(transcript, params);
+    return NULL;
+  }
+  return transcript;
+}
+
+/* Compute the challenge for the message and open the transcript accordingly */
+static void openTranscript(transcript_t* transcript, const uint8_t* pubKey,
+                           const uint8_t* plaintext, const uint8_t* message,
+                           size_t messageByteLength, signature2_t* sig,
+                           const picnic_instance_t* params) {
+  tree_t** seeds      = transcript->seeds;
+  randomTape_t* tapes = transcript->tapes;
+  inputs_t inputs     = transcript->inputs;
+  msgs_t* msgs        = transcript->msgs;
+  memcpy(sig->salt, transcript->salt, SALT_SIZE);
 
   /* Compute the challenge; two lists of integers */
+  STATS_TIMER(stats_timer);
   uint16_t* challengeC = sig->challengeC;
   uint16_t* challengeP = sig->challengeP;
-  HCP(sig->challenge, challengeC, challengeP, &Ch, treeCv->nodes[0], sig->salt, pubKey, plaintext,
-      message, messageByteLength, params);
+  HCP(sig->challenge, challengeC, challengeP, &transcript->Ch, transcript->treeCv->nodes[0],
+      sig->salt, pubKey, plaintext, message, messageByteLength, params);
+  STATS_RECORD(stats_timer, CHALLENGE);
 
   /* Send information required for checking commitments with Merkle tree.
    * The commitments the verifier will be missing are those not in challengeC. */
   size_t missingLeavesSize = params->num_rounds - params->num_opened_rounds;
   uint16_t* missingLeaves  = getMissingLeavesList(challengeC, params);
   size_t cvInfoLen         = 0;
-  uint8_t* cvInfo          = openMerkleTree(treeCv, missingLeaves, missingLeavesSize, &cvInfoLen);
-  sig->cvInfo              = cvInfo;
-  sig->cvInfoLen           = cvInfoLen;
-  free(missingLeaves);
+  uint8_t* cvInfo =
+      openMerkleTree(transcript->treeCv, missingLeaves, missingLeavesSize, &cvInfoLen);
+  sig->cvInfo    = cvInfo;
+  sig->cvInfoLen = cvInfoLen;
+  picnic_free(missingLeaves);
 
   /* Reveal iSeeds for unopned rounds, those in {0..T-1} \ ChallengeC. */
-  sig->iSeedInfo    = malloc(params->num_rounds * params->seed_size);
-  sig->iSeedInfoLen = revealSeeds(iSeedsTree, challengeC, params->num_opened_rounds, sig->iSeedInfo,
-                                  params->num_rounds * params->seed_size, params);
-  sig->iSeedInfo    = realloc(sig->iSeedInfo, sig->iSeedInfoLen);
+  sig->iSeedInfo    = picnic_malloc(params->num_rounds * params->seed_size);
+  /* the buffer is not shrunk to the revealed size; it is released at the end of signing anyway */
+  sig->iSeedInfoLen =
+      revealSeeds(transcript->iSeedsTree, challengeC, params->num_opened_rounds, sig->iSeedInfo,
+                  params->num_rounds * params->seed_size, params);
+  STATS_RECORD(stats_timer, SEEDS);
 
   /* Assemble the proof */
   proof2_t* proofs = sig->proofs;
+  /* commitments of the unopened parties, batched over the opened rounds */
+  hash_queue_t aux_commits, commits;
+  commit_queue_init(&aux_commits, true, params);
+  commit_queue_init(&commits, false, params);
   for (size_t t = 0; t < params->num_rounds; t++) {
     if (contains(challengeC, params->num_opened_rounds, t)) {
       allocateProof2(&proofs[t], params);
@@ -676,10 +901,9 @@ static int sign_picnic3(const uint8_t* privateKey, const uint8_t* pubKey, const
 
       uint16_t hideList[1];
       hideList[0]           = challengeP[P_index];
-      proofs[t].seedInfo    = malloc(params->num_MPC_parties * params->seed_size);
+      proofs[t].seedInfo    = picnic_malloc(params->num_MPC_parties * params->seed_size);
       proofs[t].seedInfoLen = revealSeeds(seeds[t], hideList, 1, proofs[t].seedInfo,
                                           params->num_MPC_parties * params->seed_size, params);
-      proofs[t].seedInfo    = realloc(proofs[t].seedInfo, proofs[t].seedInfoLen);
 
       size_t last = params->num_MPC_parties - 1;
       if (challengeP[P_index] != last) {
@@ -692,32 +916,39 @@ static int sign_picnic3(const uint8_t* privateKey, const uint8_t* pubKey, const
       /* recompute commitment of unopened party since we did not store it for memory optimization
        */
       if (proofs[t].unOpenedIndex == params->num_MPC_parties - 1) {
-        commit(proofs[t].C, getLeaf(seeds[t], proofs[t].unOpenedIndex), tapes[t].aux_bits,
-               sig->salt, t, proofs[t].unOpenedIndex, params);
+        commit_enqueue(&aux_commits, proofs[t].C, getLeaf(seeds[t], proofs[t].unOpenedIndex),
+                       tapes[t].aux_bits, sig->salt, t, proofs[t].unOpenedIndex);
       } else {
-        commit(proofs[t].C, getLeaf(seeds[t], proofs[t].unOpenedIndex), NULL, sig->salt, t,
-               proofs[t].unOpenedIndex, params);
+        commit_enqueue(&commits, proofs[t].C, getLeaf(seeds[t], proofs[t].unOpenedIndex), NULL,
+                       sig->salt, t, proofs[t].unOpenedIndex);
       }
     }
   }
+  hash_queue_flush(&aux_commits);
+  hash_queue_flush(&commits);
 
   sig->proofs = proofs;
+  STATS_RECORD(stats_timer, SERIALIZATION);
+}
 
-  freeTree(treeCv);
-  for (size_t t = 0; t < params->num_rounds; t++) {
-    freeRandomTape(&tapes[t]);
-    freeTree(seeds[t]);
-  }
-  freeCommitments2(&Cv);
-  freeCommitments2(&Ch);
-  freeMsgs(msgs);
-  freeInputs(inputs);
-  freeCommitments(C);
-  free(seeds);
-  free(tapes);
-  freeTree(iSeedsTree);
+static int sign_picnic3(const uint8_t* privateKey, const uint8_t* pubKey, const uint8_t* plaintext,
+                        const uint8_t* message, size_t messageByteLength, signature2_t* sig,
+                        const picnic_instance_t* params) {
+  uint8_t* saltAndRoot = picnic_malloc(params->seed_size + SALT_SIZE);
 
-  return ret;
+  STATS_TIMER(stats_timer);
+  computeSaltAndRootSeed(saltAndRoot, params->seed_size + SALT_SIZE, privateKey, pubKey, plaintext,
+                         message, messageByteLength, params);
+  STATS_RECORD(stats_timer, SEEDS);
+  transcript_t* transcript = commitTranscript(privateKey, pubKey, plaintext, saltAndRoot, params);
+  picnic_free(saltAndRoot);
+  if (!transcript) {
+    return -1;
+  }
+
+  openTranscript(transcript, pubKey, plaintext, message, messageByteLength, sig, params);
+  freeTranscript(transcript, params);
+  return 0;
 }
 
 static int arePaddingBitsZero(uint8_t* data, size_t byteLength, size_t bitLength) {
@@ -750,7 +981,7 @@ static int deserializeSignature2(signature2_t* sig, const uint8_t* sigBytes, siz
   uint16_t* missingLeaves  = getMissingLeavesList(sig->challengeC, params);
   sig->cvInfoLen = openMerkleTreeSize(params->num_rounds, missingLeaves, missingLeavesSize, params);
   bytesRequired += sig->cvInfoLen;
-  free(missingLeaves);
+  picnic_free(missingLeaves);
 
   /* Compute the number of bytes required for the proofs */
   uint16_t hideList[1] = {0};
@@ -777,11 +1008,11 @@ static int deserializeSignature2(signature2_t* sig, const uint8_t* sigBytes, siz
     return EXIT_FAILURE;
   }
 
-  sig->iSeedInfo = malloc(sig->iSeedInfoLen);
+  sig->iSeedInfo = picnic_malloc(sig->iSeedInfoLen);
   memcpy(sig->iSeedInfo, sigBytes, sig->iSeedInfoLen);
   sigBytes += sig->iSeedInfoLen;
 
-  sig->cvInfo = malloc(sig->cvInfoLen);
+  sig->cvInfo = picnic_malloc(sig->cvInfoLen);
   memcpy(sig->cvInfo, sigBytes, sig->cvInfoLen);
   sigBytes += sig->cvInfoLen;
 
@@ -790,7 +1021,7 @@ static int deserializeSignature2(signature2_t* sig, const uint8_t* sigBytes, siz
     if (contains(sig->challengeC, params->num_opened_rounds, t)) {
       allocateProof2(&sig->proofs[t], params);
       sig->proofs[t].seedInfoLen = seedInfoLen;
-      sig->proofs[t].seedInfo    = malloc(sig->proofs[t].seedInfoLen);
+      sig->proofs[t].seedInfo    = picnic_malloc(sig->proofs[t].seedInfoLen);
       memcpy(sig->proofs[t].seedInfo, sigBytes, sig->proofs[t].seedInfoLen);
       sigBytes += sig->proofs[t].seedInfoLen;
 
@@ -905,11 +1136,11 @@ int impl_sign_picnic3(const picnic_instance_t* instance, const uint8_t* plaintex
                       const uint8_t* private_key, const uint8_t* public_key, const uint8_t* msg,
                       size_t msglen, uint8_t* signature, size_t* signature_len) {
   int ret;
-  signature2_t* sig = (signature2_t*)malloc(sizeof(signature2_t));
-  allocateSignature2(sig, instance);
+  signature2_t* sig = (signature2_t*)picnic_malloc(sizeof(signature2_t));
   if (sig == NULL) {
     return -1;
   }
+  allocateSignature2(sig, instance);
   ret = sign_picnic3(private_key, public_key, plaintext, msg, msglen, sig, instance);
   if (ret != EXIT_SUCCESS) {
 #if !defined(NDEBUG)
@@ -917,44 +1148,87 @@ int impl_sign_picnic3(const picnic_instance_t* instance, const uint8_t* plaintex
     fflush(stderr);
 #endif
     freeSignature2(sig, instance);
-    free(sig);
+    picnic_free(sig);
     return -1;
   }
+  STATS_TIMER(stats_timer);
   ret = serializeSignature2(sig, signature, *signature_len, instance);
+  STATS_RECORD(stats_timer, SERIALIZATION);
   if (ret == -1) {
 #if !defined(NDEBUG)
     fprintf(stderr, "Failed to serialize signature\n");
     fflush(stderr);
 #endif
     freeSignature2(sig, instance);
-    free(sig);
+    picnic_free(sig);
     return -1;
   }
   *signature_len = ret;
 
   freeSignature2(sig, instance);
-  free(sig);
+  picnic_free(sig);
   return 0;
 }
 
+void* impl_presign_picnic3(const picnic_instance_t* instance, const uint8_t* plaintext,
+                           const uint8_t* private_key, const uint8_t* public_key) {
+  /* fresh salt and root seed instead of deriving them from the private key and the message */
+  uint8_t saltAndRoot[SALT_SIZE + MAX_DIGEST_SIZE];
+  if (rand_bytes(saltAndRoot, SALT_SIZE + instance->seed_size)) {
+    return NULL;
+  }
+  return commitTranscript(private_key, public_key, plaintext, saltAndRoot, instance);
+}
+
+int impl_sign_presigned_picnic3(const picnic_instance_t* instance, void* transcript,
+                                const uint8_t* plaintext, const uint8_t* public_key,
+                                const uint8_t* msg, size_t msglen, uint8_t* signature,
+                                size_t* signature_len) {
+  signature2_t* sig = (signature2_t*)picnic_malloc(sizeof(signature2_t));
+  if (sig == NULL) {
+    freeTranscript(transcript, instance);
+    return -1;
+  }
+  allocateSignature2(sig, instance);
+  openTranscript(transcript, public_key, plaintext, msg, msglen, sig, instance);
+  freeTranscript(transcript, instance);
+
+  STATS_TIMER(stats_timer);
+  const int ret = serializeSignature2(sig, signature, *signature_len, instance);
+  STATS_RECORD(stats_timer, SERIALIZATION);
+  freeSignature2(sig, instance);
+  picnic_free(sig);
+  if (ret == -1) {
+    return -1;
+  }
+  *signature_len = ret;
+  return 0;
+}
+
+void impl_presigned_free_picnic3(const picnic_instance_t* instance, void* transcript) {
+  freeTranscript(transcript, instance);
+}
+
 int impl_verify_picnic3(const picnic_instance_t* instance, const uint8_t* plaintext,
                         const uint8_t* public_key, const uint8_t* msg, size_t msglen,
                         const uint8_t* signature, size_t signature_len) {
   int ret;
-  signature2_t* sig = (signature2_t*)malloc(sizeof(signature2_t));
-  allocateSignature2(sig, instance);
+  signature2_t* sig = (signature2_t*)picnic_malloc(sizeof(signature2_t));
   if (sig == NULL) {
     return -1;
   }
+  allocateSignature2(sig, instance);
 
+  STATS_TIMER(stats_timer);
   ret = deserializeSignature2(sig, signature, signature_len, instance);
+  STATS_RECORD(stats_timer, SERIALIZATION);
   if (ret != EXIT_SUCCESS) {
 #if !defined(NDEBUG)
     fprintf(stderr, "Failed to deserialize signature\n");
     fflush(stderr);
 #endif
     freeSignature2(sig, instance);
-    free(sig);
+    picnic_free(sig);
     return -1;
   }
 
@@ -962,11 +1236,103 @@ int impl_verify_picnic3(const picnic_instance_t* instance, const uint8_t* plaint
   if (ret != EXIT_SUCCESS) {
     /* Signature is invalid, or verify function failed */
     freeSignature2(sig, instance);
-    free(sig);
+    picnic_free(sig);
     return -1;
   }
 
   freeSignature2(sig, instance);
-  free(sig);
+  picnic_free(sig);
   return 0;
 }
+
+void* impl_sign_begin_picnic3(const picnic_instance_t* instance, const uint8_t* plaintext,
+                              const uint8_t* private_key, const uint8_t* public_key,
+                              const uint8_t* msg, size_t msglen) {
+  uint8_t saltAndRoot[SALT_SIZE + MAX_DIGEST_SIZE];
+
+  STATS_TIMER(stats_timer);
+  computeSaltAndRootSeed(saltAndRoot, instance->seed_size + SALT_SIZE, private_key, public_key,
+                         plaintext, msg, msglen, instance);
+  STATS_RECORD(stats_timer, SEEDS);
+  return newTranscript(saltAndRoot, instance);
+}
+
+int impl_sign_step_picnic3(const picnic_instance_t* instance, void* transcript, unsigned int step,
+                           const uint8_t* plaintext, const uint8_t* private_key,
+                           const uint8_t* public_key) {
+  const size_t num_rounds = instance->num_rounds;
+
+  /* steps 0 to T - 1 preprocess one round each, steps T to 2T - 1 simulate one round each */
+  if (step < num_rounds) {
+    preprocessRound(transcript, step, instance);
+    return 1;
+  }
+  if (step < 2 * num_rounds) {
+    return simulateRound(transcript, step - num_rounds, private_key, public_key, plaintext,
+                         instance)
+               ? -1
+               : 1;
+  }
+
+  /* the remaining steps commit to groups of four rounds */
+  const size_t begin = (step - 2 * num_rounds) * 4;
+  const size_t end   = MIN(begin + 4, num_rounds);
+  for (size_t t = begin; t < end; t += (t + 4 <= num_rounds) ? 4 : 1) {
+    commitRounds(transcript, t, instance);
+  }
+  if (end < num_rounds) {
+    return 1;
+  }
+  buildCvTree(transcript, instance);
+  return 0;
+}
+
+void* impl_verify_begin_picnic3(const picnic_instance_t* instance, const uint8_t* signature,
+                                size_t signature_len) {
+  signature2_t* sig = (signature2_t*)picnic_malloc(sizeof(signature2_t));
+  if (sig == NULL) {
+    return NULL;
+  }
+  allocateSignature2(sig, instance);
+
+  STATS_TIMER(stats_timer);
+  int ret = deserializeSignature2(sig, signature, signature_len, instance);
+  STATS_RECORD(stats_timer, SERIALIZATION);
+  verify_state_t* state = ret == EXIT_SUCCESS ? verifyBegin(sig, instance) : NULL;
+  if (!state) {
+    freeSignature2(sig, instance);
+    picnic_free(sig);
+  }
+  return state;
+}
+
+int impl_verify_step_picnic3(const picnic_instance_t* instance, void* state, unsigned int step,
+                             const uint8_t* plaintext, const uint8_t* public_key) {
+  const size_t num_rounds = instance->num_rounds;
+
+  /* steps 0 to T - 1 recompute the commitments of one round each, the remaining steps simulate one
+   * opened round each */
+  if (step < num_rounds) {
+    if (verifyRound(state, step, instance)) {
+      return -1;
+    }
+  } else if (verifyOnline(state, step - num_rounds, public_key, plaintext, instance)) {
+    return -1;
+  }
+  return step + 1 < num_rounds + instance->num_opened_rounds;
+}
+
+void impl_verify_free_picnic3(const picnic_instance_t* instance, void* state) {
+  signature2_t* sig = ((verify_state_t*)state)->sig;
+  verifyFree(state);
+  freeSignature2(sig, instance);
+  picnic_free(sig);
+}
+
+int impl_verify_finish_picnic3(const picnic_instance_t* instance, void* state,
+                               const uint8_t* plaintext, const uint8_t* public_key,
+                               const uint8_t* msg, size_t msglen) {
+  const int ret = verifyChallenge(state, public_key, plaintext, msg, msglen, instance);
+  impl_verify_free_picnic3(instance, state);
+  return ret == EXIT_SUCCESS ? 0 : -1;
+}
@@ -45,6 +45,29 @@ int impl_sign_picnic3(const picnic_instance_t* pp, const uint8_t* plaintext,
 int impl_verify_picnic3(const picnic_instance_t* instance, const uint8_t* plaintext,
                         const uint8_t* public_key, const uint8_t* msg, size_t msglen,
                         const uint8_t* signature, size_t signature_len);
+void* impl_presign_picnic3(const picnic_instance_t* instance, const uint8_t* plaintext,
+                           const uint8_t* private_key, const uint8_t* public_key);
+int impl_sign_presigned_picnic3(const picnic_instance_t* instance, void* transcript,
+                                const uint8_t* plaintext, const uint8_t* public_key,
+                                const uint8_t* msg, size_t msglen, uint8_t* signature,
+                                size_t* signature_len);
+void impl_presigned_free_picnic3(const picnic_instance_t* instance, void* transcript);
+
+/* signing and verification in bounded steps, see impl_sign_begin and impl_verify_begin */
+void* impl_sign_begin_picnic3(const picnic_instance_t* instance, const uint8_t* plaintext,
+                              const uint8_t* private_key, const uint8_t* public_key,
+                              const uint8_t* msg, size_t msglen);
+int impl_sign_step_picnic3(const picnic_instance_t* instance, void* transcript, unsigned int step,
+                           const uint8_t* plaintext, const uint8_t* private_key,
+                           const uint8_t* public_key);
+void* impl_verify_begin_picnic3(const picnic_instance_t* instance, const uint8_t* signature,
+                                size_t signature_len);
+int impl_verify_step_picnic3(const picnic_instance_t* instance, void* state, unsigned int step,
+                             const uint8_t* plaintext, const uint8_t* public_key);
+int impl_verify_finish_picnic3(const picnic_instance_t* instance, void* state,
+                               const uint8_t* plaintext, const uint8_t* public_key,
+                               const uint8_t* msg, size_t msglen);
+void impl_verify_free_picnic3(const picnic_instance_t* instance, void* state);
 
 void allocateSignature2(signature2_t* sig, const picnic_instance_t* params);
 void freeSignature2(signature2_t* sig, const picnic_instance_t* params);
@@ -155,6 +155,9 @@
 #if defined(WITH_LOWMC_255_255_4)
 #include "lowmc_255_255_4.h"
 #endif
+#if defined(WITH_GFNI)
+#include "lowmc_gfni.h"
+#endif
 
 #if !defined(NO_UINT64_FALLBACK)
 #if defined(WITH_LOWMC_129_129_4)
@@ -568,6 +571,37 @@ static void picnic3_mpc_sbox_s256_lowmc_255_255_4(mzd_local_t* statein, randomTa
 #include "picnic3_simulate.c.i"
 
 #undef IMPL
+
+#if defined(WITH_GFNI)
+#define IMPL gfni
+#undef FN_ATTR
+#define FN_ATTR ATTR_TARGET_GFNI
+
+/* GFNI only replaces the matrix multiplications, the S-box layers are shared with AVX2 */
+#define picnic3_mpc_sbox_gfni_lowmc_129_129_4_gfni picnic3_mpc_sbox_s256_lowmc_129_129_4
+#define picnic3_mpc_sbox_gfni_lowmc_192_192_4_gfni picnic3_mpc_sbox_s256_lowmc_192_192_4
+#define picnic3_mpc_sbox_gfni_lowmc_255_255_4_gfni picnic3_mpc_sbox_s256_lowmc_255_255_4
+
+/* PICNIC3_L1_FS */
+#include "lowmc_129_129_4_fns_gfni.h"
+#undef SIM_ONLINE
+#define SIM_ONLINE lowmc_simulate_online_gfni_129_43
+#include "picnic3_simulate.c.i"
+
+/* PICNIC3_L3_FS */
+#include "lowmc_192_192_4_fns_gfni.h"
+#undef SIM_ONLINE
+#define SIM_ONLINE lowmc_simulate_online_gfni_192_64
+#include "picnic3_simulate.c.i"
+
+/* PICNIC3_L5_FS */
+#include "lowmc_255_255_4_fns_gfni.h"
+#undef SIM_ONLINE
+#define SIM_ONLINE lowmc_simulate_online_gfni_255_85
+#include "picnic3_simulate.c.i"
+
+#undef IMPL
+#endif
 #endif // AVX2
 #endif // WITH_OPT
 
@@ -577,7 +611,24 @@ lowmc_simulate_online_f lowmc_simulate_online_get_implementation(const lowmc_par
 
 #if defined(WITH_OPT)
 #if defined(WITH_AVX2)
-  if (CPU_SUPPORTS_AVX2) {
+#if defined(WITH_GFNI)
+  if (lowmc_get_backend() == LOWMC_BACKEND_GFNI) {
+#if defined(WITH_LOWMC_129_129_4)
+    if (lowmc->n == 129 && lowmc->m == 43)
+      return lowmc_simulate_online_gfni_129_43;
+#endif
+#if defined(WITH_LOWMC_192_192_4)
+    if (lowmc->n == 192 && lowmc->m == 64)
+      return lowmc_simulate_online_gfni_192_64;
+#endif
+#if defined(WITH_LOWMC_255_255_4)
+    if (lowmc->n == 255 && lowmc->m == 85)
+      return lowmc_simulate_online_gfni_255_85;
+#endif
+  }
+#endif
+
+  if (lowmc_get_backend() == LOWMC_BACKEND_S256) {
 #if defined(WITH_LOWMC_129_129_4)
     if (lowmc->n == 129 && lowmc->m == 43)
       return lowmc_simulate_online_s256_129_43;
@@ -594,7 +645,7 @@ lowmc_simulate_online_f lowmc_simulate_online_get_implementation(const lowmc_par
 #endif
 
 #if defined(WITH_SSE2) || defined(WITH_NEON)
-  if (CPU_SUPPORTS_SSE2 || CPU_SUPPORTS_NEON) {
+  if (lowmc_get_backend() != LOWMC_BACKEND_UINT64) {
 #if defined(WITH_LOWMC_129_129_4)
     if (lowmc->n == 129 && lowmc->m == 43)
       return lowmc_simulate_online_s128_129_43;
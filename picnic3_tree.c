@@ -18,7 +18,9 @@
 #include <limits.h>
 #include <stdlib.h>
 
+#include "allocator.h"
 #include "endian_compat.h"
+#include "hash_jobs.h"
 #include "kdf_shake.h"
 #include "picnic.h"
 #include "picnic3_tree.h"
@@ -44,7 +46,7 @@ static int exists(tree_t* tree, size_t i) {
 }
 
 tree_t* createTree(size_t numLeaves, size_t dataSize) {
-  tree_t* tree = malloc(sizeof(tree_t));
+  tree_t* tree = picnic_malloc(sizeof(tree_t));
 
   tree->depth = ceil_log2(numLeaves) + 1;
   tree->numNodes =
@@ -52,19 +54,19 @@ tree_t* createTree(size_t numLeaves, size_t dataSize) {
       ((1 << (tree->depth - 1)) - numLeaves); /* Num nodes in complete - number of missing leaves */
   tree->numLeaves = numLeaves;
   tree->dataSize  = dataSize;
-  tree->nodes     = malloc(tree->numNodes * sizeof(uint8_t*));
+  tree->nodes     = picnic_malloc(tree->numNodes * sizeof(uint8_t*));
 
-  uint8_t* slab = calloc(tree->numNodes, dataSize);
+  uint8_t* slab = picnic_calloc(tree->numNodes, dataSize);
 
   for (size_t i = 0; i < tree->numNodes; i++) {
     tree->nodes[i] = slab;
     slab += dataSize;
   }
 
-  tree->haveNode = calloc(tree->numNodes, 1);
+  tree->haveNode = picnic_calloc(tree->numNodes, 1);
 
   /* Depending on the number of leaves, the tree may not be complete */
-  tree->exists = calloc(tree->numNodes, 1);
+  tree->exists = picnic_calloc(tree->numNodes, 1);
   memset(tree->exists + tree->numNodes - tree->numLeaves, 1, tree->numLeaves); /* Set leaves */
   for (int i = tree->numNodes - tree->numLeaves; i > 0; i--) {
     if (exists(tree, 2 * i + 1) || exists(tree, 2 * i + 2)) {
@@ -78,11 +80,11 @@ tree_t* createTree(size_t numLeaves, size_t dataSize) {
 
 void freeTree(tree_t* tree) {
   if (tree != NULL) {
-    free(tree->nodes[0]);
-    free(tree->nodes);
-    free(tree->haveNode);
-    free(tree->exists);
-    free(tree);
+    picnic_free(tree->nodes[0]);
+    picnic_free(tree->nodes);
+    picnic_free(tree->haveNode);
+    picnic_free(tree->exists);
+    picnic_free(tree);
   }
 }
 
@@ -116,114 +118,64 @@ uint8_t* getLeaf(tree_t* tree, size_t leafIndex) {
   return tree->nodes[firstLeaf + leafIndex];
 }
 
-static void hashSeed(uint8_t* digest, const uint8_t* inputSeed, uint8_t* salt, uint8_t hashPrefix,
-                     size_t repIndex, size_t nodeIndex, const picnic_instance_t* params) {
-  hash_context ctx;
-
-  hash_init_prefix(&ctx, params->digest_size, hashPrefix);
-  hash_update(&ctx, inputSeed, params->seed_size);
-  hash_update(&ctx, salt, SALT_SIZE);
-  hash_update_uint16_le(&ctx, repIndex);
-  hash_update_uint16_le(&ctx, nodeIndex);
-  hash_final(&ctx);
-  hash_squeeze(&ctx, digest, 2 * params->seed_size);
-}
-
-static void hashSeed_x4(uint8_t** digest, const uint8_t** inputSeed, uint8_t* salt,
-                        uint8_t hashPrefix, size_t repIndex, size_t nodeIndex,
-                        const picnic_instance_t* params) {
-  hash_context_x4 ctx;
-
-  hash_init_prefix_x4(&ctx, params->digest_size, hashPrefix);
-  hash_update_x4(&ctx, inputSeed, params->seed_size);
-
-  const uint8_t* salts[4] = {salt, salt, salt, salt};
-  hash_update_x4(&ctx, salts, SALT_SIZE);
-  hash_update_x4_uint16_le(&ctx, repIndex);
-
-  const uint16_t nodes[4] = {nodeIndex, nodeIndex + 1, nodeIndex + 2, nodeIndex + 3};
-  hash_update_x4_uint16s_le(&ctx, nodes);
-
-  hash_final_x4(&ctx);
-  hash_squeeze_x4(&ctx, digest, 2 * params->seed_size);
+/* Queue of seed expansions H(seed_i || salt || t || i) of the nodes of one level */
+static void seedQueueInit(hash_queue_t* queue, const picnic_instance_t* params) {
+  hash_queue_init_prefix(queue, params->digest_size, HASH_PREFIX_1, 2 * params->seed_size);
+  hash_queue_add_input(queue, params->seed_size);
+  hash_queue_add_input(queue, SALT_SIZE);
+  hash_queue_add_input(queue, HASH_INPUT_UINT16);
+  hash_queue_add_input(queue, HASH_INPUT_UINT16);
 }
 
 static void expandSeeds(tree_t* tree, uint8_t* salt, size_t repIndex,
                         const picnic_instance_t* params) {
-  uint8_t tmp[4 * 2 * MAX_SEED_SIZE_BYTES];
-  uint8_t* tmp_ptr[4] = {&tmp[0], &tmp[2 * MAX_SEED_SIZE_BYTES], &tmp[2 * 2 * MAX_SEED_SIZE_BYTES],
-                         &tmp[3 * 2 * MAX_SEED_SIZE_BYTES]};
+  /* The nodes of one level are independent of each other, so their seeds are hashed together.
+   * Each level holds fewer nodes than there are leaves. */
+  uint8_t* tmp = picnic_malloc(tree->numLeaves * 2 * params->seed_size);
+  hash_queue_t queue;
+  seedQueueInit(&queue, params);
 
   /* Walk the tree, expanding seeds where possible. Compute children of
    * non-leaf nodes. */
   size_t lastNonLeaf = getParent(tree->numNodes - 1);
-  size_t i           = 0;
-  /* expand the first 4 seeds*/
-  for (; i <= MIN(2,lastNonLeaf); i++) {
-    if (!tree->haveNode[i]) {
-      continue;
-    }
-
-    hashSeed(tmp, tree->nodes[i], salt, HASH_PREFIX_1, repIndex, i, params);
+  for (size_t first = 0; first <= lastNonLeaf; first = 2 * first + 1) {
+    size_t last = MIN(2 * first, lastNonLeaf);
 
-    if (!tree->haveNode[2 * i + 1]) {
-      /* left child = H_left(seed_i || salt || t || i) */
-      memcpy(tree->nodes[2 * i + 1], tmp, params->seed_size);
-      tree->haveNode[2 * i + 1] = 1;
-    }
+    for (size_t i = first; i <= last; i++) {
+      if (!tree->haveNode[i]) {
+        continue;
+      }
 
-    /* The last non-leaf node will only have a left child when there are an odd number of leaves */
-    if (exists(tree, 2 * i + 2) && !tree->haveNode[2 * i + 2]) {
-      /* right child = H_right(seed_i || salt || t || i)  */
-      memcpy(tree->nodes[2 * i + 2], tmp + params->seed_size, params->seed_size);
-      tree->haveNode[2 * i + 2] = 1;
+      hash_job_t* job = hash_queue_push(&queue, tmp + (i - first) * 2 * params->seed_size);
+      job->data[0]    = tree->nodes[i];
+      job->data[1]    = salt;
+      job->values[2]  = repIndex;
+      job->values[3]  = i;
     }
-  }
-  /* now hash in groups of 4 for faster hashing */
-  for (; i <= lastNonLeaf / 4 * 4; i += 4) {
-
-    hashSeed_x4(tmp_ptr, (const uint8_t**) &tree->nodes[i], salt, HASH_PREFIX_1, repIndex, i, params);
+    hash_queue_flush(&queue);
 
-    for (size_t j = i; j < i + 4; j++) {
-      if (!tree->haveNode[j]) {
+    for (size_t i = first; i <= last; i++) {
+      if (!tree->haveNode[i]) {
         continue;
       }
-      if (!tree->haveNode[2 * j + 1]) {
-        /* left child = H_left(seed_i || salt || t || j) */
-        memcpy(tree->nodes[2 * j + 1], tmp_ptr[j-i], params->seed_size);
-        tree->haveNode[2 * j + 1] = 1;
+
+      const uint8_t* digest = tmp + (i - first) * 2 * params->seed_size;
+      if (!tree->haveNode[2 * i + 1]) {
+        /* left child = H_left(seed_i || salt || t || i) */
+        memcpy(tree->nodes[2 * i + 1], digest, params->seed_size);
+        tree->haveNode[2 * i + 1] = 1;
       }
 
-      /* The last non-leaf node will only have a left child when there are an odd number of leaves
-       */
-      if (exists(tree, 2 * j + 2) && !tree->haveNode[2 * j + 2]) {
-        /* right child = H_right(seed_i || salt || t || j)  */
-        memcpy(tree->nodes[2 * j + 2], tmp_ptr[j-i] + params->seed_size, params->seed_size);
-        tree->haveNode[2 * j + 2] = 1;
+      /* The last non-leaf node will only have a left child when there are an odd number of leaves */
+      if (exists(tree, 2 * i + 2) && !tree->haveNode[2 * i + 2]) {
+        /* right child = H_right(seed_i || salt || t || i)  */
+        memcpy(tree->nodes[2 * i + 2], digest + params->seed_size, params->seed_size);
+        tree->haveNode[2 * i + 2] = 1;
       }
     }
   }
-  /* handle last few, which are not a multiple of 4 */
-  for (; i <= lastNonLeaf; i++) {
-    if (!tree->haveNode[i]) {
-      continue;
-    }
-
-    hashSeed(tmp, tree->nodes[i], salt, HASH_PREFIX_1, repIndex, i, params);
-
-    if (!tree->haveNode[2 * i + 1]) {
-      /* left child = H_left(seed_i || salt || t || i) */
-      memcpy(tree->nodes[2 * i + 1], tmp, params->seed_size);
-      tree->haveNode[2 * i + 1] = 1;
-    }
 
-    /* The last non-leaf node will only have a left child when there are an odd number of leaves */
-    if (exists(tree, 2 * i + 2) && !tree->haveNode[2 * i + 2]) {
-      /* right child = H_right(seed_i || salt || t || i)  */
-      memcpy(tree->nodes[2 * i + 2], tmp + params->seed_size, params->seed_size);
-      tree->haveNode[2 * i + 2] = 1;
-    }
-  }
+  picnic_free(tmp);
 }
 
 tree_t* generateSeeds(size_t nSeeds, uint8_t* rootSeed, uint8_t* salt, size_t repIndex,
@@ -278,8 +230,8 @@ static size_t* getRevealedNodes(tree_t* tree, uint16_t* hideList, size_t hideLis
 
   /* pathSets[i][0...hideListSize] stores the nodes in the path at depth i
    * for each of the leaf nodes in hideListSize */
-  size_t** pathSets = malloc(pathLen * sizeof(size_t*));
-  size_t* slab      = malloc(hideListSize * pathLen * sizeof(size_t));
+  size_t** pathSets = picnic_malloc(pathLen * sizeof(size_t*));
+  size_t* slab      = picnic_malloc(hideListSize * pathLen * sizeof(size_t));
 
   for (size_t i = 0; i < pathLen; i++) {
     pathSets[i] = slab;
@@ -301,7 +253,7 @@ static size_t* getRevealedNodes(tree_t* tree, uint16_t* hideList, size_t hideLis
   }
 
   /* Determine seeds to reveal */
-  size_t* revealed   = malloc(tree->numLeaves * sizeof(size_t));
+  size_t* revealed   = picnic_malloc(tree->numLeaves * sizeof(size_t));
   size_t revealedPos = 0;
   for (size_t d = 0; d < pathLen; d++) {
     for (size_t i = 0; i < hideListSize; i++) {
@@ -323,8 +275,8 @@ static size_t* getRevealedNodes(tree_t* tree, uint16_t* hideList, size_t hideLis
     }
   }
 
-  free(pathSets[0]);
-  free(pathSets);
+  picnic_free(pathSets[0]);
+  picnic_free(pathSets);
 
   *outputSize = revealedPos;
   return revealed;
@@ -337,7 +289,7 @@ size_t revealSeedsSize(size_t numNodes, uint16_t* hideList, size_t hideListSize,
   size_t* revealed        = getRevealedNodes(tree, hideList, hideListSize, &numNodesRevealed);
 
   freeTree(tree);
-  free(revealed);
+  picnic_free(revealed);
   return numNodesRevealed * params->seed_size;
 }
 
@@ -356,14 +308,14 @@ size_t revealSeeds(tree_t* tree, uint16_t* hideList, size_t hideListSize, uint8_
     outLen -= params->seed_size;
     if (outLen < 0) {
       assert(!"Insufficient sized buffer provided to revealSeeds");
-      free(revealed);
+      picnic_free(revealed);
       return 0;
     }
     memcpy(output, tree->nodes[revealed[i]], params->seed_size);
     output += params->seed_size;
   }
 
-  free(revealed);
+  picnic_free(revealed);
   return output - outputBase;
 }
 
@@ -393,46 +345,62 @@ int reconstructSeeds(tree_t* tree, uint16_t* hideList, size_t hideListSize, uint
   expandSeeds(tree, salt, repIndex, params);
 
 Exit:
-  free(revealed);
+  picnic_free(revealed);
   return ret;
 }
 
-static void computeParentHash(tree_t* tree, size_t child, uint8_t* salt,
-                              const picnic_instance_t* params) {
-  if (!exists(tree, child)) {
-    return;
-  }
-
-  size_t parent = getParent(child);
-
-  if (tree->haveNode[parent]) {
-    return;
-  }
-
-  /* Compute the hash for parent, if we have everything */
-  if (!tree->haveNode[2 * parent + 1]) {
-    return;
+/* Queue of parent hashes H(left child data || [right child data] || salt || parent idx) */
+static void parentQueueInit(hash_queue_t* queue, int withRightChild,
+                            const picnic_instance_t* params) {
+  hash_queue_init_prefix(queue, params->digest_size, HASH_PREFIX_3, params->digest_size);
+  hash_queue_add_input(queue, params->digest_size);
+  if (withRightChild) {
+    hash_queue_add_input(queue, params->digest_size);
   }
+  hash_queue_add_input(queue, SALT_SIZE);
+  hash_queue_add_input(queue, HASH_INPUT_UINT16);
+}
 
-  if (exists(tree, 2 * parent + 2) && !tree->haveNode[2 * parent + 2]) {
-    return;
-  }
+/* Starting at the leaves, work up the tree, computing the hashes for intermediate nodes for which
+ * we have all children. The parents of one level are independent, so their hashes are batched. */
+static void computeParentHashes(tree_t* tree, uint8_t* salt, const picnic_instance_t* params) {
+  hash_queue_t queue, queueLeft;
+  parentQueueInit(&queue, 1, params);
+  /* One node may not have a right child when there's an odd number of leaves */
+  parentQueueInit(&queueLeft, 0, params);
 
-  /* Compute parent data = H(left child data || [right child data] || salt || parent idx) */
-  hash_context ctx;
+  size_t lastNonLeaf = getParent(tree->numNodes - 1);
+  for (size_t level = tree->depth - 1; level > 0; level--) {
+    size_t first = ((size_t)1 << (level - 1)) - 1;
+    size_t last  = MIN(2 * first, lastNonLeaf);
+
+    for (size_t parent = first; parent <= last; parent++) {
+      /* Compute the hash for parent, if we have everything */
+      if (tree->haveNode[parent] || !exists(tree, 2 * parent + 1) ||
+          !tree->haveNode[2 * parent + 1]) {
+        continue;
+      }
+      if (exists(tree, 2 * parent + 2) && !tree->haveNode[2 * parent + 2]) {
+        continue;
+      }
 
-  hash_init_prefix(&ctx, params->digest_size, HASH_PREFIX_3);
-  hash_update(&ctx, tree->nodes[2 * parent + 1], params->digest_size);
-  if (hasRightChild(tree, parent)) {
-    /* One node may not have a right child when there's an odd number of leaves */
-    hash_update(&ctx, tree->nodes[2 * parent + 2], params->digest_size);
+      hash_job_t* job;
+      if (hasRightChild(tree, parent)) {
+        job          = hash_queue_push(&queue, tree->nodes[parent]);
+        job->data[1] = tree->nodes[2 * parent + 2];
+        job->data[2] = salt;
+        job->values[3] = parent;
+      } else {
+        job            = hash_queue_push(&queueLeft, tree->nodes[parent]);
+        job->data[1]   = salt;
+        job->values[2] = parent;
+      }
+      job->data[0]           = tree->nodes[2 * parent + 1];
+      tree->haveNode[parent] = 1;
+    }
+    hash_queue_flush(&queue);
+    hash_queue_flush(&queueLeft);
   }
-
-  hash_update(&ctx, salt, SALT_SIZE);
-  hash_update_uint16_le(&ctx, parent);
-  hash_final(&ctx);
-  hash_squeeze(&ctx, tree->nodes[parent], params->digest_size);
-  tree->haveNode[parent] = 1;
 }
 
 /* Create a Merkle tree by hashing up all nodes.
@@ -449,17 +417,14 @@ void buildMerkleTree(tree_t* tree, uint8_t** leafData, uint8_t* salt,
       tree->haveNode[firstLeaf + i] = 1;
     }
   }
-  /* Starting at the leaves, work up the tree, computing the hashes for intermediate nodes */
-  for (int i = (int)tree->numNodes; i > 0; i--) {
-    computeParentHash(tree, i, salt, params);
-  }
+  computeParentHashes(tree, salt, params);
 }
 
 /* Note that we never output the root node */
 static size_t* getRevealedMerkleNodes(tree_t* tree, uint16_t* missingLeaves,
                                       size_t missingLeavesSize, size_t* outputSize) {
   size_t firstLeaf      = tree->numNodes - tree->numLeaves;
-  uint8_t* missingNodes = calloc(tree->numNodes, 1);
+  uint8_t* missingNodes = picnic_calloc(tree->numNodes, 1);
 
   /* Mark leaves that are missing */
   for (size_t i = 0; i < missingLeavesSize; i++) {
@@ -485,7 +450,7 @@ static size_t* getRevealedMerkleNodes(tree_t* tree, uint16_t* missingLeaves,
 
   /* For each missing leaf node, add the highest missing node on the path
    * back to the root to the set to be revealed */
-  size_t* revealed = malloc(tree->numLeaves * sizeof(size_t));
+  size_t* revealed = picnic_malloc(tree->numLeaves * sizeof(size_t));
   size_t pos       = 0;
   for (size_t i = 0; i < missingLeavesSize; i++) {
     size_t node = missingLeaves[i] + firstLeaf; /* input is leaf indexes, translate to nodes */
@@ -500,7 +465,7 @@ static size_t* getRevealedMerkleNodes(tree_t* tree, uint16_t* missingLeaves,
     } while ((node = getParent(node)) != 0);
   }
 
-  free(missingNodes);
+  picnic_free(missingNodes);
   *outputSize = pos;
   return revealed;
 }
@@ -513,7 +478,7 @@ size_t openMerkleTreeSize(size_t numNodes, uint16_t* missingLeaves, size_t missi
   size_t* revealed = getRevealedMerkleNodes(tree, missingLeaves, missingLeavesSize, &revealedSize);
 
   freeTree(tree);
-  free(revealed);
+  picnic_free(revealed);
 
   return revealedSize * params->digest_size;
 }
@@ -527,7 +492,7 @@ uint8_t* openMerkleTree(tree_t* tree, uint16_t* missingLeaves, size_t missingLea
 
   /* Serialize output */
   *outputSizeBytes    = revealedSize * tree->dataSize;
-  uint8_t* output     = malloc(*outputSizeBytes);
+  uint8_t* output     = picnic_malloc(*outputSizeBytes);
   uint8_t* outputBase = output;
 
   for (size_t i = 0; i < revealedSize; i++) {
@@ -535,7 +500,7 @@ uint8_t* openMerkleTree(tree_t* tree, uint16_t* missingLeaves, size_t missingLea
     output += tree->dataSize;
   }
 
-  free(revealed);
+  picnic_free(revealed);
 
   return outputBase;
 }
@@ -575,7 +540,7 @@ int addMerkleNodes(tree_t* tree, uint16_t* missingLeaves, size_t missingLeavesSi
 
 Exit:
 
-  free(revealed);
+  picnic_free(revealed);
 
   return ret;
 }
@@ -602,9 +567,7 @@ int verifyMerkleTree(tree_t* tree, /* uint16_t* missingLeaves, size_t missingLea
 
   /* At this point the tree has some of the leaves, and some intermediate nodes
    * Work up the tree, computing all nodes we don't have that are missing. */
-  for (int i = (int)tree->numNodes; i > 0; i--) {
-    computeParentHash(tree, i, salt, params);
-  }
+  computeParentHashes(tree, salt, params);
 
   /* Fail if the root was not computed. */
   if (!tree->haveNode[0]) {
@@ -19,17 +19,18 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "allocator.h"
 #include "compat.h"
 #include "picnic3_types.h"
 
 void allocateRandomTape(randomTape_t* tape, const picnic_instance_t* params) {
   tape->nTapes         = params->num_MPC_parties;
-  tape->tape           = malloc(tape->nTapes * sizeof(uint8_t*));
-  tape->aux_bits       = calloc(1, params->view_size);
-  tape->buffer         = aligned_alloc(32, 16 * sizeof(uint16_t));
+  tape->tape           = picnic_malloc(tape->nTapes * sizeof(uint8_t*));
+  tape->aux_bits       = picnic_calloc(1, params->view_size);
+  tape->buffer         = picnic_aligned_alloc(32, 16 * sizeof(uint16_t));
   size_t tapeSizeBytes = 2 * params->view_size;
-  tape->parity_tapes   = calloc(1, tapeSizeBytes);
-  uint8_t* slab        = calloc(1, tape->nTapes * tapeSizeBytes);
+  tape->parity_tapes   = picnic_calloc(1, tapeSizeBytes);
+  uint8_t* slab        = picnic_calloc(1, tape->nTapes * tapeSizeBytes);
   for (uint8_t i = 0; i < tape->nTapes; i++) {
     tape->tape[i] = slab;
     slab += tapeSizeBytes;
@@ -39,12 +40,13 @@ void allocateRandomTape(randomTape_t* tape, const picnic_instance_t* params) {
 }
 
 void freeRandomTape(randomTape_t* tape) {
-  if (tape != NULL) {
-    free(tape->tape[0]);
-    free(tape->tape);
-    free(tape->parity_tapes);
-    aligned_free(tape->buffer);
-    free(tape->aux_bits);
+  /* tapes of a transcript that was released before all rounds were committed are not allocated */
+  if (tape != NULL && tape->tape != NULL) {
+    picnic_free(tape->tape[0]);
+    picnic_free(tape->tape);
+    picnic_free(tape->parity_tapes);
+    picnic_aligned_free(tape->buffer);
+    picnic_free(tape->aux_bits);
   }
 }
 
@@ -54,18 +56,18 @@ void allocateProof2(proof2_t* proof, const picnic_instance_t* params) {
   proof->unOpenedIndex = 0;
   proof->seedInfo      = NULL; // Sign/verify code sets it
   proof->seedInfoLen   = 0;
-  proof->C             = malloc(params->digest_size);
-  proof->input         = malloc(params->input_size);
-  proof->aux           = malloc(params->view_size);
-  proof->msgs          = malloc(params->view_size);
+  proof->C             = picnic_malloc(params->digest_size);
+  proof->input         = picnic_malloc(params->input_size);
+  proof->aux           = picnic_malloc(params->view_size);
+  proof->msgs          = picnic_malloc(params->view_size);
 }
 
 static void freeProof2(proof2_t* proof) {
-  free(proof->seedInfo);
-  free(proof->C);
-  free(proof->input);
-  free(proof->aux);
-  free(proof->msgs);
+  picnic_free(proof->seedInfo);
+  picnic_free(proof->C);
+  picnic_free(proof->input);
+  picnic_free(proof->aux);
+  picnic_free(proof->msgs);
 }
 
 void allocateSignature2(signature2_t* sig, const picnic_instance_t* params) {
@@ -73,23 +75,23 @@ void allocateSignature2(signature2_t* sig, const picnic_instance_t* params) {
   sig->iSeedInfoLen = 0;
   sig->cvInfo       = NULL; // Sign/verify code sets it
   sig->cvInfoLen    = 0;
-  sig->challenge    = (uint8_t*)malloc(params->digest_size);
-  sig->challengeC   = (uint16_t*)malloc(params->num_opened_rounds * sizeof(uint16_t));
-  sig->challengeP   = (uint16_t*)malloc(params->num_opened_rounds * sizeof(uint16_t));
-  sig->proofs       = calloc(params->num_rounds, sizeof(proof2_t));
+  sig->challenge    = (uint8_t*)picnic_malloc(params->digest_size);
+  sig->challengeC   = (uint16_t*)picnic_malloc(params->num_opened_rounds * sizeof(uint16_t));
+  sig->challengeP   = (uint16_t*)picnic_malloc(params->num_opened_rounds * sizeof(uint16_t));
+  sig->proofs       = picnic_calloc(params->num_rounds, sizeof(proof2_t));
   // Individual proofs are allocated during signature generation, only for rounds when neeeded
 }
 
 void freeSignature2(signature2_t* sig, const picnic_instance_t* params) {
-  free(sig->iSeedInfo);
-  free(sig->cvInfo);
-  free(sig->challenge);
-  free(sig->challengeC);
-  free(sig->challengeP);
+  picnic_free(sig->iSeedInfo);
+  picnic_free(sig->cvInfo);
+  picnic_free(sig->challenge);
+  picnic_free(sig->challengeC);
+  picnic_free(sig->challengeP);
   for (size_t i = 0; i < params->num_rounds; i++) {
     freeProof2(&sig->proofs[i]);
   }
-  free(sig->proofs);
+  picnic_free(sig->proofs);
 }
 
 /* Allocate one commitments_t object with capacity for numCommitments values */
@@ -97,7 +99,7 @@ void allocateCommitments2(commitments_t* commitments, const picnic_instance_t* p
                           size_t numCommitments) {
   commitments->nCommitments = numCommitments;
 
-  uint8_t* slab = malloc(numCommitments * params->digest_size + numCommitments * sizeof(uint8_t*));
+  uint8_t* slab = picnic_malloc(numCommitments * params->digest_size + numCommitments * sizeof(uint8_t*));
 
   commitments->hashes = (uint8_t**)slab;
   slab += numCommitments * sizeof(uint8_t*);
@@ -110,12 +112,12 @@ void allocateCommitments2(commitments_t* commitments, const picnic_instance_t* p
 
 void freeCommitments2(commitments_t* commitments) {
   if (commitments != NULL) {
-    free(commitments->hashes);
+    picnic_free(commitments->hashes);
   }
 }
 
 inputs_t allocateInputs(const picnic_instance_t* params) {
-  uint8_t* slab = calloc(1, params->num_rounds * (params->input_size + sizeof(uint8_t*)));
+  uint8_t* slab = picnic_calloc(1, params->num_rounds * (params->input_size + sizeof(uint8_t*)));
 
   inputs_t inputs = (uint8_t**)slab;
 
@@ -130,14 +132,14 @@ inputs_t allocateInputs(const picnic_instance_t* params) {
 }
 
 void freeInputs(inputs_t inputs) {
-  free(inputs);
+  picnic_free(inputs);
 }
 
 msgs_t* allocateMsgs(const picnic_instance_t* params) {
-  msgs_t* msgs = malloc(params->num_rounds * sizeof(msgs_t));
+  msgs_t* msgs = picnic_malloc(params->num_rounds * sizeof(msgs_t));
 
   uint8_t* slab =
-      calloc(1, params->num_rounds * (params->num_MPC_parties * ((params->view_size + 7) / 8 * 8) +
+      picnic_calloc(1, params->num_rounds * (params->num_MPC_parties * ((params->view_size + 7) / 8 * 8) +
                                       params->num_MPC_parties * sizeof(uint8_t*)));
 
   for (uint32_t i = 0; i < params->num_rounds; i++) {
@@ -156,9 +158,9 @@ msgs_t* allocateMsgs(const picnic_instance_t* params) {
 }
 
 msgs_t* allocateMsgsVerify(const picnic_instance_t* params) {
-  msgs_t* msgs = malloc(sizeof(msgs_t));
+  msgs_t* msgs = picnic_malloc(sizeof(msgs_t));
 
-  uint8_t* slab = calloc(1, (params->num_MPC_parties * ((params->view_size + 7) / 8 * 8) +
+  uint8_t* slab = picnic_calloc(1, (params->num_MPC_parties * ((params->view_size + 7) / 8 * 8) +
                              params->num_MPC_parties * sizeof(uint8_t*)));
 
   msgs->pos      = 0;
@@ -175,16 +177,16 @@ msgs_t* allocateMsgsVerify(const picnic_instance_t* params) {
 }
 
 void freeMsgs(msgs_t* msgs) {
-  free(msgs[0].msgs);
-  free(msgs);
+  picnic_free(msgs[0].msgs);
+  picnic_free(msgs);
 }
 
 commitments_t* allocateCommitments(const picnic_instance_t* params, size_t numCommitments) {
-  commitments_t* commitments = malloc(params->num_rounds * sizeof(commitments_t));
+  commitments_t* commitments = picnic_malloc(params->num_rounds * sizeof(commitments_t));
 
   commitments->nCommitments = (numCommitments) ? numCommitments : params->num_MPC_parties;
 
-  uint8_t* slab = malloc(params->num_rounds * (commitments->nCommitments * params->digest_size +
+  uint8_t* slab = picnic_malloc(params->num_rounds * (commitments->nCommitments * params->digest_size +
                                                commitments->nCommitments * sizeof(uint8_t*)));
 
   for (uint32_t i = 0; i < params->num_rounds; i++) {
@@ -201,6 +203,6 @@ commitments_t* allocateCommitments(const picnic_instance_t* params, size_t numCo
 }
 
 void freeCommitments(commitments_t* commitments) {
-  free(commitments[0].hashes);
-  free(commitments);
+  picnic_free(commitments[0].hashes);
+  picnic_free(commitments);
 }
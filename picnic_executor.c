@@ -0,0 +1,384 @@
+/*
+ *  This file is part of the optimized implementation of the Picnic signature scheme.
+ *  See the accompanying documentation for complete details.
+ *
+ *  The code is provided under the MIT license, see LICENSE for
+ *  more details.
+ *  SPDX-License-Identifier: MIT
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "picnic.h"
+
+#include <stdbool.h>
+
+#include "allocator.h"
+
+#if defined(HAVE_PTHREAD)
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+#if defined(HAVE_SYS_EVENTFD_H)
+#include <sys/eventfd.h>
+#endif
+
+/* maximal number of queued verifications of one parameter set taken by a worker at once */
+#define VERIFY_BATCH_SIZE 8
+
+typedef struct {
+  pthread_mutex_t lock;
+  picnic_job_t* head;
+  picnic_job_t* tail;
+} job_queue_t;
+
+typedef struct {
+  struct picnic_executor_s* executor;
+  job_queue_t queue;
+  pthread_t thread;
+  bool started;
+} worker_t;
+
+struct picnic_executor_s {
+  worker_t* workers;
+  unsigned int num_workers;
+  /* protects pending, running and next and is used to wait for jobs */
+  pthread_mutex_t lock;
+  pthread_cond_t work;
+  /* number of jobs in all queues */
+  size_t pending;
+  bool running;
+  /* queue of the next submitted job */
+  unsigned int next;
+  /* completed jobs waiting for picnic_executor_dispatch */
+  job_queue_t done;
+  /* readable while completed jobs are waiting; both ends are the same eventfd if available */
+  int fds[2];
+};
+
+static void queue_push(job_queue_t* queue, picnic_job_t* job) {
+  job->next = NULL;
+  if (queue->tail) {
+    queue->tail->next = job;
+  } else {
+    queue->head = job;
+  }
+  queue->tail = job;
+}
+
+/* take the first job and, if it verifies a signature, further verifications of the same parameter
+ * set; caller has to hold the lock of the queue */
+static picnic_job_t* queue_take(job_queue_t* queue, size_t* count) {
+  picnic_job_t* first = queue->head;
+  if (!first) {
+    return NULL;
+  }
+  queue->head = first->next;
+  if (!queue->head) {
+    queue->tail = NULL;
+  }
+  first->next = NULL;
+  *count      = 1;
+
+  picnic_job_t* last = first;
+  picnic_job_t* prev = NULL;
+  for (picnic_job_t* it = queue->head; first->verify && it && *count < VERIFY_BATCH_SIZE;) {
+    picnic_job_t* next = it->next;
+    if (it->verify && it->pk->data[0] == first->pk->data[0]) {
+      if (prev) {
+        prev->next = next;
+      } else {
+        queue->head = next;
+      }
+      if (queue->tail == it) {
+        queue->tail = prev;
+      }
+      it->next   = NULL;
+      last->next = it;
+      last       = it;
+      ++*count;
+    } else {
+      prev = it;
+    }
+    it = next;
+  }
+  return first;
+}
+
+/* take jobs from the own queue, or steal them from the other workers */
+static picnic_job_t* take_jobs(picnic_executor_t* executor, unsigned int self) {
+  for (unsigned int i = 0; i < executor->num_workers; ++i) {
+    job_queue_t* queue = &executor->workers[(self + i) % executor->num_workers].queue;
+    size_t count       = 0;
+
+    pthread_mutex_lock(&queue->lock);
+    picnic_job_t* jobs = queue_take(queue, &count);
+    pthread_mutex_unlock(&queue->lock);
+    if (jobs) {
+      pthread_mutex_lock(&executor->lock);
+      executor->pending -= count;
+      pthread_mutex_unlock(&executor->lock);
+      return jobs;
+    }
+  }
+  return NULL;
+}
+
+static void notify(picnic_executor_t* executor, uint64_t count) {
+#if defined(HAVE_SYS_EVENTFD_H)
+  ssize_t ret = write(executor->fds[1], &count, sizeof(count));
+#else
+  /* the pipe only needs to be readable */
+  const uint8_t byte = 1;
+  ssize_t ret        = write(executor->fds[1], &byte, sizeof(byte));
+  (void)count;
+#endif
+  /* the counter or the pipe is full, so it is readable anyway */
+  (void)ret;
+}
+
+static void run_jobs(picnic_executor_t* executor, picnic_job_t* jobs) {
+  uint64_t count = 0;
+  for (picnic_job_t* job = jobs; job; job = job->next, ++count) {
+    if (job->verify) {
+      job->result = picnic_verify(job->pk, job->message, job->message_len, job->signature,
+                                  job->signature_len);
+    } else {
+      job->result = picnic_sign(job->sk, job->message, job->message_len, job->signature,
+                                &job->signature_len);
+    }
+  }
+
+  pthread_mutex_lock(&executor->done.lock);
+  for (picnic_job_t* job = jobs; job;) {
+    picnic_job_t* next = job->next;
+    queue_push(&executor->done, job);
+    job = next;
+  }
+  pthread_mutex_unlock(&executor->done.lock);
+  notify(executor, count);
+}
+
+static void* worker_main(void* arg) {
+  worker_t* worker            = arg;
+  picnic_executor_t* executor = worker->executor;
+  const unsigned int self     = worker - executor->workers;
+
+  for (;;) {
+    picnic_job_t* jobs = take_jobs(executor, self);
+    if (jobs) {
+      run_jobs(executor, jobs);
+      continue;
+    }
+
+    pthread_mutex_lock(&executor->lock);
+    while (!executor->pending && executor->running) {
+      pthread_cond_wait(&executor->work, &executor->lock);
+    }
+    /* all submitted jobs are completed before the workers stop */
+    const bool stop = !executor->pending && !executor->running;
+    pthread_mutex_unlock(&executor->lock);
+    if (stop) {
+      break;
+    }
+  }
+  return NULL;
+}
+
+static int open_fds(int fds[2]) {
+#if defined(HAVE_SYS_EVENTFD_H)
+  fds[0] = fds[1] = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  return fds[0] == -1 ? -1 : 0;
+#else
+  if (pipe(fds)) {
+    return -1;
+  }
+  for (unsigned int i = 0; i < 2; ++i) {
+    fcntl(fds[i], F_SETFL, fcntl(fds[i], F_GETFL) | O_NONBLOCK);
+    fcntl(fds[i], F_SETFD, FD_CLOEXEC);
+  }
+  return 0;
+#endif
+}
+
+static void close_fds(int fds[2]) {
+  close(fds[0]);
+  if (fds[1] != fds[0]) {
+    close(fds[1]);
+  }
+}
+
+picnic_executor_t* PICNIC_CALLING_CONVENTION picnic_executor_create(unsigned int threads) {
+  if (!threads) {
+    const long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    threads         = cpus > 0 ? cpus : 1;
+  }
+
+  picnic_executor_t* executor = picnic_calloc_persistent(1, sizeof(picnic_executor_t));
+  if (!executor) {
+    return NULL;
+  }
+  executor->workers = picnic_calloc_persistent(threads, sizeof(worker_t));
+  if (!executor->workers || open_fds(executor->fds)) {
+    picnic_free(executor->workers);
+    picnic_free(executor);
+    return NULL;
+  }
+  executor->num_workers = threads;
+  executor->running     = true;
+  pthread_mutex_init(&executor->lock, NULL);
+  pthread_cond_init(&executor->work, NULL);
+  pthread_mutex_init(&executor->done.lock, NULL);
+  for (unsigned int i = 0; i < threads; ++i) {
+    executor->workers[i].executor = executor;
+    pthread_mutex_init(&executor->workers[i].queue.lock, NULL);
+  }
+
+  for (unsigned int i = 0; i < threads; ++i) {
+    if (pthread_create(&executor->workers[i].thread, NULL, worker_main, &executor->workers[i])) {
+      picnic_executor_destroy(executor);
+      return NULL;
+    }
+    executor->workers[i].started = true;
+  }
+  return executor;
+}
+
+static int submit(picnic_executor_t* executor, picnic_job_t* job, picnic_job_callback_t callback) {
+  job->callback = callback;
+
+  pthread_mutex_lock(&executor->lock);
+  if (!executor->running) {
+    /* the workers may already be gone */
+    pthread_mutex_unlock(&executor->lock);
+    return -1;
+  }
+  job_queue_t* queue = &executor->workers[executor->next++ % executor->num_workers].queue;
+  pthread_mutex_lock(&queue->lock);
+  queue_push(queue, job);
+  pthread_mutex_unlock(&queue->lock);
+  ++executor->pending;
+  pthread_cond_signal(&executor->work);
+  pthread_mutex_unlock(&executor->lock);
+  return 0;
+}
+
+int PICNIC_CALLING_CONVENTION picnic_submit_sign(picnic_executor_t* executor, picnic_job_t* job,
+                                                 picnic_job_callback_t callback) {
+  if (!executor || !job || !job->sk || !callback) {
+    return -1;
+  }
+  job->verify = 0;
+  return submit(executor, job, callback);
+}
+
+int PICNIC_CALLING_CONVENTION picnic_submit_verify(picnic_executor_t* executor, picnic_job_t* job,
+                                                   picnic_job_callback_t callback) {
+  if (!executor || !job || !job->pk || !callback) {
+    return -1;
+  }
+  job->verify = 1;
+  return submit(executor, job, callback);
+}
+
+int PICNIC_CALLING_CONVENTION picnic_executor_fd(const picnic_executor_t* executor) {
+  return executor ? executor->fds[0] : -1;
+}
+
+size_t PICNIC_CALLING_CONVENTION picnic_executor_dispatch(picnic_executor_t* executor) {
+  if (!executor) {
+    return 0;
+  }
+
+  /* clear the notification before taking the jobs, so that no completion is missed */
+#if defined(HAVE_SYS_EVENTFD_H)
+  uint64_t value;
+  ssize_t ret = read(executor->fds[0], &value, sizeof(value));
+  (void)ret;
+#else
+  uint8_t buffer[64];
+  while (read(executor->fds[0], buffer, sizeof(buffer)) > 0) {
+  }
+#endif
+
+  pthread_mutex_lock(&executor->done.lock);
+  picnic_job_t* jobs  = executor->done.head;
+  executor->done.head = NULL;
+  executor->done.tail = NULL;
+  pthread_mutex_unlock(&executor->done.lock);
+
+  size_t count = 0;
+  while (jobs) {
+    /* the callback may reuse or release the job */
+    picnic_job_t* next = jobs->next;
+    jobs->callback(jobs);
+    jobs = next;
+    ++count;
+  }
+  return count;
+}
+
+void PICNIC_CALLING_CONVENTION picnic_executor_destroy(picnic_executor_t* executor) {
+  if (!executor) {
+    return;
+  }
+
+  pthread_mutex_lock(&executor->lock);
+  executor->running = false;
+  pthread_cond_broadcast(&executor->work);
+  pthread_mutex_unlock(&executor->lock);
+  for (unsigned int i = 0; i < executor->num_workers; ++i) {
+    if (executor->workers[i].started) {
+      pthread_join(executor->workers[i].thread, NULL);
+    }
+  }
+  picnic_executor_dispatch(executor);
+
+  for (unsigned int i = 0; i < executor->num_workers; ++i) {
+    pthread_mutex_destroy(&executor->workers[i].queue.lock);
+  }
+  pthread_mutex_destroy(&executor->done.lock);
+  pthread_cond_destroy(&executor->work);
+  pthread_mutex_destroy(&executor->lock);
+  close_fds(executor->fds);
+  picnic_free(executor->workers);
+  picnic_free(executor);
+}
+#else
+picnic_executor_t* PICNIC_CALLING_CONVENTION picnic_executor_create(unsigned int threads) {
+  (void)threads;
+  return NULL;
+}
+
+int PICNIC_CALLING_CONVENTION picnic_submit_sign(picnic_executor_t* executor, picnic_job_t* job,
+                                                 picnic_job_callback_t callback) {
+  (void)executor;
+  (void)job;
+  (void)callback;
+  return -1;
+}
+
+int PICNIC_CALLING_CONVENTION picnic_submit_verify(picnic_executor_t* executor, picnic_job_t* job,
+                                                   picnic_job_callback_t callback) {
+  (void)executor;
+  (void)job;
+  (void)callback;
+  return -1;
+}
+
+int PICNIC_CALLING_CONVENTION picnic_executor_fd(const picnic_executor_t* executor) {
+  (void)executor;
+  return -1;
+}
+
+size_t PICNIC_CALLING_CONVENTION picnic_executor_dispatch(picnic_executor_t* executor) {
+  (void)executor;
+  return 0;
+}
+
+void PICNIC_CALLING_CONVENTION picnic_executor_destroy(picnic_executor_t* executor) {
+  (void)executor;
+}
+#endif
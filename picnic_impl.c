@@ -11,13 +11,16 @@
 #include <config.h>
 #endif
 
+#include "allocator.h"
 #include "bitstream.h"
 #include "compat.h"
+#include "hash_jobs.h"
 #include "io.h"
 #include "kdf_shake.h"
 #include "lowmc.h"
 #include "mpc_lowmc.h"
 #include "picnic_impl.h"
+#include "picnic_stats.h"
 #include "randomness.h"
 
 #include <limits.h>
@@ -34,20 +37,11 @@
 #define MAX_NUM_ROUNDS 219
 #endif
 
-/* max view size per round */
-#if defined(WITH_LOWMC_256_256_38)
-#define MAX_VIEW_SIZE 143
-#elif defined(WITH_LOWMC_255_255_4)
-#define MAX_VIEW_SIZE 128
-#elif defined(WITH_LOWMC_192_192_30)
-#define MAX_VIEW_SIZE 113
-#elif defined(WITH_LOWMC_192_192_4)
-#define MAX_VIEW_SIZE 96
-#elif defined(WITH_LOWMC_128_128_20)
-#define MAX_VIEW_SIZE 75
-#elif defined(WITH_LOWMC_129_129_4)
-#define MAX_VIEW_SIZE 65
-#endif
+/* rounds per step of impl_sign_step, i.e., one group of the 4x implementations */
+#define SIGN_STEP_ROUNDS 4
+/* rounds per step of impl_verify_step; the rounds of a step are grouped by their challenge, hence
+ * more rounds are needed to fill the groups of the 4x implementations */
+#define VERIFY_STEP_ROUNDS 12
 
 typedef struct {
   uint8_t* seeds[SC_PROOF];
@@ -60,9 +54,11 @@ typedef struct {
 #endif
 } proof_round_t;
 
-typedef struct {
+typedef struct sig_proof_s {
   uint8_t* challenge;
   uint8_t* salt;
+  /* states of the LowMC evaluation, kept by transcripts of impl_sign_begin for all steps */
+  recorded_state_t* recorded_state;
   proof_round_t round[];
 } sig_proof_t;
 
@@ -128,7 +124,7 @@ static sig_proof_t* proof_new(const picnic_instance_t* pp) {
   const size_t unruh_with_input_bytes_size    = pp->unruh_with_input_bytes_size;
   const size_t unruh_without_input_bytes_size = pp->unruh_without_input_bytes_size;
 
-  sig_proof_t* prf = calloc(1, sizeof(sig_proof_t) + num_rounds * sizeof(proof_round_t));
+  sig_proof_t* prf = picnic_calloc(1, sizeof(sig_proof_t) + num_rounds * sizeof(proof_round_t));
   if (!prf) {
     return NULL;
   }
@@ -154,7 +150,7 @@ static sig_proof_t* proof_new(const picnic_instance_t* pp) {
   // Since seeds size, commitment size, input share size and output share size are all divisible by
   // the alignment of uint64_t, this means, that up to the memory of the Gs, everything is
   // uint64_t-aligned.
-  uint8_t* slab  = calloc(1, num_rounds * per_round_mem + ALIGNU64T(num_rounds) + SALT_SIZE);
+  uint8_t* slab  = picnic_calloc(1, num_rounds * per_round_mem + ALIGNU64T(num_rounds) + SALT_SIZE);
   prf->challenge = slab;
   slab += ALIGNU64T(num_rounds);
 
@@ -219,7 +215,7 @@ static sig_proof_t* proof_new_verify(const picnic_instance_t* pp, uint8_t** rsla
   const size_t view_size                   = ALIGNU64T(pp->view_size);
   const size_t unruh_with_input_bytes_size = pp->unruh_with_input_bytes_size;
 
-  sig_proof_t* proof = calloc(1, sizeof(sig_proof_t) + num_rounds * sizeof(proof_round_t));
+  sig_proof_t* proof = picnic_calloc(1, sizeof(sig_proof_t) + num_rounds * sizeof(proof_round_t));
   if (!proof) {
     return NULL;
   }
@@ -233,7 +229,7 @@ static sig_proof_t* proof_new_verify(const picnic_instance_t* pp, uint8_t** rsla
 #endif
   per_round_mem += SC_VERIFY * input_size + SC_PROOF * output_size + view_size;
 
-  uint8_t* slab    = calloc(1, num_rounds * per_round_mem + ALIGNU64T(num_rounds) + SALT_SIZE);
+  uint8_t* slab    = picnic_calloc(1, num_rounds * per_round_mem + ALIGNU64T(num_rounds) + SALT_SIZE);
   proof->challenge = slab;
   slab += ALIGNU64T(num_rounds);
 
@@ -277,8 +273,9 @@ static sig_proof_t* proof_new_verify(const picnic_instance_t* pp, uint8_t** rsla
 }
 
 static void proof_free(sig_proof_t* prf) {
-  free(prf->challenge);
-  free(prf);
+  picnic_aligned_free(prf->recorded_state);
+  picnic_free(prf->challenge);
+  picnic_free(prf);
 }
 
 static void kdf_init_from_seed(kdf_shake_t* kdf, const uint8_t* seed, const uint8_t* salt,
@@ -332,17 +329,8 @@ static void kdf_init_x4_from_seed(kdf_shake_x4_t* kdf, const uint8_t** seed, con
   kdf_shake_x4_finalize_key(kdf);
 }
 
-#if defined(WITH_LOWMC_128_128_20) || defined(WITH_LOWMC_192_192_30) || defined(WITH_LOWMC_256_256_38)
-static void uint64_to_bitstream_10(bitstream_t* bs, const uint64_t v) {
-  bitstream_put_bits(bs, v >> (64 - 30), 30);
-}
-
-static uint64_t uint64_from_bitstream_10(bitstream_t* bs) {
-  return bitstream_get_bits(bs, 30) << (64 - 30);
-}
-#endif
-
-static void compress_view(uint8_t* dst, const picnic_instance_t* pp, const view_t* views,
+/* views is an array of view_t, or of view_partial_t for the instances with partial S-box layer */
+static void compress_view(uint8_t* dst, const picnic_instance_t* pp, const void* views,
                           const unsigned int idx) {
   const size_t num_views = pp->lowmc.r;
 
@@ -350,12 +338,12 @@ static void compress_view(uint8_t* dst, const picnic_instance_t* pp, const view_
   bs.buffer.w = dst;
   bs.position = 0;
 
-  const view_t* v = &views[0];
 #if defined(WITH_LOWMC_129_129_4) || defined(WITH_LOWMC_192_192_4) || defined(WITH_LOWMC_255_255_4)
   if (pp->lowmc.m != 10) {
     const size_t view_round_size = pp->view_round_size;
     const size_t width           = (pp->lowmc.n + 63) / 64;
 
+    const view_t* v = views;
     for (size_t i = 0; i < num_views; ++i, ++v) {
       mzd_to_bitstream(&bs, &v->s[idx], width, view_round_size);
     }
@@ -364,14 +352,14 @@ static void compress_view(uint8_t* dst, const picnic_instance_t* pp, const view_
 #endif
 #if defined(WITH_LOWMC_128_128_20) || defined(WITH_LOWMC_192_192_30) || defined(WITH_LOWMC_256_256_38)
   if (pp->lowmc.m == 10) {
-    for (size_t i = 0; i < num_views; ++i, ++v) {
-      uint64_to_bitstream_10(&bs, v->t[idx]);
-    }
+    const view_partial_t* v = views;
+    bitstream_put_fields_32(&bs, &v->t[idx], sizeof(view_partial_t) / sizeof(uint32_t), num_views,
+                            30);
   }
 #endif
 }
 
-static void decompress_view(view_t* views, const picnic_instance_t* pp, const uint8_t* src,
+static void decompress_view(void* views, const picnic_instance_t* pp, const uint8_t* src,
                             const unsigned int idx) {
   const size_t num_views = pp->lowmc.r;
 
@@ -379,12 +367,12 @@ static void decompress_view(view_t* views, const picnic_instance_t* pp, const ui
   bs.buffer.r = src;
   bs.position = 0;
 
-  view_t* v = &views[0];
 #if defined(WITH_LOWMC_129_129_4) || defined(WITH_LOWMC_192_192_4) || defined(WITH_LOWMC_255_255_4)
   if (pp->lowmc.m != 10) {
     const size_t view_round_size = pp->view_round_size;
     const size_t width           = (pp->lowmc.n + 63) / 64;
 
+    view_t* v = views;
     for (size_t i = 0; i < num_views; ++i, ++v) {
       mzd_from_bitstream(&bs, &v->s[idx], width, view_round_size);
     }
@@ -393,44 +381,55 @@ static void decompress_view(view_t* views, const picnic_instance_t* pp, const ui
 #endif
 #if defined(WITH_LOWMC_128_128_20) || defined(WITH_LOWMC_192_192_30) || defined(WITH_LOWMC_256_256_38)
   if (pp->lowmc.m == 10) {
-    for (size_t i = 0; i < num_views; ++i, ++v) {
-      v->t[idx] = uint64_from_bitstream_10(&bs);
-    }
+    view_partial_t* v = views;
+    bitstream_get_fields_32(&bs, &v->t[idx], sizeof(view_partial_t) / sizeof(uint32_t), num_views,
+                            30);
   }
 #endif
 }
 
-static void decompress_random_tape(rvec_t* rvec, const picnic_instance_t* pp, const uint8_t* src,
-                                   const unsigned int idx) {
+void decompress_random_tape(void* rvec, const picnic_instance_t* pp, const uint8_t* src,
+                            const unsigned int idx) {
   decompress_view(rvec, pp, src, idx);
 }
 
 /**
- * Compute commitment to a view.
+ * Compute commitments to the first num_views views of rounds that do not fill a group of 4. The
+ * hashes of all the rounds are batched.
  */
-static void hash_commitment(const picnic_instance_t* pp, proof_round_t* prf_round,
-                            const unsigned int vidx) {
+static void hash_commitments_batched(const picnic_instance_t* pp, proof_round_t* const* rounds,
+                                     unsigned int num_rounds, unsigned int num_views) {
   const size_t hashlen = pp->digest_size;
 
-  hash_context ctx;
-  // hash the seed
-  hash_init_prefix(&ctx, hashlen, HASH_PREFIX_4);
-  hash_update(&ctx, prf_round->seeds[vidx], pp->seed_size);
-  hash_final(&ctx);
-  uint8_t tmp[MAX_DIGEST_SIZE];
-  hash_squeeze(&ctx, tmp, hashlen);
+  hash_queue_t queue;
+  // hash the seeds, the commitments hold H_4(seed) until they are computed
+  hash_queue_init_prefix(&queue, hashlen, HASH_PREFIX_4, hashlen);
+  hash_queue_add_input(&queue, pp->seed_size);
+  for (unsigned int r = 0; r < num_rounds; ++r) {
+    for (unsigned int vidx = 0; vidx < num_views; ++vidx) {
+      hash_job_t* job = hash_queue_push(&queue, rounds[r]->commitments[vidx]);
+      job->data[0]    = rounds[r]->seeds[vidx];
+    }
+  }
+  hash_queue_flush(&queue);
 
   // compute H_0(H_4(seed), view)
-  hash_init_prefix(&ctx, hashlen, HASH_PREFIX_0);
-  hash_update(&ctx, tmp, hashlen);
-  // hash input share
-  hash_update(&ctx, prf_round->input_shares[vidx], pp->input_size);
-  // hash communicated bits
-  hash_update(&ctx, prf_round->communicated_bits[vidx], pp->view_size);
-  // hash output share
-  hash_update(&ctx, prf_round->output_shares[vidx], pp->output_size);
-  hash_final(&ctx);
-  hash_squeeze(&ctx, prf_round->commitments[vidx], hashlen);
+  hash_queue_init_prefix(&queue, hashlen, HASH_PREFIX_0, hashlen);
+  hash_queue_add_input(&queue, hashlen);
+  // input share, communicated bits and output share
+  hash_queue_add_input(&queue, pp->input_size);
+  hash_queue_add_input(&queue, pp->view_size);
+  hash_queue_add_input(&queue, pp->output_size);
+  for (unsigned int r = 0; r < num_rounds; ++r) {
+    for (unsigned int vidx = 0; vidx < num_views; ++vidx) {
+      hash_job_t* job = hash_queue_push(&queue, rounds[r]->commitments[vidx]);
+      job->data[0]    = rounds[r]->commitments[vidx];
+      job->data[1]    = rounds[r]->input_shares[vidx];
+      job->data[2]    = rounds[r]->communicated_bits[vidx];
+      job->data[3]    = rounds[r]->output_shares[vidx];
+    }
+  }
+  hash_queue_flush(&queue);
 }
 
 /**
@@ -698,34 +697,61 @@ static void H3(const picnic_instance_t* pp, sig_proof_t* prf, const uint8_t* cir
 
 #if defined(WITH_UNRUH)
 /*
- * G permutation for Unruh transform
+ * G permutation for Unruh transform of the first num_views views of rounds that do not fill a group
+ * of 4. include_is[r * num_views + vidx] selects whether the input share is included. The hashes of
+ * all the rounds are batched.
  */
-static void unruh_G(const picnic_instance_t* pp, proof_round_t* prf_round, unsigned int vidx,
-                    bool include_is) {
-  const size_t outputlen =
-      include_is ? pp->unruh_with_input_bytes_size : pp->unruh_without_input_bytes_size;
+static void unruh_G_batched(const picnic_instance_t* pp, proof_round_t* const* rounds,
+                            unsigned int num_rounds, unsigned int num_views,
+                            const bool* include_is) {
   const size_t digest_size = pp->digest_size;
   const size_t seedlen     = pp->seed_size;
-
-  // Hash the seed with H_5, store digest in output
-  hash_context ctx;
-  hash_init_prefix(&ctx, digest_size, HASH_PREFIX_5);
-  hash_update(&ctx, prf_round->seeds[vidx], seedlen);
-  hash_final(&ctx);
-
-  uint8_t tmp[MAX_DIGEST_SIZE];
-  hash_squeeze(&ctx, tmp, digest_size);
+  const size_t with_is     = pp->unruh_with_input_bytes_size;
+  const size_t without_is  = pp->unruh_without_input_bytes_size;
+
+  // Hash the seeds with H_5, the outputs hold H_5(seed) until they are computed
+  assert(without_is >= digest_size && with_is >= digest_size);
+  hash_queue_t queue;
+  hash_queue_init_prefix(&queue, digest_size, HASH_PREFIX_5, digest_size);
+  hash_queue_add_input(&queue, seedlen);
+  for (unsigned int r = 0; r < num_rounds; ++r) {
+    for (unsigned int vidx = 0; vidx < num_views; ++vidx) {
+      hash_job_t* job = hash_queue_push(&queue, rounds[r]->gs[vidx]);
+      job->data[0]    = rounds[r]->seeds[vidx];
+    }
+  }
+  hash_queue_flush(&queue);
 
   // Hash H_5(seed), the view, and the length
-  hash_init(&ctx, digest_size);
-  hash_update(&ctx, tmp, digest_size);
-  if (include_is) {
-    hash_update(&ctx, prf_round->input_shares[vidx], pp->input_size);
+  hash_queue_t queue_is;
+  hash_queue_init(&queue_is, digest_size, with_is);
+  hash_queue_add_input(&queue_is, digest_size);
+  hash_queue_add_input(&queue_is, pp->input_size);
+  hash_queue_add_input(&queue_is, pp->view_size);
+  hash_queue_add_input(&queue_is, HASH_INPUT_UINT16);
+  hash_queue_init(&queue, digest_size, without_is);
+  hash_queue_add_input(&queue, digest_size);
+  hash_queue_add_input(&queue, pp->view_size);
+  hash_queue_add_input(&queue, HASH_INPUT_UINT16);
+  for (unsigned int r = 0; r < num_rounds; ++r) {
+    for (unsigned int vidx = 0; vidx < num_views; ++vidx) {
+      uint8_t* gs = rounds[r]->gs[vidx];
+      if (include_is[r * num_views + vidx]) {
+        hash_job_t* job = hash_queue_push(&queue_is, gs);
+        job->data[0]    = gs;
+        job->data[1]    = rounds[r]->input_shares[vidx];
+        job->data[2]    = rounds[r]->communicated_bits[vidx];
+        job->values[3]  = with_is;
+      } else {
+        hash_job_t* job = hash_queue_push(&queue, gs);
+        job->data[0]    = gs;
+        job->data[1]    = rounds[r]->communicated_bits[vidx];
+        job->values[2]  = without_is;
+      }
+    }
   }
-  hash_update(&ctx, prf_round->communicated_bits[vidx], pp->view_size);
-  hash_update_uint16_le(&ctx, outputlen);
-  hash_final(&ctx);
-  hash_squeeze(&ctx, prf_round->gs[vidx], outputlen);
+  hash_queue_flush(&queue_is);
+  hash_queue_flush(&queue);
 }
 
 /*
@@ -1034,389 +1060,340 @@ static void generate_seeds(const picnic_instance_t* pp, const uint8_t* private_k
   kdf_shake_clear(&ctx);
 }
 
-static int sign_impl(const picnic_instance_t* pp, const uint8_t* private_key,
-                     const lowmc_key_t* lowmc_key, const uint8_t* plaintext, const mzd_local_t* p,
-                     const uint8_t* public_key, const uint8_t* m, size_t m_len, uint8_t* sig,
-                     size_t* siglen) {
-  const size_t num_rounds     = pp->num_rounds;
-#if defined(WITH_UNRUH)
-  const transform_t transform = pp->transform;
+// ZKB++ instances with partial LowMC instances
+#if defined(WITH_LOWMC_128_128_20)
+#define ZKBPP_INSTANCE lowmc_128_128_20
+#define ZKBPP_LOWMC_N 128
+#define ZKBPP_LOWMC_M 10
+#define ZKBPP_LOWMC_R 20
+#define ZKBPP_NUM_ROUNDS 219
+#include "picnic_impl.c.i"
 #endif
-  const size_t input_size     = pp->input_size;
-  const size_t output_size    = pp->output_size;
-  const size_t lowmc_r        = pp->lowmc.r;
-  const size_t view_size      = pp->view_size;
-  const unsigned int diff     = input_size * 8 - pp->lowmc.n;
 
-  const zkbpp_lowmc_implementation_f lowmc_impl       = pp->impls.zkbpp_lowmc;
-  const lowmc_store_implementation_f lowmc_store_impl = pp->impls.lowmc_store;
-  const zkbpp_share_implementation_f mzd_share        = pp->impls.mzd_share;
-
-  // Perform LowMC evaluation and record state before AND gates
-  recorded_state_t* recorded_state = aligned_alloc(32, sizeof(recorded_state_t) * (lowmc_r + 1));
-  lowmc_store_impl(lowmc_key, p, recorded_state);
-
-  sig_proof_t* prf = proof_new(pp);
-  view_t* views    = aligned_alloc(32, sizeof(view_t) * lowmc_r);
+#if defined(WITH_LOWMC_192_192_30)
+#define ZKBPP_INSTANCE lowmc_192_192_30
+#define ZKBPP_LOWMC_N 192
+#define ZKBPP_LOWMC_M 10
+#define ZKBPP_LOWMC_R 30
+#define ZKBPP_NUM_ROUNDS 329
+#include "picnic_impl.c.i"
+#endif
 
-  in_out_shares_t in_out_shares[2];
+#if defined(WITH_LOWMC_256_256_38)
+#define ZKBPP_INSTANCE lowmc_256_256_38
+#define ZKBPP_LOWMC_N 256
+#define ZKBPP_LOWMC_M 10
+#define ZKBPP_LOWMC_R 38
+#define ZKBPP_NUM_ROUNDS 438
+#include "picnic_impl.c.i"
+#endif
 
-  // Generate seeds
-  generate_seeds(pp, private_key, plaintext, public_key, m, m_len, prf->round[0].seeds[0],
-                 prf->salt);
+// ZKB++ instances with full LowMC instances
+#if defined(WITH_LOWMC_129_129_4)
+#define ZKBPP_INSTANCE lowmc_129_129_4
+#define ZKBPP_LOWMC_N 129
+#define ZKBPP_LOWMC_M 43
+#define ZKBPP_LOWMC_R 4
+#define ZKBPP_NUM_ROUNDS 219
+#include "picnic_impl.c.i"
+#endif
 
-  rvec_t* rvec = aligned_alloc(32, sizeof(rvec_t) * lowmc_r); // random tapes for AND-gates
+#if defined(WITH_LOWMC_192_192_4)
+#define ZKBPP_INSTANCE lowmc_192_192_4
+#define ZKBPP_LOWMC_N 192
+#define ZKBPP_LOWMC_M 64
+#define ZKBPP_LOWMC_R 4
+#define ZKBPP_NUM_ROUNDS 329
+#include "picnic_impl.c.i"
+#endif
 
-  proof_round_t* round = prf->round;
-  // use 4 parallel instances of keccak for speedup
-  uint8_t* tape_bytes_x4[SC_PROOF][4];
-  for (unsigned int k = 0; k < SC_PROOF; k++) {
-    for (unsigned int j = 0; j < 4; j++) {
-      tape_bytes_x4[k][j] = malloc(view_size);
-    }
-  }
-  unsigned int i = 0;
-  for (; i < (num_rounds / 4) * 4; i += 4, round += 4) {
-    kdf_shake_x4_t kdfs[SC_PROOF];
-    for (unsigned int j = 0; j < SC_PROOF; ++j) {
-      const bool include_input_size   = (j != SC_PROOF - 1);
-      const uint8_t* seeds[4]         = {round[0].seeds[j], round[1].seeds[j], round[2].seeds[j],
-                                 round[3].seeds[j]};
-      const uint16_t round_numbers[4] = {i, i + 1, i + 2, i + 3};
-      kdf_init_x4_from_seed(&kdfs[j], seeds, prf->salt, round_numbers, j, include_input_size, pp);
-    }
+#if defined(WITH_LOWMC_255_255_4)
+#define ZKBPP_INSTANCE lowmc_255_255_4
+#define ZKBPP_LOWMC_N 255
+#define ZKBPP_LOWMC_M 85
+#define ZKBPP_LOWMC_R 4
+#define ZKBPP_NUM_ROUNDS 438
+#include "picnic_impl.c.i"
+#endif
 
-    // compute sharing
-    for (unsigned int j = 0; j < SC_PROOF - 1; ++j) {
-      uint8_t* input_shares[4] = {round[0].input_shares[j], round[1].input_shares[j],
-                                  round[2].input_shares[j], round[3].input_shares[j]};
-      kdf_shake_x4_get_randomness(&kdfs[j], input_shares, input_size);
+zkbpp_prove_rounds_f get_zkbpp_prove_rounds_implementation(const lowmc_parameters_t* lowmc) {
+  switch (lowmc->n) {
+#if defined(WITH_LOWMC_128_128_20)
+  case 128:
+    return prove_rounds_lowmc_128_128_20;
+#endif
+#if defined(WITH_LOWMC_129_129_4)
+  case 129:
+    return prove_rounds_lowmc_129_129_4;
+#endif
+  case 192:
+#if defined(WITH_LOWMC_192_192_30)
+    if (lowmc->m == 10) {
+      return prove_rounds_lowmc_192_192_30;
     }
-    // compute random tapes
-    for (unsigned int j = 0; j < SC_PROOF; ++j) {
-      kdf_shake_x4_get_randomness(&kdfs[j], tape_bytes_x4[j], view_size);
-      kdf_shake_x4_clear(&kdfs[j]);
+#endif
+#if defined(WITH_LOWMC_192_192_4)
+    if (lowmc->m == 64) {
+      return prove_rounds_lowmc_192_192_4;
     }
+#endif
+    break;
+#if defined(WITH_LOWMC_255_255_4)
+  case 255:
+    return prove_rounds_lowmc_255_255_4;
+#endif
+#if defined(WITH_LOWMC_256_256_38)
+  case 256:
+    return prove_rounds_lowmc_256_256_38;
+#endif
+  }
 
-    for (unsigned int round_offset = 0; round_offset < 4; round_offset++) {
-      for (unsigned int j = 0; j < SC_PROOF - 1; ++j) {
-        clear_padding_bits(&round[round_offset].input_shares[j][input_size - 1], diff);
-        mzd_from_char_array(in_out_shares[0].s[j], round[round_offset].input_shares[j], input_size);
-      }
-      mzd_share(in_out_shares[0].s[2], in_out_shares[0].s[0], in_out_shares[0].s[1], lowmc_key);
-      mzd_to_char_array(round[round_offset].input_shares[SC_PROOF - 1],
-                        in_out_shares[0].s[SC_PROOF - 1], input_size);
-
-      for (unsigned int j = 0; j < SC_PROOF; ++j) {
-        decompress_random_tape(rvec, pp, tape_bytes_x4[j][round_offset], j);
-      }
-
-      // perform ZKB++ LowMC evaluation
-      lowmc_impl(p, views, in_out_shares, rvec, recorded_state);
-
-      for (unsigned int j = 0; j < SC_PROOF; ++j) {
-        mzd_to_char_array(round[round_offset].output_shares[j], in_out_shares[1].s[j], output_size);
-        compress_view(round[round_offset].communicated_bits[j], pp, views, j);
-      }
-    }
+  return NULL;
+}
 
-    // commitments
-    for (unsigned int j = 0; j < SC_PROOF; ++j) {
-      hash_commitment_x4(pp, round, j);
+zkbpp_verify_rounds_f get_zkbpp_verify_rounds_implementation(const lowmc_parameters_t* lowmc) {
+  switch (lowmc->n) {
+#if defined(WITH_LOWMC_128_128_20)
+  case 128:
+    return verify_rounds_lowmc_128_128_20;
+#endif
+#if defined(WITH_LOWMC_129_129_4)
+  case 129:
+    return verify_rounds_lowmc_129_129_4;
+#endif
+  case 192:
+#if defined(WITH_LOWMC_192_192_30)
+    if (lowmc->m == 10) {
+      return verify_rounds_lowmc_192_192_30;
     }
-
-#if defined(WITH_UNRUH)
-    // unruh G
-    if (transform == TRANSFORM_UR) {
-      for (unsigned int j = 0; j < SC_PROOF; ++j) {
-        unruh_G_x4(pp, round, j, j == SC_PROOF - 1);
-      }
+#endif
+#if defined(WITH_LOWMC_192_192_4)
+    if (lowmc->m == 64) {
+      return verify_rounds_lowmc_192_192_4;
     }
+#endif
+    break;
+#if defined(WITH_LOWMC_255_255_4)
+  case 255:
+    return verify_rounds_lowmc_255_255_4;
+#endif
+#if defined(WITH_LOWMC_256_256_38)
+  case 256:
+    return verify_rounds_lowmc_256_256_38;
 #endif
   }
-  for (; i < num_rounds; ++i, ++round) {
-    kdf_shake_t kdfs[SC_PROOF];
-    for (unsigned int j = 0; j < SC_PROOF; ++j) {
-      const bool include_input_size = (j != SC_PROOF - 1);
-      kdf_init_from_seed(&kdfs[j], round->seeds[j], prf->salt, i, j, include_input_size, pp);
-    }
 
-    // compute sharing
-    for (unsigned int j = 0; j < SC_PROOF - 1; ++j) {
-      kdf_shake_get_randomness(&kdfs[j], round->input_shares[j], input_size);
-      clear_padding_bits(&round->input_shares[j][input_size - 1], diff);
-      mzd_from_char_array(in_out_shares[0].s[j], round->input_shares[j], input_size);
-    }
-    mzd_share(in_out_shares[0].s[2], in_out_shares[0].s[0], in_out_shares[0].s[1], lowmc_key);
-    mzd_to_char_array(round->input_shares[SC_PROOF - 1], in_out_shares[0].s[SC_PROOF - 1],
-                      input_size);
-
-    // compute random tapes
-    for (unsigned int j = 0; j < SC_PROOF; ++j) {
-      assert(view_size <= MAX_VIEW_SIZE);
-      uint8_t tape_bytes[MAX_VIEW_SIZE];
-      kdf_shake_get_randomness(&kdfs[j], tape_bytes, view_size);
-      decompress_random_tape(rvec, pp, tape_bytes, j);
-    }
+  return NULL;
+}
 
-    for (unsigned int j = 0; j < SC_PROOF; ++j) {
-      kdf_shake_clear(&kdfs[j]);
-    }
+/**
+ * Compute the challenge for the message and serialize the signature.
+ */
+static int sign_finish(const picnic_instance_t* pp, sig_proof_t* prf, const uint8_t* plaintext,
+                       const uint8_t* public_key, const uint8_t* m, size_t m_len, uint8_t* sig,
+                       size_t* siglen) {
+  STATS_TIMER(stats_timer);
+  H3(pp, prf, public_key, plaintext, m, m_len);
+  STATS_RECORD(stats_timer, CHALLENGE);
 
-    // perform ZKB++ LowMC evaluation
-    lowmc_impl(p, views, in_out_shares, rvec, recorded_state);
+  const int ret = sig_proof_to_char_array(pp, prf, sig, siglen);
+  STATS_RECORD(stats_timer, SERIALIZATION);
+  return ret;
+}
 
-    // commitments
-    for (unsigned int j = 0; j < SC_PROOF; ++j) {
-      mzd_to_char_array(round->output_shares[j], in_out_shares[1].s[j], output_size);
-      compress_view(round->communicated_bits[j], pp, views, j);
-      hash_commitment(pp, round, j);
-    }
+static int sign_impl(const picnic_instance_t* pp, const uint8_t* private_key,
+                     const lowmc_key_t* lowmc_key, const uint8_t* plaintext, const mzd_local_t* p,
+                     const uint8_t* public_key, const uint8_t* m, size_t m_len, uint8_t* sig,
+                     size_t* siglen) {
+  sig_proof_t* prf = proof_new(pp);
 
-#if defined(WITH_UNRUH)
-    // unruh G
-    if (transform == TRANSFORM_UR) {
-      for (unsigned int j = 0; j < SC_PROOF; ++j) {
-        unruh_G(pp, round, j, j == SC_PROOF - 1);
-      }
-    }
-#endif
-  }
-  H3(pp, prf, public_key, plaintext, m, m_len);
+  // Generate seeds
+  STATS_TIMER(stats_timer);
+  generate_seeds(pp, private_key, plaintext, public_key, m, m_len, prf->round[0].seeds[0],
+                 prf->salt);
+  STATS_RECORD(stats_timer, SEEDS);
 
-  const int ret = sig_proof_to_char_array(pp, prf, sig, siglen);
+  // Perform LowMC evaluation and record state before AND gates
+  recorded_state_t recorded_state[MAX_LOWMC_ROUNDS + 1];
+  STATS_RESTART(stats_timer);
+  pp->impls.lowmc_store(lowmc_key, p, recorded_state);
+  STATS_RECORD(stats_timer, MPC);
+
+  pp->impls.zkbpp_prove_rounds(pp, lowmc_key, p, recorded_state, prf, 0, pp->num_rounds);
+  const int ret = sign_finish(pp, prf, plaintext, public_key, m, m_len, sig, siglen);
 
-  // clean up
-  for (unsigned int k = 0; k < SC_PROOF; ++k) {
-    for (unsigned int j = 0; j < 4; ++j) {
-      free(tape_bytes_x4[k][j]);
-    }
-  }
-  aligned_free(rvec);
-  aligned_free(views);
   proof_free(prf);
-  aligned_free(recorded_state);
   return ret;
 }
 
+/**
+ * Recompute the challenge from the commitments of all rounds and compare it to the one of the
+ * signature.
+ */
+static int verify_finish(const picnic_instance_t* pp, sig_proof_t* prf, const uint8_t* plaintext,
+                         const uint8_t* ciphertext, const uint8_t* m, size_t m_len) {
+  assert(pp->num_rounds <= MAX_NUM_ROUNDS);
+  unsigned char challenge[MAX_NUM_ROUNDS] = {0};
+  STATS_TIMER(stats_timer);
+  H3_verify(pp, prf, ciphertext, plaintext, m, m_len, challenge);
+  STATS_RECORD(stats_timer, CHALLENGE);
+  return memcmp(challenge, prf->challenge, pp->num_rounds);
+}
+
 static int verify_impl(const picnic_instance_t* pp, const uint8_t* plaintext, mzd_local_t const* p,
                        const uint8_t* ciphertext, mzd_local_t const* c, const uint8_t* m,
                        size_t m_len, const uint8_t* sig, size_t siglen) {
-  const size_t num_rounds     = pp->num_rounds;
-#if defined(WITH_UNRUH)
-  const transform_t transform = pp->transform;
-#endif
-  const size_t input_size     = pp->input_size;
-  const size_t output_size    = pp->output_size;
-  const size_t lowmc_r        = pp->lowmc.r;
-  const size_t view_size      = pp->view_size;
-  const unsigned int diff     = input_size * 8 - pp->lowmc.n;
-
-  const zkbpp_lowmc_verify_implementation_f lowmc_verify_impl = pp->impls.zkbpp_lowmc_verify;
-  const zkbpp_share_implementation_f mzd_share                = pp->impls.mzd_share;
-
+  STATS_TIMER(stats_timer);
   sig_proof_t* prf = sig_proof_from_char_array(pp, sig, siglen);
   if (!prf) {
     return -1;
   }
+  STATS_RECORD(stats_timer, SERIALIZATION);
 
-  in_out_shares_t in_out_shares[2];
-  view_t* views = aligned_alloc(32, sizeof(view_t) * lowmc_r);
-  rvec_t* rvec  = aligned_alloc(32, sizeof(rvec_t) * lowmc_r); // random tapes for and-gates
+  pp->impls.zkbpp_verify_rounds(pp, p, c, prf, 0, pp->num_rounds);
+  const int success_status = verify_finish(pp, prf, plaintext, ciphertext, m, m_len);
 
-  // sort the different challenge rounds based on their H3 index, so we can use the 4x Keccak when
-  // verifying since all of this is public information, there is no leakage
-  uint8_t* tape_bytes_x4[SC_VERIFY][4];
-  for (unsigned int i = 0; i < SC_VERIFY; i++) {
-    for (unsigned int j = 0; j < 4; j++) {
-      tape_bytes_x4[i][j] = malloc(view_size);
-    }
-  }
-  sorting_helper_t* sorted_rounds = malloc(sizeof(sorting_helper_t) * num_rounds);
-  for (unsigned int current_chal = 0; current_chal < 3; current_chal++) {
-    unsigned int num_current_rounds = 0;
-    for (unsigned int r = 0; r < num_rounds; r++) {
-      if (prf->challenge[r] == current_chal) {
-        sorted_rounds[num_current_rounds].round        = &prf->round[r];
-        sorted_rounds[num_current_rounds].round_number = r;
-        num_current_rounds++;
-      }
-    }
-    unsigned int i                 = 0;
-    const sorting_helper_t* helper = sorted_rounds;
-    for (; i < (num_current_rounds / 4) * 4; i += 4, helper += 4) {
-      const unsigned int a_i = current_chal;
-      const unsigned int b_i = (a_i + 1) % 3;
-      const unsigned int c_i = (a_i + 2) % 3;
-
-      kdf_shake_x4_t kdfs[SC_VERIFY];
-      for (unsigned int j = 0; j < SC_VERIFY; ++j) {
-        const bool include_input_size    = (j == 0 && b_i) || (j == 1 && c_i);
-        const unsigned int player_number = (j == 0) ? a_i : b_i;
-        const uint8_t* seeds[4]          = {helper[0].round->seeds[j], helper[1].round->seeds[j],
-                                   helper[2].round->seeds[j], helper[3].round->seeds[j]};
-        const uint16_t round_numbers[4]  = {helper[0].round_number, helper[1].round_number,
-                                           helper[2].round_number, helper[3].round_number};
-        kdf_init_x4_from_seed(&kdfs[j], seeds, prf->salt, round_numbers, player_number,
-                              include_input_size, pp);
-      }
+  // clean up
+  proof_free(prf);
 
-      // compute input shares if necessary
-      if (b_i) {
-        uint8_t* input_shares[4] = {
-            helper[0].round->input_shares[0], helper[1].round->input_shares[0],
-            helper[2].round->input_shares[0], helper[3].round->input_shares[0]};
-        kdf_shake_x4_get_randomness(&kdfs[0], input_shares, input_size);
-      }
-      if (c_i) {
-        uint8_t* input_shares[4] = {
-            helper[0].round->input_shares[1], helper[1].round->input_shares[1],
-            helper[2].round->input_shares[1], helper[3].round->input_shares[1]};
-        kdf_shake_x4_get_randomness(&kdfs[1], input_shares, input_size);
-      }
-      // compute random tapes
-      for (unsigned int j = 0; j < SC_VERIFY; ++j) {
-        kdf_shake_x4_get_randomness(&kdfs[j], tape_bytes_x4[j], view_size);
-        kdf_shake_clear(&kdfs[j]);
-      }
-      for (unsigned int round_offset = 0; round_offset < 4; round_offset++) {
-        if (b_i) {
-          clear_padding_bits(&helper[round_offset].round->input_shares[0][input_size - 1], diff);
-        }
-        mzd_from_char_array(in_out_shares[0].s[0], helper[round_offset].round->input_shares[0],
-                            input_size);
-        if (c_i) {
-          clear_padding_bits(&helper[round_offset].round->input_shares[1][input_size - 1], diff);
-        }
-        mzd_from_char_array(in_out_shares[0].s[1], helper[round_offset].round->input_shares[1],
-                            input_size);
-
-        for (unsigned int j = 0; j < SC_VERIFY; ++j) {
-          decompress_random_tape(rvec, pp, tape_bytes_x4[j][round_offset], j);
-        }
-
-        decompress_view(views, pp, helper[round_offset].round->communicated_bits[1], 1);
-        // perform ZKB++ LowMC evaluation
-        lowmc_verify_impl(p, views, in_out_shares, rvec, a_i);
-        compress_view(helper[round_offset].round->communicated_bits[0], pp, views, 0);
-
-        mzd_share(in_out_shares[1].s[2], in_out_shares[1].s[0], in_out_shares[1].s[1], c);
-        // recompute commitments
-        for (unsigned int j = 0; j < SC_VERIFY; ++j) {
-          mzd_to_char_array(helper[round_offset].round->output_shares[j], in_out_shares[1].s[j],
-                            output_size);
-        }
-        mzd_to_char_array(helper[round_offset].round->output_shares[SC_VERIFY],
-                          in_out_shares[1].s[SC_VERIFY], output_size);
-      }
-      for (unsigned int j = 0; j < SC_VERIFY; ++j) {
-        hash_commitment_x4_verify(pp, helper, j);
-      }
-#if defined(WITH_UNRUH)
-      if (transform == TRANSFORM_UR) {
-        // apply Unruh G permutation
-        for (unsigned int j = 0; j < SC_VERIFY; ++j) {
-          unruh_G_x4_verify(pp, helper, j, (a_i == 1 && j == 1) || (a_i == 2 && j == 0));
-        }
-      }
-#endif
-    }
-    for (; i < num_current_rounds; ++i, ++helper) {
-      const unsigned int a_i = current_chal;
-      const unsigned int b_i = (a_i + 1) % 3;
-      const unsigned int c_i = (a_i + 2) % 3;
-
-      kdf_shake_t kdfs[SC_VERIFY];
-      for (unsigned int j = 0; j < SC_VERIFY; ++j) {
-        const bool include_input_size    = (j == 0 && b_i) || (j == 1 && c_i);
-        const unsigned int player_number = (j == 0) ? a_i : b_i;
-        kdf_init_from_seed(&kdfs[j], helper->round->seeds[j], prf->salt, helper->round_number,
-                           player_number, include_input_size, pp);
-      }
+  return success_status;
+}
 
-      // compute input shares if necessary
-      if (b_i) {
-        kdf_shake_get_randomness(&kdfs[0], helper->round->input_shares[0], input_size);
-        clear_padding_bits(&helper->round->input_shares[0][input_size - 1], diff);
-      }
-      if (c_i) {
-        kdf_shake_get_randomness(&kdfs[1], helper->round->input_shares[1], input_size);
-        clear_padding_bits(&helper->round->input_shares[1][input_size - 1], diff);
-      }
+int impl_sign(const picnic_instance_t* pp, const uint8_t* plaintext, const uint8_t* private_key,
+              const uint8_t* public_key, const uint8_t* msg, size_t msglen, uint8_t* sig,
+              size_t* siglen) {
+  mzd_local_t m_plaintext[(MAX_LOWMC_BLOCK_SIZE_BITS + 255) / 256];
+  mzd_local_t m_privatekey[(MAX_LOWMC_KEY_SIZE_BITS + 255) / 256];
 
-      mzd_from_char_array(in_out_shares[0].s[0], helper->round->input_shares[0], input_size);
-      mzd_from_char_array(in_out_shares[0].s[1], helper->round->input_shares[1], input_size);
+  mzd_from_char_array(m_plaintext, plaintext, pp->output_size);
+  mzd_from_char_array(m_privatekey, private_key, pp->input_size);
 
-      // compute random tapes
-      for (unsigned int j = 0; j < SC_VERIFY; ++j) {
-        assert(view_size <= MAX_VIEW_SIZE);
-        uint8_t tape_bytes[MAX_VIEW_SIZE];
-        kdf_shake_get_randomness(&kdfs[j], tape_bytes, view_size);
-        decompress_random_tape(rvec, pp, tape_bytes, j);
-      }
+  const int result = sign_impl(pp, private_key, m_privatekey, plaintext, m_plaintext, public_key,
+                               msg, msglen, sig, siglen);
 
-      for (unsigned int j = 0; j < SC_VERIFY; ++j) {
-        kdf_shake_clear(&kdfs[j]);
-      }
+  return result;
+}
 
-      decompress_view(views, pp, helper->round->communicated_bits[1], 1);
-      // perform ZKB++ LowMC evaluation
-      lowmc_verify_impl(p, views, in_out_shares, rvec, a_i);
-      compress_view(helper->round->communicated_bits[0], pp, views, 0);
+void* impl_presign(const picnic_instance_t* pp, const uint8_t* plaintext, const uint8_t* private_key) {
+  mzd_local_t m_plaintext[(MAX_LOWMC_BLOCK_SIZE_BITS + 255) / 256];
+  mzd_local_t m_privatekey[(MAX_LOWMC_KEY_SIZE_BITS + 255) / 256];
 
-      mzd_share(in_out_shares[1].s[2], in_out_shares[1].s[0], in_out_shares[1].s[1], c);
-      // recompute commitments
-      for (unsigned int j = 0; j < SC_VERIFY; ++j) {
-        mzd_to_char_array(helper->round->output_shares[j], in_out_shares[1].s[j], output_size);
-        hash_commitment(pp, helper->round, j);
-      }
-      mzd_to_char_array(helper->round->output_shares[SC_VERIFY], in_out_shares[1].s[SC_VERIFY],
-                        output_size);
+  sig_proof_t* prf = proof_new(pp);
+  if (!prf) {
+    return NULL;
+  }
 
-#if defined(WITH_UNRUH)
-      if (transform == TRANSFORM_UR) {
-        // apply Unruh G permutation
-        for (unsigned int j = 0; j < SC_VERIFY; ++j) {
-          unruh_G(pp, helper->round, j, (a_i == 1 && j == 1) || (a_i == 2 && j == 0));
-        }
-      }
-#endif
-    }
+  // fresh seeds instead of seeds derived from the private key and the message
+  STATS_TIMER(stats_timer);
+  if (rand_bytes(prf->round[0].seeds[0], pp->seed_size * pp->num_rounds * SC_PROOF) ||
+      rand_bytes(prf->salt, SALT_SIZE)) {
+    proof_free(prf);
+    return NULL;
   }
+  STATS_RECORD(stats_timer, SEEDS);
 
-  assert(pp->num_rounds <= MAX_NUM_ROUNDS);
-  unsigned char challenge[MAX_NUM_ROUNDS] = {0};
-  H3_verify(pp, prf, ciphertext, plaintext, m, m_len, challenge);
-  const int success_status = memcmp(challenge, prf->challenge, pp->num_rounds);
+  mzd_from_char_array(m_plaintext, plaintext, pp->output_size);
+  mzd_from_char_array(m_privatekey, private_key, pp->input_size);
+  recorded_state_t recorded_state[MAX_LOWMC_ROUNDS + 1];
+  STATS_RESTART(stats_timer);
+  pp->impls.lowmc_store(m_privatekey, m_plaintext, recorded_state);
+  STATS_RECORD(stats_timer, MPC);
 
-  // clean up
-  free(sorted_rounds);
-  for (unsigned int i = 0; i < SC_VERIFY; i++) {
-    for (unsigned int j = 0; j < 4; j++) {
-      free(tape_bytes_x4[i][j]);
-    }
+  pp->impls.zkbpp_prove_rounds(pp, m_privatekey, m_plaintext, recorded_state, prf, 0,
+                               pp->num_rounds);
+  return prf;
+}
+
+int impl_sign_presigned(const picnic_instance_t* pp, void* transcript, const uint8_t* plaintext,
+                        const uint8_t* public_key, const uint8_t* msg, size_t msglen, uint8_t* sig,
+                        size_t* siglen) {
+  const int ret = sign_finish(pp, transcript, plaintext, public_key, msg, msglen, sig, siglen);
+  proof_free(transcript);
+  return ret;
+}
+
+void impl_presigned_free(const picnic_instance_t* pp, void* transcript) {
+  (void)pp;
+  proof_free(transcript);
+}
+
+void* impl_sign_begin(const picnic_instance_t* pp, const uint8_t* plaintext,
+                      const uint8_t* private_key, const uint8_t* public_key, const uint8_t* msg,
+                      size_t msglen) {
+  mzd_local_t m_plaintext[(MAX_LOWMC_BLOCK_SIZE_BITS + 255) / 256];
+  mzd_local_t m_privatekey[(MAX_LOWMC_KEY_SIZE_BITS + 255) / 256];
+
+  sig_proof_t* prf = proof_new(pp);
+  if (!prf) {
+    return NULL;
+  }
+  /* the LowMC evaluation is the same for all steps, hence it is only performed once */
+  prf->recorded_state =
+      picnic_aligned_alloc(32, (MAX_LOWMC_ROUNDS + 1) * sizeof(recorded_state_t));
+  if (!prf->recorded_state) {
+    proof_free(prf);
+    return NULL;
   }
-  aligned_free(rvec);
-  aligned_free(views);
 
-  proof_free(prf);
+  STATS_TIMER(stats_timer);
+  generate_seeds(pp, private_key, plaintext, public_key, msg, msglen, prf->round[0].seeds[0],
+                 prf->salt);
+  STATS_RECORD(stats_timer, SEEDS);
 
-  return success_status;
+  mzd_from_char_array(m_plaintext, plaintext, pp->output_size);
+  mzd_from_char_array(m_privatekey, private_key, pp->input_size);
+  pp->impls.lowmc_store(m_privatekey, m_plaintext, prf->recorded_state);
+  STATS_RECORD(stats_timer, MPC);
+  return prf;
 }
 
-int impl_sign(const picnic_instance_t* pp, const uint8_t* plaintext, const uint8_t* private_key,
-              const uint8_t* public_key, const uint8_t* msg, size_t msglen, uint8_t* sig,
-              size_t* siglen) {
+int impl_sign_step(const picnic_instance_t* pp, void* transcript, unsigned int step,
+                   const uint8_t* plaintext, const uint8_t* private_key) {
   mzd_local_t m_plaintext[(MAX_LOWMC_BLOCK_SIZE_BITS + 255) / 256];
   mzd_local_t m_privatekey[(MAX_LOWMC_KEY_SIZE_BITS + 255) / 256];
 
   mzd_from_char_array(m_plaintext, plaintext, pp->output_size);
   mzd_from_char_array(m_privatekey, private_key, pp->input_size);
 
-  const int result = sign_impl(pp, private_key, m_privatekey, plaintext, m_plaintext, public_key,
-                               msg, msglen, sig, siglen);
+  sig_proof_t* prf         = transcript;
+  const unsigned int begin = step * SIGN_STEP_ROUNDS;
+  const unsigned int end   = MIN(begin + SIGN_STEP_ROUNDS, pp->num_rounds);
+  pp->impls.zkbpp_prove_rounds(pp, m_privatekey, m_plaintext, prf->recorded_state, prf, begin,
+                               end);
+  return end < pp->num_rounds;
+}
 
-  return result;
+void* impl_verify_begin(const picnic_instance_t* pp, const uint8_t* sig, size_t siglen) {
+  STATS_TIMER(stats_timer);
+  sig_proof_t* prf = sig_proof_from_char_array(pp, sig, siglen);
+  STATS_RECORD(stats_timer, SERIALIZATION);
+  return prf;
+}
+
+int impl_verify_step(const picnic_instance_t* pp, void* state, unsigned int step,
+                     const uint8_t* plaintext, const uint8_t* public_key) {
+  mzd_local_t m_plaintext[(MAX_LOWMC_BLOCK_SIZE_BITS + 255) / 256];
+  mzd_local_t m_publickey[(MAX_LOWMC_BLOCK_SIZE_BITS + 255) / 256];
+
+  mzd_from_char_array(m_plaintext, plaintext, pp->output_size);
+  mzd_from_char_array(m_publickey, public_key, pp->output_size);
+
+  const unsigned int begin = step * VERIFY_STEP_ROUNDS;
+  const unsigned int end   = MIN(begin + VERIFY_STEP_ROUNDS, pp->num_rounds);
+  pp->impls.zkbpp_verify_rounds(pp, m_plaintext, m_publickey, state, begin, end);
+  return end < pp->num_rounds;
+}
+
+int impl_verify_finish(const picnic_instance_t* pp, void* state, const uint8_t* plaintext,
+                       const uint8_t* public_key, const uint8_t* msg, size_t msglen) {
+  const int ret = verify_finish(pp, state, plaintext, public_key, msg, msglen);
+  proof_free(state);
+  return ret;
+}
+
+void impl_verify_free(const picnic_instance_t* pp, void* state) {
+  (void)pp;
+  proof_free(state);
 }
 
 int impl_verify(const picnic_instance_t* pp, const uint8_t* plaintext, const uint8_t* public_key,
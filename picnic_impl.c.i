@@ -0,0 +1,425 @@
+/*
+ *  This file is part of the optimized implementation of the Picnic signature scheme.
+ *  See the accompanying documentation for complete details.
+ *
+ *  The code is provided under the MIT license, see LICENSE for
+ *  more details.
+ *  SPDX-License-Identifier: MIT
+ */
+
+/* Proof and verification rounds of ZKB++ specialised for one instance. The sizes of the instance
+ * are compile-time constants derived from ZKBPP_LOWMC_N, ZKBPP_LOWMC_M, ZKBPP_LOWMC_R and
+ * ZKBPP_NUM_ROUNDS. */
+#if defined(ZKBPP_INSTANCE)
+#define PROVE_ROUNDS CONCAT(prove_rounds, ZKBPP_INSTANCE)
+#define VERIFY_ROUNDS CONCAT(verify_rounds, ZKBPP_INSTANCE)
+#define ZKBPP_INPUT_SIZE ((ZKBPP_LOWMC_N + 7) / 8)
+#define ZKBPP_OUTPUT_SIZE ((ZKBPP_LOWMC_N + 7) / 8)
+#define ZKBPP_VIEW_SIZE ((ZKBPP_LOWMC_R * 3 * ZKBPP_LOWMC_M + 7) / 8)
+#if ZKBPP_LOWMC_M == 10
+#define ZKBPP_VIEW_T view_partial_t
+#define ZKBPP_RVEC_T rvec_partial_t
+#else
+#define ZKBPP_VIEW_T view_t
+#define ZKBPP_RVEC_T rvec_t
+#endif
+
+/**
+ * Compute the rounds begin to end - 1 of the proof from the seeds and the salt stored in prf and
+ * the states recorded by the LowMC evaluation of p under lowmc_key. Nothing in here depends on the
+ * message.
+ */
+static void PROVE_ROUNDS(const picnic_instance_t* pp, const lowmc_key_t* lowmc_key,
+                         const mzd_local_t* p, const recorded_state_t* recorded_state,
+                         sig_proof_t* prf, unsigned int begin, unsigned int end) {
+#if defined(WITH_UNRUH)
+  const transform_t transform = pp->transform;
+#endif
+  const size_t input_size     = ZKBPP_INPUT_SIZE;
+  const size_t output_size    = ZKBPP_OUTPUT_SIZE;
+  const size_t lowmc_r        = ZKBPP_LOWMC_R;
+  const size_t view_size      = ZKBPP_VIEW_SIZE;
+  const unsigned int diff     = ZKBPP_INPUT_SIZE * 8 - ZKBPP_LOWMC_N;
+
+  const zkbpp_lowmc_implementation_f lowmc_impl    = pp->impls.zkbpp_lowmc;
+  const zkbpp_lowmc_implementation_f lowmc_x4_impl = pp->impls.zkbpp_lowmc_x4;
+  const zkbpp_share_implementation_f mzd_share     = pp->impls.mzd_share;
+
+  STATS_TIMER(stats_timer);
+
+  // views for 4 rounds
+  ZKBPP_VIEW_T views[ZKBPP_LOWMC_R * 4];
+
+  in_out_shares_t in_out_shares[2 * 4];
+
+  // random tapes for AND-gates, for 4 rounds
+  ZKBPP_RVEC_T rvec[ZKBPP_LOWMC_R * 4];
+
+  proof_round_t* round = &prf->round[begin];
+  // use 4 parallel instances of keccak for speedup
+  uint8_t tape_bytes_x4[4][ZKBPP_VIEW_SIZE];
+  uint8_t* tape_bytes[4] = {tape_bytes_x4[0], tape_bytes_x4[1], tape_bytes_x4[2],
+                            tape_bytes_x4[3]};
+  unsigned int i = begin;
+  for (; i + 4 <= end; i += 4, round += 4) {
+    STATS_RESTART(stats_timer);
+    kdf_shake_x4_t kdfs[SC_PROOF];
+    for (unsigned int j = 0; j < SC_PROOF; ++j) {
+      const bool include_input_size   = (j != SC_PROOF - 1);
+      const uint8_t* seeds[4]         = {round[0].seeds[j], round[1].seeds[j], round[2].seeds[j],
+                                 round[3].seeds[j]};
+      const uint16_t round_numbers[4] = {i, i + 1, i + 2, i + 3};
+      kdf_init_x4_from_seed(&kdfs[j], seeds, prf->salt, round_numbers, j, include_input_size, pp);
+    }
+
+    // compute sharing
+    for (unsigned int j = 0; j < SC_PROOF - 1; ++j) {
+      uint8_t* input_shares[4] = {round[0].input_shares[j], round[1].input_shares[j],
+                                  round[2].input_shares[j], round[3].input_shares[j]};
+      kdf_shake_x4_get_randomness(&kdfs[j], input_shares, input_size);
+    }
+    // compute random tapes and expand them directly
+    for (unsigned int j = 0; j < SC_PROOF; ++j) {
+      kdf_shake_x4_get_randomness(&kdfs[j], tape_bytes, view_size);
+      kdf_shake_x4_clear(&kdfs[j]);
+      for (unsigned int round_offset = 0; round_offset < 4; round_offset++) {
+        decompress_random_tape(&rvec[round_offset * lowmc_r], pp, tape_bytes[round_offset], j);
+      }
+    }
+    STATS_RECORD(stats_timer, TAPES);
+
+    for (unsigned int round_offset = 0; round_offset < 4; round_offset++) {
+      in_out_shares_t* shares = &in_out_shares[2 * round_offset];
+      for (unsigned int j = 0; j < SC_PROOF - 1; ++j) {
+        clear_padding_bits(&round[round_offset].input_shares[j][input_size - 1], diff);
+        mzd_from_char_array(shares[0].s[j], round[round_offset].input_shares[j], input_size);
+      }
+      mzd_share(shares[0].s[2], shares[0].s[0], shares[0].s[1], lowmc_key);
+      mzd_to_char_array(round[round_offset].input_shares[SC_PROOF - 1],
+                        shares[0].s[SC_PROOF - 1], input_size);
+    }
+
+    // perform ZKB++ LowMC evaluation of all 4 rounds at once
+    lowmc_x4_impl(p, views, in_out_shares, rvec, recorded_state);
+    STATS_RECORD(stats_timer, MPC);
+
+    for (unsigned int round_offset = 0; round_offset < 4; round_offset++) {
+      for (unsigned int j = 0; j < SC_PROOF; ++j) {
+        mzd_to_char_array(round[round_offset].output_shares[j],
+                          in_out_shares[2 * round_offset + 1].s[j], output_size);
+        compress_view(round[round_offset].communicated_bits[j], pp, &views[round_offset * lowmc_r],
+                      j);
+      }
+    }
+    STATS_RECORD(stats_timer, VIEWS);
+
+    // commitments
+    for (unsigned int j = 0; j < SC_PROOF; ++j) {
+      hash_commitment_x4(pp, round, j);
+    }
+
+#if defined(WITH_UNRUH)
+    // unruh G
+    if (transform == TRANSFORM_UR) {
+      for (unsigned int j = 0; j < SC_PROOF; ++j) {
+        unruh_G_x4(pp, round, j, j == SC_PROOF - 1);
+      }
+    }
+#endif
+    STATS_RECORD(stats_timer, COMMITMENTS);
+  }
+  for (; i < end; ++i, ++round) {
+    STATS_RESTART(stats_timer);
+    kdf_shake_t kdfs[SC_PROOF];
+    for (unsigned int j = 0; j < SC_PROOF; ++j) {
+      const bool include_input_size = (j != SC_PROOF - 1);
+      kdf_init_from_seed(&kdfs[j], round->seeds[j], prf->salt, i, j, include_input_size, pp);
+    }
+
+    // compute sharing
+    for (unsigned int j = 0; j < SC_PROOF - 1; ++j) {
+      kdf_shake_get_randomness(&kdfs[j], round->input_shares[j], input_size);
+      clear_padding_bits(&round->input_shares[j][input_size - 1], diff);
+      mzd_from_char_array(in_out_shares[0].s[j], round->input_shares[j], input_size);
+    }
+    mzd_share(in_out_shares[0].s[2], in_out_shares[0].s[0], in_out_shares[0].s[1], lowmc_key);
+    mzd_to_char_array(round->input_shares[SC_PROOF - 1], in_out_shares[0].s[SC_PROOF - 1],
+                      input_size);
+
+    // compute random tapes
+    for (unsigned int j = 0; j < SC_PROOF; ++j) {
+      kdf_shake_get_randomness(&kdfs[j], tape_bytes[0], view_size);
+      decompress_random_tape(rvec, pp, tape_bytes[0], j);
+    }
+
+    for (unsigned int j = 0; j < SC_PROOF; ++j) {
+      kdf_shake_clear(&kdfs[j]);
+    }
+    STATS_RECORD(stats_timer, TAPES);
+
+    // perform ZKB++ LowMC evaluation
+    lowmc_impl(p, views, in_out_shares, rvec, recorded_state);
+    STATS_RECORD(stats_timer, MPC);
+
+    for (unsigned int j = 0; j < SC_PROOF; ++j) {
+      mzd_to_char_array(round->output_shares[j], in_out_shares[1].s[j], output_size);
+      compress_view(round->communicated_bits[j], pp, views, j);
+    }
+    STATS_RECORD(stats_timer, VIEWS);
+  }
+
+  // commitments of the remaining rounds, batched to fill the lanes of the 4x Keccak
+  const unsigned int num_tail_rounds = (end - begin) % 4;
+  if (num_tail_rounds) {
+    STATS_RESTART(stats_timer);
+    proof_round_t* tail_rounds[3];
+    for (unsigned int r = 0; r < num_tail_rounds; ++r) {
+      tail_rounds[r] = &prf->round[end - num_tail_rounds + r];
+    }
+    hash_commitments_batched(pp, tail_rounds, num_tail_rounds, SC_PROOF);
+
+#if defined(WITH_UNRUH)
+    // unruh G
+    if (transform == TRANSFORM_UR) {
+      bool include_is[3 * SC_PROOF];
+      for (unsigned int r = 0; r < num_tail_rounds; ++r) {
+        for (unsigned int j = 0; j < SC_PROOF; ++j) {
+          include_is[r * SC_PROOF + j] = j == SC_PROOF - 1;
+        }
+      }
+      unruh_G_batched(pp, tail_rounds, num_tail_rounds, SC_PROOF, include_is);
+    }
+#endif
+    STATS_RECORD(stats_timer, COMMITMENTS);
+  }
+}
+
+/**
+ * Recompute the commitments of the rounds begin to end - 1 of the proof in prf.
+ */
+static void VERIFY_ROUNDS(const picnic_instance_t* pp, mzd_local_t const* p, mzd_local_t const* c,
+                          sig_proof_t* prf, unsigned int begin, unsigned int end) {
+#if defined(WITH_UNRUH)
+  const transform_t transform = pp->transform;
+#endif
+  const size_t input_size     = ZKBPP_INPUT_SIZE;
+  const size_t output_size    = ZKBPP_OUTPUT_SIZE;
+  const size_t lowmc_r        = ZKBPP_LOWMC_R;
+  const size_t view_size      = ZKBPP_VIEW_SIZE;
+  const unsigned int diff     = ZKBPP_INPUT_SIZE * 8 - ZKBPP_LOWMC_N;
+
+  const zkbpp_lowmc_verify_implementation_f lowmc_verify_impl = pp->impls.zkbpp_lowmc_verify;
+  const zkbpp_lowmc_verify_implementation_f lowmc_verify_x4_impl =
+      pp->impls.zkbpp_lowmc_verify_x4;
+  const zkbpp_share_implementation_f mzd_share                = pp->impls.mzd_share;
+
+  STATS_TIMER(stats_timer);
+  in_out_shares_t in_out_shares[2 * 4];
+  // views for 4 rounds
+  ZKBPP_VIEW_T views[ZKBPP_LOWMC_R * 4];
+  // random tapes for and-gates, for 4 rounds
+  ZKBPP_RVEC_T rvec[ZKBPP_LOWMC_R * 4];
+
+  uint8_t tape_bytes_x4[4][ZKBPP_VIEW_SIZE];
+  uint8_t* tape_bytes[4] = {tape_bytes_x4[0], tape_bytes_x4[1], tape_bytes_x4[2],
+                            tape_bytes_x4[3]};
+
+  // sort the different challenge rounds based on their H3 index, so we can use the 4x Keccak when
+  // verifying since all of this is public information, there is no leakage
+  sorting_helper_t sorted_rounds[ZKBPP_NUM_ROUNDS];
+  // rounds of each challenge that do not fill a group of 4
+  proof_round_t* tail_rounds[3 * 3];
+#if defined(WITH_UNRUH)
+  bool include_is[3 * 3 * SC_VERIFY];
+#endif
+  unsigned int num_tail_rounds = 0;
+  for (unsigned int current_chal = 0; current_chal < 3; current_chal++) {
+    unsigned int num_current_rounds = 0;
+    for (unsigned int r = begin; r < end; r++) {
+      if (prf->challenge[r] == current_chal) {
+        sorted_rounds[num_current_rounds].round        = &prf->round[r];
+        sorted_rounds[num_current_rounds].round_number = r;
+        num_current_rounds++;
+      }
+    }
+    unsigned int i                 = 0;
+    const sorting_helper_t* helper = sorted_rounds;
+    for (; i < (num_current_rounds / 4) * 4; i += 4, helper += 4) {
+      STATS_RESTART(stats_timer);
+      const unsigned int a_i = current_chal;
+      const unsigned int b_i = (a_i + 1) % 3;
+      const unsigned int c_i = (a_i + 2) % 3;
+
+      kdf_shake_x4_t kdfs[SC_VERIFY];
+      for (unsigned int j = 0; j < SC_VERIFY; ++j) {
+        const bool include_input_size    = (j == 0 && b_i) || (j == 1 && c_i);
+        const unsigned int player_number = (j == 0) ? a_i : b_i;
+        const uint8_t* seeds[4]          = {helper[0].round->seeds[j], helper[1].round->seeds[j],
+                                   helper[2].round->seeds[j], helper[3].round->seeds[j]};
+        const uint16_t round_numbers[4]  = {helper[0].round_number, helper[1].round_number,
+                                           helper[2].round_number, helper[3].round_number};
+        kdf_init_x4_from_seed(&kdfs[j], seeds, prf->salt, round_numbers, player_number,
+                              include_input_size, pp);
+      }
+
+      // compute input shares if necessary
+      if (b_i) {
+        uint8_t* input_shares[4] = {
+            helper[0].round->input_shares[0], helper[1].round->input_shares[0],
+            helper[2].round->input_shares[0], helper[3].round->input_shares[0]};
+        kdf_shake_x4_get_randomness(&kdfs[0], input_shares, input_size);
+      }
+      if (c_i) {
+        uint8_t* input_shares[4] = {
+            helper[0].round->input_shares[1], helper[1].round->input_shares[1],
+            helper[2].round->input_shares[1], helper[3].round->input_shares[1]};
+        kdf_shake_x4_get_randomness(&kdfs[1], input_shares, input_size);
+      }
+      // compute random tapes and expand them directly
+      for (unsigned int j = 0; j < SC_VERIFY; ++j) {
+        kdf_shake_x4_get_randomness(&kdfs[j], tape_bytes, view_size);
+        kdf_shake_x4_clear(&kdfs[j]);
+        for (unsigned int round_offset = 0; round_offset < 4; round_offset++) {
+          decompress_random_tape(&rvec[round_offset * lowmc_r], pp, tape_bytes[round_offset], j);
+        }
+      }
+      STATS_RECORD(stats_timer, TAPES);
+      for (unsigned int round_offset = 0; round_offset < 4; round_offset++) {
+        in_out_shares_t* shares = &in_out_shares[2 * round_offset];
+        if (b_i) {
+          clear_padding_bits(&helper[round_offset].round->input_shares[0][input_size - 1], diff);
+        }
+        mzd_from_char_array(shares[0].s[0], helper[round_offset].round->input_shares[0],
+                            input_size);
+        if (c_i) {
+          clear_padding_bits(&helper[round_offset].round->input_shares[1][input_size - 1], diff);
+        }
+        mzd_from_char_array(shares[0].s[1], helper[round_offset].round->input_shares[1],
+                            input_size);
+
+        decompress_view(&views[round_offset * lowmc_r], pp,
+                        helper[round_offset].round->communicated_bits[1], 1);
+      }
+      STATS_RECORD(stats_timer, VIEWS);
+
+      // perform ZKB++ LowMC evaluation of all 4 rounds at once
+      lowmc_verify_x4_impl(p, views, in_out_shares, rvec, a_i);
+      STATS_RECORD(stats_timer, MPC);
+
+      for (unsigned int round_offset = 0; round_offset < 4; round_offset++) {
+        in_out_shares_t* shares = &in_out_shares[2 * round_offset];
+        compress_view(helper[round_offset].round->communicated_bits[0], pp,
+                      &views[round_offset * lowmc_r], 0);
+
+        mzd_share(shares[1].s[2], shares[1].s[0], shares[1].s[1], c);
+        // recompute commitments
+        for (unsigned int j = 0; j < SC_VERIFY; ++j) {
+          mzd_to_char_array(helper[round_offset].round->output_shares[j], shares[1].s[j],
+                            output_size);
+        }
+        mzd_to_char_array(helper[round_offset].round->output_shares[SC_VERIFY],
+                          shares[1].s[SC_VERIFY], output_size);
+      }
+      STATS_RECORD(stats_timer, VIEWS);
+      for (unsigned int j = 0; j < SC_VERIFY; ++j) {
+        hash_commitment_x4_verify(pp, helper, j);
+      }
+#if defined(WITH_UNRUH)
+      if (transform == TRANSFORM_UR) {
+        // apply Unruh G permutation
+        for (unsigned int j = 0; j < SC_VERIFY; ++j) {
+          unruh_G_x4_verify(pp, helper, j, (a_i == 1 && j == 1) || (a_i == 2 && j == 0));
+        }
+      }
+#endif
+      STATS_RECORD(stats_timer, COMMITMENTS);
+    }
+    for (; i < num_current_rounds; ++i, ++helper) {
+      STATS_RESTART(stats_timer);
+      const unsigned int a_i = current_chal;
+      const unsigned int b_i = (a_i + 1) % 3;
+      const unsigned int c_i = (a_i + 2) % 3;
+
+      kdf_shake_t kdfs[SC_VERIFY];
+      for (unsigned int j = 0; j < SC_VERIFY; ++j) {
+        const bool include_input_size    = (j == 0 && b_i) || (j == 1 && c_i);
+        const unsigned int player_number = (j == 0) ? a_i : b_i;
+        kdf_init_from_seed(&kdfs[j], helper->round->seeds[j], prf->salt, helper->round_number,
+                           player_number, include_input_size, pp);
+      }
+
+      // compute input shares if necessary
+      if (b_i) {
+        kdf_shake_get_randomness(&kdfs[0], helper->round->input_shares[0], input_size);
+        clear_padding_bits(&helper->round->input_shares[0][input_size - 1], diff);
+      }
+      if (c_i) {
+        kdf_shake_get_randomness(&kdfs[1], helper->round->input_shares[1], input_size);
+        clear_padding_bits(&helper->round->input_shares[1][input_size - 1], diff);
+      }
+
+      mzd_from_char_array(in_out_shares[0].s[0], helper->round->input_shares[0], input_size);
+      mzd_from_char_array(in_out_shares[0].s[1], helper->round->input_shares[1], input_size);
+
+      // compute random tapes
+      for (unsigned int j = 0; j < SC_VERIFY; ++j) {
+        kdf_shake_get_randomness(&kdfs[j], tape_bytes[0], view_size);
+        decompress_random_tape(rvec, pp, tape_bytes[0], j);
+      }
+
+      for (unsigned int j = 0; j < SC_VERIFY; ++j) {
+        kdf_shake_clear(&kdfs[j]);
+      }
+      STATS_RECORD(stats_timer, TAPES);
+
+      decompress_view(views, pp, helper->round->communicated_bits[1], 1);
+      STATS_RECORD(stats_timer, VIEWS);
+      // perform ZKB++ LowMC evaluation
+      lowmc_verify_impl(p, views, in_out_shares, rvec, a_i);
+      STATS_RECORD(stats_timer, MPC);
+      compress_view(helper->round->communicated_bits[0], pp, views, 0);
+
+      mzd_share(in_out_shares[1].s[2], in_out_shares[1].s[0], in_out_shares[1].s[1], c);
+      for (unsigned int j = 0; j <= SC_VERIFY; ++j) {
+        mzd_to_char_array(helper->round->output_shares[j], in_out_shares[1].s[j], output_size);
+      }
+      STATS_RECORD(stats_timer, VIEWS);
+
+      tail_rounds[num_tail_rounds] = helper->round;
+#if defined(WITH_UNRUH)
+      for (unsigned int j = 0; j < SC_VERIFY; ++j) {
+        include_is[num_tail_rounds * SC_VERIFY + j] = (a_i == 1 && j == 1) || (a_i == 2 && j == 0);
+      }
+#endif
+      ++num_tail_rounds;
+    }
+  }
+
+  // recompute commitments of the rounds that did not fill a group of 4 for any challenge, batched
+  // to fill the lanes of the 4x Keccak
+  STATS_RESTART(stats_timer);
+  hash_commitments_batched(pp, tail_rounds, num_tail_rounds, SC_VERIFY);
+#if defined(WITH_UNRUH)
+  if (transform == TRANSFORM_UR) {
+    // apply Unruh G permutation
+    unruh_G_batched(pp, tail_rounds, num_tail_rounds, SC_VERIFY, include_is);
+  }
+#endif
+  STATS_RECORD(stats_timer, COMMITMENTS);
+}
+
+#undef ZKBPP_RVEC_T
+#undef ZKBPP_VIEW_T
+#undef ZKBPP_VIEW_SIZE
+#undef ZKBPP_OUTPUT_SIZE
+#undef ZKBPP_INPUT_SIZE
+#undef VERIFY_ROUNDS
+#undef PROVE_ROUNDS
+#undef ZKBPP_NUM_ROUNDS
+#undef ZKBPP_LOWMC_R
+#undef ZKBPP_LOWMC_M
+#undef ZKBPP_LOWMC_N
+#undef ZKBPP_INSTANCE
+#endif
+
+// vim: ft=c
@@ -11,6 +11,7 @@
 #define PICNIC_IMPL_H
 
 #include "lowmc.h"
+#include "mpc_lowmc.h"
 #include "picnic_instances.h"
 #include "picnic.h"
 
@@ -21,6 +22,40 @@ int impl_sign(const picnic_instance_t* pp, const uint8_t* plaintext, const uint8
 int impl_verify(const picnic_instance_t* pp, const uint8_t* plaintext, const uint8_t* public_key,
                 const uint8_t* msg, size_t msglen, const uint8_t* sig, size_t siglen);
 
+/* message independent part of a signature with fresh random seeds, see picnic_presign_enable */
+void* impl_presign(const picnic_instance_t* pp, const uint8_t* plaintext, const uint8_t* private_key);
+/* complete the signature of msg from a transcript of impl_presign and release the transcript */
+int impl_sign_presigned(const picnic_instance_t* pp, void* transcript, const uint8_t* plaintext,
+                        const uint8_t* public_key, const uint8_t* msg, size_t msglen, uint8_t* sig,
+                        size_t* siglen);
+void impl_presigned_free(const picnic_instance_t* pp, void* transcript);
+
+/**
+ * Signing in bounded steps, see picnic_sign_begin. impl_sign_begin returns a transcript, which is
+ * complete once impl_sign_step returned 0 for the steps 0, 1, ... in order, and then finished with
+ * impl_sign_presigned. A positive return value of impl_sign_step indicates that more steps follow.
+ */
+void* impl_sign_begin(const picnic_instance_t* pp, const uint8_t* plaintext,
+                      const uint8_t* private_key, const uint8_t* public_key, const uint8_t* msg,
+                      size_t msglen);
+int impl_sign_step(const picnic_instance_t* pp, void* transcript, unsigned int step,
+                   const uint8_t* plaintext, const uint8_t* private_key);
+
+/**
+ * Verification in bounded steps, see picnic_verify_begin. impl_verify_begin returns NULL if the
+ * signature is malformed. impl_verify_finish releases the state.
+ */
+void* impl_verify_begin(const picnic_instance_t* pp, const uint8_t* sig, size_t siglen);
+int impl_verify_step(const picnic_instance_t* pp, void* state, unsigned int step,
+                     const uint8_t* plaintext, const uint8_t* public_key);
+int impl_verify_finish(const picnic_instance_t* pp, void* state, const uint8_t* plaintext,
+                       const uint8_t* public_key, const uint8_t* msg, size_t msglen);
+void impl_verify_free(const picnic_instance_t* pp, void* state);
+
+/* proof rounds specialised for the LowMC instance and the number of rounds of the instance */
+zkbpp_prove_rounds_f get_zkbpp_prove_rounds_implementation(const lowmc_parameters_t* lowmc);
+zkbpp_verify_rounds_f get_zkbpp_verify_rounds_implementation(const lowmc_parameters_t* lowmc);
+
 #if defined(PICNIC_STATIC)
 void visualize_signature(FILE* out, const picnic_instance_t* pp, const uint8_t* msg, size_t msglen,
                          const uint8_t* sig, size_t siglen);
@@ -28,6 +63,10 @@ void picnic_visualize_keys(FILE* out, const picnic_privatekey_t* private_key,
                            const picnic_publickey_t* public_key);
 void picnic_visualize(FILE* out, const picnic_publickey_t* public_key, const uint8_t* msg,
                       size_t msglen, const uint8_t* sig, size_t siglen);
+/* expand the random tape of player idx into the AND-gate layout, i.e., into r entries of rvec_t or
+ * rvec_partial_t */
+void decompress_random_tape(void* rvec, const picnic_instance_t* pp, const uint8_t* src,
+                            const unsigned int idx);
 #endif
 
 #endif
@@ -12,6 +12,19 @@
 #endif
 
 #include "picnic_instances.h"
+#include "lock.h"
+#if defined(WITH_ZKBPP)
+#include "picnic_impl.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined(__STDC_NO_ATOMICS__) && !defined(_MSC_VER)
+#include <stdatomic.h>
+#define HAVE_STDATOMIC
+#endif
 
 // instance handling
 
@@ -63,13 +76,13 @@
 
 #if defined(WITH_ZKBPP) && defined(WITH_KKW)
 #define NULL_FNS                                                                                   \
-  { NULL, NULL, NULL, NULL, NULL, NULL, NULL }
+  { NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL }
 #elif defined(WITH_ZKBPP)
 #define NULL_FNS                                                                                   \
-  { NULL, NULL, NULL, NULL, NULL }
+  { NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL }
 #elif defined(WITH_KKW)
 #define NULL_FNS                                                                                   \
-  { NULL, NULL, NULL }
+  { NULL, NULL, NULL, NULL }
 #else
 #error "At least one of WITH_ZKBPP and WITH_KKW have to be defined!"
 #endif
@@ -104,7 +117,32 @@ static picnic_instance_t instances[PARAMETER_SET_MAX_INDEX] = {
     {ENABLE_ZKBPP(lowmc_parameters_255_255_4), 64, 32, 438, 438, 3, 32, 32, 128, 255, 110, 0, 0,
      PICNIC_SIGNATURE_SIZE_Picnic_L5_full, Picnic_L5_full, TRANSFORM_FS, NULL_FNS},
 };
+#if defined(HAVE_STDATOMIC)
+static atomic_bool instance_initialized[PARAMETER_SET_MAX_INDEX];
+#else
 static bool instance_initialized[PARAMETER_SET_MAX_INDEX];
+#endif
+
+/* serializes the initialization of the instances and the selection of the backend */
+static lock_t instances_lock = LOCK_INITIALIZER;
+
+/* lock-free check whether an instance is ready; falls back to taking the lock without atomics */
+static bool instance_ready(picnic_params_t param) {
+#if defined(HAVE_STDATOMIC)
+  return atomic_load_explicit(&instance_initialized[param], memory_order_acquire);
+#else
+  (void)param;
+  return false;
+#endif
+}
+
+static void set_instance_ready(picnic_params_t param) {
+#if defined(HAVE_STDATOMIC)
+  atomic_store_explicit(&instance_initialized[param], true, memory_order_release);
+#else
+  instance_initialized[param] = true;
+#endif
+}
 
 static bool create_instance(picnic_instance_t* pp) {
   if (!pp->lowmc.m || !pp->lowmc.n || !pp->lowmc.r || !pp->lowmc.k) {
@@ -118,13 +156,18 @@ static bool create_instance(picnic_instance_t* pp) {
 #endif
 
   pp->impls.lowmc                 = lowmc_get_implementation(&pp->lowmc);
+  pp->impls.lowmc_batch           = lowmc_batch_get_implementation(&pp->lowmc);
 #if defined(WITH_ZKBPP)
   if ((pp->params >= Picnic_L1_FS && pp->params <= Picnic_L5_UR) ||
       (pp->params >= Picnic_L1_full && pp->params <= Picnic_L5_full)) {
     pp->impls.lowmc_store        = lowmc_store_get_implementation(&pp->lowmc);
     pp->impls.zkbpp_lowmc        = get_zkbpp_lowmc_implementation(&pp->lowmc);
     pp->impls.zkbpp_lowmc_verify = get_zkbpp_lowmc_verify_implementation(&pp->lowmc);
+    pp->impls.zkbpp_lowmc_x4     = get_zkbpp_lowmc_x4_implementation(&pp->lowmc);
+    pp->impls.zkbpp_lowmc_verify_x4 = get_zkbpp_lowmc_verify_x4_implementation(&pp->lowmc);
     pp->impls.mzd_share          = get_zkbpp_share_implentation(&pp->lowmc);
+    pp->impls.zkbpp_prove_rounds  = get_zkbpp_prove_rounds_implementation(&pp->lowmc);
+    pp->impls.zkbpp_verify_rounds = get_zkbpp_verify_rounds_implementation(&pp->lowmc);
   }
 #endif
 #if defined(WITH_KKW)
@@ -137,16 +180,86 @@ static bool create_instance(picnic_instance_t* pp) {
   return true;
 }
 
+static bool backend_initialized;
+
+/* apply PICNIC_BACKEND unless a backend was already selected via picnic_set_backend */
+static void init_backend(void) {
+  if (backend_initialized) {
+    return;
+  }
+  backend_initialized = true;
+
+  const char* name = getenv("PICNIC_BACKEND");
+  if (!name || !*name) {
+    return;
+  }
+
+  lowmc_backend_t backend;
+  if (!strcmp(name, "uint64")) {
+    backend = LOWMC_BACKEND_UINT64;
+  } else if (!strcmp(name, "s128")) {
+    backend = LOWMC_BACKEND_S128;
+  } else if (!strcmp(name, "s256")) {
+    backend = LOWMC_BACKEND_S256;
+  } else if (!strcmp(name, "gfni")) {
+    backend = LOWMC_BACKEND_GFNI;
+  } else {
+#if !defined(NDEBUG)
+    fprintf(stderr, "PICNIC_BACKEND: unknown backend %s, using the default backend\n", name);
+#endif
+    return;
+  }
+  if (!lowmc_set_backend(backend)) {
+#if !defined(NDEBUG)
+    fprintf(stderr, "PICNIC_BACKEND: backend %s is not available, using the default backend\n",
+            name);
+#endif
+  }
+}
+
+bool picnic_instances_set_backend(lowmc_backend_t backend) {
+  lock_acquire(&instances_lock);
+  backend_initialized = true;
+  const bool ret      = lowmc_set_backend(backend);
+  if (ret) {
+    // select the new implementations for all instances that have already been initialized
+    for (unsigned int param = PARAMETER_SET_INVALID + 1; param < PARAMETER_SET_MAX_INDEX; ++param) {
+      if (instance_initialized[param]) {
+        create_instance(&instances[param]);
+      }
+    }
+  }
+  lock_release(&instances_lock);
+  return ret;
+}
+
+lowmc_backend_t picnic_instances_get_backend(void) {
+  lock_acquire(&instances_lock);
+  init_backend();
+  const lowmc_backend_t backend = lowmc_get_backend();
+  lock_release(&instances_lock);
+  return backend;
+}
+
 const picnic_instance_t* picnic_instance_get(picnic_params_t param) {
   if (param <= PARAMETER_SET_INVALID || param >= PARAMETER_SET_MAX_INDEX) {
     return NULL;
   }
 
-  if (!instance_initialized[param]) {
-    if (!create_instance(&instances[param])) {
+  if (!instance_ready(param)) {
+    lock_acquire(&instances_lock);
+    bool ret = instance_initialized[param];
+    if (!ret) {
+      init_backend();
+      ret = create_instance(&instances[param]);
+      if (ret) {
+        set_instance_ready(param);
+      }
+    }
+    lock_release(&instances_lock);
+    if (!ret) {
       return NULL;
     }
-    instance_initialized[param] = true;
   }
 
   return &instances[param];
@@ -24,6 +24,20 @@
 
 typedef enum { TRANSFORM_FS, TRANSFORM_UR } transform_t;
 
+#if defined(WITH_ZKBPP)
+struct picnic_instance_t;
+struct sig_proof_s;
+
+/* computes the rounds begin to end - 1 of a ZKB++ proof from the states recorded by lowmc_store */
+typedef void (*zkbpp_prove_rounds_f)(const struct picnic_instance_t*, lowmc_key_t const*,
+                                     mzd_local_t const*, recorded_state_t const*,
+                                     struct sig_proof_s*, unsigned int begin, unsigned int end);
+/* recomputes the commitments of the rounds begin to end - 1 of a ZKB++ proof */
+typedef void (*zkbpp_verify_rounds_f)(const struct picnic_instance_t*, mzd_local_t const*,
+                                      mzd_local_t const*, struct sig_proof_s*, unsigned int begin,
+                                      unsigned int end);
+#endif
+
 typedef struct picnic_instance_t {
   lowmc_parameters_t lowmc;
 
@@ -48,11 +62,16 @@ typedef struct picnic_instance_t {
 
   struct {
     lowmc_implementation_f lowmc;
+    lowmc_batch_implementation_f lowmc_batch;
 #if defined(WITH_ZKBPP)
     lowmc_store_implementation_f lowmc_store;
     zkbpp_lowmc_implementation_f zkbpp_lowmc;
     zkbpp_lowmc_verify_implementation_f zkbpp_lowmc_verify;
+    zkbpp_lowmc_implementation_f zkbpp_lowmc_x4;
+    zkbpp_lowmc_verify_implementation_f zkbpp_lowmc_verify_x4;
     zkbpp_share_implementation_f mzd_share;
+    zkbpp_prove_rounds_f zkbpp_prove_rounds;
+    zkbpp_verify_rounds_f zkbpp_verify_rounds;
 #endif
 #if defined(WITH_KKW)
     lowmc_compute_aux_implementation_f lowmc_aux;
@@ -62,20 +81,17 @@ typedef struct picnic_instance_t {
 } picnic_instance_t;
 
 const picnic_instance_t* picnic_instance_get(picnic_params_t param);
+/**
+ * Select the backend of all instances, including those that are already initialized. Unless this
+ * function is called before the first instance is created, the backend is taken from the
+ * PICNIC_BACKEND environment variable.
+ */
+bool picnic_instances_set_backend(lowmc_backend_t backend);
+lowmc_backend_t picnic_instances_get_backend(void);
 
 PICNIC_EXPORT size_t PICNIC_CALLING_CONVENTION picnic_get_lowmc_block_size(picnic_params_t param);
 PICNIC_EXPORT size_t PICNIC_CALLING_CONVENTION picnic_get_private_key_size(picnic_params_t param);
 PICNIC_EXPORT size_t PICNIC_CALLING_CONVENTION picnic_get_public_key_size(picnic_params_t param);
-/**
- * Compute public key from secret key.
- *
- * @param[in] sk The secret key
- * @param[out] pk The public key to be populated
- * @return Returns 0 on success, or a nonzero value indicating an error.
- **/
-PICNIC_EXPORT int PICNIC_CALLING_CONVENTION picnic_sk_to_pk(const picnic_privatekey_t* sk,
-                                                            picnic_publickey_t* pk);
-
 /* Prefix values for domain separation */
 static const uint8_t HASH_PREFIX_0 = 0;
 static const uint8_t HASH_PREFIX_1 = 1;
@@ -0,0 +1,415 @@
+/*
+ *  This file is part of the optimized implementation of the Picnic signature scheme.
+ *  See the accompanying documentation for complete details.
+ *
+ *  The code is provided under the MIT license, see LICENSE for
+ *  more details.
+ *  SPDX-License-Identifier: MIT
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "picnic_presign.h"
+
+#include <stdbool.h>
+#include <string.h>
+
+#include "allocator.h"
+#include "compat.h"
+#include "picnic_instances.h"
+#if defined(WITH_ZKBPP)
+#include "picnic_impl.h"
+#endif
+#if defined(WITH_KKW)
+#include "picnic3_impl.h"
+#endif
+
+#if defined(HAVE_PTHREAD)
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+#if !defined(__STDC_NO_ATOMICS__) && !defined(_MSC_VER)
+#include <stdatomic.h>
+#define HAVE_STDATOMIC
+#endif
+
+/* delay before retrying after a failed precomputation, doubled after each further failure */
+#define RETRY_DELAY_MIN_MS 10
+#define RETRY_DELAY_MAX_MS 1000
+
+typedef struct presign_pool_s {
+  struct presign_pool_s* next;
+  picnic_privatekey_t sk;
+  const picnic_instance_t* instance;
+  /* ring buffer of transcripts */
+  void** transcripts;
+  size_t capacity;
+  size_t head;
+  size_t count;
+  /* process that runs the thread; the pool is dead in a forked child */
+  pid_t pid;
+  bool running;
+  pthread_t thread;
+  /* signalled when a transcript was taken or the pool is shut down */
+  pthread_cond_t not_full;
+  uint64_t hits;
+  uint64_t misses;
+  uint64_t failures;
+} presign_pool_t;
+
+/* protects the list of pools and the state of all pools */
+static pthread_mutex_t pools_lock = PTHREAD_MUTEX_INITIALIZER;
+static presign_pool_t* pools;
+#if defined(HAVE_STDATOMIC)
+/* number of pools in the list, so that signing without any pool does not take pools_lock */
+static atomic_size_t num_pools;
+#endif
+static pthread_once_t atfork_once = PTHREAD_ONCE_INIT;
+
+/* keep pools_lock consistent across fork */
+static void presign_atfork_prepare(void) {
+  pthread_mutex_lock(&pools_lock);
+}
+
+static void presign_atfork_parent(void) {
+  pthread_mutex_unlock(&pools_lock);
+}
+
+/*
+ * The threads filling the pools do not exist in the child, and the transcripts must never be used
+ * by it, since the parent may use them as well.
+ */
+static void presign_atfork_child(void) {
+  for (presign_pool_t* pool = pools; pool; pool = pool->next) {
+    pool->running = false;
+  }
+  pthread_mutex_unlock(&pools_lock);
+}
+
+static void presign_register_atfork(void) {
+  pthread_atfork(presign_atfork_prepare, presign_atfork_parent, presign_atfork_child);
+}
+
+/* caller has to hold pools_lock */
+static void link_pool(presign_pool_t* pool) {
+  pool->next = pools;
+  pools      = pool;
+#if defined(HAVE_STDATOMIC)
+  atomic_fetch_add_explicit(&num_pools, 1, memory_order_relaxed);
+#endif
+}
+
+/* caller has to hold pools_lock */
+static void unlink_pool(presign_pool_t** link) {
+  *link = (*link)->next;
+#if defined(HAVE_STDATOMIC)
+  atomic_fetch_sub_explicit(&num_pools, 1, memory_order_relaxed);
+#endif
+}
+
+static bool is_picnic3(picnic_params_t param) {
+  return param == Picnic3_L1 || param == Picnic3_L3 || param == Picnic3_L5;
+}
+
+static void* presign(const picnic_instance_t* instance, const picnic_privatekey_t* sk) {
+  const uint8_t* sk_sk = &sk->data[1];
+  const uint8_t* sk_c  = &sk->data[1 + instance->input_size];
+  const uint8_t* sk_pt = &sk->data[1 + instance->input_size + instance->output_size];
+
+  if (is_picnic3(sk->data[0])) {
+#if defined(WITH_KKW)
+    return impl_presign_picnic3(instance, sk_pt, sk_sk, sk_c);
+#else
+    return NULL;
+#endif
+  }
+#if defined(WITH_ZKBPP)
+  (void)sk_c;
+  return impl_presign(instance, sk_pt, sk_sk);
+#else
+  return NULL;
+#endif
+}
+
+static int sign_presigned(const picnic_instance_t* instance, const picnic_privatekey_t* sk,
+                          void* transcript, const uint8_t* message, size_t message_len,
+                          uint8_t* signature, size_t* signature_len) {
+  const uint8_t* sk_c  = &sk->data[1 + instance->input_size];
+  const uint8_t* sk_pt = &sk->data[1 + instance->input_size + instance->output_size];
+
+  if (is_picnic3(sk->data[0])) {
+#if defined(WITH_KKW)
+    return impl_sign_presigned_picnic3(instance, transcript, sk_pt, sk_c, message, message_len,
+                                       signature, signature_len);
+#else
+    return -1;
+#endif
+  }
+#if defined(WITH_ZKBPP)
+  return impl_sign_presigned(instance, transcript, sk_pt, sk_c, message, message_len, signature,
+                             signature_len);
+#else
+  return -1;
+#endif
+}
+
+static void release_transcript(const picnic_instance_t* instance, picnic_params_t param,
+                               void* transcript) {
+  if (is_picnic3(param)) {
+#if defined(WITH_KKW)
+    impl_presigned_free_picnic3(instance, transcript);
+#endif
+  } else {
+#if defined(WITH_ZKBPP)
+    impl_presigned_free(instance, transcript);
+#endif
+  }
+}
+
+static bool same_key(const picnic_privatekey_t* a, const picnic_privatekey_t* b) {
+  const size_t size = picnic_get_private_key_size(a->data[0]);
+  return size && !memcmp(a->data, b->data, size);
+}
+
+/* caller has to hold pools_lock */
+static presign_pool_t* find_pool(const picnic_privatekey_t* sk, presign_pool_t*** link) {
+  presign_pool_t** it = &pools;
+  for (; *it; it = &(*it)->next) {
+    if (same_key(&(*it)->sk, sk)) {
+      break;
+    }
+  }
+  if (link) {
+    *link = it;
+  }
+  return *it;
+}
+
+/* wait for delay_ms or until the pool is shut down; caller has to hold pools_lock */
+static void wait_for_retry(presign_pool_t* pool, unsigned int delay_ms) {
+  struct timespec deadline;
+  clock_gettime(CLOCK_REALTIME, &deadline);
+  deadline.tv_sec += delay_ms / 1000;
+  deadline.tv_nsec += (long)(delay_ms % 1000) * 1000000;
+  if (deadline.tv_nsec >= 1000000000) {
+    deadline.tv_sec += 1;
+    deadline.tv_nsec -= 1000000000;
+  }
+
+  /* taking a transcript signals the condition as well */
+  int ret = 0;
+  while (pool->running && !ret) {
+    ret = pthread_cond_timedwait(&pool->not_full, &pools_lock, &deadline);
+  }
+}
+
+static void* fill_pool(void* arg) {
+  presign_pool_t* pool  = arg;
+  unsigned int delay_ms = RETRY_DELAY_MIN_MS;
+
+  pthread_mutex_lock(&pools_lock);
+  while (pool->running) {
+    if (pool->count == pool->capacity) {
+      pthread_cond_wait(&pool->not_full, &pools_lock);
+      continue;
+    }
+    pthread_mutex_unlock(&pools_lock);
+
+    void* transcript = presign(pool->instance, &pool->sk);
+
+    pthread_mutex_lock(&pools_lock);
+    if (!transcript) {
+      /* randomness or memory unavailable; signing falls back to picnic_sign in the meantime */
+      ++pool->failures;
+      wait_for_retry(pool, delay_ms);
+      delay_ms = delay_ms < RETRY_DELAY_MAX_MS / 2 ? 2 * delay_ms : RETRY_DELAY_MAX_MS;
+      continue;
+    }
+    delay_ms = RETRY_DELAY_MIN_MS;
+    if (!pool->running) {
+      release_transcript(pool->instance, pool->sk.data[0], transcript);
+      break;
+    }
+    pool->transcripts[(pool->head + pool->count) % pool->capacity] = transcript;
+    ++pool->count;
+  }
+  pthread_mutex_unlock(&pools_lock);
+  return NULL;
+}
+
+static void free_pool(presign_pool_t* pool) {
+  for (size_t i = 0; i < pool->count; ++i) {
+    release_transcript(pool->instance, pool->sk.data[0],
+                       pool->transcripts[(pool->head + i) % pool->capacity]);
+  }
+  /* in a forked child, the condition may still count the waiting thread of the parent */
+  if (pool->pid == getpid()) {
+    pthread_cond_destroy(&pool->not_full);
+  }
+  picnic_free(pool->transcripts);
+  picnic_explicit_bzero(&pool->sk, sizeof(pool->sk));
+  picnic_free(pool);
+}
+
+/* stop the thread of an unlinked pool and release it */
+static void stop_pool(presign_pool_t* pool) {
+  /* in a forked child, the thread is gone */
+  if (pool->pid == getpid()) {
+    pthread_mutex_lock(&pools_lock);
+    pool->running = false;
+    pthread_cond_signal(&pool->not_full);
+    pthread_mutex_unlock(&pools_lock);
+
+    pthread_join(pool->thread, NULL);
+  }
+  free_pool(pool);
+}
+
+int PICNIC_CALLING_CONVENTION picnic_presign_enable(const picnic_privatekey_t* sk,
+                                                    size_t capacity) {
+  if (!sk || !capacity) {
+    return -1;
+  }
+  const picnic_instance_t* instance = picnic_instance_get(sk->data[0]);
+  if (!instance) {
+    return -1;
+  }
+
+  pthread_once(&atfork_once, presign_register_atfork);
+
+  presign_pool_t* pool = picnic_calloc_persistent(1, sizeof(presign_pool_t));
+  if (!pool) {
+    return -1;
+  }
+  pool->transcripts = picnic_calloc_persistent(capacity, sizeof(void*));
+  if (!pool->transcripts || pthread_cond_init(&pool->not_full, NULL)) {
+    picnic_free(pool->transcripts);
+    picnic_free(pool);
+    return -1;
+  }
+  memcpy(&pool->sk, sk, sizeof(*sk));
+  pool->instance = instance;
+  pool->capacity = capacity;
+  pool->pid      = getpid();
+  pool->running  = true;
+
+  if (pthread_create(&pool->thread, NULL, fill_pool, pool)) {
+    free_pool(pool);
+    return -1;
+  }
+
+  pthread_mutex_lock(&pools_lock);
+  presign_pool_t** link;
+  presign_pool_t* old = find_pool(sk, &link);
+  if (old) {
+    unlink_pool(link);
+  }
+  link_pool(pool);
+  pthread_mutex_unlock(&pools_lock);
+
+  if (old) {
+    stop_pool(old);
+  }
+  return 0;
+}
+
+void PICNIC_CALLING_CONVENTION picnic_presign_disable(const picnic_privatekey_t* sk) {
+  if (!sk) {
+    return;
+  }
+
+  pthread_mutex_lock(&pools_lock);
+  presign_pool_t** link;
+  presign_pool_t* pool = find_pool(sk, &link);
+  if (pool) {
+    unlink_pool(link);
+  }
+  pthread_mutex_unlock(&pools_lock);
+
+  if (pool) {
+    stop_pool(pool);
+  }
+}
+
+int PICNIC_CALLING_CONVENTION picnic_presign_get_stats(const picnic_privatekey_t* sk,
+                                                       picnic_presign_stats_t* stats) {
+  if (!sk || !stats) {
+    return -1;
+  }
+
+  pthread_mutex_lock(&pools_lock);
+  const presign_pool_t* pool = find_pool(sk, NULL);
+  if (pool) {
+    stats->hits      = pool->hits;
+    stats->misses    = pool->misses;
+    stats->failures  = pool->failures;
+    stats->available = pool->count;
+    stats->capacity  = pool->capacity;
+  }
+  pthread_mutex_unlock(&pools_lock);
+  return pool ? 0 : -1;
+}
+
+int presign_sign(const picnic_privatekey_t* sk, const uint8_t* message, size_t message_len,
+                 uint8_t* signature, size_t* signature_len) {
+#if defined(HAVE_STDATOMIC)
+  if (!atomic_load_explicit(&num_pools, memory_order_relaxed)) {
+    return 1;
+  }
+#endif
+
+  pthread_mutex_lock(&pools_lock);
+  presign_pool_t* pool = pools ? find_pool(sk, NULL) : NULL;
+  if (!pool) {
+    pthread_mutex_unlock(&pools_lock);
+    return 1;
+  }
+  if (!pool->count || !pool->running) {
+    ++pool->misses;
+    pthread_mutex_unlock(&pools_lock);
+    return 1;
+  }
+
+  /* each transcript is used for exactly one signature */
+  void* transcript = pool->transcripts[pool->head];
+  pool->head       = (pool->head + 1) % pool->capacity;
+  --pool->count;
+  ++pool->hits;
+  const picnic_instance_t* instance = pool->instance;
+  pthread_cond_signal(&pool->not_full);
+  pthread_mutex_unlock(&pools_lock);
+
+  return sign_presigned(instance, sk, transcript, message, message_len, signature, signature_len);
+}
+#else
+int PICNIC_CALLING_CONVENTION picnic_presign_enable(const picnic_privatekey_t* sk,
+                                                    size_t capacity) {
+  (void)sk;
+  (void)capacity;
+  return -1;
+}
+
+void PICNIC_CALLING_CONVENTION picnic_presign_disable(const picnic_privatekey_t* sk) {
+  (void)sk;
+}
+
+int PICNIC_CALLING_CONVENTION picnic_presign_get_stats(const picnic_privatekey_t* sk,
+                                                       picnic_presign_stats_t* stats) {
+  (void)sk;
+  (void)stats;
+  return -1;
+}
+
+int presign_sign(const picnic_privatekey_t* sk, const uint8_t* message, size_t message_len,
+                 uint8_t* signature, size_t* signature_len) {
+  (void)sk;
+  (void)message;
+  (void)message_len;
+  (void)signature;
+  (void)signature_len;
+  return 1;
+}
+#endif
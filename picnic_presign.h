@@ -0,0 +1,22 @@
+/*
+ *  This file is part of the optimized implementation of the Picnic signature scheme.
+ *  See the accompanying documentation for complete details.
+ *
+ *  The code is provided under the MIT license, see LICENSE for
+ *  more details.
+ *  SPDX-License-Identifier: MIT
+ */
+
+#ifndef PICNIC_PRESIGN_H
+#define PICNIC_PRESIGN_H
+
+#include "picnic.h"
+
+/**
+ * Sign with a precomputed transcript from the pool of sk. Returns 0 on success, a negative value on
+ * failure, and a positive value if no transcript is available.
+ */
+int presign_sign(const picnic_privatekey_t* sk, const uint8_t* message, size_t message_len,
+                 uint8_t* signature, size_t* signature_len);
+
+#endif
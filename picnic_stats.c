@@ -0,0 +1,86 @@
+/*
+ *  This file is part of the optimized implementation of the Picnic signature scheme.
+ *  See the accompanying documentation for complete details.
+ *
+ *  The code is provided under the MIT license, see LICENSE for
+ *  more details.
+ *  SPDX-License-Identifier: MIT
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "picnic_stats.h"
+
+#include <string.h>
+
+static const char* const phase_names[PICNIC_STATS_MAX] = {
+    "seeds", "tapes", "mpc", "views", "commitments", "challenge", "serialization",
+};
+
+const char* PICNIC_CALLING_CONVENTION picnic_stats_get_phase_name(picnic_stats_phase_t phase) {
+  if ((unsigned int)phase >= PICNIC_STATS_MAX) {
+    return "unknown";
+  }
+  return phase_names[phase];
+}
+
+#if defined(WITH_STATS)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define STATS_TLS __declspec(thread)
+#else
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <time.h>
+#endif
+#define STATS_TLS _Thread_local
+#endif
+
+static STATS_TLS picnic_stats_t stats;
+
+uint64_t picnic_stats_timestamp(void) {
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#elif defined(__aarch64__)
+  uint64_t result;
+  __asm__ volatile("mrs %0, cntvct_el0" : "=r"(result));
+  return result;
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * UINT64_C(1000000000) + ts.tv_nsec;
+#endif
+}
+
+void picnic_stats_record(picnic_stats_phase_t phase, uint64_t* timestamp) {
+  const uint64_t now = picnic_stats_timestamp();
+  stats.phases[phase].ticks += now - *timestamp;
+  stats.phases[phase].calls += 1;
+  *timestamp = now;
+}
+
+int PICNIC_CALLING_CONVENTION picnic_stats_get(picnic_stats_t* out) {
+  if (!out) {
+    return -1;
+  }
+
+  memcpy(out, &stats, sizeof(stats));
+  return 0;
+}
+
+void PICNIC_CALLING_CONVENTION picnic_stats_reset(void) {
+  memset(&stats, 0, sizeof(stats));
+}
+#else
+int PICNIC_CALLING_CONVENTION picnic_stats_get(picnic_stats_t* out) {
+  if (out) {
+    memset(out, 0, sizeof(*out));
+  }
+  return -1;
+}
+
+void PICNIC_CALLING_CONVENTION picnic_stats_reset(void) {}
+#endif
@@ -0,0 +1,33 @@
+/*
+ *  This file is part of the optimized implementation of the Picnic signature scheme.
+ *  See the accompanying documentation for complete details.
+ *
+ *  The code is provided under the MIT license, see LICENSE for
+ *  more details.
+ *  SPDX-License-Identifier: MIT
+ */
+
+#ifndef PICNIC_STATS_H
+#define PICNIC_STATS_H
+
+#include "picnic.h"
+
+#include <stdint.h>
+
+#if defined(WITH_STATS)
+uint64_t picnic_stats_timestamp(void);
+void picnic_stats_record(picnic_stats_phase_t phase, uint64_t* timestamp);
+
+/* Declare and start a timer. */
+#define STATS_TIMER(t) uint64_t t = picnic_stats_timestamp()
+/* Restart a timer without recording the elapsed time. */
+#define STATS_RESTART(t) t = picnic_stats_timestamp()
+/* Account the time elapsed since the timer was started to phase and restart the timer. */
+#define STATS_RECORD(t, phase) picnic_stats_record(PICNIC_STATS_##phase, &t)
+#else
+#define STATS_TIMER(t)
+#define STATS_RESTART(t)
+#define STATS_RECORD(t, phase)
+#endif
+
+#endif
@@ -0,0 +1,291 @@
+/*
+ *  This file is part of the optimized implementation of the Picnic signature scheme.
+ *  See the accompanying documentation for complete details.
+ *
+ *  The code is provided under the MIT license, see LICENSE for
+ *  more details.
+ *  SPDX-License-Identifier: MIT
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "picnic.h"
+
+#include <stdbool.h>
+
+#include "allocator.h"
+#include "picnic_instances.h"
+#if defined(WITH_ZKBPP)
+#include "picnic_impl.h"
+#endif
+#if defined(WITH_KKW)
+#include "picnic3_impl.h"
+#endif
+
+struct picnic_sign_ctx_s {
+  const picnic_instance_t* instance;
+  const picnic_privatekey_t* sk;
+  const uint8_t* message;
+  size_t message_len;
+  /* transcript of impl_sign_begin */
+  void* state;
+  unsigned int step;
+  /* 1 if more steps follow, 0 if all steps are done, -1 on failure */
+  int status;
+};
+
+struct picnic_verify_ctx_s {
+  const picnic_instance_t* instance;
+  const picnic_publickey_t* pk;
+  const uint8_t* message;
+  size_t message_len;
+  /* state of impl_verify_begin */
+  void* state;
+  unsigned int step;
+  /* 1 if more steps follow, 0 if all steps are done, -1 on failure */
+  int status;
+};
+
+static bool is_picnic3(picnic_params_t param) {
+  return param == Picnic3_L1 || param == Picnic3_L3 || param == Picnic3_L5;
+}
+
+#define SK_SK(ctx) &(ctx)->sk->data[1]
+#define SK_C(ctx) &(ctx)->sk->data[1 + (ctx)->instance->input_size]
+#define SK_PT(ctx) &(ctx)->sk->data[1 + (ctx)->instance->input_size + (ctx)->instance->output_size]
+
+#define PK_C(ctx) &(ctx)->pk->data[1]
+#define PK_PT(ctx) &(ctx)->pk->data[1 + (ctx)->instance->output_size]
+
+static void sign_release(picnic_sign_ctx_t* ctx) {
+  if (ctx->state) {
+    if (is_picnic3(ctx->sk->data[0])) {
+#if defined(WITH_KKW)
+      impl_presigned_free_picnic3(ctx->instance, ctx->state);
+#endif
+    } else {
+#if defined(WITH_ZKBPP)
+      impl_presigned_free(ctx->instance, ctx->state);
+#endif
+    }
+  }
+  picnic_free(ctx);
+}
+
+picnic_sign_ctx_t* PICNIC_CALLING_CONVENTION picnic_sign_begin(const picnic_privatekey_t* sk,
+                                                               const uint8_t* message,
+                                                               size_t message_len) {
+  if (!sk) {
+    return NULL;
+  }
+
+  const picnic_instance_t* instance = picnic_instance_get(sk->data[0]);
+  if (!instance) {
+    return NULL;
+  }
+
+  picnic_sign_ctx_t* ctx = picnic_calloc(1, sizeof(picnic_sign_ctx_t));
+  if (!ctx) {
+    return NULL;
+  }
+  ctx->instance    = instance;
+  ctx->sk          = sk;
+  ctx->message     = message;
+  ctx->message_len = message_len;
+  ctx->status      = 1;
+
+  if (is_picnic3(sk->data[0])) {
+#if defined(WITH_KKW)
+    ctx->state = impl_sign_begin_picnic3(instance, SK_PT(ctx), SK_SK(ctx), SK_C(ctx), message,
+                                         message_len);
+#endif
+  } else {
+#if defined(WITH_ZKBPP)
+    ctx->state =
+        impl_sign_begin(instance, SK_PT(ctx), SK_SK(ctx), SK_C(ctx), message, message_len);
+#endif
+  }
+  if (!ctx->state) {
+    sign_release(ctx);
+    return NULL;
+  }
+  return ctx;
+}
+
+int PICNIC_CALLING_CONVENTION picnic_sign_step(picnic_sign_ctx_t* ctx) {
+  if (!ctx) {
+    return -1;
+  }
+  if (ctx->status <= 0) {
+    return ctx->status;
+  }
+
+  if (is_picnic3(ctx->sk->data[0])) {
+#if defined(WITH_KKW)
+    ctx->status = impl_sign_step_picnic3(ctx->instance, ctx->state, ctx->step, SK_PT(ctx),
+                                         SK_SK(ctx), SK_C(ctx));
+#endif
+  } else {
+#if defined(WITH_ZKBPP)
+    ctx->status = impl_sign_step(ctx->instance, ctx->state, ctx->step, SK_PT(ctx), SK_SK(ctx));
+#endif
+  }
+  ctx->step++;
+  return ctx->status;
+}
+
+int PICNIC_CALLING_CONVENTION picnic_sign_finish(picnic_sign_ctx_t* ctx, uint8_t* signature,
+                                                 size_t* signature_len) {
+  if (!ctx) {
+    return -1;
+  }
+  if (!signature || !signature_len) {
+    sign_release(ctx);
+    return -1;
+  }
+
+  while (picnic_sign_step(ctx) > 0) {
+  }
+  if (ctx->status < 0) {
+    sign_release(ctx);
+    return -1;
+  }
+
+  /* the transcript is released by impl_sign_presigned */
+  int ret = -1;
+  if (is_picnic3(ctx->sk->data[0])) {
+#if defined(WITH_KKW)
+    ret = impl_sign_presigned_picnic3(ctx->instance, ctx->state, SK_PT(ctx), SK_C(ctx),
+                                      ctx->message, ctx->message_len, signature, signature_len);
+#endif
+  } else {
+#if defined(WITH_ZKBPP)
+    ret = impl_sign_presigned(ctx->instance, ctx->state, SK_PT(ctx), SK_C(ctx), ctx->message,
+                              ctx->message_len, signature, signature_len);
+#endif
+  }
+  ctx->state = NULL;
+  sign_release(ctx);
+  return ret;
+}
+
+void PICNIC_CALLING_CONVENTION picnic_sign_cancel(picnic_sign_ctx_t* ctx) {
+  if (ctx) {
+    sign_release(ctx);
+  }
+}
+
+static void verify_release(picnic_verify_ctx_t* ctx) {
+  if (ctx->state) {
+    if (is_picnic3(ctx->pk->data[0])) {
+#if defined(WITH_KKW)
+      impl_verify_free_picnic3(ctx->instance, ctx->state);
+#endif
+    } else {
+#if defined(WITH_ZKBPP)
+      impl_verify_free(ctx->instance, ctx->state);
+#endif
+    }
+  }
+  picnic_free(ctx);
+}
+
+picnic_verify_ctx_t* PICNIC_CALLING_CONVENTION picnic_verify_begin(const picnic_publickey_t* pk,
+                                                                   const uint8_t* message,
+                                                                   size_t message_len,
+                                                                   const uint8_t* signature,
+                                                                   size_t signature_len) {
+  if (!pk || !signature || !signature_len) {
+    return NULL;
+  }
+
+  const picnic_instance_t* instance = picnic_instance_get(pk->data[0]);
+  if (!instance) {
+    return NULL;
+  }
+
+  picnic_verify_ctx_t* ctx = picnic_calloc(1, sizeof(picnic_verify_ctx_t));
+  if (!ctx) {
+    return NULL;
+  }
+  ctx->instance    = instance;
+  ctx->pk          = pk;
+  ctx->message     = message;
+  ctx->message_len = message_len;
+  ctx->status      = 1;
+
+  if (is_picnic3(pk->data[0])) {
+#if defined(WITH_KKW)
+    ctx->state = impl_verify_begin_picnic3(instance, signature, signature_len);
+#endif
+  } else {
+#if defined(WITH_ZKBPP)
+    ctx->state = impl_verify_begin(instance, signature, signature_len);
+#endif
+  }
+  if (!ctx->state) {
+    verify_release(ctx);
+    return NULL;
+  }
+  return ctx;
+}
+
+int PICNIC_CALLING_CONVENTION picnic_verify_step(picnic_verify_ctx_t* ctx) {
+  if (!ctx) {
+    return -1;
+  }
+  if (ctx->status <= 0) {
+    return ctx->status;
+  }
+
+  if (is_picnic3(ctx->pk->data[0])) {
+#if defined(WITH_KKW)
+    ctx->status =
+        impl_verify_step_picnic3(ctx->instance, ctx->state, ctx->step, PK_PT(ctx), PK_C(ctx));
+#endif
+  } else {
+#if defined(WITH_ZKBPP)
+    ctx->status = impl_verify_step(ctx->instance, ctx->state, ctx->step, PK_PT(ctx), PK_C(ctx));
+#endif
+  }
+  ctx->step++;
+  return ctx->status;
+}
+
+int PICNIC_CALLING_CONVENTION picnic_verify_finish(picnic_verify_ctx_t* ctx) {
+  if (!ctx) {
+    return -1;
+  }
+
+  while (picnic_verify_step(ctx) > 0) {
+  }
+  if (ctx->status < 0) {
+    verify_release(ctx);
+    return -1;
+  }
+
+  /* the state is released by impl_verify_finish */
+  int ret = -1;
+  if (is_picnic3(ctx->pk->data[0])) {
+#if defined(WITH_KKW)
+    ret = impl_verify_finish_picnic3(ctx->instance, ctx->state, PK_PT(ctx), PK_C(ctx),
+                                     ctx->message, ctx->message_len);
+#endif
+  } else {
+#if defined(WITH_ZKBPP)
+    ret = impl_verify_finish(ctx->instance, ctx->state, PK_PT(ctx), PK_C(ctx), ctx->message,
+                             ctx->message_len);
+#endif
+  }
+  ctx->state = NULL;
+  verify_release(ctx);
+  return ret;
+}
+
+void PICNIC_CALLING_CONVENTION picnic_verify_cancel(picnic_verify_ctx_t* ctx) {
+  if (ctx) {
+    verify_release(ctx);
+  }
+}
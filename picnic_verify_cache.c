@@ -0,0 +1,263 @@
+/*
+ *  This file is part of the optimized implementation of the Picnic signature scheme.
+ *  See the accompanying documentation for complete details.
+ *
+ *  The code is provided under the MIT license, see LICENSE for
+ *  more details.
+ *  SPDX-License-Identifier: MIT
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "picnic.h"
+
+#include <string.h>
+
+#include "allocator.h"
+#include "endian_compat.h"
+#include "kdf_shake.h"
+#include "lock.h"
+#include "picnic_instances.h"
+
+/* cache keys are SHAKE256 digests of public key, message and signature */
+#define CACHE_KEY_SIZE 32
+#define NIL UINT32_MAX
+/* the number of buckets is the next power of 2 and needs to fit into 32 bits */
+#define MAX_CAPACITY (UINT32_C(1) << 31)
+
+typedef struct {
+  uint8_t key[CACHE_KEY_SIZE];
+  /* next entry in the same bucket */
+  uint32_t chain;
+  /* neighbours in eviction order */
+  uint32_t older;
+  uint32_t newer;
+  int result;
+} cache_entry_t;
+
+typedef struct {
+  cache_entry_t* entries;
+  uint32_t* buckets;
+  uint32_t capacity;
+  uint32_t bucket_mask;
+  uint32_t size;
+  /* the next entry to be evicted and the most recently inserted (or used) entry */
+  uint32_t oldest;
+  uint32_t newest;
+  picnic_cache_policy_t policy;
+  uint64_t hits;
+  uint64_t misses;
+  uint64_t evictions;
+} verify_cache_t;
+
+static verify_cache_t cache;
+static lock_t cache_lock = LOCK_INITIALIZER;
+
+static bool compute_key(uint8_t* key, const picnic_publickey_t* pk, const uint8_t* message,
+                        size_t message_len, const uint8_t* signature, size_t signature_len) {
+  const size_t pk_size = picnic_get_public_key_size(pk->data[0]);
+  if (!pk_size) {
+    return false;
+  }
+
+  const uint64_t message_len_le = htole64(message_len);
+
+  hash_context ctx;
+  hash_init(&ctx, 64);
+  hash_update(&ctx, pk->data, pk_size);
+  hash_update(&ctx, (const uint8_t*)&message_len_le, sizeof(message_len_le));
+  hash_update(&ctx, message, message_len);
+  hash_update(&ctx, signature, signature_len);
+  hash_final(&ctx);
+  hash_squeeze(&ctx, key, CACHE_KEY_SIZE);
+  return true;
+}
+
+static uint32_t bucket_of(const uint8_t* key) {
+  /* the key is a digest, so any of its bytes are good enough as hash */
+  uint32_t bucket;
+  memcpy(&bucket, key, sizeof(bucket));
+  return bucket & cache.bucket_mask;
+}
+
+static void unlink_order(uint32_t index) {
+  cache_entry_t* entry = &cache.entries[index];
+  if (entry->older != NIL) {
+    cache.entries[entry->older].newer = entry->newer;
+  } else {
+    cache.oldest = entry->newer;
+  }
+  if (entry->newer != NIL) {
+    cache.entries[entry->newer].older = entry->older;
+  } else {
+    cache.newest = entry->older;
+  }
+}
+
+static void link_newest(uint32_t index) {
+  cache_entry_t* entry = &cache.entries[index];
+  entry->older         = cache.newest;
+  entry->newer         = NIL;
+  if (cache.newest != NIL) {
+    cache.entries[cache.newest].newer = index;
+  } else {
+    cache.oldest = index;
+  }
+  cache.newest = index;
+}
+
+static uint32_t lookup(const uint8_t* key) {
+  for (uint32_t index = cache.buckets[bucket_of(key)]; index != NIL;
+       index          = cache.entries[index].chain) {
+    if (!memcmp(cache.entries[index].key, key, CACHE_KEY_SIZE)) {
+      return index;
+    }
+  }
+  return NIL;
+}
+
+static void evict_oldest(void) {
+  const uint32_t index = cache.oldest;
+  uint32_t* link       = &cache.buckets[bucket_of(cache.entries[index].key)];
+  while (*link != index) {
+    link = &cache.entries[*link].chain;
+  }
+  *link = cache.entries[index].chain;
+
+  unlink_order(index);
+  --cache.size;
+  ++cache.evictions;
+}
+
+static void insert(const uint8_t* key, int result) {
+  if (lookup(key) != NIL) {
+    /* inserted by a concurrent verification of the same signature */
+    return;
+  }
+
+  uint32_t index;
+  if (cache.size == cache.capacity) {
+    index = cache.oldest;
+    evict_oldest();
+  } else {
+    /* entries are only released by eviction, so the first size entries are in use */
+    index = cache.size;
+  }
+
+  cache_entry_t* entry = &cache.entries[index];
+  memcpy(entry->key, key, CACHE_KEY_SIZE);
+  entry->result = result;
+
+  const uint32_t bucket = bucket_of(key);
+  entry->chain          = cache.buckets[bucket];
+  cache.buckets[bucket] = index;
+  link_newest(index);
+  ++cache.size;
+}
+
+static void release_cache(void) {
+  picnic_free(cache.buckets);
+  picnic_free(cache.entries);
+  memset(&cache, 0, sizeof(cache));
+}
+
+int PICNIC_CALLING_CONVENTION picnic_verify_cache_enable(size_t capacity,
+                                                         picnic_cache_policy_t policy) {
+  if (!capacity || capacity > MAX_CAPACITY ||
+      (policy != PICNIC_CACHE_LRU && policy != PICNIC_CACHE_FIFO)) {
+    return -1;
+  }
+
+  /* at least one bucket per entry */
+  uint32_t buckets = 1;
+  while (buckets < capacity) {
+    buckets <<= 1;
+  }
+
+  cache_entry_t* entries = picnic_calloc_persistent(capacity, sizeof(cache_entry_t));
+  uint32_t* bucket_heads = picnic_calloc_persistent(buckets, sizeof(uint32_t));
+  if (!entries || !bucket_heads) {
+    picnic_free(bucket_heads);
+    picnic_free(entries);
+    return -1;
+  }
+  memset(bucket_heads, 0xff, buckets * sizeof(uint32_t));
+
+  lock_acquire(&cache_lock);
+  release_cache();
+  cache.entries     = entries;
+  cache.buckets     = bucket_heads;
+  cache.capacity    = capacity;
+  cache.bucket_mask = buckets - 1;
+  cache.oldest      = NIL;
+  cache.newest      = NIL;
+  cache.policy      = policy;
+  lock_release(&cache_lock);
+  return 0;
+}
+
+void PICNIC_CALLING_CONVENTION picnic_verify_cache_disable(void) {
+  lock_acquire(&cache_lock);
+  release_cache();
+  lock_release(&cache_lock);
+}
+
+int PICNIC_CALLING_CONVENTION picnic_verify_cached(const picnic_publickey_t* pk,
+                                                   const uint8_t* message, size_t message_len,
+                                                   const uint8_t* signature,
+                                                   size_t signature_len) {
+  uint8_t key[CACHE_KEY_SIZE];
+  if (!pk || !signature || !signature_len ||
+      !compute_key(key, pk, message, message_len, signature, signature_len)) {
+    return picnic_verify(pk, message, message_len, signature, signature_len);
+  }
+
+  lock_acquire(&cache_lock);
+  if (!cache.entries) {
+    lock_release(&cache_lock);
+    return picnic_verify(pk, message, message_len, signature, signature_len);
+  }
+
+  const uint32_t index = lookup(key);
+  if (index != NIL) {
+    const int result = cache.entries[index].result;
+    if (cache.policy == PICNIC_CACHE_LRU) {
+      unlink_order(index);
+      link_newest(index);
+    }
+    ++cache.hits;
+    lock_release(&cache_lock);
+    return result;
+  }
+  ++cache.misses;
+  lock_release(&cache_lock);
+
+  /* verify without holding the lock; a failure to allocate memory says nothing about the signature,
+   * so such results are not cached */
+  const size_t failures = picnic_allocation_failures();
+  const int result      = picnic_verify(pk, message, message_len, signature, signature_len);
+  const bool definitive = !result || picnic_allocation_failures() == failures;
+
+  lock_acquire(&cache_lock);
+  if (cache.entries && definitive) {
+    insert(key, result);
+  }
+  lock_release(&cache_lock);
+  return result;
+}
+
+void PICNIC_CALLING_CONVENTION picnic_verify_cache_get_stats(picnic_verify_cache_stats_t* stats) {
+  if (!stats) {
+    return;
+  }
+
+  lock_acquire(&cache_lock);
+  stats->hits      = cache.hits;
+  stats->misses    = cache.misses;
+  stats->evictions = cache.evictions;
+  stats->entries   = cache.size;
+  stats->capacity  = cache.capacity;
+  lock_release(&cache_lock);
+}
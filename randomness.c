@@ -27,7 +27,7 @@ int rand_bytes(uint8_t* dst, size_t len) {
                            (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 25))
 #include <sys/random.h>
 
-int rand_bytes(uint8_t* dst, size_t len) {
+static int os_rand_bytes(uint8_t* dst, size_t len) {
   const ssize_t ret = getrandom(dst, len, GRND_NONBLOCK);
   if (ret < 0 || (size_t)ret != len) {
     return -1;
@@ -37,7 +37,7 @@ int rand_bytes(uint8_t* dst, size_t len) {
 #elif defined(__APPLE__) && defined(HAVE_APPLE_FRAMEWORK)
 #include <Security/Security.h>
 
-int rand_bytes(uint8_t* dst, size_t len) {
+static int os_rand_bytes(uint8_t* dst, size_t len) {
   if (SecRandomCopyBytes(kSecRandomDefault, len, dst) == errSecSuccess) {
     return 0;
   }
@@ -62,7 +62,7 @@ int rand_bytes(uint8_t* dst, size_t len) {
 #define O_CLOEXEC 0
 #endif
 
-int rand_bytes(uint8_t* dst, size_t len) {
+static int os_rand_bytes(uint8_t* dst, size_t len) {
   int fd;
   while ((fd = open("/dev/urandom", O_RDONLY | O_NOFOLLOW | O_CLOEXEC, 0)) == -1) {
     // check if we should restart
@@ -104,7 +104,7 @@ int rand_bytes(uint8_t* dst, size_t len) {
 #elif defined(_WIN16) || defined(_WIN32) || defined(_WIN64)
 #include <windows.h>
 
-int rand_bytes(uint8_t* dst, size_t len) {
+static int os_rand_bytes(uint8_t* dst, size_t len) {
   if (len > ULONG_MAX) {
     return -1;
   }
@@ -116,6 +116,165 @@ int rand_bytes(uint8_t* dst, size_t len) {
 #else
 #error "Unsupported OS! Please implement rand_bytes."
 #endif
+
+#if defined(WITH_DRBG)
+#include "compat.h"
+#include "kdf_shake.h"
+#include "macros.h"
+
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#if !defined(_WIN32)
+#include <pthread.h>
+#endif
+#if !defined(__STDC_NO_ATOMICS__) && !defined(_MSC_VER)
+#include <stdatomic.h>
+#define HAVE_STDATOMIC
+#endif
+
+/* size of the key and of the entropy requested from the OS on (re)seeding */
+#define DRBG_KEY_SIZE 32
+/* number of bytes generated ahead of time */
+#define DRBG_BUFFER_SIZE 512
+/* reseed from the OS after this many bytes have been generated ... */
+#define DRBG_RESEED_BYTES (UINT64_C(1) << 20)
+/* ... or after this many seconds */
+#define DRBG_RESEED_INTERVAL 300
+
+/* domain separation of the two SHAKE256 invocations */
+#define DRBG_PREFIX_RESEED 0
+#define DRBG_PREFIX_GENERATE 1
+
+typedef struct {
+  uint8_t key[DRBG_KEY_SIZE];
+  uint8_t buffer[DRBG_BUFFER_SIZE];
+  /* number of unused bytes at the end of buffer */
+  size_t available;
+  uint64_t generated;
+  time_t seeded_at;
+  unsigned int fork_generation;
+  bool seeded;
+} drbg_t;
+
+static THREAD_LOCAL drbg_t drbg;
+
+#if !defined(_WIN32)
+/* incremented in the child after fork, so that no two processes share a DRBG state */
+#if defined(HAVE_STDATOMIC)
+static atomic_uint fork_generation;
+#else
+static unsigned int fork_generation;
+#endif
+static pthread_once_t atfork_once = PTHREAD_ONCE_INIT;
+
+static void drbg_atfork_child(void) {
+#if defined(HAVE_STDATOMIC)
+  atomic_fetch_add_explicit(&fork_generation, 1, memory_order_relaxed);
+#else
+  ++fork_generation;
+#endif
+}
+
+static void drbg_register_atfork(void) {
+  pthread_atfork(NULL, NULL, drbg_atfork_child);
+}
+
+static unsigned int get_fork_generation(void) {
+#if defined(HAVE_STDATOMIC)
+  return atomic_load_explicit(&fork_generation, memory_order_relaxed);
+#else
+  return fork_generation;
+#endif
+}
+#else
+static unsigned int get_fork_generation(void) {
+  return 0;
+}
+#endif
+
+static bool drbg_needs_reseed(const drbg_t* state) {
+  return !state->seeded || state->fork_generation != get_fork_generation() ||
+         state->generated >= DRBG_RESEED_BYTES ||
+         time(NULL) - state->seeded_at >= DRBG_RESEED_INTERVAL;
+}
+
+static int drbg_reseed(drbg_t* state) {
+#if !defined(_WIN32)
+  pthread_once(&atfork_once, drbg_register_atfork);
+#endif
+
+  uint8_t entropy[DRBG_KEY_SIZE];
+  if (os_rand_bytes(entropy, sizeof(entropy))) {
+    return -1;
+  }
+
+  // new key = H(old key || entropy); the old key is all zero on the first seed
+  hash_context ctx;
+  hash_init_prefix(&ctx, 64, DRBG_PREFIX_RESEED);
+  hash_update(&ctx, state->key, sizeof(state->key));
+  hash_update(&ctx, entropy, sizeof(entropy));
+  hash_final(&ctx);
+  hash_squeeze(&ctx, state->key, sizeof(state->key));
+  picnic_explicit_bzero(entropy, sizeof(entropy));
+  picnic_explicit_bzero(&ctx, sizeof(ctx));
+
+  // discard output generated from the old key
+  picnic_explicit_bzero(state->buffer, sizeof(state->buffer));
+  state->available       = 0;
+  state->generated       = 0;
+  state->seeded_at       = time(NULL);
+  state->fork_generation = get_fork_generation();
+  state->seeded          = true;
+  return 0;
+}
+
+/* replace the key and produce len bytes of output from the old key */
+static void drbg_squeeze(drbg_t* state, uint8_t* dst, size_t len) {
+  hash_context ctx;
+  hash_init_prefix(&ctx, 64, DRBG_PREFIX_GENERATE);
+  hash_update(&ctx, state->key, sizeof(state->key));
+  hash_final(&ctx);
+  hash_squeeze(&ctx, state->key, sizeof(state->key));
+  hash_squeeze(&ctx, dst, len);
+  picnic_explicit_bzero(&ctx, sizeof(ctx));
+}
+
+int rand_bytes(uint8_t* dst, size_t len) {
+  drbg_t* state = &drbg;
+  if (drbg_needs_reseed(state) && drbg_reseed(state)) {
+    return -1;
+  }
+  state->generated += len;
+
+  while (len) {
+    if (!state->available) {
+      if (len >= DRBG_BUFFER_SIZE) {
+        // large requests bypass the buffer
+        drbg_squeeze(state, dst, len);
+        return 0;
+      }
+      drbg_squeeze(state, state->buffer, DRBG_BUFFER_SIZE);
+      state->available = DRBG_BUFFER_SIZE;
+    }
+
+    uint8_t* src     = state->buffer + DRBG_BUFFER_SIZE - state->available;
+    const size_t cnt = len < state->available ? len : state->available;
+    memcpy(dst, src, cnt);
+    // erase output once it has been handed out
+    picnic_explicit_bzero(src, cnt);
+
+    state->available -= cnt;
+    dst += cnt;
+    len -= cnt;
+  }
+  return 0;
+}
+#else
+int rand_bytes(uint8_t* dst, size_t len) {
+  return os_rand_bytes(dst, len);
+}
+#endif
 #endif
 
 int rand_bits(uint8_t* dst, size_t num_bits) {
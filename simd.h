@@ -38,12 +38,16 @@
 #define CPU_SUPPORTS_AVX2 cpu_supports(CPU_CAP_AVX2 | CPU_CAP_BMI2)
 #define CPU_SUPPORTS_POPCNT cpu_supports(CPU_CAP_POPCNT)
 #endif
+#if defined(WITH_GFNI)
+/* __builtin_cpu_supports does not know GFNI on all supported compilers */
+#define CPU_SUPPORTS_GFNI (CPU_SUPPORTS_AVX2 && cpu_supports(CPU_CAP_GFNI))
+#endif
 #endif
 
 #if defined(__x86_64__) || defined(_M_X64)
 // X86-64 CPUs always support SSE2
 #define CPU_SUPPORTS_SSE2 1
-#if defined(WITH_SSE2) || defined(WITH_AVX2)
+#if (defined(WITH_SSE2) || defined(WITH_AVX2)) && !defined(WITH_UINT64_FALLBACK)
 #define NO_UINT64_FALLBACK
 #endif
 #elif defined(__i386__) || defined(_M_IX86)
@@ -58,7 +62,7 @@
 
 #if defined(__aarch64__)
 #define CPU_SUPPORTS_NEON 1
-#if defined(WITH_NEON)
+#if defined(WITH_NEON) && !defined(WITH_UINT64_FALLBACK)
 #define NO_UINT64_FALLBACK
 #endif
 #elif defined(__arm__)
@@ -181,6 +185,15 @@ typedef __m128i word128;
 #define mm128_broadcast_u64(x) _mm_set1_epi64x((x))
 #define mm128_sl_u64(x, s) _mm_slli_epi64((x), (s))
 #define mm128_sr_u64(x, s) _mm_srli_epi64((x), (s))
+#define mm128_broadcast_u32(x) _mm_set1_epi32((int)(x))
+#define mm128_sl_u32(x, s) _mm_slli_epi32((x), (s))
+#define mm128_sr_u32(x, s) _mm_srli_epi32((x), (s))
+#define mm128_broadcast_u16(x) _mm_set1_epi16((short)(x))
+#define mm128_sl_u16(x, s) _mm_slli_epi16((x), (s))
+#define mm128_sr_u16(x, s) _mm_srli_epi16((x), (s))
+/* interleave the lower (upper) 64 bit words of l and r */
+#define mm128_unpacklo_u64(l, r) _mm_unpacklo_epi64((l), (r))
+#define mm128_unpackhi_u64(l, r) _mm_unpackhi_epi64((l), (r))
 
 apply_region(mm128_xor_region, word128, mm128_xor, FN_ATTRIBUTES_SSE2)
 apply_mask_region(mm128_xor_mask_region, word128, mm128_xor, mm128_and, FN_ATTRIBUTES_SSE2)
@@ -267,6 +280,27 @@ typedef uint64x2_t word128;
   (__builtin_constant_p(s) ? vshlq_n_u64((x), (s)) : vshlq_u64((x), vdupq_n_s64(s)))
 #define mm128_sr_u64(x, s)                                                                         \
   (__builtin_constant_p(s) ? vshrq_n_u64((x), (s)) : vshlq_u64((x), vdupq_n_s64(-(int64_t)(s))))
+#define mm128_broadcast_u32(x) vreinterpretq_u64_u32(vdupq_n_u32((x)))
+#define mm128_sl_u32(x, s)                                                                         \
+  vreinterpretq_u64_u32(__builtin_constant_p(s)                                                    \
+                            ? vshlq_n_u32(vreinterpretq_u32_u64(x), (s))                           \
+                            : vshlq_u32(vreinterpretq_u32_u64(x), vdupq_n_s32(s)))
+#define mm128_sr_u32(x, s)                                                                         \
+  vreinterpretq_u64_u32(__builtin_constant_p(s)                                                    \
+                            ? vshrq_n_u32(vreinterpretq_u32_u64(x), (s))                           \
+                            : vshlq_u32(vreinterpretq_u32_u64(x), vdupq_n_s32(-(int32_t)(s))))
+#define mm128_broadcast_u16(x) vreinterpretq_u64_u16(vdupq_n_u16((x)))
+#define mm128_sl_u16(x, s)                                                                         \
+  vreinterpretq_u64_u16(__builtin_constant_p(s)                                                    \
+                            ? vshlq_n_u16(vreinterpretq_u16_u64(x), (s))                           \
+                            : vshlq_u16(vreinterpretq_u16_u64(x), vdupq_n_s16(s)))
+#define mm128_sr_u16(x, s)                                                                         \
+  vreinterpretq_u64_u16(__builtin_constant_p(s)                                                    \
+                            ? vshrq_n_u16(vreinterpretq_u16_u64(x), (s))                           \
+                            : vshlq_u16(vreinterpretq_u16_u64(x), vdupq_n_s16(-(int16_t)(s))))
+/* interleave the lower (upper) 64 bit words of l and r */
+#define mm128_unpacklo_u64(l, r) vzip1q_u64((l), (r))
+#define mm128_unpackhi_u64(l, r) vzip2q_u64((l), (r))
 
 apply_region(mm128_xor_region, word128, mm128_xor, FN_ATTRIBUTES_NEON)
 apply_mask_region(mm128_xor_mask_region, word128, mm128_xor, mm128_and, FN_ATTRIBUTES_NEON)
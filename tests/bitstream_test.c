@@ -15,6 +15,7 @@
 
 #include <inttypes.h>
 #include <stdio.h>
+#include <string.h>
 
 static int simple_test(void) {
   int ret = 0;
@@ -139,6 +140,122 @@ static int test_multiple_30(void) {
   return ret;
 }
 
+static int test_fields(void) {
+  int ret = 0;
+  uint64_t values[17];
+  for (unsigned int i = 0; i < 17; ++i) {
+    values[i] = UINT64_C(0x9e3779b97f4a7c15) * (i + 1);
+  }
+
+  for (unsigned int num_bits = 1; num_bits <= 64; ++num_bits) {
+    for (unsigned int offset = 0; offset < 8; ++offset) {
+      uint8_t buffer[17 * 8 + 2];
+      uint8_t buffer2[17 * 8 + 2];
+      memset(buffer, 0xa5, sizeof(buffer));
+      memset(buffer2, 0xa5, sizeof(buffer2));
+
+      bitstream_t bsw;
+      bsw.buffer.w = buffer;
+      bsw.position = offset;
+      bitstream_put_fields(&bsw, values, 1, 17, num_bits);
+
+      bitstream_t bsw2;
+      bsw2.buffer.w = buffer2;
+      bsw2.position = offset;
+      for (unsigned int i = 0; i < 17; ++i) {
+        bitstream_put_bits(&bsw2, values[i] >> (64 - num_bits), num_bits);
+      }
+
+      if (bsw.position != bsw2.position || memcmp(buffer, buffer2, sizeof(buffer))) {
+        printf("test_fields: put mismatch for %u bits at offset %u\n", num_bits, offset);
+        ret = -1;
+        continue;
+      }
+
+      uint64_t read[17];
+      bitstream_t bsr;
+      bsr.buffer.r = buffer;
+      bsr.position = offset;
+      bitstream_get_fields(&bsr, read, 1, 17, num_bits);
+
+      const uint64_t mask = UINT64_C(0xffffffffffffffff) << (64 - num_bits);
+      for (unsigned int i = 0; i < 17; ++i) {
+        if (read[i] != (values[i] & mask)) {
+          printf("test_fields: get mismatch for %u bits at offset %u: expected %016" PRIx64
+                 ", got %016" PRIx64 "\n",
+                 num_bits, offset, values[i] & mask, read[i]);
+          ret = -1;
+        }
+      }
+      if (bsr.position != bsw.position) {
+        printf("test_fields: position mismatch for %u bits at offset %u\n", num_bits, offset);
+        ret = -1;
+      }
+    }
+  }
+
+  return ret;
+}
+
+/* fields in every third 32 bit word as in the views of the instances with partial S-box layer */
+static int test_fields_32(void) {
+  int ret = 0;
+  uint32_t values[3 * 17];
+  for (unsigned int i = 0; i < 3 * 17; ++i) {
+    values[i] = UINT32_C(0x9e3779b9) * (i + 1);
+  }
+
+  for (unsigned int num_bits = 1; num_bits <= 32; ++num_bits) {
+    for (unsigned int offset = 0; offset < 8; ++offset) {
+      uint8_t buffer[17 * 4 + 2];
+      uint8_t buffer2[17 * 4 + 2];
+      memset(buffer, 0xa5, sizeof(buffer));
+      memset(buffer2, 0xa5, sizeof(buffer2));
+
+      bitstream_t bsw;
+      bsw.buffer.w = buffer;
+      bsw.position = offset;
+      bitstream_put_fields_32(&bsw, &values[1], 3, 17, num_bits);
+
+      bitstream_t bsw2;
+      bsw2.buffer.w = buffer2;
+      bsw2.position = offset;
+      for (unsigned int i = 0; i < 17; ++i) {
+        bitstream_put_bits(&bsw2, values[3 * i + 1] >> (32 - num_bits), num_bits);
+      }
+
+      if (bsw.position != bsw2.position || memcmp(buffer, buffer2, sizeof(buffer))) {
+        printf("test_fields_32: put mismatch for %u bits at offset %u\n", num_bits, offset);
+        ret = -1;
+        continue;
+      }
+
+      uint32_t read[3 * 17];
+      memset(read, 0xa5, sizeof(read));
+      bitstream_t bsr;
+      bsr.buffer.r = buffer;
+      bsr.position = offset;
+      bitstream_get_fields_32(&bsr, &read[1], 3, 17, num_bits);
+
+      const uint32_t mask = UINT32_C(0xffffffff) << (32 - num_bits);
+      for (unsigned int i = 0; i < 17; ++i) {
+        if (read[3 * i + 1] != (values[3 * i + 1] & mask) || read[3 * i] != UINT32_C(0xa5a5a5a5)) {
+          printf("test_fields_32: get mismatch for %u bits at offset %u: expected %08" PRIx32
+                 ", got %08" PRIx32 "\n",
+                 num_bits, offset, values[3 * i + 1] & mask, read[3 * i + 1]);
+          ret = -1;
+        }
+      }
+      if (bsr.position != bsw.position) {
+        printf("test_fields_32: position mismatch for %u bits at offset %u\n", num_bits, offset);
+        ret = -1;
+      }
+    }
+  }
+
+  return ret;
+}
+
 int main(void) {
   int ret = 0;
 
@@ -160,5 +277,17 @@ int main(void) {
     ret = tmp;
   }
 
+  tmp = test_fields();
+  if (tmp) {
+    printf("test_fields: failed!\n");
+    ret = tmp;
+  }
+
+  tmp = test_fields_32();
+  if (tmp) {
+    printf("test_fields_32: failed!\n");
+    ret = tmp;
+  }
+
   return ret;
 }
@@ -48,6 +48,36 @@ static int lowmc_enc(const lowmc_parameters_t* lowmc, const uint8_t* key, const
     ret = 2;
   }
 
+  const lowmc_batch_implementation_f enc_batch = lowmc_batch_get_implementation(lowmc);
+  if (enc_batch) {
+    // the other lanes encrypt the expected ciphertext
+    enc(sk, ct, ctr);
+
+    mzd_local_t* ctb[LOWMC_BATCH_SIZE];
+    mzd_local_t const* sks[LOWMC_BATCH_SIZE];
+    mzd_local_t const* pts[LOWMC_BATCH_SIZE];
+    for (unsigned int i = 0; i < LOWMC_BATCH_SIZE; ++i) {
+      ctb[i] = mzd_local_init(1, lowmc->n);
+      sks[i] = sk;
+    }
+
+    for (unsigned int lane = 0; lane < LOWMC_BATCH_SIZE; ++lane) {
+      for (unsigned int i = 0; i < LOWMC_BATCH_SIZE; ++i) {
+        pts[i] = i == lane ? pt : ct;
+      }
+      enc_batch(sks, pts, ctb);
+      for (unsigned int i = 0; i < LOWMC_BATCH_SIZE; ++i) {
+        if (!mzd_local_equal(ctb[i], i == lane ? ct : ctr, 1, lowmc->n)) {
+          ret = 3;
+        }
+      }
+    }
+
+    for (unsigned int i = 0; i < LOWMC_BATCH_SIZE; ++i) {
+      mzd_local_free(ctb[i]);
+    }
+  }
+
   mzd_local_free(ctr);
   mzd_local_free(ct);
   mzd_local_free(pt);
@@ -410,6 +440,60 @@ static int LowMC_test_vector_255_255_4_4(void) {
 }
 #endif
 
+typedef struct {
+  const lowmc_parameters_t* lowmc;
+  /* sizes of the constant tables and of the tables used by the GFNI backend in bytes */
+  size_t size;
+  size_t gfni_size;
+} table_size_t;
+
+static const table_size_t table_sizes[] = {
+#if defined(WITH_LOWMC_128_128_20)
+    {&parameters_128_128_20, 34752, 35968},
+#endif
+#if defined(WITH_LOWMC_192_192_30)
+    {&parameters_192_192_30, 92704, 78496},
+#endif
+#if defined(WITH_LOWMC_256_256_38)
+    {&parameters_256_256_38, 128576, 133312},
+#endif
+#if defined(WITH_LOWMC_129_129_4)
+    {&parameters_129_129_4, 86144, 45824},
+#endif
+#if defined(WITH_LOWMC_192_192_4)
+    {&parameters_192_192_4, 86144, 64640},
+#endif
+#if defined(WITH_LOWMC_255_255_4)
+    {&parameters_255_255_4, 114816, 114816},
+#endif
+};
+
+static int LowMC_prefault_size(void) {
+  /* all backends but GFNI share the same tables */
+  const lowmc_backend_t backends[] = {LOWMC_BACKEND_UINT64, LOWMC_BACKEND_S128,
+                                      LOWMC_BACKEND_S256};
+
+  int ret = 0;
+  for (size_t i = 0; i < sizeof(table_sizes) / sizeof(table_sizes[0]); ++i) {
+    const table_size_t* entry = &table_sizes[i];
+
+    for (size_t b = 0; b < sizeof(backends) / sizeof(backends[0]); ++b) {
+      if (lowmc_set_backend(backends[b]) && lowmc_prefault(entry->lowmc, true) != entry->size) {
+        ret = 1;
+      }
+    }
+#if defined(WITH_GFNI)
+    if (lowmc_set_backend(LOWMC_BACKEND_GFNI) &&
+        lowmc_prefault(entry->lowmc, true) != entry->gfni_size) {
+      ret = 2;
+    }
+#endif
+  }
+
+  lowmc_set_backend(LOWMC_BACKEND_AUTO);
+  return ret;
+}
+
 typedef int (*test_fn_t)(void);
 
 static const test_fn_t tests[] = {
@@ -437,6 +521,7 @@ static const test_fn_t tests[] = {
     LowMC_test_vector_255_255_4_1, LowMC_test_vector_255_255_4_2,
     LowMC_test_vector_255_255_4_3, LowMC_test_vector_255_255_4_4,
 #endif
+    LowMC_prefault_size,
 };
 
 static const size_t num_tests = sizeof(tests) / sizeof(tests[0]);
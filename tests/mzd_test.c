@@ -226,6 +226,86 @@ static int test_mzd_addmul_s128_256(void) {
 }
 #endif
 
+#if defined(WITH_OPT) &&                                                                          \
+    (defined(WITH_LOWMC_128_128_20) || defined(WITH_LOWMC_192_192_30) ||                           \
+     defined(WITH_LOWMC_256_256_38))
+/* compare the parity based multiplication with 30 rows against the uint64 implementation */
+static int test_mzd_mul_parity_f(const char* n, unsigned int cols, mul_fn f, mul_fn ref) {
+  int ret = 0;
+
+  mzd_t* A = mzd_init(30, cols);
+  mzd_t* v = mzd_init(1, cols);
+
+  for (unsigned int k = 0; k < 3; ++k) {
+    mzd_randomize(A);
+    mzd_randomize(v);
+
+    mzd_local_t* Al = mzd_convert(A);
+    mzd_local_t* vl = mzd_convert(v);
+    mzd_local_t* c1 = mzd_local_init(1, cols);
+    mzd_local_t* c2 = mzd_local_init(1, cols);
+
+    ref(c1, vl, Al);
+    f(c2, vl, Al);
+
+    if (!mzd_local_equal(c1, c2, 1, cols)) {
+      printf("%s: fail [30 x %u]\n", n, cols);
+      ret = -1;
+    } else {
+      printf("%s: ok [30 x %u]\n", n, cols);
+    }
+
+    mzd_local_free(c2);
+    mzd_local_free(c1);
+    mzd_local_free(vl);
+    mzd_local_free(Al);
+  }
+
+  mzd_free(v);
+  mzd_free(A);
+
+  return ret;
+}
+
+#if defined(WITH_SSE2) || defined(WITH_NEON)
+static int test_mzd_mul_parity_s128(void) {
+  int ret = 0;
+#if defined(WITH_LOWMC_128_128_20)
+  ret |= test_mzd_mul_parity_f("mul parity s128 128", 128, mzd_mul_v_parity_s128_128_30,
+                               mzd_mul_v_parity_uint64_128_30);
+#endif
+#if defined(WITH_LOWMC_192_192_30)
+  ret |= test_mzd_mul_parity_f("mul parity s128 192", 192, mzd_mul_v_parity_s128_192_30,
+                               mzd_mul_v_parity_uint64_192_30);
+#endif
+#if defined(WITH_LOWMC_256_256_38)
+  ret |= test_mzd_mul_parity_f("mul parity s128 256", 256, mzd_mul_v_parity_s128_256_30,
+                               mzd_mul_v_parity_uint64_256_30);
+#endif
+  return ret;
+}
+#endif
+
+#if defined(WITH_AVX2)
+static int test_mzd_mul_parity_s256(void) {
+  int ret = 0;
+#if defined(WITH_LOWMC_128_128_20)
+  ret |= test_mzd_mul_parity_f("mul parity s256 128", 128, mzd_mul_v_parity_s256_128_30,
+                               mzd_mul_v_parity_uint64_128_30);
+#endif
+#if defined(WITH_LOWMC_192_192_30)
+  ret |= test_mzd_mul_parity_f("mul parity s256 192", 192, mzd_mul_v_parity_s256_192_30,
+                               mzd_mul_v_parity_uint64_192_30);
+#endif
+#if defined(WITH_LOWMC_256_256_38)
+  ret |= test_mzd_mul_parity_f("mul parity s256 256", 256, mzd_mul_v_parity_s256_256_30,
+                               mzd_mul_v_parity_uint64_256_30);
+#endif
+  return ret;
+}
+#endif
+#endif
+
 int main(void) {
   int ret = 0;
 
@@ -253,6 +333,10 @@ int main(void) {
     ret |= test_mzd_addmul_s256_128();
     ret |= test_mzd_addmul_s256_192();
     ret |= test_mzd_addmul_s256_256();
+#if defined(WITH_LOWMC_128_128_20) || defined(WITH_LOWMC_192_192_30) ||                            \
+    defined(WITH_LOWMC_256_256_38)
+    ret |= test_mzd_mul_parity_s256();
+#endif
   }
 #endif
 #if defined(WITH_SSE2) || defined(WITH_NEON)
@@ -273,6 +357,10 @@ int main(void) {
     ret |= test_mzd_addmul_s128_128();
     ret |= test_mzd_addmul_s128_192();
     ret |= test_mzd_addmul_s128_256();
+#if defined(WITH_LOWMC_128_128_20) || defined(WITH_LOWMC_192_192_30) ||                            \
+    defined(WITH_LOWMC_256_256_38)
+    ret |= test_mzd_mul_parity_s128();
+#endif
   }
 #endif
   return ret;
@@ -12,10 +12,648 @@
 #endif
 
 #include <stdlib.h>
+#include <string.h>
+#if defined(HAVE_PTHREAD)
+#include <poll.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
 
 #include "picnic.h"
 #include "utils.h"
 
+/* Signatures produced with one backend have to verify with all other backends; if signing is
+ * deterministic, all backends have to produce the signature of the default backend */
+static int picnic_cross_backend(const picnic_params_t param) {
+  static const uint8_t m[] = "test message";
+
+  const size_t max_signature_size = picnic_signature_size(param);
+
+  picnic_privatekey_t private_key;
+  picnic_publickey_t public_key;
+  if (picnic_keygen(param, &public_key, &private_key)) {
+    return -1;
+  }
+
+  uint8_t* sig           = malloc(max_signature_size);
+  uint8_t* reference_sig = malloc(max_signature_size);
+  size_t reference_len   = max_signature_size;
+  int ret                = 0;
+
+  /* signing is randomized if the library was built with extra randomness */
+  picnic_set_backend(PICNIC_BACKEND_AUTO);
+  size_t second_len = max_signature_size;
+  if (picnic_sign(&private_key, m, sizeof(m), reference_sig, &reference_len) ||
+      picnic_sign(&private_key, m, sizeof(m), sig, &second_len)) {
+    printf("signing with the default backend FAILED ");
+    ret = -1;
+  }
+  const bool deterministic =
+      !ret && second_len == reference_len && !memcmp(sig, reference_sig, second_len);
+
+  for (unsigned int signer = PICNIC_BACKEND_UINT64; signer <= PICNIC_BACKEND_GFNI && !ret;
+       ++signer) {
+    if (picnic_set_backend(signer)) {
+      /* not available */
+      continue;
+    }
+
+    size_t siglen = max_signature_size;
+    if (picnic_sign(&private_key, m, sizeof(m), sig, &siglen)) {
+      printf("signing with %s FAILED ", picnic_get_backend_name(signer));
+      ret = -1;
+      break;
+    }
+    if (deterministic && (siglen != reference_len || memcmp(sig, reference_sig, siglen))) {
+      printf("signature of %s differs from the default backend FAILED ",
+             picnic_get_backend_name(signer));
+      ret = -1;
+      break;
+    }
+
+    for (unsigned int verifier = PICNIC_BACKEND_UINT64; verifier <= PICNIC_BACKEND_GFNI;
+         ++verifier) {
+      if (picnic_set_backend(verifier)) {
+        continue;
+      }
+      if (picnic_verify(&public_key, m, sizeof(m), sig, siglen)) {
+        printf("%s -> %s FAILED ", picnic_get_backend_name(signer),
+               picnic_get_backend_name(verifier));
+        ret = -1;
+      }
+    }
+  }
+
+  picnic_set_backend(PICNIC_BACKEND_AUTO);
+  free(reference_sig);
+  free(sig);
+  return ret;
+}
+
+typedef struct {
+  size_t allocations;
+  size_t live;
+} allocator_stats_t;
+
+static void* counting_alloc(void* opaque, size_t alignment, size_t size) {
+  allocator_stats_t* stats = opaque;
+  void* ptr                = aligned_alloc(alignment, (size + alignment - 1) & ~(alignment - 1));
+  if (ptr) {
+    ++stats->allocations;
+    ++stats->live;
+  }
+  return ptr;
+}
+
+static void counting_free(void* opaque, void* ptr) {
+  allocator_stats_t* stats = opaque;
+  --stats->live;
+  free(ptr);
+}
+
+static int sign_and_verify(const picnic_privatekey_t* private_key,
+                           const picnic_publickey_t* public_key, uint8_t* sig, size_t siglen) {
+  static const uint8_t m[] = "test message";
+
+  if (picnic_sign(private_key, m, sizeof(m), sig, &siglen)) {
+    return -1;
+  }
+  return picnic_verify(public_key, m, sizeof(m), sig, siglen);
+}
+
+static int picnic_custom_allocator(const picnic_params_t param) {
+  const size_t max_signature_size = picnic_signature_size(param);
+
+  picnic_privatekey_t private_key;
+  picnic_publickey_t public_key;
+  if (picnic_keygen(param, &public_key, &private_key)) {
+    return -1;
+  }
+
+  /* large enough for all parameter sets */
+  const size_t arena_size = 8 * 1024 * 1024;
+  uint8_t* arena          = malloc(arena_size);
+  uint8_t* sig            = malloc(max_signature_size);
+  int ret                 = 0;
+
+  allocator_stats_t stats            = {0, 0};
+  const picnic_allocator_t allocator = {counting_alloc, counting_free, &stats};
+  if (picnic_set_allocator(&allocator)) {
+    ret = -1;
+    goto out;
+  }
+
+  /* all allocations go through the allocator */
+  if (sign_and_verify(&private_key, &public_key, sig, max_signature_size) || !stats.allocations ||
+      stats.live) {
+    printf("allocator FAILED ");
+    ret = -1;
+    goto out;
+  }
+
+  /* a small arena serves some of the allocations */
+  if (picnic_set_thread_arena(arena, 4096) ||
+      sign_and_verify(&private_key, &public_key, sig, max_signature_size) || stats.live) {
+    printf("small arena FAILED ");
+    ret = -1;
+    goto out;
+  }
+
+  /* a large arena serves all of the allocations and is reset after each operation */
+  const size_t allocations = stats.allocations;
+  if (picnic_set_thread_arena(arena, arena_size) ||
+      sign_and_verify(&private_key, &public_key, sig, max_signature_size) ||
+      sign_and_verify(&private_key, &public_key, sig, max_signature_size) ||
+      stats.allocations != allocations) {
+    printf("large arena FAILED ");
+    ret = -1;
+    goto out;
+  }
+
+  /* memory is released through the allocator that provided it, even after switching */
+  static const uint8_t m[] = "test message";
+  picnic_sign_ctx_t* ctx   = picnic_sign_begin(&private_key, m, sizeof(m));
+  if (!ctx || picnic_sign_step(ctx) < 0 || picnic_set_allocator(NULL)) {
+    picnic_sign_cancel(ctx);
+    printf("switch FAILED ");
+    ret = -1;
+    goto out;
+  }
+  picnic_sign_cancel(ctx);
+  if (stats.live || picnic_set_thread_arena(NULL, 0)) {
+    printf("switch FAILED ");
+    ret = -1;
+  }
+
+out:
+  picnic_set_thread_arena(NULL, 0);
+  picnic_set_allocator(NULL);
+  free(sig);
+  free(arena);
+  return ret;
+}
+
+/* counters of a signature are identical for each signature of the same key */
+static int picnic_stats(const picnic_params_t param) {
+  static const uint8_t m[] = "test message";
+
+  const size_t max_signature_size = picnic_signature_size(param);
+
+  picnic_privatekey_t private_key;
+  picnic_publickey_t public_key;
+  if (picnic_keygen(param, &public_key, &private_key)) {
+    return -1;
+  }
+
+  uint8_t* sig  = malloc(max_signature_size);
+  size_t siglen = max_signature_size;
+  int ret       = -1;
+  picnic_stats_t once, twice;
+
+  picnic_stats_reset();
+  if (picnic_sign(&private_key, m, sizeof(m), sig, &siglen)) {
+    goto out;
+  }
+  if (picnic_stats_get(&once)) {
+    /* built without WITH_STATS */
+    for (unsigned int p = 0; p < PICNIC_STATS_MAX; ++p) {
+      if (once.phases[p].calls || once.phases[p].ticks) {
+        goto out;
+      }
+    }
+    ret = 0;
+    goto out;
+  }
+
+  siglen = max_signature_size;
+  if (picnic_sign(&private_key, m, sizeof(m), sig, &siglen) || picnic_stats_get(&twice)) {
+    goto out;
+  }
+  /* every signature derives seeds, simulates the MPC protocol, computes the challenge and is
+   * serialized */
+  if (!once.phases[PICNIC_STATS_SEEDS].calls || !once.phases[PICNIC_STATS_MPC].calls ||
+      !once.phases[PICNIC_STATS_CHALLENGE].calls ||
+      !once.phases[PICNIC_STATS_SERIALIZATION].calls) {
+    goto out;
+  }
+  for (unsigned int p = 0; p < PICNIC_STATS_MAX; ++p) {
+    if ((!once.phases[p].calls && once.phases[p].ticks) ||
+        twice.phases[p].calls != 2 * once.phases[p].calls ||
+        twice.phases[p].ticks < once.phases[p].ticks) {
+      goto out;
+    }
+  }
+
+  picnic_stats_reset();
+  if (picnic_stats_get(&once)) {
+    goto out;
+  }
+  for (unsigned int p = 0; p < PICNIC_STATS_MAX; ++p) {
+    if (once.phases[p].calls || once.phases[p].ticks) {
+      goto out;
+    }
+  }
+  ret = 0;
+
+out:
+  free(sig);
+  return ret;
+}
+
+static void* failing_alloc(void* opaque, size_t alignment, size_t size) {
+  (void)opaque;
+  (void)alignment;
+  (void)size;
+  return NULL;
+}
+
+static int picnic_verify_cache(const picnic_params_t param) {
+  static const uint8_t m[] = "test message";
+
+  const size_t max_signature_size = picnic_signature_size(param);
+
+  picnic_privatekey_t private_key;
+  picnic_publickey_t public_key;
+  if (picnic_keygen(param, &public_key, &private_key)) {
+    return -1;
+  }
+
+  uint8_t* sig  = malloc(max_signature_size);
+  size_t siglen = max_signature_size;
+  int ret       = -1;
+  picnic_verify_cache_stats_t stats;
+
+  /* the number of buckets would not fit into 32 bits */
+  if (!picnic_verify_cache_enable(UINT32_MAX - 1, PICNIC_CACHE_LRU) ||
+      !picnic_verify_cache_enable(SIZE_MAX, PICNIC_CACHE_LRU)) {
+    goto out;
+  }
+
+  if (picnic_sign(&private_key, m, sizeof(m), sig, &siglen) ||
+      picnic_verify_cache_enable(2, PICNIC_CACHE_LRU)) {
+    goto out;
+  }
+
+  /* failures to allocate memory are not cached */
+  const picnic_allocator_t allocator = {failing_alloc, counting_free, NULL};
+  if (picnic_set_allocator(&allocator)) {
+    goto out;
+  }
+  const int oom_result = picnic_verify_cached(&public_key, m, sizeof(m), sig, siglen);
+  picnic_set_allocator(NULL);
+  picnic_verify_cache_get_stats(&stats);
+  if (!oom_result || stats.entries) {
+    goto out;
+  }
+  if (picnic_verify_cache_enable(2, PICNIC_CACHE_LRU)) {
+    goto out;
+  }
+
+  /* miss, then hit */
+  if (picnic_verify_cached(&public_key, m, sizeof(m), sig, siglen) ||
+      picnic_verify_cached(&public_key, m, sizeof(m), sig, siglen)) {
+    goto out;
+  }
+  /* failures are cached as well */
+  if (!picnic_verify_cached(&public_key, m, sizeof(m) - 1, sig, siglen) ||
+      !picnic_verify_cached(&public_key, m, sizeof(m) - 1, sig, siglen)) {
+    goto out;
+  }
+  picnic_verify_cache_get_stats(&stats);
+  if (stats.hits != 2 || stats.misses != 2 || stats.entries != 2 || stats.evictions) {
+    goto out;
+  }
+
+  /* the valid signature was used least recently and is evicted */
+  if (!picnic_verify_cached(&public_key, m, 1, sig, siglen) ||
+      picnic_verify_cached(&public_key, m, sizeof(m), sig, siglen)) {
+    goto out;
+  }
+  picnic_verify_cache_get_stats(&stats);
+  if (stats.hits != 2 || stats.misses != 4 || stats.entries != 2 || stats.evictions != 2) {
+    goto out;
+  }
+  ret = 0;
+
+out:
+  picnic_verify_cache_disable();
+  free(sig);
+  return ret;
+}
+
+#if defined(HAVE_PTHREAD)
+/* fails the allocations of all threads but the main thread while fail is set */
+typedef struct {
+  pthread_t main_thread;
+  atomic_bool fail;
+} flaky_allocator_t;
+
+static void* flaky_alloc(void* opaque, size_t alignment, size_t size) {
+  flaky_allocator_t* flaky = opaque;
+  if (atomic_load(&flaky->fail) && !pthread_equal(pthread_self(), flaky->main_thread)) {
+    return NULL;
+  }
+  return aligned_alloc(alignment, (size + alignment - 1) & ~(alignment - 1));
+}
+
+static void flaky_free(void* opaque, void* ptr) {
+  (void)opaque;
+  free(ptr);
+}
+
+/* the pool keeps retrying after its precomputations failed */
+static int picnic_presign_retry(const picnic_privatekey_t* private_key) {
+  flaky_allocator_t flaky;
+  flaky.main_thread = pthread_self();
+  atomic_init(&flaky.fail, true);
+  const picnic_allocator_t allocator = {flaky_alloc, flaky_free, &flaky};
+
+  int ret = -1;
+  picnic_presign_stats_t stats;
+  if (picnic_set_allocator(&allocator) || picnic_presign_enable(private_key, 1)) {
+    goto out;
+  }
+  for (unsigned int i = 0; i < 6000; ++i) {
+    if (picnic_presign_get_stats(private_key, &stats) || stats.failures >= 2) {
+      break;
+    }
+    usleep(10000);
+  }
+  if (stats.failures < 2 || stats.available) {
+    goto out;
+  }
+
+  atomic_store(&flaky.fail, false);
+  for (unsigned int i = 0; i < 6000; ++i) {
+    if (picnic_presign_get_stats(private_key, &stats) || stats.available == 1) {
+      break;
+    }
+    usleep(10000);
+  }
+  if (stats.available == 1) {
+    ret = 0;
+  }
+
+out:
+  picnic_presign_disable(private_key);
+  picnic_set_allocator(NULL);
+  return ret;
+}
+
+static int picnic_presign(const picnic_params_t param) {
+  static const uint8_t m[] = "test message";
+
+  const size_t max_signature_size = picnic_signature_size(param);
+
+  picnic_privatekey_t private_key;
+  picnic_publickey_t public_key;
+  if (picnic_keygen(param, &public_key, &private_key)) {
+    return -1;
+  }
+
+  uint8_t* sig[3] = {malloc(max_signature_size), malloc(max_signature_size),
+                     malloc(max_signature_size)};
+  size_t siglen[3];
+  int ret = -1;
+  picnic_presign_stats_t stats;
+
+  if (picnic_presign_enable(&private_key, 2)) {
+    goto out;
+  }
+  /* wait for the pool to be filled */
+  for (unsigned int i = 0; i < 6000; ++i) {
+    if (picnic_presign_get_stats(&private_key, &stats) || stats.available == 2) {
+      break;
+    }
+    usleep(10000);
+  }
+  if (stats.available != 2 || stats.capacity != 2) {
+    goto out;
+  }
+
+  /* a forked child never uses the transcripts of its parent */
+  const pid_t pid = fork();
+  if (!pid) {
+    siglen[0] = max_signature_size;
+    const int child_ret =
+        picnic_sign(&private_key, m, sizeof(m), sig[0], &siglen[0]) ||
+        picnic_presign_get_stats(&private_key, &stats) || stats.hits || stats.misses != 1;
+    picnic_presign_disable(&private_key);
+    _exit(child_ret);
+  }
+  int status;
+  if (pid < 0 || waitpid(pid, &status, 0) != pid || !WIFEXITED(status) || WEXITSTATUS(status)) {
+    goto out;
+  }
+
+  /* two presigned signatures and possibly a third one signed as usual */
+  for (unsigned int i = 0; i < 3; ++i) {
+    siglen[i] = max_signature_size;
+    if (picnic_sign(&private_key, m, sizeof(m), sig[i], &siglen[i]) ||
+        picnic_verify(&public_key, m, sizeof(m), sig[i], siglen[i])) {
+      goto out;
+    }
+  }
+  if (picnic_presign_get_stats(&private_key, &stats) || stats.hits < 2 ||
+      stats.hits + stats.misses != 3) {
+    goto out;
+  }
+  /* the seeds of presigned signatures are random */
+  if (siglen[0] == siglen[1] && !memcmp(sig[0], sig[1], siglen[0])) {
+    goto out;
+  }
+  if (stats.failures) {
+    goto out;
+  }
+  picnic_presign_disable(&private_key);
+  if (picnic_presign_retry(&private_key)) {
+    goto out;
+  }
+  ret = 0;
+
+out:
+  picnic_presign_disable(&private_key);
+  if (!ret && !picnic_presign_get_stats(&private_key, &stats)) {
+    ret = -1;
+  }
+  for (unsigned int i = 0; i < 3; ++i) {
+    free(sig[i]);
+  }
+  return ret;
+}
+
+static void count_job(picnic_job_t* job) {
+  ++*(unsigned int*)job->opaque;
+}
+
+typedef struct {
+  picnic_executor_t* executor;
+  int result;
+} resubmit_t;
+
+static void resubmit_job(picnic_job_t* job) {
+  resubmit_t* resubmit = job->opaque;
+  resubmit->result     = picnic_submit_verify(resubmit->executor, job, count_job);
+}
+
+/* dispatch completed jobs until count reaches expected */
+static int wait_for_jobs(picnic_executor_t* executor, unsigned int* count, unsigned int expected) {
+  struct pollfd pfd = {picnic_executor_fd(executor), POLLIN, 0};
+  while (*count < expected) {
+    if (poll(&pfd, 1, 60000) <= 0) {
+      return -1;
+    }
+    picnic_executor_dispatch(executor);
+  }
+  return 0;
+}
+
+static int picnic_executor(const picnic_params_t param) {
+  static const uint8_t m[] = "test message";
+
+  const size_t max_signature_size = picnic_signature_size(param);
+
+  picnic_privatekey_t private_key;
+  picnic_publickey_t public_key;
+  if (picnic_keygen(param, &public_key, &private_key)) {
+    return -1;
+  }
+
+  picnic_executor_t* executor = picnic_executor_create(2);
+  if (!executor) {
+    return -1;
+  }
+
+  picnic_job_t jobs[4];
+  unsigned int completed = 0;
+  int ret                = -1;
+  memset(jobs, 0, sizeof(jobs));
+  for (unsigned int i = 0; i < 4; ++i) {
+    jobs[i].sk            = &private_key;
+    jobs[i].message       = m;
+    jobs[i].message_len   = sizeof(m);
+    jobs[i].signature     = malloc(max_signature_size);
+    jobs[i].signature_len = max_signature_size;
+    jobs[i].opaque        = &completed;
+    if (picnic_submit_sign(executor, &jobs[i], count_job)) {
+      goto out;
+    }
+  }
+  if (wait_for_jobs(executor, &completed, 4)) {
+    goto out;
+  }
+
+  /* the verifications are queued together; the last signature is modified */
+  completed = 0;
+  for (unsigned int i = 0; i < 4; ++i) {
+    if (jobs[i].result) {
+      goto out;
+    }
+    jobs[i].pk = &public_key;
+  }
+  jobs[3].signature[jobs[3].signature_len / 2] ^= 0x01;
+  for (unsigned int i = 0; i < 4; ++i) {
+    if (picnic_submit_verify(executor, &jobs[i], count_job)) {
+      goto out;
+    }
+  }
+  if (wait_for_jobs(executor, &completed, 4) || jobs[0].result || jobs[1].result ||
+      jobs[2].result || !jobs[3].result) {
+    goto out;
+  }
+
+  /* callbacks invoked while the executor is destroyed cannot submit jobs */
+  resubmit_t resubmit = {executor, 0};
+  jobs[0].opaque      = &resubmit;
+  if (picnic_submit_verify(executor, &jobs[0], resubmit_job)) {
+    goto out;
+  }
+  picnic_executor_destroy(executor);
+  executor = NULL;
+  if (!resubmit.result) {
+    goto out;
+  }
+  ret = 0;
+
+out:
+  /* completes outstanding jobs before their buffers are released */
+  picnic_executor_destroy(executor);
+  for (unsigned int i = 0; i < 4; ++i) {
+    free(jobs[i].signature);
+  }
+  return ret;
+}
+#endif
+
+static int picnic_step(const picnic_params_t param) {
+  static const uint8_t m[] = "test message";
+
+  const size_t max_signature_size = picnic_signature_size(param);
+
+  picnic_privatekey_t private_key;
+  picnic_publickey_t public_key;
+  if (picnic_keygen(param, &public_key, &private_key)) {
+    return -1;
+  }
+
+  uint8_t* sig[2] = {malloc(max_signature_size), malloc(max_signature_size)};
+  size_t siglen[2] = {max_signature_size, max_signature_size};
+  int ret          = -1;
+
+  /* without presigning pool, signing is deterministic */
+  picnic_sign_ctx_t* sign_ctx = picnic_sign_begin(&private_key, m, sizeof(m));
+  if (!sign_ctx) {
+    goto out;
+  }
+  unsigned int steps = 0;
+  while (picnic_sign_step(sign_ctx) > 0) {
+    ++steps;
+  }
+  if (!steps || picnic_sign_step(sign_ctx) != 0 ||
+      picnic_sign_finish(sign_ctx, sig[0], &siglen[0]) ||
+      picnic_sign(&private_key, m, sizeof(m), sig[1], &siglen[1]) || siglen[0] != siglen[1] ||
+      memcmp(sig[0], sig[1], siglen[0])) {
+    goto out;
+  }
+
+  /* finish performs all remaining steps */
+  picnic_verify_ctx_t* verify_ctx =
+      picnic_verify_begin(&public_key, m, sizeof(m), sig[0], siglen[0]);
+  if (!verify_ctx || picnic_verify_step(verify_ctx) <= 0 || picnic_verify_finish(verify_ctx)) {
+    goto out;
+  }
+
+  /* cancel signing and verification halfway */
+  sign_ctx   = picnic_sign_begin(&private_key, m, sizeof(m));
+  verify_ctx = picnic_verify_begin(&public_key, m, sizeof(m), sig[0], siglen[0]);
+  if (!sign_ctx || !verify_ctx) {
+    picnic_sign_cancel(sign_ctx);
+    picnic_verify_cancel(verify_ctx);
+    goto out;
+  }
+  for (unsigned int i = 0; i < steps / 2; ++i) {
+    picnic_sign_step(sign_ctx);
+    picnic_verify_step(verify_ctx);
+  }
+  picnic_sign_cancel(sign_ctx);
+  picnic_verify_cancel(verify_ctx);
+
+  /* a modified signature has to be rejected */
+  sig[0][siglen[0] - 1] ^= 0x01;
+  verify_ctx = picnic_verify_begin(&public_key, m, sizeof(m), sig[0], siglen[0]);
+  if (verify_ctx && !picnic_verify_finish(verify_ctx)) {
+    goto out;
+  }
+  ret = 0;
+
+out:
+  free(sig[1]);
+  free(sig[0]);
+  return ret;
+}
+
 static int picnic_sign_verify(const picnic_params_t param) {
   static const uint8_t m[] = "test message";
 
@@ -25,6 +663,16 @@ static int picnic_sign_verify(const picnic_params_t param) {
     return -2;
   }
 
+  /* Eager initialization */
+  printf("Initializing parameter set ... ");
+  if (picnic_init(PICNIC_PARAMS_MASK(param),
+                  PICNIC_INIT_ADVISE | PICNIC_INIT_PREFAULT | PICNIC_INIT_WARMUP) ||
+      !picnic_init(PICNIC_PARAMS_MASK(param), 0x80)) {
+    printf("FAILED!\n");
+    return -1;
+  }
+  printf("OK\n");
+
   picnic_privatekey_t private_key;
   picnic_publickey_t public_key;
 
@@ -44,6 +692,36 @@ static int picnic_sign_verify(const picnic_params_t param) {
   }
   printf("OK\n");
 
+  /* Public key from the private key */
+  printf("Deriving public key ... ");
+  picnic_publickey_t derived_key;
+  uint8_t pk_buf[PICNIC_MAX_PUBLICKEY_SIZE], derived_buf[PICNIC_MAX_PUBLICKEY_SIZE];
+  const int pk_len = picnic_write_public_key(&public_key, pk_buf, sizeof(pk_buf));
+  if (picnic_sk_to_pk(&private_key, &derived_key) ||
+      picnic_write_public_key(&derived_key, derived_buf, sizeof(derived_buf)) != pk_len ||
+      pk_len <= 0 || memcmp(pk_buf, derived_buf, pk_len)) {
+    printf("FAILED!\n");
+    return -1;
+  }
+  printf("OK\n");
+
+  /* Batch key generation with a remainder not filling a batch */
+  printf("Creating and validating key pairs in batch ... ");
+  picnic_privatekey_t private_keys[6];
+  picnic_publickey_t public_keys[6];
+  if (picnic_keygen_batch(param, public_keys, private_keys, 6) ||
+      picnic_validate_keypairs(private_keys, public_keys, 6)) {
+    printf("FAILED!\n");
+    return -1;
+  }
+  /* A modified public key has to be rejected */
+  public_keys[2].data[1] ^= 0x80;
+  if (!picnic_validate_keypairs(private_keys, public_keys, 6)) {
+    printf("FAILED!\n");
+    return -1;
+  }
+  printf("OK\n");
+
   uint8_t* sig  = malloc(max_signature_size);
   size_t siglen = max_signature_size;
   int ret       = 0;
@@ -64,6 +742,78 @@ static int picnic_sign_verify(const picnic_params_t param) {
     printf("FAILED!\n");
   }
 
+  if (!ret) {
+    printf("Collecting statistics ... ");
+    if (picnic_stats(param)) {
+      ret = -1;
+      printf("FAILED!\n");
+    } else {
+      printf("OK\n");
+    }
+  }
+
+  if (!ret) {
+    printf("Signing with custom allocators ... ");
+    if (picnic_custom_allocator(param)) {
+      ret = -1;
+      printf("FAILED!\n");
+    } else {
+      printf("OK\n");
+    }
+  }
+
+  if (!ret) {
+    printf("Verifying signatures with cache ... ");
+    if (picnic_verify_cache(param)) {
+      ret = -1;
+      printf("FAILED!\n");
+    } else {
+      printf("OK\n");
+    }
+  }
+
+#if defined(HAVE_PTHREAD)
+  if (!ret) {
+    printf("Signing with precomputed transcripts ... ");
+    if (picnic_presign(param)) {
+      ret = -1;
+      printf("FAILED!\n");
+    } else {
+      printf("OK\n");
+    }
+  }
+
+  if (!ret) {
+    printf("Signing and verifying with an executor ... ");
+    if (picnic_executor(param)) {
+      ret = -1;
+      printf("FAILED!\n");
+    } else {
+      printf("OK\n");
+    }
+  }
+#endif
+
+  if (!ret) {
+    printf("Signing and verifying in steps ... ");
+    if (picnic_step(param)) {
+      ret = -1;
+      printf("FAILED!\n");
+    } else {
+      printf("OK\n");
+    }
+  }
+
+  if (!ret) {
+    printf("Verifying signatures across backends ... ");
+    if (picnic_cross_backend(param)) {
+      ret = -1;
+      printf("FAILED!\n");
+    } else {
+      printf("OK\n");
+    }
+  }
+
   free(sig);
   return ret;
 }
@@ -0,0 +1,140 @@
+/*
+ *  This file is part of the optimized implementation of the Picnic signature scheme.
+ *  See the accompanying documentation for complete details.
+ *
+ *  The code is provided under the MIT license, see LICENSE for
+ *  more details.
+ *  SPDX-License-Identifier: MIT
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "../randomness.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#if !defined(_WIN32)
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+static int distinct_test(void) {
+  /* sizes below, at and above the internal buffer size of the DRBG */
+  static const size_t sizes[] = {1, 16, 32, 511, 512, 513, 4096};
+
+  int ret = 0;
+  for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i) {
+    uint8_t first[4096]  = {0};
+    uint8_t second[4096] = {0};
+
+    if (rand_bytes(first, sizes[i]) || rand_bytes(second, sizes[i])) {
+      printf("distinct_test: rand_bytes failed for %zu bytes\n", sizes[i]);
+      ret = -1;
+      continue;
+    }
+    /* single bytes collide with probability 1/256 */
+    if (sizes[i] >= 16 && !memcmp(first, second, sizes[i])) {
+      printf("distinct_test: repeated output for %zu bytes\n", sizes[i]);
+      ret = -1;
+    }
+  }
+
+  return ret;
+}
+
+static int bits_test(void) {
+  int ret = 0;
+  for (unsigned int i = 0; i < 64; ++i) {
+    uint8_t buffer[2] = {0xff, 0xff};
+    if (rand_bits(buffer, 13)) {
+      printf("bits_test: rand_bits failed\n");
+      return -1;
+    }
+    if (buffer[1] & 0x07) {
+      printf("bits_test: trailing bits not cleared\n");
+      ret = -1;
+    }
+  }
+
+  return ret;
+}
+
+#if !defined(_WIN32)
+/* parent and child must not produce the same output after fork */
+static int fork_test(void) {
+  uint8_t buffer[32];
+  /* make sure that the state is seeded and has buffered output */
+  if (rand_bytes(buffer, sizeof(buffer))) {
+    printf("fork_test: rand_bytes failed\n");
+    return -1;
+  }
+
+  int fds[2];
+  if (pipe(fds)) {
+    printf("fork_test: pipe failed\n");
+    return -1;
+  }
+
+  const pid_t pid = fork();
+  if (pid < 0) {
+    printf("fork_test: fork failed\n");
+    close(fds[0]);
+    close(fds[1]);
+    return -1;
+  }
+  if (!pid) {
+    close(fds[0]);
+    const int child_ret = rand_bytes(buffer, sizeof(buffer)) ||
+                          write(fds[1], buffer, sizeof(buffer)) != (ssize_t)sizeof(buffer);
+    close(fds[1]);
+    _exit(child_ret);
+  }
+
+  close(fds[1]);
+  uint8_t child_buffer[sizeof(buffer)];
+  const ssize_t len = read(fds[0], child_buffer, sizeof(child_buffer));
+  close(fds[0]);
+
+  int status = 0;
+  waitpid(pid, &status, 0);
+  if (len != (ssize_t)sizeof(child_buffer) || !WIFEXITED(status) || WEXITSTATUS(status)) {
+    printf("fork_test: child failed\n");
+    return -1;
+  }
+
+  if (rand_bytes(buffer, sizeof(buffer))) {
+    printf("fork_test: rand_bytes failed\n");
+    return -1;
+  }
+  if (!memcmp(buffer, child_buffer, sizeof(buffer))) {
+    printf("fork_test: parent and child produced the same output\n");
+    return -1;
+  }
+
+  return 0;
+}
+#endif
+
+int main(void) {
+  int ret = 0;
+  if (distinct_test()) {
+    printf("rand_bytes: distinct_test failed\n");
+    ret = -1;
+  }
+  if (bits_test()) {
+    printf("rand_bits: bits_test failed\n");
+    ret = -1;
+  }
+#if !defined(_WIN32)
+  if (fork_test()) {
+    printf("rand_bytes: fork_test failed\n");
+    ret = -1;
+  }
+#endif
+
+  return ret;
+}
@@ -0,0 +1,315 @@
+/*
+ *  This file is part of the optimized implementation of the Picnic signature scheme.
+ *  See the accompanying documentation for complete details.
+ *
+ *  The code is provided under the MIT license, see LICENSE for
+ *  more details.
+ *  SPDX-License-Identifier: MIT
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "picnic.h"
+#include "../tools/signd_protocol.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#define NUM_REQUESTS 7
+
+typedef struct {
+  uint8_t* data;
+  size_t len;
+} buffer_t;
+
+typedef struct {
+  uint32_t id;
+  uint8_t status;
+  unsigned int responses;
+} expected_t;
+
+static const uint8_t message[] = "test message";
+
+static bool append(buffer_t* buffer, const void* data, size_t len) {
+  uint8_t* new_data = realloc(buffer->data, buffer->len + len);
+  if (!new_data) {
+    return false;
+  }
+  buffer->data = new_data;
+  memcpy(buffer->data + buffer->len, data, len);
+  buffer->len += len;
+  return true;
+}
+
+static bool append_request(buffer_t* buffer, uint32_t id, uint8_t op, uint16_t key,
+                           const uint8_t* body, size_t body_len) {
+  uint8_t header[SIGND_REQUEST_HEADER_SIZE];
+  signd_put_u32(header, SIGND_REQUEST_HEADER_SIZE - 4 + body_len);
+  signd_put_u32(header + 4, id);
+  header[8] = op;
+  signd_put_u16(header + 9, key);
+  return append(buffer, header, sizeof(header)) && append(buffer, body, body_len);
+}
+
+/* signature_len_field is sent as length of the signature */
+static bool append_verify(buffer_t* buffer, uint32_t id, uint32_t signature_len_field,
+                          const uint8_t* signature, size_t signature_len, const uint8_t* msg,
+                          size_t msg_len) {
+  uint8_t* body = malloc(4 + signature_len + msg_len);
+  if (!body) {
+    return false;
+  }
+  signd_put_u32(body, signature_len_field);
+  memcpy(body + 4, signature, signature_len);
+  memcpy(body + 4 + signature_len, msg, msg_len);
+  const bool ok =
+      append_request(buffer, id, SIGND_OP_VERIFY, 0, body, 4 + signature_len + msg_len);
+  free(body);
+  return ok;
+}
+
+static bool write_private_key(const char* path, const picnic_privatekey_t* sk) {
+  uint8_t buf[PICNIC_MAX_PRIVATEKEY_SIZE];
+  const int len = picnic_write_private_key(sk, buf, sizeof(buf));
+  if (len <= 0) {
+    return false;
+  }
+  const int fd = open(path, O_WRONLY | O_CREAT | O_EXCL, 0600);
+  if (fd < 0) {
+    return false;
+  }
+  const bool ok = write(fd, buf, len) == len;
+  return !close(fd) && ok;
+}
+
+static pid_t start_daemon(const char* signd, const char* socket_path, const char* key_path) {
+  const pid_t pid = fork();
+  if (!pid) {
+    /* the daemon prints its keys */
+    const int null_fd = open("/dev/null", O_WRONLY);
+    if (null_fd >= 0) {
+      dup2(null_fd, STDOUT_FILENO);
+      close(null_fd);
+    }
+    execl(signd, signd, "-s", socket_path, "-t", "2", "-k", key_path, (char*)NULL);
+    _exit(127);
+  }
+  return pid;
+}
+
+/* connect once the daemon listens, for at most 30 seconds */
+static int connect_daemon(const char* socket_path) {
+  struct sockaddr_un addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strcpy(addr.sun_path, socket_path);
+
+  const struct timespec delay = {0, 10 * 1000 * 1000};
+  for (unsigned int i = 0; i < 3000; ++i) {
+    const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+      return -1;
+    }
+    if (!connect(fd, (struct sockaddr*)&addr, sizeof(addr))) {
+      return fd;
+    }
+    close(fd);
+    nanosleep(&delay, NULL);
+  }
+  return -1;
+}
+
+static bool send_all(int fd, const buffer_t* buffer) {
+  for (size_t sent = 0; sent < buffer->len;) {
+    const ssize_t ret = send(fd, buffer->data + sent, buffer->len - sent, MSG_NOSIGNAL);
+    if (ret < 0 && errno != EINTR) {
+      return false;
+    }
+    if (ret > 0) {
+      sent += ret;
+    }
+  }
+  return true;
+}
+
+static bool receive_all(int fd, buffer_t* buffer) {
+  for (;;) {
+    uint8_t chunk[4096];
+    const ssize_t ret = read(fd, chunk, sizeof(chunk));
+    if (ret < 0 && errno != EINTR) {
+      return false;
+    }
+    if (!ret) {
+      return true;
+    }
+    if (ret > 0 && !append(buffer, chunk, ret)) {
+      return false;
+    }
+  }
+}
+
+/* every request is answered exactly once with the expected status */
+static int check_responses(const buffer_t* responses, expected_t* expected,
+                           const picnic_publickey_t* pk) {
+  size_t pos = 0;
+  while (responses->len - pos >= 4) {
+    const uint32_t frame_len = signd_get_u32(responses->data + pos);
+    if (frame_len < SIGND_RESPONSE_HEADER_SIZE - 4 || responses->len - pos - 4 < frame_len) {
+      printf("signd_test: truncated response\n");
+      return -1;
+    }
+    const uint8_t* frame  = responses->data + pos + 4;
+    const uint32_t id     = signd_get_u32(frame);
+    const uint8_t status  = frame[4];
+    const uint8_t* body   = frame + SIGND_RESPONSE_HEADER_SIZE - 4;
+    const size_t body_len = frame_len - (SIGND_RESPONSE_HEADER_SIZE - 4);
+    pos += 4 + frame_len;
+
+    if (!id || id > NUM_REQUESTS) {
+      printf("signd_test: response for unknown id %u\n", id);
+      return -1;
+    }
+    expected_t* entry = &expected[id - 1];
+    ++entry->responses;
+    if (status != entry->status) {
+      printf("signd_test: request %u: status %u instead of %u\n", id, status, entry->status);
+      return -1;
+    }
+    /* only successful signing requests carry a body, which is a valid signature */
+    if (id == 1 ? picnic_verify(pk, message, sizeof(message), body, body_len) : body_len != 0) {
+      printf("signd_test: request %u: unexpected body\n", id);
+      return -1;
+    }
+  }
+  if (pos != responses->len) {
+    printf("signd_test: trailing response bytes\n");
+    return -1;
+  }
+
+  for (unsigned int i = 0; i < NUM_REQUESTS; ++i) {
+    if (expected[i].responses != 1) {
+      printf("signd_test: request %u answered %u times\n", expected[i].id, expected[i].responses);
+      return -1;
+    }
+  }
+  return 0;
+}
+
+static int run_test(const char* signd, const char* socket_path, const char* key_path) {
+  picnic_privatekey_t sk;
+  picnic_publickey_t pk;
+  picnic_params_t param = Picnic_L1_FS;
+  while (param < PARAMETER_SET_MAX_INDEX && picnic_keygen(param, &pk, &sk)) {
+    ++param;
+  }
+  uint8_t signature[PICNIC_MAX_SIGNATURE_SIZE];
+  size_t signature_len = sizeof(signature);
+  if (param == PARAMETER_SET_MAX_INDEX || !write_private_key(key_path, &sk) ||
+      picnic_sign(&sk, message, sizeof(message), signature, &signature_len)) {
+    printf("signd_test: failed to create key\n");
+    return -1;
+  }
+
+  /* pipelined requests: sign, valid and invalid verification, unknown key, malformed verification
+   * requests and an unknown operation */
+  expected_t expected[NUM_REQUESTS] = {
+      {1, SIGND_STATUS_OK, 0},          {2, SIGND_STATUS_OK, 0},
+      {3, SIGND_STATUS_FAILED, 0},      {4, SIGND_STATUS_BAD_REQUEST, 0},
+      {5, SIGND_STATUS_BAD_REQUEST, 0}, {6, SIGND_STATUS_BAD_REQUEST, 0},
+      {7, SIGND_STATUS_BAD_REQUEST, 0},
+  };
+  buffer_t requests = {NULL, 0};
+  const uint8_t short_body[2] = {0};
+  const bool built =
+      append_request(&requests, 1, SIGND_OP_SIGN, 0, message, sizeof(message)) &&
+      append_verify(&requests, 2, signature_len, signature, signature_len, message,
+                    sizeof(message)) &&
+      append_verify(&requests, 3, signature_len, signature, signature_len, message,
+                    sizeof(message) - 1) &&
+      append_request(&requests, 4, SIGND_OP_SIGN, 1, message, sizeof(message)) &&
+      append_verify(&requests, 5, signature_len + sizeof(message) + 1, signature, signature_len,
+                    message, sizeof(message)) &&
+      append_request(&requests, 6, SIGND_OP_VERIFY, 0, short_body, sizeof(short_body)) &&
+      append_request(&requests, 7, 0xff, 0, message, sizeof(message));
+  if (!built) {
+    free(requests.data);
+    return -1;
+  }
+
+  const pid_t pid = start_daemon(signd, socket_path, key_path);
+  if (pid < 0) {
+    printf("signd_test: fork failed\n");
+    free(requests.data);
+    return -1;
+  }
+
+  int ret           = -1;
+  buffer_t responses = {NULL, 0};
+  const int fd       = connect_daemon(socket_path);
+  if (fd < 0) {
+    printf("signd_test: failed to connect\n");
+  } else if (!send_all(fd, &requests) || shutdown(fd, SHUT_WR) || !receive_all(fd, &responses)) {
+    printf("signd_test: failed to exchange requests\n");
+  } else {
+    ret = check_responses(&responses, expected, &pk);
+  }
+  if (fd >= 0) {
+    close(fd);
+  }
+
+  /* the daemon removes its socket when terminated */
+  int status = 0;
+  kill(pid, SIGTERM);
+  waitpid(pid, &status, 0);
+  if (!WIFEXITED(status) || WEXITSTATUS(status)) {
+    printf("signd_test: daemon failed\n");
+    ret = -1;
+  }
+  struct stat st;
+  if (!lstat(socket_path, &st) || errno != ENOENT) {
+    printf("signd_test: socket not removed\n");
+    unlink(socket_path);
+    ret = -1;
+  }
+
+  free(responses.data);
+  free(requests.data);
+  return ret;
+}
+
+int main(int argc, char** argv) {
+  if (argc != 2) {
+    printf("usage: %s picnic-signd\n", argv[0]);
+    return -1;
+  }
+
+  char dir[] = "/tmp/picnic-signd-test-XXXXXX";
+  if (!mkdtemp(dir)) {
+    printf("signd_test: failed to create temporary directory\n");
+    return -1;
+  }
+  char socket_path[sizeof(dir) + 16];
+  char key_path[sizeof(dir) + 16];
+  snprintf(socket_path, sizeof(socket_path), "%s/sock", dir);
+  snprintf(key_path, sizeof(key_path), "%s/key", dir);
+
+  const int ret = run_test(argv[1], socket_path, key_path);
+
+  unlink(key_path);
+  rmdir(dir);
+  return ret;
+}
@@ -31,6 +31,34 @@ static void print_timings(timing_and_size_t* timings, unsigned int iter) {
   }
 }
 
+static void accumulate_stats(picnic_stats_t* total) {
+  picnic_stats_t stats;
+  if (!picnic_stats_get(&stats)) {
+    for (unsigned int p = 0; p < PICNIC_STATS_MAX; ++p) {
+      total->phases[p].ticks += stats.phases[p].ticks;
+      total->phases[p].calls += stats.phases[p].calls;
+    }
+  }
+  picnic_stats_reset();
+}
+
+static void print_stats(const picnic_stats_t* sign_stats, const picnic_stats_t* verify_stats,
+                        unsigned int iter) {
+  picnic_stats_t stats;
+  if (picnic_stats_get(&stats) || !iter) {
+    /* statistics collection not available */
+    return;
+  }
+
+  printf("phase,sign_ticks,sign_calls,verify_ticks,verify_calls\n");
+  for (unsigned int p = 0; p < PICNIC_STATS_MAX; ++p) {
+    printf("%s,%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 "\n",
+           picnic_stats_get_phase_name((picnic_stats_phase_t)p),
+           sign_stats->phases[p].ticks / iter, sign_stats->phases[p].calls / iter,
+           verify_stats->phases[p].ticks / iter, verify_stats->phases[p].calls / iter);
+  }
+}
+
 static void bench_sign_and_verify(const bench_options_t* options) {
   static const uint8_t m[] = {1,  2,  3,  4,  5,  6,  7,  8,  9,  10, 11, 12, 13, 14, 15, 16,
                               17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32};
@@ -47,8 +75,17 @@ static void bench_sign_and_verify(const bench_options_t* options) {
     return;
   }
 
+  counters_context_t counters;
+  const bool have_counters           = counters_init(&counters);
+  counter_values_t sign_counters     = {{0}};
+  counter_values_t verify_counters   = {{0}};
+  unsigned int successful_iterations = 0;
+  counter_values_t start_counters, end_counters;
+
   timing_and_size_t* timings = calloc(options->iter, sizeof(timing_and_size_t));
   uint8_t sig[PICNIC_MAX_SIGNATURE_SIZE];
+  picnic_stats_t sign_stats   = {0};
+  picnic_stats_t verify_stats = {0};
 
   for (unsigned int i = 0; i != options->iter; ++i) {
     timing_and_size_t* timing = &timings[i];
@@ -65,20 +102,31 @@ static void bench_sign_and_verify(const bench_options_t* options) {
 
     uint64_t tmp_time = timing_read(&ctx);
     timing->keygen    = tmp_time - start_time;
-    start_time        = timing_read(&ctx);
+
+    picnic_stats_reset();
+    counters_read(&counters, &start_counters);
+    start_time = timing_read(&ctx);
 
     size_t siglen = max_signature_size;
     if (!picnic_sign(&private_key, m, sizeof(m), sig, &siglen)) {
       tmp_time     = timing_read(&ctx);
       timing->sign = tmp_time - start_time;
       timing->size = siglen;
-      start_time   = timing_read(&ctx);
+      counters_read(&counters, &end_counters);
+      counters_accumulate(&sign_counters, &start_counters, &end_counters);
+      accumulate_stats(&sign_stats);
+      counters_read(&counters, &start_counters);
+      start_time = timing_read(&ctx);
 
       if (picnic_verify(&public_key, m, sizeof(m), sig, siglen)) {
         printf("picnic_verify: failed\n");
       }
       tmp_time       = timing_read(&ctx);
       timing->verify = tmp_time - start_time;
+      counters_read(&counters, &end_counters);
+      counters_accumulate(&verify_counters, &start_counters, &end_counters);
+      accumulate_stats(&verify_stats);
+      ++successful_iterations;
     } else {
       printf("picnic_sign: failed\n");
     }
@@ -86,6 +134,12 @@ static void bench_sign_and_verify(const bench_options_t* options) {
 
   timing_close(&ctx);
   print_timings(timings, options->iter);
+  print_stats(&sign_stats, &verify_stats, options->iter);
+  if (have_counters) {
+    counters_close(&counters);
+    counters_print("sign", &sign_counters, successful_iterations, true);
+    counters_print("verify", &verify_counters, successful_iterations, false);
+  }
 
   free(timings);
 }
@@ -0,0 +1,483 @@
+/*
+ *  This file is part of the optimized implementation of the Picnic signature scheme.
+ *  See the accompanying documentation for complete details.
+ *
+ *  The code is provided under the MIT license, see LICENSE for
+ *  more details.
+ *  SPDX-License-Identifier: MIT
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "bench_timing.h"
+#include "bench_utils.h"
+#include "../bitstream.h"
+#include "../kdf_shake.h"
+#include "../lowmc.h"
+#include "../macros.h"
+#include "../mpc_lowmc.h"
+#include "../mzd_additional.h"
+#include "../picnic_impl.h"
+#include "../picnic_instances.h"
+#include "../randomness.h"
+#if defined(WITH_OPT)
+#include "../simd.h"
+#endif
+
+#if defined(WITH_LOWMC_128_128_20)
+#include "../lowmc_128_128_20.h"
+#endif
+#if defined(WITH_LOWMC_129_129_4)
+#include "../lowmc_129_129_4.h"
+#endif
+#if defined(WITH_LOWMC_192_192_4)
+#include "../lowmc_192_192_4.h"
+#endif
+#if defined(WITH_LOWMC_192_192_30)
+#include "../lowmc_192_192_30.h"
+#endif
+#if defined(WITH_LOWMC_256_256_38)
+#include "../lowmc_256_256_38.h"
+#endif
+#if defined(WITH_LOWMC_255_255_4)
+#include "../lowmc_255_255_4.h"
+#endif
+#if defined(WITH_GFNI)
+#include "../lowmc_gfni.h"
+#endif
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* size of the buffers hashed and squeezed by the SHAKE kernels */
+#define SHAKE_BUFFER_SIZE 1024
+
+typedef struct {
+  const picnic_instance_t* pp;
+  unsigned int iter;
+  counters_context_t counters;
+  /* if false, time is measured in nanoseconds instead of cycles */
+  bool have_cycles;
+} kernel_bench_t;
+
+static uint64_t kernel_clock(kernel_bench_t* kb) {
+  if (kb->have_cycles) {
+    counter_values_t values;
+    counters_read(&kb->counters, &values);
+    return values.values[COUNTER_CYCLES];
+  }
+
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * UINT64_C(1000000000) + ts.tv_nsec;
+}
+
+static void kernel_report(kernel_bench_t* kb, const char* backend, const char* kernel,
+                          uint64_t total, size_t bytes) {
+  const double per_op = kb->iter ? (double)total / kb->iter : 0;
+  printf("%s,%s,%.1f,%.3f\n", kernel, backend, per_op, per_op > 0 ? bytes / per_op : 0);
+}
+
+/* with IPO the kernels are inlined, so make sure that their inputs and outputs stay live */
+#if defined(__GNUC__)
+#define KERNEL_ESCAPE(p) __asm__ __volatile__("" : : "r"(p) : "memory")
+#else
+#define KERNEL_ESCAPE(p) ((void)(p))
+#endif
+
+/* time iter invocations of op; bytes is the amount of data read by a single invocation */
+#define BENCH_KERNEL(kb, backend, name, bytes, op)                                                 \
+  do {                                                                                             \
+    op;                                                                                            \
+    const uint64_t start_ = kernel_clock(kb);                                                      \
+    for (unsigned int i_ = 0; i_ != (kb)->iter; ++i_) {                                            \
+      op;                                                                                          \
+      KERNEL_ESCAPE(kb);                                                                           \
+    }                                                                                              \
+    kernel_report(kb, backend, name, kernel_clock(kb) - start_, bytes);                            \
+  } while (0)
+
+static const char* backend_name(lowmc_backend_t backend) {
+  switch (backend) {
+  case LOWMC_BACKEND_GFNI:
+    return "gfni";
+  case LOWMC_BACKEND_S256:
+    return "s256";
+  case LOWMC_BACKEND_S128:
+    return "s128";
+  default:
+    return "uint64";
+  }
+}
+
+/* size of a rows x cols matrix in the mzd_local_t layout */
+static size_t matrix_bytes(unsigned int rows, unsigned int cols) {
+  if (cols <= 128) {
+    return rows * 16;
+  }
+  return rows * ((cols + 255) / 256) * sizeof(mzd_local_t);
+}
+
+#if !defined(NO_UINT64_FALLBACK)
+#define IMPL uint64
+#define BACKEND LOWMC_BACKEND_UINT64
+
+#include "../lowmc_129_129_4_fns_uint64.h"
+#include "bench_kernels.c.i"
+
+#include "../lowmc_192_192_4_fns_uint64.h"
+#include "bench_kernels.c.i"
+
+#include "../lowmc_255_255_4_fns_uint64.h"
+#include "bench_kernels.c.i"
+
+#include "../lowmc_128_128_20_fns_uint64.h"
+#include "bench_kernels.c.i"
+
+#include "../lowmc_192_192_30_fns_uint64.h"
+#include "bench_kernels.c.i"
+
+#include "../lowmc_256_256_38_fns_uint64.h"
+#include "bench_kernels.c.i"
+#endif
+
+#if defined(WITH_OPT)
+#if defined(WITH_SSE2) || defined(WITH_NEON)
+#undef IMPL
+#undef BACKEND
+#define IMPL s128
+#define BACKEND LOWMC_BACKEND_S128
+
+#include "../lowmc_129_129_4_fns_s128.h"
+#include "bench_kernels.c.i"
+
+#include "../lowmc_192_192_4_fns_s128.h"
+#include "bench_kernels.c.i"
+
+#include "../lowmc_255_255_4_fns_s128.h"
+#include "bench_kernels.c.i"
+
+#include "../lowmc_128_128_20_fns_s128.h"
+#include "bench_kernels.c.i"
+
+#include "../lowmc_192_192_30_fns_s128.h"
+#include "bench_kernels.c.i"
+
+#include "../lowmc_256_256_38_fns_s128.h"
+#include "bench_kernels.c.i"
+#endif
+
+#if defined(WITH_AVX2)
+#undef IMPL
+#undef BACKEND
+#define IMPL s256
+#define BACKEND LOWMC_BACKEND_S256
+
+#include "../lowmc_129_129_4_fns_s256.h"
+#include "bench_kernels.c.i"
+
+#include "../lowmc_192_192_4_fns_s256.h"
+#include "bench_kernels.c.i"
+
+#include "../lowmc_255_255_4_fns_s256.h"
+#include "bench_kernels.c.i"
+
+#include "../lowmc_128_128_20_fns_s256.h"
+#include "bench_kernels.c.i"
+
+#include "../lowmc_192_192_30_fns_s256.h"
+#include "bench_kernels.c.i"
+
+#include "../lowmc_256_256_38_fns_s256.h"
+#include "bench_kernels.c.i"
+#endif
+
+#if defined(WITH_GFNI)
+#undef IMPL
+#undef BACKEND
+#define IMPL gfni
+#define BACKEND LOWMC_BACKEND_GFNI
+/* the GFNI instances carry a suffix */
+#define bench_kernels_gfni_lowmc_129_129_4 bench_kernels_gfni_lowmc_129_129_4_gfni
+#define bench_kernels_gfni_lowmc_192_192_4 bench_kernels_gfni_lowmc_192_192_4_gfni
+#define bench_kernels_gfni_lowmc_255_255_4 bench_kernels_gfni_lowmc_255_255_4_gfni
+#define bench_kernels_gfni_lowmc_128_128_20 bench_kernels_gfni_lowmc_128_128_20_gfni
+#define bench_kernels_gfni_lowmc_192_192_30 bench_kernels_gfni_lowmc_192_192_30_gfni
+#define bench_kernels_gfni_lowmc_256_256_38 bench_kernels_gfni_lowmc_256_256_38_gfni
+
+#include "../lowmc_129_129_4_fns_gfni.h"
+#include "bench_kernels.c.i"
+
+#include "../lowmc_192_192_4_fns_gfni.h"
+#include "bench_kernels.c.i"
+
+#include "../lowmc_255_255_4_fns_gfni.h"
+#include "bench_kernels.c.i"
+
+#include "../lowmc_128_128_20_fns_gfni.h"
+#include "bench_kernels.c.i"
+
+#include "../lowmc_192_192_30_fns_gfni.h"
+#include "bench_kernels.c.i"
+
+#include "../lowmc_256_256_38_fns_gfni.h"
+#include "bench_kernels.c.i"
+#endif
+#endif
+
+typedef void (*kernel_bench_f)(kernel_bench_t* kb);
+
+typedef struct {
+  lowmc_backend_t backend;
+  unsigned int n;
+  unsigned int m;
+  kernel_bench_f bench;
+} kernel_bench_entry_t;
+
+#define KERNEL_BENCHES(impl, backend)                                                              \
+  KERNEL_BENCH_128_128_20(impl, backend)                                                           \
+  KERNEL_BENCH_129_129_4(impl, backend)                                                            \
+  KERNEL_BENCH_192_192_30(impl, backend)                                                           \
+  KERNEL_BENCH_192_192_4(impl, backend)                                                            \
+  KERNEL_BENCH_256_256_38(impl, backend)                                                           \
+  KERNEL_BENCH_255_255_4(impl, backend)
+
+#if defined(WITH_LOWMC_128_128_20)
+#define KERNEL_BENCH_128_128_20(impl, backend)                                                     \
+  {backend, 128, 10, CONCAT(bench_kernels, CONCAT(impl, lowmc_128_128_20))},
+#else
+#define KERNEL_BENCH_128_128_20(impl, backend)
+#endif
+#if defined(WITH_LOWMC_129_129_4)
+#define KERNEL_BENCH_129_129_4(impl, backend)                                                      \
+  {backend, 129, 43, CONCAT(bench_kernels, CONCAT(impl, lowmc_129_129_4))},
+#else
+#define KERNEL_BENCH_129_129_4(impl, backend)
+#endif
+#if defined(WITH_LOWMC_192_192_30)
+#define KERNEL_BENCH_192_192_30(impl, backend)                                                     \
+  {backend, 192, 10, CONCAT(bench_kernels, CONCAT(impl, lowmc_192_192_30))},
+#else
+#define KERNEL_BENCH_192_192_30(impl, backend)
+#endif
+#if defined(WITH_LOWMC_192_192_4)
+#define KERNEL_BENCH_192_192_4(impl, backend)                                                      \
+  {backend, 192, 64, CONCAT(bench_kernels, CONCAT(impl, lowmc_192_192_4))},
+#else
+#define KERNEL_BENCH_192_192_4(impl, backend)
+#endif
+#if defined(WITH_LOWMC_256_256_38)
+#define KERNEL_BENCH_256_256_38(impl, backend)                                                     \
+  {backend, 256, 10, CONCAT(bench_kernels, CONCAT(impl, lowmc_256_256_38))},
+#else
+#define KERNEL_BENCH_256_256_38(impl, backend)
+#endif
+#if defined(WITH_LOWMC_255_255_4)
+#define KERNEL_BENCH_255_255_4(impl, backend)                                                      \
+  {backend, 255, 85, CONCAT(bench_kernels, CONCAT(impl, lowmc_255_255_4))},
+#else
+#define KERNEL_BENCH_255_255_4(impl, backend)
+#endif
+
+static const kernel_bench_entry_t kernel_benches[] = {
+#if defined(WITH_OPT)
+#if defined(WITH_GFNI)
+    KERNEL_BENCHES(gfni, LOWMC_BACKEND_GFNI)
+#endif
+#if defined(WITH_AVX2)
+    KERNEL_BENCHES(s256, LOWMC_BACKEND_S256)
+#endif
+#if defined(WITH_SSE2) || defined(WITH_NEON)
+    KERNEL_BENCHES(s128, LOWMC_BACKEND_S128)
+#endif
+#endif
+#if !defined(NO_UINT64_FALLBACK)
+    KERNEL_BENCHES(uint64, LOWMC_BACKEND_UINT64)
+#endif
+};
+
+static bool backend_supported(lowmc_backend_t backend) {
+  switch (backend) {
+#if defined(WITH_OPT)
+#if defined(WITH_GFNI)
+  case LOWMC_BACKEND_GFNI:
+    return CPU_SUPPORTS_GFNI;
+#endif
+#if defined(WITH_AVX2)
+  case LOWMC_BACKEND_S256:
+    return CPU_SUPPORTS_AVX2;
+#endif
+#if defined(WITH_SSE2)
+  case LOWMC_BACKEND_S128:
+    return CPU_SUPPORTS_SSE2;
+#elif defined(WITH_NEON)
+  case LOWMC_BACKEND_S128:
+    return CPU_SUPPORTS_NEON;
+#endif
+#endif
+  case LOWMC_BACKEND_UINT64:
+    return true;
+  default:
+    return false;
+  }
+}
+
+#if defined(WITH_ZKBPP)
+static bool is_zkbpp(picnic_params_t params) {
+  return params < Picnic3_L1 || params > Picnic3_L5;
+}
+
+static void bench_views(kernel_bench_t* kb) {
+  const picnic_instance_t* pp = kb->pp;
+  const size_t num_views      = pp->lowmc.r;
+
+  view_t* views   = calloc(num_views, sizeof(view_t));
+  uint8_t* buffer = calloc(1, pp->view_size);
+  rand_bytes((uint8_t*)views, num_views * sizeof(view_t));
+  KERNEL_ESCAPE(views);
+  KERNEL_ESCAPE(buffer);
+
+  bitstream_t bs;
+#if defined(WITH_LOWMC_129_129_4) || defined(WITH_LOWMC_192_192_4) || defined(WITH_LOWMC_255_255_4)
+  if (pp->lowmc.m != 10) {
+    const size_t view_round_size = pp->view_round_size;
+    const size_t width           = (pp->lowmc.n + 63) / 64;
+
+    BENCH_KERNEL(kb, "generic", "mzd_to_bitstream", num_views * sizeof(view_t) / SC_PROOF, {
+      bs.buffer.w = buffer;
+      bs.position = 0;
+      for (size_t j = 0; j < num_views; ++j) {
+        mzd_to_bitstream(&bs, &views[j].s[0], width, view_round_size);
+      }
+    });
+    BENCH_KERNEL(kb, "generic", "mzd_from_bitstream", pp->view_size, {
+      bs.buffer.r = buffer;
+      bs.position = 0;
+      for (size_t j = 0; j < num_views; ++j) {
+        mzd_from_bitstream(&bs, &views[j].s[0], width, view_round_size);
+      }
+    });
+  }
+#endif
+#if defined(WITH_LOWMC_128_128_20) || defined(WITH_LOWMC_192_192_30) || defined(WITH_LOWMC_256_256_38)
+  if (pp->lowmc.m == 10) {
+    /* the buffer is large enough for both layouts */
+    view_partial_t* partial_views = (void*)views;
+    const ptrdiff_t stride        = sizeof(view_partial_t) / sizeof(uint32_t);
+
+    BENCH_KERNEL(kb, "generic", "bitstream_put_fields", num_views * sizeof(uint32_t), {
+      bs.buffer.w = buffer;
+      bs.position = 0;
+      bitstream_put_fields_32(&bs, &partial_views[0].t[0], stride, num_views, 30);
+    });
+    BENCH_KERNEL(kb, "generic", "bitstream_get_fields", pp->view_size, {
+      bs.buffer.r = buffer;
+      bs.position = 0;
+      bitstream_get_fields_32(&bs, &partial_views[0].t[0], stride, num_views, 30);
+    });
+  }
+#endif
+
+  BENCH_KERNEL(kb, "generic", "decompress_random_tape", pp->view_size,
+               decompress_random_tape(views, pp, buffer, 0));
+
+  free(buffer);
+  free(views);
+}
+#endif
+
+static void bench_shake(kernel_bench_t* kb) {
+  const size_t digest_size = kb->pp->digest_size;
+
+  uint8_t* buffers[4];
+  const uint8_t* const_buffers[4];
+  for (unsigned int i = 0; i < 4; ++i) {
+    buffers[i]       = malloc(SHAKE_BUFFER_SIZE);
+    const_buffers[i] = buffers[i];
+    rand_bytes(buffers[i], SHAKE_BUFFER_SIZE);
+    KERNEL_ESCAPE(buffers[i]);
+  }
+
+  hash_context ctx;
+  KERNEL_ESCAPE(&ctx);
+  hash_init(&ctx, digest_size);
+  BENCH_KERNEL(kb, "generic", "shake_absorb", SHAKE_BUFFER_SIZE,
+               hash_update(&ctx, buffers[0], SHAKE_BUFFER_SIZE));
+  hash_final(&ctx);
+  BENCH_KERNEL(kb, "generic", "shake_squeeze", SHAKE_BUFFER_SIZE,
+               hash_squeeze(&ctx, buffers[0], SHAKE_BUFFER_SIZE));
+
+  hash_context_x4 ctx_x4;
+  KERNEL_ESCAPE(&ctx_x4);
+  hash_init_x4(&ctx_x4, digest_size);
+  BENCH_KERNEL(kb, "generic", "shake_x4_absorb", 4 * SHAKE_BUFFER_SIZE,
+               hash_update_x4(&ctx_x4, const_buffers, SHAKE_BUFFER_SIZE));
+  hash_final_x4(&ctx_x4);
+  BENCH_KERNEL(kb, "generic", "shake_x4_squeeze", 4 * SHAKE_BUFFER_SIZE,
+               hash_squeeze_x4(&ctx_x4, buffers, SHAKE_BUFFER_SIZE));
+
+  for (unsigned int i = 0; i < 4; ++i) {
+    free(buffers[i]);
+  }
+}
+
+static void bench_kernels(const bench_options_t* options) {
+  kernel_bench_t kb;
+  kb.pp = picnic_instance_get(options->params);
+  if (!kb.pp) {
+    printf("Failed to initialize LowMC instance.\n");
+    return;
+  }
+  kb.iter = options->iter;
+
+  kb.have_cycles = counters_init(&kb.counters);
+  if (kb.have_cycles) {
+    counter_values_t values;
+    counters_read(&kb.counters, &values);
+    if (values.values[COUNTER_CYCLES] == COUNTER_UNAVAILABLE) {
+      counters_close(&kb.counters);
+      kb.have_cycles = false;
+    }
+  }
+
+  if (kb.have_cycles) {
+    printf("kernel,backend,cycles_per_op,bytes_per_cycle\n");
+  } else {
+    printf("kernel,backend,ns_per_op,bytes_per_ns\n");
+  }
+
+  const lowmc_parameters_t* lowmc = &kb.pp->lowmc;
+  for (size_t i = 0; i < sizeof(kernel_benches) / sizeof(kernel_benches[0]); ++i) {
+    const kernel_bench_entry_t* entry = &kernel_benches[i];
+    if (entry->n == lowmc->n && entry->m == lowmc->m && backend_supported(entry->backend)) {
+      entry->bench(&kb);
+    }
+  }
+
+#if defined(WITH_ZKBPP)
+  if (is_zkbpp(options->params)) {
+    bench_views(&kb);
+  }
+#endif
+  bench_shake(&kb);
+
+  if (kb.have_cycles) {
+    counters_close(&kb.counters);
+  }
+}
+
+int main(int argc, char** argv) {
+  bench_options_t opts = {PARAMETER_SET_INVALID, 0};
+  int ret              = parse_args(&opts, argc, argv) ? 0 : -1;
+
+  if (!ret) {
+    bench_kernels(&opts);
+  }
+
+  return ret;
+}
@@ -0,0 +1,84 @@
+/*
+ *  This file is part of the optimized implementation of the Picnic signature scheme.
+ *  See the accompanying documentation for complete details.
+ *
+ *  The code is provided under the MIT license, see LICENSE for
+ *  more details.
+ *  SPDX-License-Identifier: MIT
+ */
+
+#if defined(LOWMC_INSTANCE)
+static void CONCAT(bench_kernels, CONCAT(IMPL, LOWMC_INSTANCE))(kernel_bench_t* kb) {
+  const lowmc_parameters_t* lowmc = &kb->pp->lowmc;
+  const char* backend             = backend_name(BACKEND);
+
+  mzd_local_t x[((LOWMC_N) + 255) / 256];
+  mzd_local_t y[((LOWMC_N) + 255) / 256];
+  mzd_local_t z[((LOWMC_N) + 255) / 256];
+  rand_bytes((uint8_t*)x, sizeof(x));
+  rand_bytes((uint8_t*)z, sizeof(z));
+  KERNEL_ESCAPE(x);
+  KERNEL_ESCAPE(y);
+  KERNEL_ESCAPE(z);
+
+  BENCH_KERNEL(kb, backend, "mul", matrix_bytes(LOWMC_N, LOWMC_N),
+               MUL(y, x, LOWMC_INSTANCE.k0_matrix));
+  BENCH_KERNEL(kb, backend, "addmul", matrix_bytes(LOWMC_N, LOWMC_N),
+               ADDMUL(y, x, LOWMC_INSTANCE.k0_matrix));
+  BENCH_KERNEL(kb, backend, "xor", 2 * sizeof(x), XOR(y, x, z));
+
+#if defined(LOWMC_PARTIAL)
+  mzd_local_t nl_part[((LOWMC_R)*32 + 255) / 256];
+  mzd_local_t nl_part2[((LOWMC_R)*32 + 255) / 256];
+  rand_bytes((uint8_t*)nl_part2, sizeof(nl_part2));
+  KERNEL_ESCAPE(nl_part);
+  KERNEL_ESCAPE(nl_part2);
+
+  BENCH_KERNEL(kb, backend, "mul_mc", matrix_bytes(LOWMC_N, (LOWMC_R)*32),
+               MUL_MC(nl_part, x, LOWMC_INSTANCE.precomputed_non_linear_part_matrix));
+  BENCH_KERNEL(kb, backend, "xor_mc", 2 * sizeof(nl_part), XOR_MC(nl_part, nl_part, nl_part2));
+  BENCH_KERNEL(kb, backend, "mul_z", matrix_bytes(3 * (LOWMC_M), LOWMC_N),
+               MUL_Z(y, x, LOWMC_INSTANCE.rounds[0].z_matrix));
+  BENCH_KERNEL(kb, backend, "addmul_r", matrix_bytes(3 * (LOWMC_M), LOWMC_N),
+               ADDMUL_R(y, x, LOWMC_INSTANCE.rounds[0].r_matrix));
+  BENCH_KERNEL(kb, backend, "shuffle", sizeof(x), SHUFFLE(x, LOWMC_INSTANCE.rounds[0].r_mask));
+#else
+  mzd_local_t round_keys[(LOWMC_R) + 1][((LOWMC_N) + 255) / 256];
+  KERNEL_ESCAPE(round_keys);
+
+  BENCH_KERNEL(kb, backend, "mul_xor", matrix_bytes(LOWMC_N, LOWMC_N),
+               MUL_XOR(y, x, LOWMC_INSTANCE.rounds[0].l_matrix, z));
+  BENCH_KERNEL(kb, backend, "mul_rk", ((LOWMC_R) + 1) * matrix_bytes(LOWMC_N, LOWMC_N),
+               MUL_RK(round_keys[0], x, LOWMC_INSTANCE.k_matrices));
+#endif
+
+  const lowmc_sbox_implementation_f sbox = lowmc_sbox_get_implementation(lowmc, BACKEND);
+  if (sbox) {
+    BENCH_KERNEL(kb, backend, "sbox", sizeof(x), sbox(x));
+  }
+
+#if defined(WITH_ZKBPP)
+  mzd_local_t in[SC_PROOF * (((LOWMC_N) + 255) / 256)];
+  mzd_local_t out[SC_PROOF * (((LOWMC_N) + 255) / 256)];
+  view_t view;
+  rvec_t rvec;
+  rand_bytes((uint8_t*)in, sizeof(in));
+  rand_bytes((uint8_t*)&rvec, sizeof(rvec));
+  KERNEL_ESCAPE(in);
+  KERNEL_ESCAPE(out);
+  KERNEL_ESCAPE(&view);
+  KERNEL_ESCAPE(&rvec);
+
+  const zkbpp_sbox_implementation_f mpc_sbox = get_zkbpp_sbox_implementation(lowmc, BACKEND, false);
+  if (mpc_sbox) {
+    BENCH_KERNEL(kb, backend, "mpc_sbox_prove", sizeof(in), mpc_sbox(out, in, &view, &rvec));
+  }
+  const zkbpp_sbox_implementation_f mpc_sbox_verify =
+      get_zkbpp_sbox_implementation(lowmc, BACKEND, true);
+  if (mpc_sbox_verify) {
+    BENCH_KERNEL(kb, backend, "mpc_sbox_verify", SC_VERIFY * sizeof(in) / SC_PROOF,
+                 mpc_sbox_verify(out, in, &view, &rvec));
+  }
+#endif
+}
+#endif
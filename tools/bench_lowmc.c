@@ -23,9 +23,11 @@
 #include <stdio.h>
 #include <stdlib.h>
 
-static void print_timings(const uint64_t* timing, unsigned int iter) {
+static void print_timings(const uint64_t* timing, const uint64_t* timing_batch,
+                          unsigned int iter) {
+  printf("lowmc,lowmc_batch\n");
   for (unsigned int i = 0; i < iter; i++) {
-    printf("%" PRIu64 "\n", timing[i]);
+    printf("%" PRIu64 ",%" PRIu64 "\n", timing[i], timing_batch[i]);
   }
 }
 
@@ -42,7 +44,14 @@ static void bench_lowmc(const bench_options_t* options) {
     return;
   }
 
-  uint64_t* timings = calloc(options->iter, sizeof(uint64_t));
+  counters_context_t counters;
+  const bool have_counters        = counters_init(&counters);
+  counter_values_t lowmc_counters = {{0}};
+  counter_values_t batch_counters = {{0}};
+  counter_values_t start_counters, end_counters;
+
+  uint64_t* timings       = calloc(options->iter, sizeof(uint64_t));
+  uint64_t* timings_batch = calloc(options->iter, sizeof(uint64_t));
 
   const lowmc_parameters_t* lowmc         = &pp->lowmc;
   const lowmc_implementation_f lowmc_impl = pp->impls.lowmc;
@@ -58,8 +67,8 @@ static void bench_lowmc(const bench_options_t* options) {
   rand_bytes(rand, input_size + output_size);
   mzd_from_char_array(sk, rand, input_size);
   mzd_from_char_array(pt, rand + input_size, output_size);
-  free(rand);
 
+  counters_read(&counters, &start_counters);
   for (unsigned int i = 0; i != options->iter; ++i) {
     const uint64_t start_time = timing_read(&ctx);
     lowmc_impl(sk, pt, ct);
@@ -69,14 +78,61 @@ static void bench_lowmc(const bench_options_t* options) {
     pt = ct;
     ct = tmp;
   }
+  counters_read(&counters, &end_counters);
+  counters_accumulate(&lowmc_counters, &start_counters, &end_counters);
+
+  const lowmc_batch_implementation_f lowmc_batch_impl = pp->impls.lowmc_batch;
+  if (lowmc_batch_impl) {
+    mzd_local_t* pts[LOWMC_BATCH_SIZE];
+    mzd_local_t* cts[LOWMC_BATCH_SIZE];
+    mzd_local_t const* sks[LOWMC_BATCH_SIZE];
+    for (unsigned int j = 0; j < LOWMC_BATCH_SIZE; ++j) {
+      pts[j] = mzd_local_init(1, lowmc->n);
+      cts[j] = mzd_local_init(1, lowmc->n);
+      sks[j] = sk;
+      mzd_from_char_array(pts[j], rand + input_size, output_size);
+    }
+
+    counters_read(&counters, &start_counters);
+    for (unsigned int i = 0; i != options->iter; ++i) {
+      const uint64_t start_time = timing_read(&ctx);
+      lowmc_batch_impl(sks, (mzd_local_t const* const*)pts, cts);
+      // report the time per encryption
+      timings_batch[i] = (timing_read(&ctx) - start_time) / LOWMC_BATCH_SIZE;
+
+      for (unsigned int j = 0; j < LOWMC_BATCH_SIZE; ++j) {
+        mzd_local_t* tmp = pts[j];
+        pts[j]           = cts[j];
+        cts[j]           = tmp;
+      }
+    }
+    counters_read(&counters, &end_counters);
+    counters_accumulate(&batch_counters, &start_counters, &end_counters);
+
+    for (unsigned int j = 0; j < LOWMC_BATCH_SIZE; ++j) {
+      mzd_local_free(cts[j]);
+      mzd_local_free(pts[j]);
+    }
+  }
 
+  free(rand);
   mzd_local_free(ct);
   mzd_local_free(pt);
   mzd_local_free(sk);
 
   timing_close(&ctx);
-  print_timings(timings, options->iter);
+  print_timings(timings, timings_batch, options->iter);
+  if (have_counters) {
+    counters_close(&counters);
+    // counters are reported per encryption, including the loop overhead
+    counters_print("lowmc", &lowmc_counters, options->iter, true);
+    if (lowmc_batch_impl) {
+      counters_print("lowmc_batch", &batch_counters, (uint64_t)options->iter * LOWMC_BATCH_SIZE,
+                     false);
+    }
+  }
 
+  free(timings_batch);
   free(timings);
 }
 
@@ -0,0 +1,288 @@
+/*
+ *  This file is part of the optimized implementation of the Picnic signature scheme.
+ *  See the accompanying documentation for complete details.
+ *
+ *  The code is provided under the MIT license, see LICENSE for
+ *  more details.
+ *  SPDX-License-Identifier: MIT
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "picnic.h"
+
+#include <errno.h>
+#include <getopt.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * The allocation functions are interposed with the linker's --wrap option, so every call to
+ * malloc, calloc, realloc, aligned_alloc and free from the library (and this tool) is routed
+ * through the __wrap_* functions below.
+ */
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t nmemb, size_t size);
+void* __real_aligned_alloc(size_t alignment, size_t size);
+void __real_free(void* ptr);
+
+void* __wrap_malloc(size_t size);
+void* __wrap_calloc(size_t nmemb, size_t size);
+void* __wrap_realloc(void* ptr, size_t size);
+void* __wrap_aligned_alloc(size_t alignment, size_t size);
+void __wrap_free(void* ptr);
+
+/* every block is preceded by its size and the offset to the start of the real allocation */
+typedef struct {
+  size_t size;
+  size_t offset;
+} alloc_header_t;
+
+/* keeps the 16 byte alignment guaranteed by malloc */
+#define ALLOC_HEADER_SIZE 16
+
+typedef struct {
+  size_t live;
+  size_t peak;
+  size_t total;
+  size_t count;
+} alloc_stats_t;
+
+static alloc_stats_t alloc_stats;
+
+static void* track(void* real, size_t offset, size_t size) {
+  if (!real) {
+    return NULL;
+  }
+
+  uint8_t* ptr           = (uint8_t*)real + offset;
+  alloc_header_t* header = (alloc_header_t*)ptr - 1;
+  header->size           = size;
+  header->offset         = offset;
+
+  alloc_stats.live += size;
+  alloc_stats.total += size;
+  ++alloc_stats.count;
+  if (alloc_stats.live > alloc_stats.peak) {
+    alloc_stats.peak = alloc_stats.live;
+  }
+  return ptr;
+}
+
+static size_t tracked_size(void* ptr) {
+  return ((alloc_header_t*)ptr - 1)->size;
+}
+
+static void* untrack(void* ptr) {
+  const alloc_header_t* header = (alloc_header_t*)ptr - 1;
+  alloc_stats.live -= header->size;
+  return (uint8_t*)ptr - header->offset;
+}
+
+void* __wrap_malloc(size_t size) {
+  if (size > SIZE_MAX - ALLOC_HEADER_SIZE) {
+    errno = ENOMEM;
+    return NULL;
+  }
+  return track(__real_malloc(size + ALLOC_HEADER_SIZE), ALLOC_HEADER_SIZE, size);
+}
+
+void* __wrap_calloc(size_t nmemb, size_t size) {
+  if (size && nmemb > (SIZE_MAX - ALLOC_HEADER_SIZE) / size) {
+    errno = ENOMEM;
+    return NULL;
+  }
+  return track(__real_calloc(1, nmemb * size + ALLOC_HEADER_SIZE), ALLOC_HEADER_SIZE,
+               nmemb * size);
+}
+
+void* __wrap_aligned_alloc(size_t alignment, size_t size) {
+  /* a multiple of alignment, so size stays a multiple of it as well */
+  const size_t offset = alignment > ALLOC_HEADER_SIZE ? alignment : ALLOC_HEADER_SIZE;
+  if (size > SIZE_MAX - offset) {
+    errno = ENOMEM;
+    return NULL;
+  }
+  return track(__real_aligned_alloc(alignment, size + offset), offset, size);
+}
+
+/* always moves the block, so the peak accounts for both copies */
+void* __wrap_realloc(void* ptr, size_t size) {
+  if (!ptr) {
+    return __wrap_malloc(size);
+  }
+  if (!size) {
+    __wrap_free(ptr);
+    return NULL;
+  }
+
+  void* new_ptr = __wrap_malloc(size);
+  if (new_ptr) {
+    const size_t old_size = tracked_size(ptr);
+    memcpy(new_ptr, ptr, old_size < size ? old_size : size);
+    __wrap_free(ptr);
+  }
+  return new_ptr;
+}
+
+void __wrap_free(void* ptr) {
+  if (ptr) {
+    __real_free(untrack(ptr));
+  }
+}
+
+typedef struct {
+  size_t peak;
+  size_t total;
+  size_t count;
+} memory_usage_t;
+
+static size_t measure_baseline;
+
+static void measure_start(void) {
+  measure_baseline  = alloc_stats.live;
+  alloc_stats.peak  = alloc_stats.live;
+  alloc_stats.total = 0;
+  alloc_stats.count = 0;
+}
+
+static void measure_stop(memory_usage_t* usage) {
+  const size_t peak = alloc_stats.peak - measure_baseline;
+  if (peak > usage->peak) {
+    usage->peak = peak;
+  }
+  usage->total += alloc_stats.total;
+  usage->count += alloc_stats.count;
+}
+
+static void print_memory_usage(const memory_usage_t* usage, picnic_params_t param,
+                               const char* operation, unsigned int iter) {
+  printf("%s,%s,%zu,%zu,%zu\n", picnic_get_param_name(param), operation, usage->peak,
+         usage->total / iter, usage->count / iter);
+}
+
+static int bench_memory(picnic_params_t param, unsigned int iter) {
+  static const uint8_t m[] = "test message";
+
+  const size_t max_signature_size = picnic_signature_size(param);
+  if (!max_signature_size) {
+    /* not supported */
+    return 0;
+  }
+
+  uint8_t* sig = malloc(max_signature_size);
+  if (!sig) {
+    return -1;
+  }
+
+  memory_usage_t keygen = {0, 0, 0};
+  memory_usage_t sign   = {0, 0, 0};
+  memory_usage_t verify = {0, 0, 0};
+  int ret               = 0;
+
+  for (unsigned int i = 0; i != iter && !ret; ++i) {
+    picnic_privatekey_t private_key;
+    picnic_publickey_t public_key;
+
+    measure_start();
+    ret = picnic_keygen(param, &public_key, &private_key);
+    measure_stop(&keygen);
+    if (ret) {
+      break;
+    }
+
+    size_t siglen = max_signature_size;
+    measure_start();
+    ret = picnic_sign(&private_key, m, sizeof(m), sig, &siglen);
+    measure_stop(&sign);
+    if (ret) {
+      break;
+    }
+
+    measure_start();
+    ret = picnic_verify(&public_key, m, sizeof(m), sig, siglen);
+    measure_stop(&verify);
+  }
+
+  free(sig);
+  if (ret) {
+    printf("%s,failed\n", picnic_get_param_name(param));
+    return ret;
+  }
+
+  print_memory_usage(&keygen, param, "keygen", iter);
+  print_memory_usage(&sign, param, "sign", iter);
+  print_memory_usage(&verify, param, "verify", iter);
+  return 0;
+}
+
+static bool parse_uint32_t(uint32_t* value, const char* arg) {
+  errno        = 0;
+  char* end    = NULL;
+  const long v = strtol(arg, &end, 10);
+  if (errno != 0 || end == arg || *end || v < 0 || (unsigned long)v > UINT32_MAX) {
+    return false;
+  }
+  *value = v;
+  return true;
+}
+
+static void print_usage(const char* arg0) {
+  printf("usage: %s [-i iterations] [param]\n", arg0);
+}
+
+int main(int argc, char** argv) {
+  uint32_t iter = 10;
+
+  static const struct option long_options[] = {
+    {"iter", required_argument, NULL, 'i'},
+    {0, 0, 0, 0}
+  };
+
+  int c            = -1;
+  int option_index = 0;
+  while ((c = getopt_long(argc, argv, "i:", long_options, &option_index)) != -1) {
+    switch (c) {
+    case 'i':
+      if (!parse_uint32_t(&iter, optarg) || !iter) {
+        printf("Invalid number of iterations!\n");
+        return -1;
+      }
+      break;
+
+    case '?':
+    default:
+      print_usage(argv[0]);
+      return -1;
+    }
+  }
+
+  uint32_t first = Picnic_L1_FS;
+  uint32_t last  = PARAMETER_SET_MAX_INDEX - 1;
+  if (optind == argc - 1) {
+    if (!parse_uint32_t(&first, argv[optind]) || first <= PARAMETER_SET_INVALID ||
+        first >= PARAMETER_SET_MAX_INDEX) {
+      printf("Invalid parameter set selected!\n");
+      return -1;
+    }
+    last = first;
+  } else if (optind != argc) {
+    print_usage(argv[0]);
+    return -1;
+  }
+
+  printf("params,operation,peak_bytes,total_bytes,allocations\n");
+  int ret = 0;
+  for (uint32_t param = first; param <= last; ++param) {
+    if (bench_memory(param, iter)) {
+      ret = -1;
+    }
+  }
+
+  return ret;
+}
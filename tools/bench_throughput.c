@@ -0,0 +1,475 @@
+/*
+ *  This file is part of the optimized implementation of the Picnic signature scheme.
+ *  See the accompanying documentation for complete details.
+ *
+ *  The code is provided under the MIT license, see LICENSE for
+ *  more details.
+ *  SPDX-License-Identifier: MIT
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "bench_timing.h"
+#include "picnic.h"
+
+#include <errno.h>
+#include <getopt.h>
+#include <inttypes.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+typedef enum { OP_SIGN = 1, OP_VERIFY = 2, OP_BOTH = OP_SIGN | OP_VERIFY } operation_t;
+typedef enum { FORMAT_CSV, FORMAT_JSON } format_t;
+
+typedef struct {
+  picnic_params_t params;
+  unsigned int threads;
+  unsigned int duration_ms;
+  operation_t operation;
+  format_t format;
+} throughput_options_t;
+
+/* latencies of one kind of operation, in nanoseconds */
+typedef struct {
+  uint64_t* values;
+  size_t len, capacity;
+} latencies_t;
+
+typedef struct {
+  const throughput_options_t* options;
+  atomic_bool* stop;
+  picnic_privatekey_t sk;
+  picnic_publickey_t pk;
+  uint8_t sig[PICNIC_MAX_SIGNATURE_SIZE];
+  size_t siglen;
+  latencies_t sign;
+  latencies_t verify;
+  /* hardware counters of this worker's thread over all operations */
+  counter_values_t counters;
+  bool have_counters;
+  int failed;
+} worker_t;
+
+typedef struct {
+  unsigned int threads;
+  double seconds;
+  uint64_t sign_ops, verify_ops;
+  uint64_t sign_percentiles[4], verify_percentiles[4];
+  double ops_per_second;
+  /* hardware counters per operation */
+  uint64_t counters[COUNTER_MAX];
+} result_t;
+
+static const double percentiles[4]           = {50, 90, 99, 99.9};
+static const char* const percentile_names[4] = {"p50", "p90", "p99", "p99.9"};
+
+static uint64_t time_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * UINT64_C(1000000000) + ts.tv_nsec;
+}
+
+static bool latencies_push(latencies_t* lat, uint64_t value) {
+  if (lat->len == lat->capacity) {
+    const size_t capacity = lat->capacity ? 2 * lat->capacity : 1024;
+    uint64_t* values      = realloc(lat->values, capacity * sizeof(uint64_t));
+    if (!values) {
+      return false;
+    }
+    lat->values   = values;
+    lat->capacity = capacity;
+  }
+  lat->values[lat->len++] = value;
+  return true;
+}
+
+static bool latencies_append(latencies_t* dst, const latencies_t* src) {
+  for (size_t i = 0; i < src->len; ++i) {
+    if (!latencies_push(dst, src->values[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static int compare_uint64(const void* lhs, const void* rhs) {
+  const uint64_t l = *(const uint64_t*)lhs;
+  const uint64_t r = *(const uint64_t*)rhs;
+  return (l > r) - (l < r);
+}
+
+static void latencies_percentiles(latencies_t* lat, uint64_t* dst) {
+  if (!lat->len) {
+    memset(dst, 0, sizeof(percentiles) / sizeof(percentiles[0]) * sizeof(uint64_t));
+    return;
+  }
+
+  qsort(lat->values, lat->len, sizeof(uint64_t), compare_uint64);
+  for (unsigned int i = 0; i < sizeof(percentiles) / sizeof(percentiles[0]); ++i) {
+    /* nearest-rank method */
+    size_t rank = (size_t)((percentiles[i] / 100) * lat->len + 0.999999);
+    if (rank) {
+      --rank;
+    }
+    dst[i] = lat->values[rank < lat->len ? rank : lat->len - 1];
+  }
+}
+
+static const uint8_t m[] = {1,  2,  3,  4,  5,  6,  7,  8,  9,  10, 11, 12, 13, 14, 15, 16,
+                            17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32};
+
+static void* worker_run(void* arg) {
+  worker_t* worker                    = arg;
+  const throughput_options_t* options = worker->options;
+  uint8_t* sig                        = worker->sig;
+  size_t siglen                       = worker->siglen;
+
+  /* counters only observe the thread that opened them */
+  counters_context_t counters;
+  counter_values_t start_counters, end_counters;
+  worker->have_counters = counters_init(&counters);
+
+  while (!atomic_load_explicit(worker->stop, memory_order_relaxed)) {
+    counters_read(&counters, &start_counters);
+    if (options->operation & OP_SIGN) {
+      siglen               = sizeof(worker->sig);
+      const uint64_t start = time_ns();
+      if (picnic_sign(&worker->sk, m, sizeof(m), sig, &siglen)) {
+        worker->failed = 1;
+        break;
+      }
+      if (!latencies_push(&worker->sign, time_ns() - start)) {
+        worker->failed = 1;
+        break;
+      }
+    }
+    if (options->operation & OP_VERIFY) {
+      const uint64_t start = time_ns();
+      if (picnic_verify(&worker->pk, m, sizeof(m), sig, siglen)) {
+        worker->failed = 1;
+        break;
+      }
+      if (!latencies_push(&worker->verify, time_ns() - start)) {
+        worker->failed = 1;
+        break;
+      }
+    }
+    counters_read(&counters, &end_counters);
+    counters_accumulate(&worker->counters, &start_counters, &end_counters);
+  }
+
+  if (worker->have_counters) {
+    counters_close(&counters);
+  }
+  return NULL;
+}
+
+static bool run(const throughput_options_t* options, unsigned int threads, result_t* result) {
+  worker_t* workers    = calloc(threads, sizeof(worker_t));
+  pthread_t* handles   = calloc(threads, sizeof(pthread_t));
+  atomic_bool stop     = false;
+  bool ok              = workers && handles;
+  unsigned int started = 0;
+
+  /* Key generation happens here, on the main thread, so that every worker signs with its own key
+   * and the instance is set up before any worker runs. */
+  for (unsigned int i = 0; ok && i < threads; ++i) {
+    workers[i].options = options;
+    workers[i].stop    = &stop;
+    if (picnic_keygen(options->params, &workers[i].pk, &workers[i].sk)) {
+      printf("picnic_keygen: failed.\n");
+      ok = false;
+    }
+    /* in verify-only mode, every worker verifies a single signature over and over */
+    workers[i].siglen = sizeof(workers[i].sig);
+    if (ok && options->operation == OP_VERIFY &&
+        picnic_sign(&workers[i].sk, m, sizeof(m), workers[i].sig, &workers[i].siglen)) {
+      printf("picnic_sign: failed.\n");
+      ok = false;
+    }
+  }
+
+  const uint64_t start = time_ns();
+  for (; ok && started < threads; ++started) {
+    if (pthread_create(&handles[started], NULL, worker_run, &workers[started])) {
+      printf("Failed to create thread.\n");
+      ok = false;
+      break;
+    }
+  }
+
+  if (ok) {
+    const struct timespec duration = {options->duration_ms / 1000,
+                                      (options->duration_ms % 1000) * 1000000L};
+    struct timespec remaining      = duration;
+    while (nanosleep(&remaining, &remaining) == -1 && errno == EINTR) {
+    }
+  }
+  atomic_store(&stop, true);
+
+  for (unsigned int i = 0; i < started; ++i) {
+    pthread_join(handles[i], NULL);
+  }
+  const uint64_t elapsed = time_ns() - start;
+
+  latencies_t sign                 = {NULL, 0, 0};
+  latencies_t verify               = {NULL, 0, 0};
+  counter_values_t counters        = {{0}};
+  const counter_values_t no_counts = {{0}};
+  for (unsigned int i = 0; ok && i < threads; ++i) {
+    if (!workers[i].have_counters) {
+      for (unsigned int c = 0; c < COUNTER_MAX; ++c) {
+        workers[i].counters.values[c] = COUNTER_UNAVAILABLE;
+      }
+    }
+    counters_accumulate(&counters, &no_counts, &workers[i].counters);
+    if (workers[i].failed) {
+      printf("Worker %u failed.\n", i);
+      ok = false;
+    } else if (!latencies_append(&sign, &workers[i].sign) ||
+               !latencies_append(&verify, &workers[i].verify)) {
+      ok = false;
+    }
+  }
+
+  if (ok) {
+    result->threads    = threads;
+    result->seconds    = elapsed / 1e9;
+    result->sign_ops   = sign.len;
+    result->verify_ops = verify.len;
+    latencies_percentiles(&sign, result->sign_percentiles);
+    latencies_percentiles(&verify, result->verify_percentiles);
+    /* for the combined mode, one sign+verify pair counts as one operation */
+    const uint64_t ops = options->operation == OP_VERIFY ? verify.len : sign.len;
+    result->ops_per_second = ops / result->seconds;
+    for (unsigned int c = 0; c < COUNTER_MAX; ++c) {
+      result->counters[c] = (counters.values[c] == COUNTER_UNAVAILABLE || !ops)
+                                ? COUNTER_UNAVAILABLE
+                                : counters.values[c] / ops;
+    }
+  }
+
+  free(verify.values);
+  free(sign.values);
+  if (workers) {
+    for (unsigned int i = 0; i < threads; ++i) {
+      free(workers[i].verify.values);
+      free(workers[i].sign.values);
+      memset(&workers[i].sk, 0, sizeof(workers[i].sk));
+    }
+  }
+  free(handles);
+  free(workers);
+  return ok;
+}
+
+static void print_csv(const result_t* results, unsigned int count) {
+  printf("threads,seconds,ops_per_second,efficiency,sign_ops,verify_ops");
+  for (unsigned int i = 0; i < 4; ++i) {
+    printf(",sign_%s_ns", percentile_names[i]);
+  }
+  for (unsigned int i = 0; i < 4; ++i) {
+    printf(",verify_%s_ns", percentile_names[i]);
+  }
+  for (unsigned int c = 0; c < COUNTER_MAX; ++c) {
+    printf(",%s_per_op", counters_name(c));
+  }
+  printf("\n");
+
+  for (unsigned int r = 0; r < count; ++r) {
+    const result_t* res = &results[r];
+    printf("%u,%.3f,%.2f,%.3f,%" PRIu64 ",%" PRIu64, res->threads, res->seconds,
+           res->ops_per_second,
+           res->ops_per_second / (res->threads * results[0].ops_per_second), res->sign_ops,
+           res->verify_ops);
+    for (unsigned int i = 0; i < 4; ++i) {
+      printf(",%" PRIu64, res->sign_percentiles[i]);
+    }
+    for (unsigned int i = 0; i < 4; ++i) {
+      printf(",%" PRIu64, res->verify_percentiles[i]);
+    }
+    for (unsigned int c = 0; c < COUNTER_MAX; ++c) {
+      if (res->counters[c] == COUNTER_UNAVAILABLE) {
+        printf(",n/a");
+      } else {
+        printf(",%" PRIu64, res->counters[c]);
+      }
+    }
+    printf("\n");
+  }
+}
+
+static void print_json_percentiles(const char* name, const uint64_t* values) {
+  printf("\"%s\": {", name);
+  for (unsigned int i = 0; i < 4; ++i) {
+    printf("%s\"%s\": %" PRIu64, i ? ", " : "", percentile_names[i], values[i]);
+  }
+  printf("}");
+}
+
+static void print_json(const throughput_options_t* options, const result_t* results,
+                       unsigned int count) {
+  printf("{\n  \"parameter_set\": \"%s\",\n  \"results\": [\n",
+         picnic_get_param_name(options->params));
+  for (unsigned int r = 0; r < count; ++r) {
+    const result_t* res = &results[r];
+    printf("    {\"threads\": %u, \"seconds\": %.3f, \"ops_per_second\": %.2f, "
+           "\"efficiency\": %.3f, \"sign_ops\": %" PRIu64 ", \"verify_ops\": %" PRIu64 ", ",
+           res->threads, res->seconds, res->ops_per_second,
+           res->ops_per_second / (res->threads * results[0].ops_per_second), res->sign_ops,
+           res->verify_ops);
+    print_json_percentiles("sign_latency_ns", res->sign_percentiles);
+    printf(", ");
+    print_json_percentiles("verify_latency_ns", res->verify_percentiles);
+    printf(", \"counters_per_op\": {");
+    for (unsigned int c = 0; c < COUNTER_MAX; ++c) {
+      printf("%s\"%s\": ", c ? ", " : "", counters_name(c));
+      if (res->counters[c] == COUNTER_UNAVAILABLE) {
+        printf("null");
+      } else {
+        printf("%" PRIu64, res->counters[c]);
+      }
+    }
+    printf("}}%s\n", r + 1 < count ? "," : "");
+  }
+  printf("  ]\n}\n");
+}
+
+static bool parse_uint32_t(uint32_t* value, const char* arg) {
+  errno        = 0;
+  char* end    = NULL;
+  const long v = strtol(arg, &end, 10);
+  if (errno != 0 || end == arg || *end || v < 0 || (unsigned long)v > UINT32_MAX) {
+    return false;
+  }
+  *value = v;
+  return true;
+}
+
+static void print_usage(const char* arg0) {
+  printf("usage: %s [-t threads] [-d duration_ms] [-o sign|verify|both] [-f csv|json] param\n",
+         arg0);
+}
+
+static bool parse_args(throughput_options_t* options, int argc, char** argv) {
+  options->params      = PARAMETER_SET_INVALID;
+  options->threads     = 1;
+  options->duration_ms = 2000;
+  options->operation   = OP_BOTH;
+  options->format      = FORMAT_CSV;
+
+  static const struct option long_options[] = {
+    {"threads", required_argument, NULL, 't'},
+    {"duration", required_argument, NULL, 'd'},
+    {"operation", required_argument, NULL, 'o'},
+    {"format", required_argument, NULL, 'f'},
+    {0, 0, 0, 0}
+  };
+
+  int c            = -1;
+  int option_index = 0;
+  while ((c = getopt_long(argc, argv, "t:d:o:f:", long_options, &option_index)) != -1) {
+    switch (c) {
+    case 't':
+      if (!parse_uint32_t(&options->threads, optarg) || !options->threads) {
+        printf("Invalid number of threads!\n");
+        return false;
+      }
+      break;
+
+    case 'd':
+      if (!parse_uint32_t(&options->duration_ms, optarg) || !options->duration_ms) {
+        printf("Invalid duration!\n");
+        return false;
+      }
+      break;
+
+    case 'o':
+      if (!strcmp(optarg, "sign")) {
+        options->operation = OP_SIGN;
+      } else if (!strcmp(optarg, "verify")) {
+        options->operation = OP_VERIFY;
+      } else if (!strcmp(optarg, "both")) {
+        options->operation = OP_BOTH;
+      } else {
+        printf("Invalid operation!\n");
+        return false;
+      }
+      break;
+
+    case 'f':
+      if (!strcmp(optarg, "csv")) {
+        options->format = FORMAT_CSV;
+      } else if (!strcmp(optarg, "json")) {
+        options->format = FORMAT_JSON;
+      } else {
+        printf("Invalid output format!\n");
+        return false;
+      }
+      break;
+
+    case '?':
+    default:
+      print_usage(argv[0]);
+      return false;
+    }
+  }
+
+  uint32_t p = PARAMETER_SET_INVALID;
+  if (optind != argc - 1 || !parse_uint32_t(&p, argv[optind])) {
+    print_usage(argv[0]);
+    return false;
+  }
+  if (p <= PARAMETER_SET_INVALID || p >= PARAMETER_SET_MAX_INDEX) {
+    printf("Invalid parameter set selected!\n");
+    return false;
+  }
+  options->params = p;
+
+  return true;
+}
+
+int main(int argc, char** argv) {
+  throughput_options_t options;
+  if (!parse_args(&options, argc, argv)) {
+    return -1;
+  }
+
+  if (!picnic_signature_size(options.params)) {
+    printf("Failed to create Picnic instance.\n");
+    return -1;
+  }
+
+  /* run with 1, 2, 4, ... threads up to the requested number to measure scaling */
+  result_t results[sizeof(unsigned int) * CHAR_BIT + 1];
+  unsigned int count = 0;
+  for (unsigned int threads = 1;; threads *= 2) {
+    if (threads > options.threads) {
+      threads = options.threads;
+    }
+    if (!run(&options, threads, &results[count])) {
+      return -1;
+    }
+    ++count;
+    if (threads == options.threads || threads > UINT_MAX / 2) {
+      break;
+    }
+  }
+
+  if (options.format == FORMAT_JSON) {
+    print_json(&options, results, count);
+  } else {
+    print_csv(results, count);
+  }
+
+  return 0;
+}
@@ -13,9 +13,11 @@
 
 #include "bench_timing.h"
 
-#include <time.h>
+#include <inttypes.h>
 #include <limits.h>
+#include <stdio.h>
 #include <string.h>
+#include <time.h>
 
 #if defined(__linux__) && defined(__aarch64__)
 #include <setjmp.h>
@@ -136,6 +138,7 @@ static bool armv8_init(timing_context_t* ctx) {
 #if defined(__linux__)
 #include <linux/perf_event.h>
 #include <linux/version.h>
+#include <sys/ioctl.h>
 #include <sys/types.h>
 #include <sys/syscall.h>
 #include <unistd.h>
@@ -192,8 +195,125 @@ static bool perf_init(timing_context_t* ctx) {
   ctx->data.fd = fd;
   return true;
 }
+
+#define CACHE_MISS_CONFIG(cache)                                                                   \
+  ((cache) | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16))
+
+static const struct {
+  uint32_t type;
+  uint64_t config;
+} counter_events[COUNTER_MAX] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HW_CACHE, CACHE_MISS_CONFIG(PERF_COUNT_HW_CACHE_L1D)},
+    {PERF_TYPE_HW_CACHE, CACHE_MISS_CONFIG(PERF_COUNT_HW_CACHE_LL)},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    {PERF_TYPE_HW_CACHE, CACHE_MISS_CONFIG(PERF_COUNT_HW_CACHE_DTLB)},
+};
+
+bool counters_init(counters_context_t* ctx) {
+  ctx->group_fd     = -1;
+  ctx->num_counters = 0;
+
+  for (unsigned int c = 0; c < COUNTER_MAX; ++c) {
+    ctx->fds[c]   = -1;
+    ctx->index[c] = -1;
+
+    struct perf_event_attr pea;
+    memset(&pea, 0, sizeof(pea));
+
+    pea.size           = sizeof(pea);
+    pea.type           = counter_events[c].type;
+    pea.config         = counter_events[c].config;
+    pea.disabled       = ctx->group_fd == -1 ? 1 : 0;
+    pea.exclude_kernel = 1;
+    pea.exclude_hv     = 1;
+    pea.read_format =
+        PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    const int fd = perf_event_open(&pea, 0, -1, ctx->group_fd, 0);
+    if (fd == -1) {
+      continue;
+    }
+
+    if (ctx->group_fd == -1) {
+      ctx->group_fd = fd;
+    }
+    ctx->fds[c]   = fd;
+    ctx->index[c] = ctx->num_counters++;
+  }
+
+  if (ctx->group_fd == -1) {
+    return false;
+  }
+
+  ioctl(ctx->group_fd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+  ioctl(ctx->group_fd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  return true;
+}
+
+void counters_read(counters_context_t* ctx, counter_values_t* values) {
+  /* layout: number of counters, time enabled, time running, values */
+  uint64_t buffer[3 + COUNTER_MAX];
+
+  const ssize_t expected = (3 + ctx->num_counters) * sizeof(uint64_t);
+  /* if the group could not be scheduled on the PMU, time running is 0 and all values are bogus */
+  const bool valid = ctx->group_fd != -1 && read(ctx->group_fd, buffer, expected) == expected &&
+                     buffer[0] == ctx->num_counters && buffer[2];
+
+  for (unsigned int c = 0; c < COUNTER_MAX; ++c) {
+    values->values[c] =
+        (valid && ctx->index[c] != -1) ? buffer[3 + ctx->index[c]] : COUNTER_UNAVAILABLE;
+  }
+}
+
+void counters_close(counters_context_t* ctx) {
+  for (unsigned int c = 0; c < COUNTER_MAX; ++c) {
+    if (ctx->fds[c] != -1) {
+      close(ctx->fds[c]);
+      ctx->fds[c] = -1;
+    }
+  }
+  ctx->group_fd = -1;
+}
+#else
+bool counters_init(counters_context_t* ctx) {
+  ctx->group_fd     = -1;
+  ctx->num_counters = 0;
+  return false;
+}
+
+void counters_read(counters_context_t* ctx, counter_values_t* values) {
+  (void)ctx;
+  for (unsigned int c = 0; c < COUNTER_MAX; ++c) {
+    values->values[c] = COUNTER_UNAVAILABLE;
+  }
+}
+
+void counters_close(counters_context_t* ctx) {
+  (void)ctx;
+}
 #endif
 
+const char* counters_name(counter_t counter) {
+  static const char* const names[COUNTER_MAX] = {
+      "cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses", "dtlb_misses",
+  };
+  return counter < COUNTER_MAX ? names[counter] : NULL;
+}
+
+void counters_accumulate(counter_values_t* total, const counter_values_t* start,
+                         const counter_values_t* end) {
+  for (unsigned int c = 0; c < COUNTER_MAX; ++c) {
+    if (total->values[c] == COUNTER_UNAVAILABLE || start->values[c] == COUNTER_UNAVAILABLE ||
+        end->values[c] == COUNTER_UNAVAILABLE) {
+      total->values[c] = COUNTER_UNAVAILABLE;
+    } else {
+      total->values[c] += end->values[c] - start->values[c];
+    }
+  }
+}
+
 static void clock_close(timing_context_t* ctx) {
   (void)ctx;
 }
@@ -222,3 +342,24 @@ bool timing_init(timing_context_t* ctx) {
 #endif
   return clock_init(ctx);
 }
+
+void counters_print(const char* operation, const counter_values_t* total, uint64_t operations,
+                    bool header) {
+  if (header) {
+    printf("operation");
+    for (unsigned int c = 0; c < COUNTER_MAX; ++c) {
+      printf(",%s", counters_name(c));
+    }
+    printf("\n");
+  }
+
+  printf("%s", operation);
+  for (unsigned int c = 0; c < COUNTER_MAX; ++c) {
+    if (total->values[c] == COUNTER_UNAVAILABLE || !operations) {
+      printf(",n/a");
+    } else {
+      printf(",%" PRIu64, total->values[c] / operations);
+    }
+  }
+  printf("\n");
+}
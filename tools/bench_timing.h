@@ -37,4 +37,54 @@ static inline void timing_close(timing_context_t* ctx) {
   ctx->close(ctx);
 }
 
+/* hardware performance counters */
+typedef enum {
+  COUNTER_CYCLES,
+  COUNTER_INSTRUCTIONS,
+  COUNTER_L1D_MISSES,
+  COUNTER_LLC_MISSES,
+  COUNTER_BRANCH_MISSES,
+  COUNTER_DTLB_MISSES,
+  COUNTER_MAX,
+} counter_t;
+
+typedef struct {
+  /* COUNTER_UNAVAILABLE if the counter could not be opened or scheduled */
+  uint64_t values[COUNTER_MAX];
+} counter_values_t;
+
+#define COUNTER_UNAVAILABLE UINT64_MAX
+
+typedef struct {
+  int group_fd;
+  int fds[COUNTER_MAX];
+  /* position of the counter in the group read, or -1 */
+  int index[COUNTER_MAX];
+  unsigned int num_counters;
+} counters_context_t;
+
+/**
+ * Open as many of the counters as possible in a single perf event group. Returns false if none of
+ * them are available.
+ */
+bool counters_init(counters_context_t* ctx);
+/**
+ * Read the current value of all counters in the group.
+ */
+void counters_read(counters_context_t* ctx, counter_values_t* values);
+void counters_close(counters_context_t* ctx);
+const char* counters_name(counter_t counter);
+
+/**
+ * Accumulate end - start into total. Unavailable counters stay unavailable.
+ */
+void counters_accumulate(counter_values_t* total, const counter_values_t* start,
+                         const counter_values_t* end);
+/**
+ * Print the per operation averages of the accumulated counters as CSV, optionally preceded by a
+ * header line.
+ */
+void counters_print(const char* operation, const counter_values_t* total, uint64_t operations,
+                    bool header);
+
 #endif
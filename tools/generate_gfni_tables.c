@@ -0,0 +1,317 @@
+/*
+ *  This file is part of the optimized implementation of the Picnic signature scheme.
+ *  See the accompanying documentation for complete details.
+ *
+ *  The code is provided under the MIT license, see LICENSE for
+ *  more details.
+ *  SPDX-License-Identifier: MIT
+ */
+
+/*
+ * Generates lowmc_gfni.c from the LowMC instances, i.e., stores all matrices as 8x8 tiles in the
+ * layout described in lowmc_gfni.h. The tool runs on the build host.
+ */
+
+#include "../lowmc_128_128_20.h"
+#include "../lowmc_129_129_4.h"
+#include "../lowmc_192_192_30.h"
+#include "../lowmc_192_192_4.h"
+#include "../lowmc_255_255_4.h"
+#include "../lowmc_256_256_38.h"
+
+#include <ctype.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+typedef enum {
+  /* n x n matrices */
+  MATRIX_LINEAR,
+  /* precomputed non-linear part of the round keys, one row per key bit */
+  MATRIX_NL_PART,
+  /* 30 x n matrices applied to the output bits of the partial S-box layer */
+  MATRIX_R,
+  /* transposed n x 30 matrices, whose parities form the input bits of the partial S-box layer */
+  MATRIX_Z,
+} matrix_kind_t;
+
+typedef struct {
+  matrix_kind_t kind;
+  /* block size as seen by the matrix multiplications, i.e., 256 for the 255 bit instance */
+  unsigned int n;
+  /* first input byte and number of input bytes */
+  unsigned int in_offset;
+  unsigned int in_bytes;
+  unsigned int out_bytes;
+} shape_t;
+
+static shape_t get_shape(matrix_kind_t kind, unsigned int n) {
+  shape_t shape = {kind, n, 0, n / 8, 0};
+  switch (kind) {
+  case MATRIX_LINEAR:
+    if (n == 129) {
+      /* the first 63 rows are skipped */
+      shape.in_offset = 7;
+      shape.in_bytes  = 17;
+      shape.out_bytes = 24;
+    } else {
+      shape.out_bytes = n / 8;
+    }
+    break;
+  case MATRIX_NL_PART:
+    shape.out_bytes = (n == 128 ? 3 : (n == 192 ? 4 : 5)) * 32;
+    break;
+  case MATRIX_R:
+    /* the 30 bits are stored in the upper part of the last word */
+    shape.in_offset = n / 8 - 4;
+    shape.in_bytes  = 4;
+    shape.out_bytes = n / 8;
+    break;
+  case MATRIX_Z:
+    /* output bit 2 + r of the last 32 bits is the parity of row r */
+    shape.out_bytes = 4;
+    break;
+  }
+  return shape;
+}
+
+/* bit of a row of 128 bit rows (two rows per block) or of rows of the given number of blocks */
+static bool row_bit(const block_t* A, unsigned int n, unsigned int blocks_per_row, unsigned int row,
+                    unsigned int col) {
+  if (n == 128 && blocks_per_row == 1) {
+    return (A[row / 2].w64[2 * (row % 2) + col / 64] >> (col % 64)) & 1;
+  }
+  return (A[row * blocks_per_row + col / 256].w64[(col % 256) / 64] >> (col % 64)) & 1;
+}
+
+/* coefficient of input bit in (of the whole vector) in output bit out (of the output range) */
+static bool matrix_bit(const shape_t* shape, const block_t* A, unsigned int in, unsigned int out) {
+  switch (shape->kind) {
+  case MATRIX_LINEAR:
+    if (shape->n == 129 && in < 63) {
+      return false;
+    }
+    return row_bit(A, shape->n, 1, in, out);
+  case MATRIX_NL_PART:
+    return row_bit(A, shape->n, shape->out_bytes / 32, in, out);
+  case MATRIX_R:
+    return in >= shape->n - 30 && row_bit(A, shape->n, 1, in - (shape->n - 30), out);
+  case MATRIX_Z:
+    return out >= 2 && row_bit(A, shape->n, 1, out - 2, in);
+  }
+  return false;
+}
+
+/* rows of 129 and 192 bit instances have to fit into three words */
+static bool check_matrix(const shape_t* shape, const block_t* A) {
+  unsigned int rows = 0;
+  if (shape->kind == MATRIX_LINEAR && (shape->n == 129 || shape->n == 192)) {
+    rows = 192;
+  } else if (shape->kind == MATRIX_R && shape->n == 192) {
+    rows = 30;
+  }
+
+  for (unsigned int row = shape->n == 129 ? 63 : 0; row < rows; ++row) {
+    if (A[row].w64[3]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static uint64_t compute_tile(const shape_t* shape, const block_t* A, unsigned int in_byte,
+                             unsigned int out_byte) {
+  uint64_t tile = 0;
+  for (unsigned int t = 0; t < 8; ++t) {
+    for (unsigned int i = 0; i < 8; ++i) {
+      if (matrix_bit(shape, A, 8 * in_byte + i, 8 * out_byte + t)) {
+        tile |= UINT64_C(1) << (8 * (7 - t) + i);
+      }
+    }
+  }
+  return tile;
+}
+
+static void print_block(FILE* out, const block_t* block) {
+  fprintf(out,
+          " {{ UINT64_C(0x%016" PRIx64 "), UINT64_C(0x%016" PRIx64 "), UINT64_C(0x%016" PRIx64
+          "), UINT64_C(0x%016" PRIx64 ") }},",
+          block->w64[0], block->w64[1], block->w64[2], block->w64[3]);
+}
+
+static bool print_matrix(FILE* out, const char* prefix, const char* name, matrix_kind_t kind,
+                         unsigned int n, const block_t* A) {
+  const shape_t shape = get_shape(kind, n);
+  if (!check_matrix(&shape, A)) {
+    fprintf(stderr, "%s_%s: matrix does not fit the GFNI layout\n", prefix, name);
+    return false;
+  }
+
+  fprintf(out, "static const block_t %s_%s[] = {\n", prefix, name);
+  for (unsigned int chunk = 0; 32 * chunk < shape.out_bytes; ++chunk) {
+    const unsigned int chunk_bytes =
+        shape.out_bytes - 32 * chunk < 32 ? shape.out_bytes - 32 * chunk : 32;
+    const unsigned int k = chunk_bytes / 4;
+    for (unsigned int b = 0; b < shape.in_bytes; ++b) {
+      fprintf(out, " ");
+      for (unsigned int j = 0; j < k; ++j) {
+        block_t tiles;
+        for (unsigned int l = 0; l < 4; ++l) {
+          tiles.w64[l] = compute_tile(&shape, A, shape.in_offset + b, 32 * chunk + k * l + j);
+        }
+        print_block(out, &tiles);
+      }
+      fprintf(out, "\n");
+    }
+  }
+  fprintf(out, "};\n\n");
+  return true;
+}
+
+static void print_blocks(FILE* out, const char* prefix, const char* name, const block_t* A,
+                         unsigned int count) {
+  fprintf(out, "static const block_t %s_%s[] = {\n ", prefix, name);
+  for (unsigned int i = 0; i < count; ++i) {
+    print_block(out, &A[i]);
+  }
+  fprintf(out, "\n};\n\n");
+}
+
+static void print_guard(FILE* out, const char* name) {
+  fprintf(out, "#if defined(WITH_");
+  for (; *name; ++name) {
+    fputc(toupper((unsigned char)*name), out);
+  }
+  fprintf(out, ")\n");
+}
+
+static bool print_partial(FILE* out, const char* name, const lowmc_partial_t* lowmc, unsigned int n,
+                          unsigned int r) {
+  char buffer[32];
+
+  print_guard(out, name);
+  bool ret = print_matrix(out, name, "k0_matrix", MATRIX_LINEAR, n, lowmc->k0_matrix) &&
+             print_matrix(out, name, "zr_matrix", MATRIX_LINEAR, n, lowmc->zr_matrix) &&
+             print_matrix(out, name, "precomputed_non_linear_part_matrix", MATRIX_NL_PART, n,
+                          lowmc->precomputed_non_linear_part_matrix);
+  for (unsigned int i = 0; ret && i < r && lowmc->rounds[i].z_matrix; ++i) {
+    snprintf(buffer, sizeof(buffer), "Z_%u", i);
+    ret = print_matrix(out, name, buffer, MATRIX_Z, n, lowmc->rounds[i].z_matrix);
+    snprintf(buffer, sizeof(buffer), "R_%u", i);
+    ret = ret && print_matrix(out, name, buffer, MATRIX_R, n, lowmc->rounds[i].r_matrix);
+  }
+  if (!ret) {
+    return false;
+  }
+  print_blocks(out, name, "precomputed_constant_linear", lowmc->precomputed_constant_linear, 1);
+  print_blocks(out, name, "precomputed_constant_non_linear",
+               lowmc->precomputed_constant_non_linear, (r * 32 + 255) / 256);
+
+  fprintf(out, "static const lowmc_partial_round_t %s_rounds[%u] = {\n", name, r);
+  for (unsigned int i = 0; i < r; ++i) {
+    if (lowmc->rounds[i].z_matrix) {
+      fprintf(out, "  {%s_Z_%u, %s_R_%u, UINT64_C(0x%016" PRIx64 ")},\n", name, i, name, i,
+              lowmc->rounds[i].r_mask);
+    } else {
+      fprintf(out, "  {NULL, NULL, 0},\n");
+    }
+  }
+  fprintf(out, "};\n\n");
+
+  fprintf(out, "const lowmc_partial_t %s_gfni = {\n", name);
+  fprintf(out, "  %s_k0_matrix,\n  %s_zr_matrix,\n  %s_rounds,\n", name, name, name);
+  fprintf(out, "  %s_precomputed_non_linear_part_matrix,\n", name);
+  fprintf(out, "  %s_precomputed_constant_linear,\n", name);
+  fprintf(out, "  %s_precomputed_constant_non_linear,\n};\n#endif\n\n", name);
+  return true;
+}
+
+static bool print_full(FILE* out, const char* name, const lowmc_t* lowmc, unsigned int n,
+                       unsigned int r) {
+  char buffer[32];
+
+  /* the round key matrices are shared with the rounds */
+  if (lowmc->k_matrices[0] != lowmc->k0_matrix) {
+    fprintf(stderr, "%s: K_0 is not shared\n", name);
+    return false;
+  }
+  for (unsigned int i = 0; i < r; ++i) {
+    if (lowmc->k_matrices[i + 1] != lowmc->rounds[i].k_matrix) {
+      fprintf(stderr, "%s: K_%u is not shared\n", name, i + 1);
+      return false;
+    }
+  }
+
+  print_guard(out, name);
+  bool ret = print_matrix(out, name, "Ki_0", MATRIX_LINEAR, n, lowmc->ki0_matrix);
+  for (unsigned int i = 0; ret && i <= r; ++i) {
+    snprintf(buffer, sizeof(buffer), "K_%u", i);
+    ret = print_matrix(out, name, buffer, MATRIX_LINEAR, n, lowmc->k_matrices[i]);
+  }
+  for (unsigned int i = 0; ret && i < r; ++i) {
+    snprintf(buffer, sizeof(buffer), "L_%u", i);
+    ret = print_matrix(out, name, buffer, MATRIX_LINEAR, n, lowmc->rounds[i].l_matrix);
+    snprintf(buffer, sizeof(buffer), "Li_%u", i);
+    ret = ret && print_matrix(out, name, buffer, MATRIX_LINEAR, n, lowmc->rounds[i].li_matrix);
+  }
+  if (!ret) {
+    return false;
+  }
+  for (unsigned int i = 0; i < r; ++i) {
+    snprintf(buffer, sizeof(buffer), "C_%u", i);
+    print_blocks(out, name, buffer, lowmc->rounds[i].constant, 1);
+  }
+
+  fprintf(out, "static const lowmc_round_t %s_rounds[%u] = {\n", name, r);
+  for (unsigned int i = 0; i < r; ++i) {
+    fprintf(out, "  {%s_K_%u, %s_L_%u, %s_Li_%u, %s_C_%u},\n", name, i + 1, name, i, name, i, name,
+            i);
+  }
+  fprintf(out, "};\n\n");
+
+  fprintf(out, "static const mzd_local_t* const %s_k_matrices[%u] = {", name, r + 1);
+  for (unsigned int i = 0; i <= r; ++i) {
+    fprintf(out, "%s%s_K_%u", i ? ", " : "", name, i);
+  }
+  fprintf(out, "};\n\n");
+
+  fprintf(out, "const lowmc_t %s_gfni = {\n", name);
+  fprintf(out, "  %s_K_0,\n  %s_Ki_0,\n  %s_rounds,\n  %s_k_matrices,\n};\n#endif\n\n", name, name,
+          name, name);
+  return true;
+}
+
+int main(int argc, char** argv) {
+  if (argc != 2) {
+    printf("usage: %s output\n", argv[0]);
+    return 1;
+  }
+
+  FILE* out = fopen(argv[1], "w");
+  if (!out) {
+    perror("fopen");
+    return 1;
+  }
+
+  fprintf(out, "/* This file is generated by tools/generate_gfni_tables.c. Do not edit. */\n\n");
+  fprintf(out, "#ifdef HAVE_CONFIG_H\n#include <config.h>\n#endif\n\n");
+  fprintf(out, "#include <stddef.h>\n\n#include \"lowmc_gfni.h\"\n\n");
+
+  const bool ret =
+      print_partial(out, "lowmc_128_128_20", &lowmc_128_128_20, LOWMC_128_128_20_N,
+                    LOWMC_128_128_20_R) &&
+      print_full(out, "lowmc_129_129_4", &lowmc_129_129_4, LOWMC_129_129_4_N, LOWMC_129_129_4_R) &&
+      print_partial(out, "lowmc_192_192_30", &lowmc_192_192_30, LOWMC_192_192_30_N,
+                    LOWMC_192_192_30_R) &&
+      print_full(out, "lowmc_192_192_4", &lowmc_192_192_4, LOWMC_192_192_4_N, LOWMC_192_192_4_R) &&
+      print_full(out, "lowmc_255_255_4", &lowmc_255_255_4, 256, LOWMC_255_255_4_R) &&
+      print_partial(out, "lowmc_256_256_38", &lowmc_256_256_38, LOWMC_256_256_38_N,
+                    LOWMC_256_256_38_R);
+
+  if (fclose(out) || !ret) {
+    remove(argv[1]);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,600 @@
+/*
+ *  This file is part of the optimized implementation of the Picnic signature scheme.
+ *  See the accompanying documentation for complete details.
+ *
+ *  The code is provided under the MIT license, see LICENSE for
+ *  more details.
+ *  SPDX-License-Identifier: MIT
+ */
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+/* struct ucred */
+#define _GNU_SOURCE
+#endif
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "picnic.h"
+#include "signd_protocol.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#define MAX_KEYS 64
+/* requests of a connection in flight before the daemon stops reading from it */
+#define MAX_OUTSTANDING 256
+/* pending response bytes of a connection before the daemon stops reading from it */
+#define MAX_PENDING_OUTPUT (4 << 20)
+/* buffered request bytes of a connection before the daemon stops reading from it */
+#define MAX_PENDING_INPUT (4 + SIGND_MAX_FRAME_SIZE)
+
+typedef struct {
+  picnic_privatekey_t sk;
+  picnic_publickey_t pk;
+} signd_key_t;
+
+typedef struct {
+  uint8_t* data;
+  size_t len;
+  size_t capacity;
+} buffer_t;
+
+typedef struct {
+  int fd;
+  buffer_t in;
+  buffer_t out;
+  /* bytes of out already sent */
+  size_t sent;
+  unsigned int outstanding;
+  /* the peer sent all its requests; released once all responses are sent */
+  bool eof;
+  /* an error occurred; released once outstanding is 0 */
+  bool closed;
+} connection_t;
+
+typedef struct {
+  picnic_job_t job;
+  connection_t* connection;
+  uint32_t id;
+  /* copy of the message and the signature */
+  uint8_t data[];
+} request_t;
+
+typedef struct {
+  const char* socket_path;
+  /* user allowed to connect in addition to the one running the daemon */
+  uid_t allowed_uid;
+  bool has_allowed_uid;
+  unsigned int threads;
+  signd_key_t keys[MAX_KEYS];
+  unsigned int num_keys;
+} signd_options_t;
+
+static volatile sig_atomic_t stop;
+
+static void handle_signal(int sig) {
+  (void)sig;
+  stop = 1;
+}
+
+/* memset through a volatile pointer is not removed, even if the memory is not read afterwards */
+static void* (*const volatile scrub_memset)(void*, int, size_t) = memset;
+
+static void scrub(void* ptr, size_t len) {
+  scrub_memset(ptr, 0, len);
+}
+
+static bool buffer_reserve(buffer_t* buffer, size_t size) {
+  if (buffer->len + size <= buffer->capacity) {
+    return true;
+  }
+
+  size_t capacity = buffer->capacity ? buffer->capacity : 4096;
+  while (capacity < buffer->len + size) {
+    capacity *= 2;
+  }
+  uint8_t* data = realloc(buffer->data, capacity);
+  if (!data) {
+    return false;
+  }
+  buffer->data     = data;
+  buffer->capacity = capacity;
+  return true;
+}
+
+static void respond(connection_t* connection, uint32_t id, uint8_t status, const uint8_t* body,
+                    size_t body_len) {
+  if (connection->closed) {
+    return;
+  }
+  if (!buffer_reserve(&connection->out, SIGND_RESPONSE_HEADER_SIZE + body_len)) {
+    connection->closed = true;
+    return;
+  }
+
+  uint8_t* dst = connection->out.data + connection->out.len;
+  signd_put_u32(dst, SIGND_RESPONSE_HEADER_SIZE - 4 + body_len);
+  signd_put_u32(dst + 4, id);
+  dst[8] = status;
+  if (body_len) {
+    memcpy(dst + SIGND_RESPONSE_HEADER_SIZE, body, body_len);
+  }
+  connection->out.len += SIGND_RESPONSE_HEADER_SIZE + body_len;
+}
+
+static void complete(picnic_job_t* job) {
+  request_t* request        = job->opaque;
+  connection_t* connection  = request->connection;
+  const uint8_t status      = job->result ? SIGND_STATUS_FAILED : SIGND_STATUS_OK;
+  const bool with_signature = !job->result && job->sk;
+
+  respond(connection, request->id, status, with_signature ? job->signature : NULL,
+          with_signature ? job->signature_len : 0);
+  --connection->outstanding;
+  free(request);
+}
+
+static void handle_request(const signd_options_t* options, picnic_executor_t* executor,
+                           connection_t* connection, const uint8_t* frame, size_t frame_len) {
+  const uint32_t id     = signd_get_u32(frame);
+  const uint8_t op      = frame[4];
+  const uint16_t key    = signd_get_u16(frame + 5);
+  const uint8_t* body   = frame + SIGND_REQUEST_HEADER_SIZE - 4;
+  const size_t body_len = frame_len - (SIGND_REQUEST_HEADER_SIZE - 4);
+
+  if (key >= options->num_keys) {
+    respond(connection, id, SIGND_STATUS_BAD_REQUEST, NULL, 0);
+    return;
+  }
+
+  request_t* request = NULL;
+  if (op == SIGND_OP_SIGN) {
+    const size_t max_signature_size = picnic_signature_size(options->keys[key].sk.data[0]);
+    request                         = malloc(sizeof(request_t) + body_len + max_signature_size);
+    if (request) {
+      memset(&request->job, 0, sizeof(request->job));
+      memcpy(request->data, body, body_len);
+      request->job.sk            = &options->keys[key].sk;
+      request->job.message       = request->data;
+      request->job.message_len   = body_len;
+      request->job.signature     = request->data + body_len;
+      request->job.signature_len = max_signature_size;
+    }
+  } else if (op == SIGND_OP_VERIFY && body_len >= 4 && signd_get_u32(body) <= body_len - 4) {
+    const size_t signature_len = signd_get_u32(body);
+    request                    = malloc(sizeof(request_t) + body_len - 4);
+    if (request) {
+      memset(&request->job, 0, sizeof(request->job));
+      memcpy(request->data, body + 4, body_len - 4);
+      request->job.pk            = &options->keys[key].pk;
+      request->job.signature     = request->data;
+      request->job.signature_len = signature_len;
+      request->job.message       = request->data + signature_len;
+      request->job.message_len   = body_len - 4 - signature_len;
+    }
+  } else {
+    respond(connection, id, SIGND_STATUS_BAD_REQUEST, NULL, 0);
+    return;
+  }
+  if (!request) {
+    respond(connection, id, SIGND_STATUS_FAILED, NULL, 0);
+    return;
+  }
+
+  request->connection = connection;
+  request->id         = id;
+  request->job.opaque = request;
+  const int ret = op == SIGND_OP_SIGN ? picnic_submit_sign(executor, &request->job, complete)
+                                      : picnic_submit_verify(executor, &request->job, complete);
+  if (ret) {
+    respond(connection, id, SIGND_STATUS_FAILED, NULL, 0);
+    free(request);
+    return;
+  }
+  ++connection->outstanding;
+}
+
+/* read the available data up to MAX_PENDING_INPUT bytes */
+static void read_requests(connection_t* connection) {
+  while (connection->in.len < MAX_PENDING_INPUT) {
+    if (!buffer_reserve(&connection->in, 64 * 1024)) {
+      connection->closed = true;
+      return;
+    }
+    size_t size = connection->in.capacity - connection->in.len;
+    if (size > MAX_PENDING_INPUT - connection->in.len) {
+      size = MAX_PENDING_INPUT - connection->in.len;
+    }
+    const ssize_t ret = read(connection->fd, connection->in.data + connection->in.len, size);
+    if (ret < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+      connection->closed = true;
+      return;
+    }
+    if (ret == 0) {
+      /* answer the requests received so far */
+      connection->eof = true;
+      break;
+    }
+    if (ret < 0) {
+      break;
+    }
+    connection->in.len += ret;
+  }
+}
+
+/* submit the complete requests until MAX_OUTSTANDING requests are in flight */
+static void submit_requests(const signd_options_t* options, picnic_executor_t* executor,
+                            connection_t* connection) {
+  size_t pos = 0;
+  while (!connection->closed && connection->outstanding < MAX_OUTSTANDING &&
+         connection->in.len - pos >= 4) {
+    const uint32_t frame_len = signd_get_u32(connection->in.data + pos);
+    if (frame_len < SIGND_REQUEST_HEADER_SIZE - 4 || frame_len > SIGND_MAX_FRAME_SIZE) {
+      connection->closed = true;
+      return;
+    }
+    if (connection->in.len - pos - 4 < frame_len) {
+      break;
+    }
+    handle_request(options, executor, connection, connection->in.data + pos + 4, frame_len);
+    pos += 4 + frame_len;
+  }
+  if (pos) {
+    memmove(connection->in.data, connection->in.data + pos, connection->in.len - pos);
+    connection->in.len -= pos;
+  }
+}
+
+static void write_responses(connection_t* connection) {
+  while (!connection->closed && connection->sent < connection->out.len) {
+    const ssize_t ret = send(connection->fd, connection->out.data + connection->sent,
+                             connection->out.len - connection->sent, MSG_NOSIGNAL);
+    if (ret < 0) {
+      if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+        connection->closed = true;
+      }
+      break;
+    }
+    connection->sent += ret;
+  }
+  if (connection->sent == connection->out.len) {
+    connection->out.len = 0;
+    connection->sent    = 0;
+  }
+}
+
+static void free_connection(connection_t* connection) {
+  close(connection->fd);
+  free(connection->out.data);
+  free(connection->in.data);
+  free(connection);
+}
+
+/* only the user running the daemon and the allowed user may connect */
+static bool peer_allowed(const signd_options_t* options, int fd) {
+#if defined(__linux__)
+  struct ucred cred;
+  socklen_t len = sizeof(cred);
+  if (getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &cred, &len)) {
+    return false;
+  }
+  const uid_t uid = cred.uid;
+#else
+  uid_t uid;
+  gid_t gid;
+  if (getpeereid(fd, &uid, &gid)) {
+    return false;
+  }
+#endif
+  return uid == geteuid() || (options->has_allowed_uid && uid == options->allowed_uid);
+}
+
+static int listen_on(const char* path) {
+  struct sockaddr_un addr;
+  if (strlen(path) >= sizeof(addr.sun_path)) {
+    printf("Socket path too long.\n");
+    return -1;
+  }
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strcpy(addr.sun_path, path);
+
+  /* only replace a stale socket, never any other file */
+  struct stat st;
+  if (!lstat(path, &st)) {
+    if (!S_ISSOCK(st.st_mode)) {
+      printf("%s exists and is not a socket.\n", path);
+      return -1;
+    }
+    unlink(path);
+  }
+
+  const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0) {
+    return -1;
+  }
+  /* the socket is only accessible by the user running the daemon */
+  const mode_t mask = umask(077);
+  const int ret     = bind(fd, (struct sockaddr*)&addr, sizeof(addr));
+  umask(mask);
+  if (ret || listen(fd, 128) || fcntl(fd, F_SETFL, O_NONBLOCK)) {
+    printf("Failed to listen on %s: %s\n", path, strerror(errno));
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+static int serve(const signd_options_t* options) {
+  picnic_executor_t* executor = picnic_executor_create(options->threads);
+  if (!executor) {
+    printf("Failed to create executor.\n");
+    return -1;
+  }
+  const int listen_fd = listen_on(options->socket_path);
+  if (listen_fd < 0) {
+    picnic_executor_destroy(executor);
+    return -1;
+  }
+
+  connection_t** connections = NULL;
+  struct pollfd* pfds        = NULL;
+  size_t num_connections     = 0;
+  int ret                    = 0;
+
+  while (!stop) {
+    /* the descriptors are rebuilt after each iteration, since connections come and go */
+    struct pollfd* new_pfds = realloc(pfds, (num_connections + 2) * sizeof(struct pollfd));
+    if (!new_pfds) {
+      ret = -1;
+      break;
+    }
+    pfds       = new_pfds;
+    pfds[0].fd = listen_fd;
+    pfds[1].fd = picnic_executor_fd(executor);
+    pfds[0].events = pfds[1].events = POLLIN;
+    for (size_t i = 0; i < num_connections; ++i) {
+      connection_t* connection = connections[i];
+      pfds[i + 2].fd           = connection->fd;
+      pfds[i + 2].events       = 0;
+      if (!connection->closed && !connection->eof && connection->outstanding < MAX_OUTSTANDING &&
+          connection->in.len < MAX_PENDING_INPUT &&
+          connection->out.len - connection->sent < MAX_PENDING_OUTPUT) {
+        pfds[i + 2].events |= POLLIN;
+      }
+      if (!connection->closed && connection->sent < connection->out.len) {
+        pfds[i + 2].events |= POLLOUT;
+      }
+      if (!pfds[i + 2].events) {
+        /* a hung up peer would be reported over and over */
+        pfds[i + 2].fd = -1;
+      }
+    }
+
+    if (poll(pfds, num_connections + 2, -1) < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      ret = -1;
+      break;
+    }
+
+    /* submit all requests that arrived before handing completed jobs back, so that concurrent
+     * requests are queued together */
+    for (size_t i = 0; i < num_connections; ++i) {
+      if (pfds[i + 2].revents & (POLLIN | POLLHUP | POLLERR)) {
+        read_requests(connections[i]);
+      }
+      submit_requests(options, executor, connections[i]);
+    }
+    if (pfds[1].revents & POLLIN) {
+      picnic_executor_dispatch(executor);
+      /* requests held back while MAX_OUTSTANDING requests were in flight */
+      for (size_t i = 0; i < num_connections; ++i) {
+        submit_requests(options, executor, connections[i]);
+      }
+    }
+
+    size_t kept = 0;
+    for (size_t i = 0; i < num_connections; ++i) {
+      connection_t* connection = connections[i];
+      write_responses(connection);
+      const bool done = connection->closed || (connection->eof && !connection->out.len);
+      if (done && !connection->outstanding) {
+        free_connection(connection);
+      } else {
+        connections[kept++] = connection;
+      }
+    }
+    num_connections = kept;
+
+    if (pfds[0].revents & POLLIN) {
+      for (;;) {
+        const int fd = accept(listen_fd, NULL, NULL);
+        if (fd < 0) {
+          break;
+        }
+        connection_t* connection = calloc(1, sizeof(connection_t));
+        connection_t** new_connections =
+            realloc(connections, (num_connections + 1) * sizeof(connection_t*));
+        if (!connection || !new_connections || !peer_allowed(options, fd) ||
+            fcntl(fd, F_SETFL, O_NONBLOCK)) {
+          free(connection);
+          if (new_connections) {
+            connections = new_connections;
+          }
+          close(fd);
+          continue;
+        }
+        connection->fd                 = fd;
+        connections                    = new_connections;
+        connections[num_connections++] = connection;
+      }
+    }
+  }
+
+  /* completes all outstanding jobs, whose callbacks still refer to the connections */
+  picnic_executor_destroy(executor);
+  for (size_t i = 0; i < num_connections; ++i) {
+    free_connection(connections[i]);
+  }
+  free(connections);
+  free(pfds);
+  close(listen_fd);
+  unlink(options->socket_path);
+  return ret;
+}
+
+static bool parse_uint32_t(uint32_t* value, const char* arg) {
+  errno        = 0;
+  char* end    = NULL;
+  const long v = strtol(arg, &end, 10);
+  if (errno != 0 || end == arg || *end || v < 0 || (unsigned long)v > UINT32_MAX) {
+    return false;
+  }
+  *value = v;
+  return true;
+}
+
+/* the file holds a private key as written by picnic_write_private_key */
+static bool load_key(signd_key_t* key, const char* path) {
+  uint8_t buf[PICNIC_MAX_PRIVATEKEY_SIZE];
+  FILE* file = fopen(path, "rb");
+  if (!file) {
+    return false;
+  }
+  const size_t len = fread(buf, 1, sizeof(buf), file);
+  fclose(file);
+
+  const bool ok = !picnic_read_private_key(&key->sk, buf, len) &&
+                 !picnic_sk_to_pk(&key->sk, &key->pk) &&
+                 !picnic_validate_keypair(&key->sk, &key->pk);
+  scrub(buf, sizeof(buf));
+  return ok;
+}
+
+static void print_usage(const char* arg0) {
+  printf("usage: %s [-s socket] [-u uid] [-t threads] (-k private_key_file | -g param)...\n",
+         arg0);
+}
+
+static bool parse_args(signd_options_t* options, int argc, char** argv) {
+  options->socket_path     = "picnic-signd.sock";
+  options->has_allowed_uid = false;
+  options->threads         = 0;
+  options->num_keys        = 0;
+
+  static const struct option long_options[] = {
+    {"socket", required_argument, NULL, 's'},
+    {"allow-uid", required_argument, NULL, 'u'},
+    {"threads", required_argument, NULL, 't'},
+    {"key", required_argument, NULL, 'k'},
+    {"generate", required_argument, NULL, 'g'},
+    {0, 0, 0, 0}
+  };
+
+  int c            = -1;
+  int option_index = 0;
+  while ((c = getopt_long(argc, argv, "s:u:t:k:g:", long_options, &option_index)) != -1) {
+    switch (c) {
+    case 's':
+      options->socket_path = optarg;
+      break;
+
+    case 'u': {
+      uint32_t uid = 0;
+      if (!parse_uint32_t(&uid, optarg)) {
+        printf("Invalid user id!\n");
+        return false;
+      }
+      options->allowed_uid     = uid;
+      options->has_allowed_uid = true;
+      break;
+    }
+
+    case 't':
+      if (!parse_uint32_t(&options->threads, optarg)) {
+        printf("Invalid number of threads!\n");
+        return false;
+      }
+      break;
+
+    case 'k':
+    case 'g': {
+      if (options->num_keys == MAX_KEYS) {
+        printf("Too many keys!\n");
+        return false;
+      }
+      signd_key_t* key = &options->keys[options->num_keys];
+      uint32_t p = PARAMETER_SET_INVALID;
+      if (c == 'k' && !load_key(key, optarg)) {
+        printf("Failed to load private key from %s!\n", optarg);
+        return false;
+      }
+      if (c == 'g' && (!parse_uint32_t(&p, optarg) || p <= PARAMETER_SET_INVALID ||
+                       p >= PARAMETER_SET_MAX_INDEX || picnic_keygen(p, &key->pk, &key->sk))) {
+        printf("Failed to generate a key for parameter set %s!\n", optarg);
+        return false;
+      }
+      printf("key %u: %s\n", options->num_keys, picnic_get_param_name(key->sk.data[0]));
+      ++options->num_keys;
+      break;
+    }
+
+    case '?':
+    default:
+      print_usage(argv[0]);
+      return false;
+    }
+  }
+
+  if (optind != argc || !options->num_keys) {
+    print_usage(argv[0]);
+    return false;
+  }
+  return true;
+}
+
+int main(int argc, char** argv) {
+  signd_options_t options;
+  if (!parse_args(&options, argc, argv)) {
+    return -1;
+  }
+
+  struct sigaction sa;
+  memset(&sa, 0, sizeof(sa));
+  sa.sa_handler = handle_signal;
+  sigaction(SIGINT, &sa, NULL);
+  sigaction(SIGTERM, &sa, NULL);
+
+  /* pay the start-up costs of the instances before the first request */
+  uint32_t params_mask = 0;
+  for (unsigned int i = 0; i < options.num_keys; ++i) {
+    params_mask |= PICNIC_PARAMS_MASK(options.keys[i].sk.data[0]);
+  }
+  picnic_init(params_mask, PICNIC_INIT_ADVISE | PICNIC_INIT_PREFAULT | PICNIC_INIT_WARMUP);
+
+  printf("listening on %s\n", options.socket_path);
+  fflush(stdout);
+  const int ret = serve(&options);
+
+  for (unsigned int i = 0; i < options.num_keys; ++i) {
+    scrub(&options.keys[i].sk, sizeof(options.keys[i].sk));
+  }
+  return ret;
+}
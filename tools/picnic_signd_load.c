@@ -0,0 +1,491 @@
+/*
+ *  This file is part of the optimized implementation of the Picnic signature scheme.
+ *  See the accompanying documentation for complete details.
+ *
+ *  The code is provided under the MIT license, see LICENSE for
+ *  more details.
+ *  SPDX-License-Identifier: MIT
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "signd_protocol.h"
+
+#include <errno.h>
+#include <getopt.h>
+#include <inttypes.h>
+#include <poll.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+#define MAX_DEPTH 1024
+
+typedef struct {
+  const char* socket_path;
+  unsigned int connections;
+  unsigned int depth;
+  unsigned int duration_ms;
+  uint8_t op;
+  uint16_t key;
+  uint32_t message_len;
+} load_options_t;
+
+typedef struct {
+  uint8_t* data;
+  size_t len;
+  size_t capacity;
+} buffer_t;
+
+typedef struct {
+  int fd;
+  buffer_t in;
+  buffer_t out;
+  size_t sent;
+  /* send time of the request in flight in each slot, 0 if the slot is free */
+  uint64_t started[MAX_DEPTH];
+  uint16_t generation[MAX_DEPTH];
+  unsigned int outstanding;
+} connection_t;
+
+/* latencies of all requests, in nanoseconds */
+typedef struct {
+  uint64_t* values;
+  size_t len, capacity;
+} latencies_t;
+
+static const double percentiles[4]           = {50, 90, 99, 99.9};
+static const char* const percentile_names[4] = {"p50", "p90", "p99", "p99.9"};
+
+static uint64_t time_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * UINT64_C(1000000000) + ts.tv_nsec;
+}
+
+static bool buffer_reserve(buffer_t* buffer, size_t size) {
+  if (buffer->len + size <= buffer->capacity) {
+    return true;
+  }
+
+  size_t capacity = buffer->capacity ? buffer->capacity : 4096;
+  while (capacity < buffer->len + size) {
+    capacity *= 2;
+  }
+  uint8_t* data = realloc(buffer->data, capacity);
+  if (!data) {
+    return false;
+  }
+  buffer->data     = data;
+  buffer->capacity = capacity;
+  return true;
+}
+
+static bool latencies_push(latencies_t* lat, uint64_t value) {
+  if (lat->len == lat->capacity) {
+    const size_t capacity = lat->capacity ? 2 * lat->capacity : 1024;
+    uint64_t* values      = realloc(lat->values, capacity * sizeof(uint64_t));
+    if (!values) {
+      return false;
+    }
+    lat->values   = values;
+    lat->capacity = capacity;
+  }
+  lat->values[lat->len++] = value;
+  return true;
+}
+
+static int compare_uint64(const void* lhs, const void* rhs) {
+  const uint64_t l = *(const uint64_t*)lhs;
+  const uint64_t r = *(const uint64_t*)rhs;
+  return (l > r) - (l < r);
+}
+
+static void latencies_percentiles(latencies_t* lat, uint64_t* dst) {
+  if (!lat->len) {
+    memset(dst, 0, sizeof(percentiles) / sizeof(percentiles[0]) * sizeof(uint64_t));
+    return;
+  }
+
+  qsort(lat->values, lat->len, sizeof(uint64_t), compare_uint64);
+  for (unsigned int i = 0; i < sizeof(percentiles) / sizeof(percentiles[0]); ++i) {
+    /* nearest-rank method */
+    size_t rank = (size_t)((percentiles[i] / 100) * lat->len + 0.999999);
+    if (rank) {
+      --rank;
+    }
+    dst[i] = lat->values[rank < lat->len ? rank : lat->len - 1];
+  }
+}
+
+static int connect_to(const char* path) {
+  struct sockaddr_un addr;
+  if (strlen(path) >= sizeof(addr.sun_path)) {
+    return -1;
+  }
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strcpy(addr.sun_path, path);
+
+  const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0) {
+    return -1;
+  }
+  if (connect(fd, (struct sockaddr*)&addr, sizeof(addr))) {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+/* append a request with the given body to the output of the connection */
+static bool queue_request(connection_t* connection, uint32_t id, uint8_t op, uint16_t key,
+                          const uint8_t* body, size_t body_len) {
+  if (!buffer_reserve(&connection->out, SIGND_REQUEST_HEADER_SIZE + body_len)) {
+    return false;
+  }
+
+  uint8_t* dst = connection->out.data + connection->out.len;
+  signd_put_u32(dst, SIGND_REQUEST_HEADER_SIZE - 4 + body_len);
+  signd_put_u32(dst + 4, id);
+  dst[8] = op;
+  signd_put_u16(dst + 9, key);
+  memcpy(dst + SIGND_REQUEST_HEADER_SIZE, body, body_len);
+  connection->out.len += SIGND_REQUEST_HEADER_SIZE + body_len;
+  return true;
+}
+
+static bool write_requests(connection_t* connection) {
+  while (connection->sent < connection->out.len) {
+    const ssize_t ret = send(connection->fd, connection->out.data + connection->sent,
+                             connection->out.len - connection->sent, MSG_NOSIGNAL);
+    if (ret < 0) {
+      return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+    }
+    connection->sent += ret;
+  }
+  connection->out.len = 0;
+  connection->sent    = 0;
+  return true;
+}
+
+/* read one complete response; returns the length of its frame, 0 if none is available yet */
+static size_t next_response(connection_t* connection, bool block) {
+  for (;;) {
+    if (connection->in.len >= 4) {
+      const uint32_t frame_len = signd_get_u32(connection->in.data);
+      if (frame_len < SIGND_RESPONSE_HEADER_SIZE - 4 || frame_len > SIGND_MAX_FRAME_SIZE) {
+        return SIZE_MAX;
+      }
+      if (connection->in.len - 4 >= frame_len) {
+        return 4 + frame_len;
+      }
+    }
+    if (!buffer_reserve(&connection->in, 64 * 1024)) {
+      return SIZE_MAX;
+    }
+    const ssize_t ret = recv(connection->fd, connection->in.data + connection->in.len,
+                             connection->in.capacity - connection->in.len, block ? 0 : MSG_DONTWAIT);
+    if (ret == 0) {
+      return SIZE_MAX;
+    }
+    if (ret < 0) {
+      return (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) ? 0 : SIZE_MAX;
+    }
+    connection->in.len += ret;
+  }
+}
+
+static void consume_response(connection_t* connection, size_t len) {
+  memmove(connection->in.data, connection->in.data + len, connection->in.len - len);
+  connection->in.len -= len;
+}
+
+static bool send_next(const load_options_t* options, connection_t* connection, unsigned int slot,
+                      const uint8_t* body, size_t body_len) {
+  const uint32_t id           = (uint32_t)++connection->generation[slot] << 16 | slot;
+  connection->started[slot] = time_ns();
+  ++connection->outstanding;
+  return queue_request(connection, id, options->op, options->key, body, body_len);
+}
+
+static bool run(const load_options_t* options, const uint8_t* body, size_t body_len) {
+  connection_t* connections = calloc(options->connections, sizeof(connection_t));
+  struct pollfd* pfds       = calloc(options->connections, sizeof(struct pollfd));
+  latencies_t latencies     = {NULL, 0, 0};
+  uint64_t failed           = 0;
+  bool ok                   = connections && pfds;
+
+  for (unsigned int i = 0; ok && i < options->connections; ++i) {
+    connections[i].fd = connect_to(options->socket_path);
+    if (connections[i].fd < 0) {
+      printf("Failed to connect to %s.\n", options->socket_path);
+      ok = false;
+    }
+    for (unsigned int slot = 0; ok && slot < options->depth; ++slot) {
+      ok = send_next(options, &connections[i], slot, body, body_len);
+    }
+  }
+
+  const uint64_t start = time_ns();
+  const uint64_t end   = start + (uint64_t)options->duration_ms * 1000000;
+  size_t outstanding   = ok ? options->connections * options->depth : 0;
+  while (ok && outstanding) {
+    const bool sending = time_ns() < end;
+    for (unsigned int i = 0; i < options->connections; ++i) {
+      pfds[i].fd     = connections[i].fd;
+      pfds[i].events = POLLIN | (connections[i].out.len ? POLLOUT : 0);
+    }
+    if (poll(pfds, options->connections, 1000) < 0 && errno != EINTR) {
+      ok = false;
+      break;
+    }
+
+    for (unsigned int i = 0; ok && i < options->connections; ++i) {
+      connection_t* connection = &connections[i];
+      if (pfds[i].revents & POLLOUT) {
+        ok = write_requests(connection);
+      }
+      if (!(pfds[i].revents & (POLLIN | POLLHUP | POLLERR))) {
+        continue;
+      }
+
+      size_t len;
+      while (ok && (len = next_response(connection, false)) != 0) {
+        if (len == SIZE_MAX) {
+          printf("Connection closed by the daemon.\n");
+          ok = false;
+          break;
+        }
+        const uint32_t id       = signd_get_u32(connection->in.data + 4);
+        const unsigned int slot = id & 0xffff;
+        if (slot >= options->depth || (id >> 16) != connection->generation[slot] ||
+            !connection->started[slot]) {
+          printf("Unexpected response.\n");
+          ok = false;
+          break;
+        }
+        if (connection->in.data[8] != SIGND_STATUS_OK) {
+          ++failed;
+        }
+        ok = latencies_push(&latencies, time_ns() - connection->started[slot]);
+        consume_response(connection, len);
+        connection->started[slot] = 0;
+        --connection->outstanding;
+        --outstanding;
+        if (ok && sending) {
+          ok = send_next(options, connection, slot, body, body_len);
+          ++outstanding;
+        }
+      }
+      if (ok && connection->out.len) {
+        ok = write_requests(connection);
+      }
+    }
+  }
+  const uint64_t elapsed = time_ns() - start;
+
+  if (ok) {
+    uint64_t values[4];
+    latencies_percentiles(&latencies, values);
+    printf("requests,seconds,requests_per_second,failed");
+    for (unsigned int i = 0; i < 4; ++i) {
+      printf(",%s_ns", percentile_names[i]);
+    }
+    printf("\n%zu,%.3f,%.2f,%" PRIu64, latencies.len, elapsed / 1e9,
+           latencies.len / (elapsed / 1e9), failed);
+    for (unsigned int i = 0; i < 4; ++i) {
+      printf(",%" PRIu64, values[i]);
+    }
+    printf("\n");
+  }
+
+  for (unsigned int i = 0; connections && i < options->connections; ++i) {
+    if (connections[i].fd > 0) {
+      close(connections[i].fd);
+    }
+    free(connections[i].in.data);
+    free(connections[i].out.data);
+  }
+  free(latencies.values);
+  free(pfds);
+  free(connections);
+  return ok && !failed;
+}
+
+/* the body of the requests: the message, or for verifications a signature of it obtained from the
+ * daemon followed by the message */
+static uint8_t* prepare_body(const load_options_t* options, size_t* body_len) {
+  uint8_t* message = malloc(options->message_len);
+  if (!message) {
+    return NULL;
+  }
+  for (uint32_t i = 0; i < options->message_len; ++i) {
+    message[i] = i;
+  }
+  if (options->op == SIGND_OP_SIGN) {
+    *body_len = options->message_len;
+    return message;
+  }
+
+  connection_t connection;
+  memset(&connection, 0, sizeof(connection));
+  connection.fd = connect_to(options->socket_path);
+  uint8_t* body = NULL;
+  size_t len    = 0;
+  if (connection.fd >= 0 &&
+      queue_request(&connection, 0, SIGND_OP_SIGN, options->key, message, options->message_len) &&
+      write_requests(&connection) && (len = next_response(&connection, true)) != 0 &&
+      len != SIZE_MAX && connection.in.data[8] == SIGND_STATUS_OK) {
+    const size_t signature_len = len - SIGND_RESPONSE_HEADER_SIZE;
+    body                       = malloc(4 + signature_len + options->message_len);
+    if (body) {
+      signd_put_u32(body, signature_len);
+      memcpy(body + 4, connection.in.data + SIGND_RESPONSE_HEADER_SIZE, signature_len);
+      memcpy(body + 4 + signature_len, message, options->message_len);
+      *body_len = 4 + signature_len + options->message_len;
+    }
+  } else {
+    printf("Failed to obtain a signature from the daemon.\n");
+  }
+  if (connection.fd >= 0) {
+    close(connection.fd);
+  }
+  free(connection.in.data);
+  free(connection.out.data);
+  free(message);
+  return body;
+}
+
+static bool parse_uint32_t(uint32_t* value, const char* arg) {
+  errno        = 0;
+  char* end    = NULL;
+  const long v = strtol(arg, &end, 10);
+  if (errno != 0 || end == arg || *end || v < 0 || (unsigned long)v > UINT32_MAX) {
+    return false;
+  }
+  *value = v;
+  return true;
+}
+
+static void print_usage(const char* arg0) {
+  printf("usage: %s [-s socket] [-c connections] [-p depth] [-d duration_ms] [-o sign|verify] "
+         "[-k key] [-m message_len]\n",
+         arg0);
+}
+
+static bool parse_args(load_options_t* options, int argc, char** argv) {
+  options->socket_path = "picnic-signd.sock";
+  options->connections = 1;
+  options->depth       = 16;
+  options->duration_ms = 2000;
+  options->op          = SIGND_OP_SIGN;
+  options->key         = 0;
+  options->message_len = 32;
+
+  static const struct option long_options[] = {
+    {"socket", required_argument, NULL, 's'},
+    {"connections", required_argument, NULL, 'c'},
+    {"depth", required_argument, NULL, 'p'},
+    {"duration", required_argument, NULL, 'd'},
+    {"operation", required_argument, NULL, 'o'},
+    {"key", required_argument, NULL, 'k'},
+    {"message-length", required_argument, NULL, 'm'},
+    {0, 0, 0, 0}
+  };
+
+  int c            = -1;
+  int option_index = 0;
+  uint32_t value   = 0;
+  while ((c = getopt_long(argc, argv, "s:c:p:d:o:k:m:", long_options, &option_index)) != -1) {
+    switch (c) {
+    case 's':
+      options->socket_path = optarg;
+      break;
+
+    case 'c':
+      if (!parse_uint32_t(&options->connections, optarg) || !options->connections) {
+        printf("Invalid number of connections!\n");
+        return false;
+      }
+      break;
+
+    case 'p':
+      if (!parse_uint32_t(&options->depth, optarg) || !options->depth ||
+          options->depth > MAX_DEPTH) {
+        printf("Invalid pipeline depth!\n");
+        return false;
+      }
+      break;
+
+    case 'd':
+      if (!parse_uint32_t(&options->duration_ms, optarg) || !options->duration_ms) {
+        printf("Invalid duration!\n");
+        return false;
+      }
+      break;
+
+    case 'o':
+      if (!strcmp(optarg, "sign")) {
+        options->op = SIGND_OP_SIGN;
+      } else if (!strcmp(optarg, "verify")) {
+        options->op = SIGND_OP_VERIFY;
+      } else {
+        printf("Invalid operation!\n");
+        return false;
+      }
+      break;
+
+    case 'k':
+      if (!parse_uint32_t(&value, optarg) || value > UINT16_MAX) {
+        printf("Invalid key!\n");
+        return false;
+      }
+      options->key = value;
+      break;
+
+    case 'm':
+      if (!parse_uint32_t(&options->message_len, optarg) ||
+          options->message_len > SIGND_MAX_FRAME_SIZE / 2) {
+        printf("Invalid message length!\n");
+        return false;
+      }
+      break;
+
+    case '?':
+    default:
+      print_usage(argv[0]);
+      return false;
+    }
+  }
+
+  if (optind != argc) {
+    print_usage(argv[0]);
+    return false;
+  }
+  return true;
+}
+
+int main(int argc, char** argv) {
+  load_options_t options;
+  if (!parse_args(&options, argc, argv)) {
+    return -1;
+  }
+
+  size_t body_len = 0;
+  uint8_t* body   = prepare_body(&options, &body_len);
+  if (!body) {
+    return -1;
+  }
+  const bool ok = run(&options, body, body_len);
+  free(body);
+  return ok ? 0 : -1;
+}
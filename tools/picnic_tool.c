@@ -0,0 +1,632 @@
+/*
+ *  This file is part of the optimized implementation of the Picnic signature scheme.
+ *  See the accompanying documentation for complete details.
+ *
+ *  The code is provided under the MIT license, see LICENSE for
+ *  more details.
+ *  SPDX-License-Identifier: MIT
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "picnic.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+/* files up to this size are read instead of mapped */
+#define MAX_READ_SIZE (64 * 1024)
+
+typedef enum { COMMAND_SIGN, COMMAND_VERIFY } command_t;
+
+typedef struct {
+  command_t command;
+  unsigned int threads;
+  /* suffix appended to the path of a file to obtain the path of its detached signature */
+  const char* suffix;
+  picnic_privatekey_t sk;
+  picnic_publickey_t pk;
+} tool_options_t;
+
+typedef struct {
+  char** paths;
+  size_t len, capacity;
+} file_list_t;
+
+typedef struct {
+  const tool_options_t* options;
+  const file_list_t* files;
+  atomic_size_t* next;
+  uint8_t signature[PICNIC_MAX_SIGNATURE_SIZE];
+  uint8_t message[MAX_READ_SIZE];
+  char error[128];
+  uint64_t processed;
+  uint64_t bytes;
+  uint64_t failed;
+} worker_t;
+
+/* a message read or mapped into memory */
+typedef struct {
+  const uint8_t* data;
+  size_t len;
+  bool mapped;
+} mapping_t;
+
+/* memset through a volatile pointer is not removed, even if the memory is not read afterwards */
+static void* (*const volatile scrub_memset)(void*, int, size_t) = memset;
+
+static void scrub(void* ptr, size_t len) {
+  scrub_memset(ptr, 0, len);
+}
+
+static uint64_t time_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * UINT64_C(1000000000) + ts.tv_nsec;
+}
+
+static bool has_suffix(const char* path, const char* suffix) {
+  const size_t path_len   = strlen(path);
+  const size_t suffix_len = strlen(suffix);
+  return path_len >= suffix_len && !strcmp(path + path_len - suffix_len, suffix);
+}
+
+static char* concat(const char* lhs, const char* separator, const char* rhs) {
+  const size_t lhs_len       = strlen(lhs);
+  const size_t separator_len = strlen(separator);
+  const size_t rhs_len       = strlen(rhs);
+  char* dst                  = malloc(lhs_len + separator_len + rhs_len + 1);
+  if (dst) {
+    memcpy(dst, lhs, lhs_len);
+    memcpy(dst + lhs_len, separator, separator_len);
+    memcpy(dst + lhs_len + separator_len, rhs, rhs_len + 1);
+  }
+  return dst;
+}
+
+static bool file_list_push(file_list_t* files, char* path) {
+  if (!path) {
+    return false;
+  }
+  if (files->len == files->capacity) {
+    const size_t capacity = files->capacity ? 2 * files->capacity : 256;
+    char** paths          = realloc(files->paths, capacity * sizeof(char*));
+    if (!paths) {
+      free(path);
+      return false;
+    }
+    files->paths    = paths;
+    files->capacity = capacity;
+  }
+  files->paths[files->len++] = path;
+  return true;
+}
+
+static void file_list_clear(file_list_t* files) {
+  for (size_t i = 0; i < files->len; ++i) {
+    free(files->paths[i]);
+  }
+  free(files->paths);
+}
+
+/*
+ * Add a file, or all files below a directory except for signatures. Symbolic links are only
+ * followed for the given path and for files, since links to directories may form loops.
+ */
+static bool collect(file_list_t* files, const char* path, const char* suffix, bool follow) {
+  struct stat st;
+  if (follow ? stat(path, &st) : lstat(path, &st)) {
+    fprintf(stderr, "%s: %s\n", path, strerror(errno));
+    return false;
+  }
+  if (S_ISLNK(st.st_mode)) {
+    if (!stat(path, &st) && S_ISDIR(st.st_mode)) {
+      return true;
+    }
+    return file_list_push(files, strdup(path));
+  }
+  if (!S_ISDIR(st.st_mode)) {
+    return file_list_push(files, strdup(path));
+  }
+
+  DIR* dir = opendir(path);
+  if (!dir) {
+    fprintf(stderr, "%s: %s\n", path, strerror(errno));
+    return false;
+  }
+  bool ok = true;
+  for (struct dirent* entry = readdir(dir); ok && entry; entry = readdir(dir)) {
+    if (!strcmp(entry->d_name, ".") || !strcmp(entry->d_name, "..") ||
+        has_suffix(entry->d_name, suffix)) {
+      continue;
+    }
+    char* child = concat(path, "/", entry->d_name);
+    ok          = child && collect(files, child, suffix, false);
+    free(child);
+  }
+  closedir(dir);
+  return ok;
+}
+
+/* add the files named in a list with one path per line, or in stdin if the name is - */
+static bool collect_list(file_list_t* files, const char* list) {
+  FILE* file = strcmp(list, "-") ? fopen(list, "r") : stdin;
+  if (!file) {
+    fprintf(stderr, "%s: %s\n", list, strerror(errno));
+    return false;
+  }
+
+  bool ok     = true;
+  char* line  = NULL;
+  size_t size = 0;
+  ssize_t len;
+  while (ok && (len = getline(&line, &size, file)) != -1) {
+    if (len && line[len - 1] == '\n') {
+      line[--len] = '\0';
+    }
+    if (len) {
+      ok = file_list_push(files, strdup(line));
+    }
+  }
+  free(line);
+  if (file != stdin) {
+    fclose(file);
+  }
+  return ok;
+}
+
+/* strerror is not thread-safe */
+static const char* error_message(worker_t* worker, int error) {
+  if (strerror_r(error, worker->error, sizeof(worker->error))) {
+    snprintf(worker->error, sizeof(worker->error), "error %d", error);
+  }
+  return worker->error;
+}
+
+/*
+ * Open a regular file for reading. Opening does not block, so that FIFOs and devices are rejected
+ * instead of waiting for a writer. Returns the reason on failure.
+ */
+static const char* open_regular(worker_t* worker, const char* path, int* fd, struct stat* st) {
+  *fd = open(path, O_RDONLY | O_CLOEXEC | O_NOCTTY | O_NONBLOCK);
+  if (*fd < 0) {
+    return error_message(worker, errno);
+  }
+
+  const char* error = NULL;
+  if (fstat(*fd, st)) {
+    error = error_message(worker, errno);
+  } else if (!S_ISREG(st->st_mode)) {
+    error = "not a regular file";
+  } else if (fcntl(*fd, F_SETFL, fcntl(*fd, F_GETFL) & ~O_NONBLOCK)) {
+    error = error_message(worker, errno);
+  }
+  if (error) {
+    close(*fd);
+  }
+  return error;
+}
+
+/*
+ * Small files are read into the buffer of the worker, larger ones are mapped. Accessing a mapping
+ * beyond the end of a file that was truncated in the meantime raises SIGBUS, so the files must not
+ * be truncated while the tool runs. Returns the reason on failure.
+ */
+static const char* map_file(worker_t* worker, mapping_t* mapping, const char* path) {
+  int fd;
+  struct stat st;
+  const char* error = open_regular(worker, path, &fd, &st);
+  if (error) {
+    return error;
+  }
+
+  bool ok         = true;
+  mapping->mapped = st.st_size > MAX_READ_SIZE;
+  if (mapping->mapped) {
+    void* data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ok         = data != MAP_FAILED;
+    if (ok) {
+      /* the message is hashed once from start to end */
+      madvise(data, st.st_size, MADV_SEQUENTIAL);
+      mapping->data = data;
+      mapping->len  = st.st_size;
+    }
+  } else {
+    mapping->data = worker->message;
+    mapping->len  = 0;
+    /* a file growing in the meantime is cut off at the size it had */
+    while (ok && mapping->len < (size_t)st.st_size) {
+      const ssize_t ret = read(fd, worker->message + mapping->len, st.st_size - mapping->len);
+      if (ret > 0) {
+        mapping->len += ret;
+      } else if (!ret) {
+        break;
+      } else {
+        ok = errno == EINTR;
+      }
+    }
+  }
+  if (!ok) {
+    error = error_message(worker, errno);
+  }
+  close(fd);
+  return error;
+}
+
+static void unmap_file(mapping_t* mapping) {
+  if (mapping->mapped) {
+    munmap((void*)mapping->data, mapping->len);
+  }
+}
+
+/*
+ * The signature is written to a temporary file next to it that replaces the signature once it is
+ * complete, so that an interrupted run never leaves a truncated signature behind.
+ */
+static bool write_signature(const char* path, const uint8_t* signature, size_t signature_len) {
+  static atomic_uint counter;
+
+  char suffix[64];
+  snprintf(suffix, sizeof(suffix), ".%ld.%u.tmp", (long)getpid(), atomic_fetch_add(&counter, 1));
+  char* tmp_path = concat(path, "", suffix);
+  if (!tmp_path) {
+    return false;
+  }
+
+  const int fd = open(tmp_path, O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0666);
+  bool ok      = fd >= 0;
+  if (ok) {
+    for (size_t written = 0; ok && written < signature_len;) {
+      const ssize_t ret = write(fd, signature + written, signature_len - written);
+      if (ret >= 0) {
+        written += ret;
+      } else {
+        ok = errno == EINTR;
+      }
+    }
+    ok = !close(fd) && ok && !rename(tmp_path, path);
+    if (!ok) {
+      unlink(tmp_path);
+    }
+  }
+  free(tmp_path);
+  return ok;
+}
+
+static bool read_signature(worker_t* worker, const char* path, size_t* signature_len) {
+  int fd;
+  struct stat st;
+  if (open_regular(worker, path, &fd, &st)) {
+    return false;
+  }
+  FILE* file = fdopen(fd, "rb");
+  if (!file) {
+    close(fd);
+    return false;
+  }
+  *signature_len = fread(worker->signature, 1, sizeof(worker->signature), file);
+  /* longer files cannot hold a valid signature */
+  const bool ok = !ferror(file) && fgetc(file) == EOF;
+  fclose(file);
+  return ok;
+}
+
+static const char* process_file(worker_t* worker, const char* path) {
+  const tool_options_t* options = worker->options;
+
+  char* signature_path = concat(path, "", options->suffix);
+  if (!signature_path) {
+    return "out of memory";
+  }
+  mapping_t mapping;
+  const char* error = map_file(worker, &mapping, path);
+  if (error) {
+    free(signature_path);
+    return error;
+  }
+
+  size_t signature_len = sizeof(worker->signature);
+  if (options->command == COMMAND_SIGN) {
+    if (picnic_sign(&options->sk, mapping.data, mapping.len, worker->signature, &signature_len)) {
+      error = "signing failed";
+    } else if (!write_signature(signature_path, worker->signature, signature_len)) {
+      error = "failed to write the signature";
+    }
+  } else {
+    if (!read_signature(worker, signature_path, &signature_len)) {
+      error = "failed to read the signature";
+    } else if (picnic_verify(&options->pk, mapping.data, mapping.len, worker->signature,
+                             signature_len)) {
+      error = "invalid signature";
+    }
+  }
+  worker->bytes += mapping.len;
+  unmap_file(&mapping);
+  free(signature_path);
+  return error;
+}
+
+static void* worker_run(void* arg) {
+  worker_t* worker = arg;
+
+  for (;;) {
+    const size_t i = atomic_fetch_add(worker->next, 1);
+    if (i >= worker->files->len) {
+      break;
+    }
+
+    const char* path = worker->files->paths[i];
+    const char* err  = process_file(worker, path);
+    if (err) {
+      fprintf(stderr, "%s: %s\n", path, err);
+      ++worker->failed;
+    }
+    ++worker->processed;
+  }
+  return NULL;
+}
+
+static bool run(const tool_options_t* options, const file_list_t* files) {
+  unsigned int threads = options->threads;
+  if (threads > files->len) {
+    threads = files->len ? files->len : 1;
+  }
+
+  worker_t* workers  = calloc(threads, sizeof(worker_t));
+  pthread_t* handles = calloc(threads, sizeof(pthread_t));
+  atomic_size_t next = 0;
+  if (!workers || !handles) {
+    free(handles);
+    free(workers);
+    return false;
+  }
+
+  const uint64_t start = time_ns();
+  unsigned int started = 0;
+  for (; started < threads; ++started) {
+    workers[started].options = options;
+    workers[started].files   = files;
+    workers[started].next    = &next;
+    if (pthread_create(&handles[started], NULL, worker_run, &workers[started])) {
+      break;
+    }
+  }
+  for (unsigned int i = 0; i < started; ++i) {
+    pthread_join(handles[i], NULL);
+  }
+  if (!started) {
+    /* process the files on this thread instead */
+    worker_run(&workers[started++]);
+  }
+  const double seconds = (time_ns() - start) / 1e9;
+
+  uint64_t processed = 0, bytes = 0, failed = 0;
+  for (unsigned int i = 0; i < started; ++i) {
+    processed += workers[i].processed;
+    bytes += workers[i].bytes;
+    failed += workers[i].failed;
+  }
+  printf("files,bytes,failed,seconds,files_per_second,MiB_per_second\n");
+  printf("%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%.3f,%.2f,%.2f\n", processed, bytes, failed, seconds,
+         seconds > 0 ? processed / seconds : 0, seconds > 0 ? bytes / seconds / (1 << 20) : 0);
+
+  free(handles);
+  free(workers);
+  return !failed && processed == files->len;
+}
+
+static bool read_file(const char* path, uint8_t* buf, size_t* len) {
+  FILE* file = fopen(path, "rb");
+  if (!file) {
+    return false;
+  }
+  *len = fread(buf, 1, *len, file);
+  fclose(file);
+  return true;
+}
+
+/* a private key is only readable by its owner, and an existing file is never overwritten */
+static bool write_file(const char* path, const uint8_t* buf, size_t len, bool private_key) {
+  FILE* file = NULL;
+  if (private_key) {
+    const int fd = open(path, O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+    if (fd >= 0) {
+      file = fdopen(fd, "wb");
+      if (!file) {
+        close(fd);
+      }
+    }
+  } else {
+    file = fopen(path, "wb");
+  }
+  if (!file) {
+    return false;
+  }
+  const bool ok = fwrite(buf, 1, len, file) == len;
+  return !fclose(file) && ok;
+}
+
+static picnic_params_t parse_param(const char* arg) {
+  for (unsigned int p = Picnic_L1_FS; p < PARAMETER_SET_MAX_INDEX; ++p) {
+    if (!strcmp(arg, picnic_get_param_name(p))) {
+      return p;
+    }
+  }
+
+  char* end             = NULL;
+  const unsigned long p = strtoul(arg, &end, 10);
+  if (end == arg || *end || p <= PARAMETER_SET_INVALID || p >= PARAMETER_SET_MAX_INDEX) {
+    return PARAMETER_SET_INVALID;
+  }
+  return p;
+}
+
+static int keygen(int argc, char** argv) {
+  if (argc != 5) {
+    printf("usage: %s keygen param private_key_file public_key_file\n", argv[0]);
+    return -1;
+  }
+
+  const picnic_params_t param = parse_param(argv[2]);
+  picnic_privatekey_t sk;
+  picnic_publickey_t pk;
+  if (param == PARAMETER_SET_INVALID || picnic_keygen(param, &pk, &sk)) {
+    printf("Invalid parameter set!\n");
+    return -1;
+  }
+
+  uint8_t sk_buf[PICNIC_MAX_PRIVATEKEY_SIZE];
+  uint8_t pk_buf[PICNIC_MAX_PUBLICKEY_SIZE];
+  const int sk_len = picnic_write_private_key(&sk, sk_buf, sizeof(sk_buf));
+  const int pk_len = picnic_write_public_key(&pk, pk_buf, sizeof(pk_buf));
+  const bool ok    = sk_len > 0 && pk_len > 0 && write_file(argv[3], sk_buf, sk_len, true) &&
+                   write_file(argv[4], pk_buf, pk_len, false);
+  scrub(sk_buf, sizeof(sk_buf));
+  scrub(&sk, sizeof(sk));
+  if (!ok) {
+    printf("Failed to write the keys!\n");
+    return -1;
+  }
+  return 0;
+}
+
+static bool parse_uint32_t(uint32_t* value, const char* arg) {
+  errno        = 0;
+  char* end    = NULL;
+  const long v = strtol(arg, &end, 10);
+  if (errno != 0 || end == arg || *end || v < 0 || (unsigned long)v > UINT32_MAX) {
+    return false;
+  }
+  *value = v;
+  return true;
+}
+
+static void print_usage(const char* arg0) {
+  printf("usage: %s keygen param private_key_file public_key_file\n"
+         "       %s sign [-j threads] [-l list] [-s suffix] private_key_file [path...]\n"
+         "       %s verify [-j threads] [-l list] [-s suffix] public_key_file [path...]\n",
+         arg0, arg0, arg0);
+}
+
+static bool parse_args(tool_options_t* options, file_list_t* files, int argc, char** argv) {
+  options->command = strcmp(argv[1], "sign") ? COMMAND_VERIFY : COMMAND_SIGN;
+  options->threads = 0;
+  options->suffix  = ".sig";
+
+  static const struct option long_options[] = {
+    {"jobs", required_argument, NULL, 'j'},
+    {"list", required_argument, NULL, 'l'},
+    {"suffix", required_argument, NULL, 's'},
+    {0, 0, 0, 0}
+  };
+
+  const char* list = NULL;
+  int c            = -1;
+  int option_index = 0;
+  /* skip the command */
+  while ((c = getopt_long(argc - 1, argv + 1, "j:l:s:", long_options, &option_index)) != -1) {
+    switch (c) {
+    case 'j':
+      if (!parse_uint32_t(&options->threads, optarg)) {
+        printf("Invalid number of threads!\n");
+        return false;
+      }
+      break;
+
+    case 'l':
+      list = optarg;
+      break;
+
+    case 's':
+      if (!*optarg) {
+        printf("Invalid suffix!\n");
+        return false;
+      }
+      options->suffix = optarg;
+      break;
+
+    case '?':
+    default:
+      print_usage(argv[0]);
+      return false;
+    }
+  }
+
+  if (optind + 1 >= argc) {
+    print_usage(argv[0]);
+    return false;
+  }
+  if (!options->threads) {
+    const long cpus  = sysconf(_SC_NPROCESSORS_ONLN);
+    options->threads = cpus > 0 ? cpus : 1;
+  }
+
+  uint8_t buf[PICNIC_MAX_PRIVATEKEY_SIZE];
+  size_t len      = sizeof(buf);
+  const char* key = argv[optind + 1];
+  bool ok         = read_file(key, buf, &len);
+  if (ok && options->command == COMMAND_SIGN) {
+    ok = !picnic_read_private_key(&options->sk, buf, len);
+  } else if (ok) {
+    ok = !picnic_read_public_key(&options->pk, buf, len);
+  }
+  scrub(buf, sizeof(buf));
+  if (!ok) {
+    printf("Failed to read the key from %s!\n", key);
+    return false;
+  }
+
+  if (list && !collect_list(files, list)) {
+    return false;
+  }
+  for (int i = optind + 2; i < argc; ++i) {
+    if (!collect(files, argv[i], options->suffix, true)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    print_usage(argv[0]);
+    return -1;
+  }
+  if (!strcmp(argv[1], "keygen")) {
+    return keygen(argc, argv);
+  }
+  if (strcmp(argv[1], "sign") && strcmp(argv[1], "verify")) {
+    print_usage(argv[0]);
+    return -1;
+  }
+
+  tool_options_t options;
+  file_list_t files = {NULL, 0, 0};
+  bool ok           = parse_args(&options, &files, argc, argv);
+  if (ok) {
+    /* page in the constant tables before the workers start */
+    const picnic_params_t param =
+        options.command == COMMAND_SIGN ? options.sk.data[0] : options.pk.data[0];
+    picnic_init(PICNIC_PARAMS_MASK(param), PICNIC_INIT_ADVISE | PICNIC_INIT_PREFAULT);
+    ok = run(&options, &files);
+  }
+  scrub(&options.sk, sizeof(options.sk));
+  file_list_clear(&files);
+  return ok ? 0 : -1;
+}
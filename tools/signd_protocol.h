@@ -0,0 +1,63 @@
+/*
+ *  This file is part of the optimized implementation of the Picnic signature scheme.
+ *  See the accompanying documentation for complete details.
+ *
+ *  The code is provided under the MIT license, see LICENSE for
+ *  more details.
+ *  SPDX-License-Identifier: MIT
+ */
+
+#ifndef SIGND_PROTOCOL_H
+#define SIGND_PROTOCOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Framing of picnic-signd. All integers are little endian. Every frame starts with the length of
+ * the rest of the frame, followed by an id chosen by the client and echoed in the response.
+ *
+ * request:  u32 length || u32 id || u8 op || u16 key || body
+ *   SIGND_OP_SIGN:   body = message
+ *   SIGND_OP_VERIFY: body = u32 signature length || signature || message
+ * response: u32 length || u32 id || u8 status || body
+ *   body = signature for successful SIGND_OP_SIGN requests, empty otherwise
+ *
+ * Requests may be pipelined; responses are sent in the order of completion.
+ */
+
+#define SIGND_OP_SIGN 1
+#define SIGND_OP_VERIFY 2
+
+#define SIGND_STATUS_OK 0
+/* signing failed or the signature is invalid */
+#define SIGND_STATUS_FAILED 1
+/* malformed request or unknown key */
+#define SIGND_STATUS_BAD_REQUEST 2
+
+#define SIGND_REQUEST_HEADER_SIZE (4 + 4 + 1 + 2)
+#define SIGND_RESPONSE_HEADER_SIZE (4 + 4 + 1)
+/* maximal length of a frame without the length field */
+#define SIGND_MAX_FRAME_SIZE (1 << 20)
+
+static inline void signd_put_u16(uint8_t* dst, uint16_t v) {
+  dst[0] = v & 0xff;
+  dst[1] = v >> 8;
+}
+
+static inline void signd_put_u32(uint8_t* dst, uint32_t v) {
+  dst[0] = v & 0xff;
+  dst[1] = (v >> 8) & 0xff;
+  dst[2] = (v >> 16) & 0xff;
+  dst[3] = v >> 24;
+}
+
+static inline uint16_t signd_get_u16(const uint8_t* src) {
+  return src[0] | (uint16_t)src[1] << 8;
+}
+
+static inline uint32_t signd_get_u32(const uint8_t* src) {
+  return src[0] | (uint32_t)src[1] << 8 | (uint32_t)src[2] << 16 | (uint32_t)src[3] << 24;
+}
+
+#endif